@@ -55,6 +55,20 @@ struct AssetPoolSize { };
         static constexpr uint64 poolSize = PoolSize;    \
     };
 
+// Assets without a memory tag are counted as untagged
+template<typename T>
+struct AssetMemoryTag
+{
+    static constexpr MemoryTag memoryTag = MemoryTag::UNTAGGED;
+};
+
+#define FE_DEFINE_ASSET_MEMORY_TAG(AssetType, MemoryTagValue)   \
+    template<>                                                  \
+    struct AssetMemoryTag<AssetType>                            \
+    {                                                           \
+        static constexpr MemoryTag memoryTag = MemoryTagValue;  \
+    };
+
 uint32 get_asset_type_count();
 
 }
@@ -2,6 +2,7 @@
 #include "model/model_bridge.h"
 #include "texture/texture_bridge.h"
 #include "core/task_composer.h"
+#include "core/profiler.h"
 #include "core/file_system/file_system.h"
 #include <unordered_set>
 
@@ -76,6 +77,11 @@ Material* AssetManager::create_material(const MaterialCreateInfo& createInfo)
 
 bool AssetManager::import_model(const ModelImportContext& inImportContext, ModelImportResult& outImportResult)
 {
+    FE_PROFILE_SCOPE("AssetManager::import_model");
+
+    // Result of the previous import of this file would be replaced anyway
+    cancel_import(inImportContext.originalFilePath);
+
     if (!ModelBridge::import(inImportContext, outImportResult))
         return false;
 
@@ -97,6 +103,8 @@ bool AssetManager::import_model(const ModelImportContext& inImportContext, Model
 
 bool AssetManager::import_texture(const TextureImportContext& inImportContext, TextureImportResult& outImportResult)
 {
+    FE_PROFILE_SCOPE("AssetManager::import_texture");
+
     if (!TextureBridge::import(inImportContext, outImportResult))
         return false;
 
@@ -111,6 +119,8 @@ bool AssetManager::import_texture(const TextureImportContext& inImportContext, T
 
 bool AssetManager::import_texture(const TextureImportFromMemoryContext& inImportContext, TextureImportResult& outImportResult)
 {
+    FE_PROFILE_SCOPE("AssetManager::import_texture_from_memory");
+
     if (!TextureBridge::import(inImportContext, outImportResult))
         return false;
 
@@ -142,7 +152,11 @@ bool AssetManager::is_asset_loaded(UUID assetUUID)
 
 void AssetManager::load_assets(TaskGroup& taskGroup)
 {
+    FE_PROFILE_SCOPE("AssetManager::load_assets");
+
+    PendingOperation pendingOperation;
     TaskGroup localTaskGroup;
+    localTaskGroup.link_cancellation_token(pendingOperation.get_cancellation_token());
 
     for (uint32 assetType = 0; assetType != std::to_underlying(Type::COUNT); ++assetType)
     {
@@ -193,6 +207,26 @@ void AssetManager::load_assets(TaskGroup& taskGroup)
     }
 
     TaskComposer::wait(localTaskGroup);
+
+    if (localTaskGroup.is_cancelled())
+        FE_LOG(LogAssetManager, WARNING, "AssetManager::load_assets(): Asset loading was cancelled");
+}
+
+void AssetManager::cancel_pending_tasks()
+{
+    std::scoped_lock<std::mutex> locker(s_pendingOperationsMutex);
+    for (PendingOperation* pendingOperation : s_pendingOperations)
+        pendingOperation->m_cancellationSource.cancel();
+}
+
+void AssetManager::cancel_import(const std::string& originalFilePath)
+{
+    std::scoped_lock<std::mutex> locker(s_pendingOperationsMutex);
+    for (PendingOperation* pendingOperation : s_pendingOperations)
+    {
+        if (pendingOperation->m_originalFilePath == originalFilePath)
+            pendingOperation->m_cancellationSource.cancel();
+    }
 }
 
 void AssetManager::save_assets()
@@ -256,6 +290,19 @@ void AssetManager::configure_created_asset(Asset* asset, const CreateInfo& creat
     s_assetStorage.add_asset(asset);
 }
 
+AssetManager::PendingOperation::PendingOperation(const std::string& originalFilePath)
+    : m_originalFilePath(originalFilePath)
+{
+    std::scoped_lock<std::mutex> locker(s_pendingOperationsMutex);
+    s_pendingOperations.push_back(this);
+}
+
+AssetManager::PendingOperation::~PendingOperation()
+{
+    std::scoped_lock<std::mutex> locker(s_pendingOperationsMutex);
+    s_pendingOperations.erase(std::find(s_pendingOperations.begin(), s_pendingOperations.end(), this));
+}
+
 std::string AssetManager::generate_path(const std::string& projectDirectory, const std::string& name)
 {
     return projectDirectory + "/" + name + ".feasset";
@@ -7,7 +7,8 @@
 #include "model/model.h"
 #include "texture/texture.h"
 #include "core/fwd.h"
-#include "core/pool_allocator.h"
+#include "core/concurrent_pool_allocator.h"
+#include "core/task_types.h"
 #include "core/file_system/archive.h"
 
 namespace fe::asset
@@ -69,8 +70,36 @@ public:
     static bool is_model_format_supported(const std::string& extension);
     static bool is_texture_format_supported(const std::string& extension);
 
+    // Cancellation of one load_assets() or import call. It lives next to the TaskGroup that is linked to its token,
+    // and is registered while it exists, so cancel_pending_tasks() and cancel_import() can reach it.
+    class PendingOperation
+    {
+    public:
+        PendingOperation(const std::string& originalFilePath = std::string());
+        ~PendingOperation();
+
+        PendingOperation(const PendingOperation&) = delete;
+        PendingOperation& operator=(const PendingOperation&) = delete;
+
+        CancellationToken get_cancellation_token() const { return m_cancellationSource.get_token(); }
+
+    private:
+        friend AssetManager;
+
+        CancellationSource m_cancellationSource;
+        std::string m_originalFilePath;
+    };
+
+    // Drops queued tasks of all load_assets() and import calls that are in progress, for example when the project
+    // is closed. Can be called from any thread, operations started after the call are not affected.
+    static void cancel_pending_tasks();
+    // Same as cancel_pending_tasks() for imports of one file, import_model() calls it before importing the file again
+    static void cancel_import(const std::string& originalFilePath);
+
 private:
     inline static AssetStorage s_assetStorage;
+    inline static std::mutex s_pendingOperationsMutex;
+    inline static std::vector<PendingOperation*> s_pendingOperations;
     inline static Model* s_defaultModel = nullptr;
     inline static Texture* s_defaultTexture = nullptr;
     inline static Material* s_defaultMaterial = nullptr;
@@ -79,7 +108,7 @@ private:
     static T* allocate()
     {
         FE_COMPILE_CHECK((std::is_base_of_v<Asset, T>));
-        static ThreadSafePoolAllocator<T, AssetPoolSize<T>::poolSize> allocator;
+        static ConcurrentPoolAllocator<T, AssetPoolSize<T>::poolSize, AssetMemoryTag<T>::memoryTag> allocator;
         return allocator.allocate();
     }
 
@@ -10,6 +10,8 @@ void AssetStorage::add_asset(Asset* asset)
 {
     FE_CHECK(asset);
 
+    std::scoped_lock<std::mutex> locker(m_mutex);
+
     if (m_assetByUUID.find(asset->get_uuid()) != m_assetByUUID.end())
     {
         FE_LOG(LogAssetManager, ERROR, "Asset with UUID {} was added earlier.", asset->get_uuid());
@@ -21,6 +23,8 @@ void AssetStorage::add_asset(Asset* asset)
 
 Asset* AssetStorage::get_asset(UUID uuid) const
 {
+    std::scoped_lock<std::mutex> locker(m_mutex);
+
     auto it = m_assetByUUID.find(uuid);
 
     if (it == m_assetByUUID.end())
@@ -31,15 +35,14 @@ Asset* AssetStorage::get_asset(UUID uuid) const
 
 void AssetStorage::save_asset(UUID uuid) const
 {
-    auto it = m_assetByUUID.find(uuid);
+    Asset* asset = get_asset(uuid);
 
-    if (it == m_assetByUUID.end())
+    if (!asset)
     {
         FE_LOG(LogAssetManager, ERROR, "Failed to find asset with UUID {}.", uuid);
         return;
     }
 
-    Asset* asset = it->second;
     if (!asset->is_dirty())
         return;
 
@@ -52,17 +55,21 @@ void AssetStorage::save_assets() const
 {
     TaskGroup taskGroup;
 
-    for (auto [uuid, asset] : m_assetByUUID)
     {
-        if (!asset->is_dirty() || has_flag(asset->get_flags(), AssetFlag::TRANSIENT))
-            continue;
+        std::scoped_lock<std::mutex> locker(m_mutex);
 
-        TaskComposer::execute(taskGroup, [asset](TaskExecutionInfo)
+        for (auto [uuid, asset] : m_assetByUUID)
         {
-            Archive archive;
-            asset->serialize(archive);
-            archive.save(asset->get_path());
-        });
+            if (!asset->is_dirty() || has_flag(asset->get_flags(), AssetFlag::TRANSIENT))
+                continue;
+
+            TaskComposer::execute(taskGroup, [asset](TaskExecutionInfo)
+            {
+                Archive archive;
+                asset->serialize(archive);
+                archive.save(asset->get_path());
+            });
+        }
     }
 
     TaskComposer::wait(taskGroup);
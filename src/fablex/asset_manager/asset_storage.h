@@ -17,7 +17,8 @@ public:
     void save_assets() const;
 
 private:
-    std::mutex m_mutex;
+    // Assets are added by loading tasks while other threads look them up
+    mutable std::mutex m_mutex;
     std::unordered_map<UUID, Asset*> m_assetByUUID;
 };
 
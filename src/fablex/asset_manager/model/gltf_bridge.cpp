@@ -21,6 +21,12 @@ namespace tinygltf
 
 struct TextureLoadingContext
 {
+    TextureLoadingContext(const std::string& originalFilePath) : pendingOperation(originalFilePath)
+    {
+        taskGroup.link_cancellation_token(pendingOperation.get_cancellation_token());
+    }
+
+    fe::asset::AssetManager::PendingOperation pendingOperation;
     fe::TaskGroup taskGroup;
     std::mutex mutex;
     std::unordered_map<std::string, fe::asset::Texture*> textureByURI; 
@@ -69,17 +75,17 @@ bool LoadImageData(Image *image, const int imageIdx, std::string *err, std::stri
 
     TextureLoadingContext* loadingContext = static_cast<TextureLoadingContext*>(userData);
 
-    fe::asset::TextureImportFromMemoryContext importContext;
-    importContext.data = bytes;
-    importContext.dataSize = size;
-    importContext.name = image->name;
-    importContext.originalFilePath = image->uri;
-    importContext.projectDirectory = fe::FileSystem::get_project_path();
-
-    fe::TaskComposer::execute(loadingContext->taskGroup, [importContext, loadingContext](fe::TaskExecutionInfo)
+    // Import context is filled inside the task to keep captures small enough for TaskHandler
+    fe::TaskComposer::execute(loadingContext->taskGroup, [bytes, size, name = image->name, uri = image->uri, loadingContext](fe::TaskExecutionInfo)
     {   
+        fe::asset::TextureImportFromMemoryContext importContext;
+        importContext.data = bytes;
+        importContext.dataSize = size;
+        importContext.name = name;
+        importContext.originalFilePath = uri;
+        importContext.projectDirectory = fe::FileSystem::get_project_path();
+
         fe::asset::TextureImportResult importResult;
-        std::string uri = importContext.originalFilePath;
 
         if (!fe::asset::AssetManager::import_texture(importContext, importResult))
         {
@@ -121,7 +127,7 @@ bool GLTFBridge::import(const ModelImportContext& inImportContext, ModelImportRe
     
     loader.SetFsCallbacks(callbacks);
 
-    tinygltf::TextureLoadingContext loadingContext;
+    tinygltf::TextureLoadingContext loadingContext(inImportContext.originalFilePath);
 
     loader.SetImageLoader(tinygltf::LoadImageData, &loadingContext);
     loader.SetImageWriter(tinygltf::WriteImageData, nullptr);
@@ -174,6 +180,13 @@ bool GLTFBridge::import(const ModelImportContext& inImportContext, ModelImportRe
 
     TaskComposer::wait(loadingContext.taskGroup);
 
+    // Some textures were not imported, so materials can't be created
+    if (loadingContext.taskGroup.is_cancelled())
+    {
+        FE_LOG(LogAssetManager, WARNING, "GLTFBridge::import(): Import of {} was cancelled", inImportContext.originalFilePath);
+        return false;
+    }
+
     if (inImportContext.generateMaterials && !gltfModel.materials.empty())
     {
         for (auto& material : gltfModel.materials)
@@ -1,5 +1,7 @@
 #include "model.h"
 #include "core/file_system/archive.h"
+#include "core/spatial/triangle_bvh.h"
+#include "core/memory_tracker.h"
 
 namespace fe::asset
 {
@@ -12,6 +14,21 @@ FE_BEGIN_PROPERTY_REGISTER(Model)
 }
 FE_END_PROPERTY_REGISTER(Model);
 
+Model::Model() = default;
+
+Model::~Model()
+{
+    if (m_trackedGeometrySize)
+        MemoryTracker::on_free(MemoryTag::ASSETS_MODELS, m_trackedGeometrySize);
+
+    if (!m_triangleBVH)
+        return;
+
+    uint64 memorySize = m_triangleBVH->get_memory_size();
+    s_triangleBVHMemoryUsage.fetch_sub(memorySize, std::memory_order_relaxed);
+    MemoryTracker::on_free(MemoryTag::ASSETS_MODELS, memorySize);
+}
+
 void Model::serialize(Archive& archive) const
 {
     Asset::serialize(archive);
@@ -85,6 +102,68 @@ void Model::deserialize(Archive& archive)
 
     archive >> m_aabb.minPoint;
     archive >> m_aabb.maxPoint;
+
+    update_geometry_memory_tracking();
+}
+
+const TriangleBVH* Model::triangle_bvh() const
+{
+    std::call_once(m_triangleBVHFlag, [this]()
+    {
+        if (m_indices.size() < 3)
+            return;
+
+        std::vector<uint32> meshFirstTriangles;
+        meshFirstTriangles.reserve(m_meshes.size());
+        for (const Mesh& mesh : m_meshes)
+            meshFirstTriangles.push_back(mesh.indexOffset / 3);
+
+        std::unique_ptr<TriangleBVH> triangleBVH = std::make_unique<TriangleBVH>();
+        triangleBVH->build(m_vertexPositions, m_indices, meshFirstTriangles);
+
+        // The exact size is known only after building, the BVH is dropped if it doesn't fit
+        uint64 memorySize = triangleBVH->get_memory_size();
+        uint64 memoryUsage = s_triangleBVHMemoryUsage.fetch_add(memorySize, std::memory_order_relaxed) + memorySize;
+        if (memoryUsage > s_triangleBVHMemoryBudget.load(std::memory_order_relaxed))
+        {
+            s_triangleBVHMemoryUsage.fetch_sub(memorySize, std::memory_order_relaxed);
+            FE_LOG(LogAssetManager, WARNING, "Triangle BVH of model {} ({} bytes) doesn't fit into the memory budget.", m_name, memorySize);
+            return;
+        }
+
+        MemoryTracker::on_allocate(MemoryTag::ASSETS_MODELS, memorySize);
+        m_triangleBVH = std::move(triangleBVH);
+    });
+
+    return m_triangleBVH.get();
+}
+
+void Model::update_geometry_memory_tracking()
+{
+    auto get_capacity_size = [](const auto& array) -> uint64
+    {
+        return array.capacity() * sizeof(array[0]);
+    };
+
+    uint64 geometrySize = get_capacity_size(m_indices)
+        + get_capacity_size(m_vertexPositions)
+        + get_capacity_size(m_vertexNormals)
+        + get_capacity_size(m_vertexTangents)
+        + get_capacity_size(m_vertexUVSet0)
+        + get_capacity_size(m_vertexUVSet1)
+        + get_capacity_size(m_vertexBoneIndices)
+        + get_capacity_size(m_vertexBoneWeights)
+        + get_capacity_size(m_vertexAtlas)
+        + get_capacity_size(m_vertexColors)
+        + get_capacity_size(m_vertexWindWeights);
+
+    // Arrays are counted as one allocation, so repeated updates don't change the allocation count
+    if (geometrySize > m_trackedGeometrySize)
+        MemoryTracker::on_allocate(MemoryTag::ASSETS_MODELS, geometrySize - m_trackedGeometrySize, m_trackedGeometrySize ? 0 : 1);
+    else if (geometrySize < m_trackedGeometrySize)
+        MemoryTracker::on_free(MemoryTag::ASSETS_MODELS, m_trackedGeometrySize - geometrySize, geometrySize ? 0 : 1);
+
+    m_trackedGeometrySize = geometrySize;
 }
 
 }
\ No newline at end of file
@@ -4,6 +4,15 @@
 #include "asset_manager/common.h"
 #include "core/primitives/aabb.h"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace fe
+{
+class TriangleBVH;
+}
+
 namespace fe::asset
 {
 
@@ -23,6 +32,8 @@ struct ModelImportContext : public ImportContext
     bool loadTextures = true;
     bool generateMaterials = false;
     bool generateTangents = false;
+    // Builds triangle BVHs of imported models instead of building them on the first ray query
+    bool buildTriangleBVH = false;
 };
 
 struct ModelImportResult
@@ -60,6 +71,10 @@ class Model : public Asset
     friend ModelProxy;
 
 public:
+    // Defined where TriangleBVH is complete, so including this header doesn't require the BVH
+    Model();
+    ~Model();
+
     // ========== Begin Object interface ==========
 
     virtual void serialize(Archive& archive) const override;
@@ -85,6 +100,15 @@ public:
     const std::vector<MaterialSlot>& material_slots() const { return m_materialSlots; }
     const AABB& aabb() const { return m_aabb; }
 
+    // Triangle BVH for precise CPU ray queries. Built on the first call, which can come from any thread.
+    // Returns nullptr if the model has no triangles or the BVH doesn't fit into the triangle BVH memory budget.
+    const TriangleBVH* triangle_bvh() const;
+
+    // Memory of all triangle BVHs, models that don't fit don't get a BVH
+    static void set_triangle_bvh_memory_budget(uint64 bytes) { s_triangleBVHMemoryBudget.store(bytes, std::memory_order_relaxed); }
+    static uint64 get_triangle_bvh_memory_budget() { return s_triangleBVHMemoryBudget.load(std::memory_order_relaxed); }
+    static uint64 get_triangle_bvh_memory_usage() { return s_triangleBVHMemoryUsage.load(std::memory_order_relaxed); }
+
     // ========== Begin Asset interface ==========
 
     virtual Type get_type() const override { return Type::MODEL; }
@@ -92,6 +116,9 @@ public:
     // ========== End Asset interface ==========
 
 protected:
+    // Reports the change of index and vertex array capacity since the previous call under the model memory tag
+    void update_geometry_memory_tracking();
+
     std::vector<uint32> m_indices;
     std::vector<Float3> m_vertexPositions;
     std::vector<Float3> m_vertexNormals;
@@ -107,9 +134,19 @@ protected:
     std::vector<MaterialSlot> m_materialSlots;
     
     AABB m_aabb;
+
+    mutable std::unique_ptr<TriangleBVH> m_triangleBVH;
+    mutable std::once_flag m_triangleBVHFlag;
+
+    // Capacity of index and vertex arrays that was last reported to MemoryTracker
+    uint64 m_trackedGeometrySize = 0;
+
+    inline static std::atomic<uint64> s_triangleBVHMemoryBudget{ 256ull * 1024 * 1024 };
+    inline static std::atomic<uint64> s_triangleBVHMemoryUsage{ 0 };
 };
 
 FE_DEFINE_ASSET_POOL_SIZE(Model, 512);
+FE_DEFINE_ASSET_MEMORY_TAG(Model, MemoryTag::ASSETS_MODELS);
 
 #ifdef FE_MODEL_PROXY
 
@@ -129,11 +166,18 @@ struct ModelProxy
         vertexWindWeights(model->m_vertexWindWeights),
         meshes(model->m_meshes),
         materialSlots(model->m_materialSlots),
-        aabb(model->m_aabb)
+        aabb(model->m_aabb),
+        model(model)
     {
 
     }
 
+    // Arrays are filled through the proxy, so their memory is reported once it is done
+    ~ModelProxy()
+    {
+        model->update_geometry_memory_tracking();
+    }
+
     std::vector<uint32>& indices;
     std::vector<Float3>& vertexPositions;
     std::vector<Float3>& vertexNormals;
@@ -149,6 +193,9 @@ struct ModelProxy
     std::vector<MaterialSlot>& materialSlots;
     
     AABB& aabb;
+
+private:
+    Model* model;
 };
 
 #endif // FE_MODEL_PROXY
@@ -24,13 +24,16 @@ bool ModelBridge::import(const ModelImportContext& inImportContext, ModelImportR
         ModelProxy modelProxy(model);
 
         modelProxy.aabb.minPoint = Float3(FLOAT_MAX, FLOAT_MAX, FLOAT_MAX);
-        modelProxy.aabb.maxPoint = Float3(FLOAT_MIN, FLOAT_MIN, FLOAT_MIN);
+        modelProxy.aabb.maxPoint = Float3(-FLOAT_MAX, -FLOAT_MAX, -FLOAT_MAX);
 
         for (const Float3& position : model->vertex_positions())
         {
             modelProxy.aabb.minPoint = min(modelProxy.aabb.minPoint, position);
             modelProxy.aabb.maxPoint = max(modelProxy.aabb.maxPoint, position);
         }
+
+        if (inImportContext.buildTriangleBVH)
+            model->triangle_bvh();
     }
 
     return true;
@@ -58,6 +58,7 @@ void Texture::deserialize(Archive& archive)
     archive >> bufferInfo.size;
     bufferInfo.bufferUsage = rhi::ResourceUsage::TRANSFER_SRC;
     bufferInfo.memoryUsage = rhi::MemoryUsage::CPU;
+    bufferInfo.memoryTag = MemoryTag::ASSETS_TEXTURES;
     rhi::create_buffer(&m_uploadBuffer, &bufferInfo);
     rhi::set_name(m_uploadBuffer, get_name() + "UploadBuffer");
 
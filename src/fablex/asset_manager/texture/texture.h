@@ -148,6 +148,7 @@ protected:
 };
 
 FE_DEFINE_ASSET_POOL_SIZE(Texture, 256);
+FE_DEFINE_ASSET_MEMORY_TAG(Texture, MemoryTag::ASSETS_TEXTURES);
 
 #ifdef FE_TEXTURE_PROXY
 
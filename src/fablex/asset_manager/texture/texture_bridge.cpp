@@ -322,6 +322,7 @@ rhi::Buffer* TextureBridge::create_upload_buffer(uint32 bufferSize, const std::s
     bufferInfo.bufferUsage = rhi::ResourceUsage::TRANSFER_SRC;
     bufferInfo.memoryUsage = rhi::MemoryUsage::CPU;
     bufferInfo.size = bufferSize;
+    bufferInfo.memoryTag = MemoryTag::ASSETS_TEXTURES;
     rhi::Buffer* buffer;
     rhi::create_buffer(&buffer, &bufferInfo);
 
@@ -0,0 +1,49 @@
+#include "benchmark.h"
+
+#include <thread>
+#include <algorithm>
+
+namespace fe::benchmark
+{
+
+bool BenchmarkRegistry::add(const char* name, const BenchmarkHandler& handler)
+{
+    get_entries().push_back({ name, handler });
+    return true;
+}
+
+void BenchmarkRegistry::run(const std::string& filter)
+{
+    for (const Entry& entry : get_entries())
+    {
+        if (!filter.empty() && std::string(entry.name).find(filter) == std::string::npos)
+            continue;
+
+        FE_LOG(LogBenchmark, INFO, "Running {}", entry.name);
+        
+        Stopwatch stopwatch;
+        entry.handler();
+
+        FE_LOG(LogBenchmark, SUCCESS, "{} completed in {:.2f} ms", entry.name, stopwatch.elapsed_milliseconds());
+    }
+}
+
+std::vector<BenchmarkRegistry::Entry>& BenchmarkRegistry::get_entries()
+{
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+std::vector<uint32> get_thread_counts()
+{
+    uint32 maxThreadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<uint32> threadCounts;
+    for (uint32 threadCount = 1; threadCount < maxThreadCount; threadCount *= 2)
+        threadCounts.push_back(threadCount);
+    threadCounts.push_back(maxThreadCount);
+
+    return threadCounts;
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "core/types.h"
+#include "core/macro.h"
+#include "core/logger.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+FE_DEFINE_LOG_CATEGORY(LogBenchmark)
+
+namespace fe::benchmark
+{
+
+using BenchmarkHandler = std::function<void()>;
+
+class BenchmarkRegistry
+{
+public:
+    static bool add(const char* name, const BenchmarkHandler& handler);
+
+    // Runs all benchmarks whose names contain the filter
+    static void run(const std::string& filter);
+
+private:
+    struct Entry
+    {
+        const char* name;
+        BenchmarkHandler handler;
+    };
+
+    static std::vector<Entry>& get_entries();
+};
+
+class Stopwatch
+{
+public:
+    Stopwatch() : m_beginning(Clock::now()) { }
+
+    void reset()
+    {
+        m_beginning = Clock::now();
+    }
+
+    double elapsed_seconds() const
+    {
+        return std::chrono::duration<double>(Clock::now() - m_beginning).count();
+    }
+
+    double elapsed_milliseconds() const
+    {
+        return elapsed_seconds() * 1000.0;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point m_beginning;
+};
+
+// Thread counts from 1 to hardware concurrency, doubling on each step
+std::vector<uint32> get_thread_counts();
+
+template<typename T>
+void do_not_optimize(const T& value)
+{
+    static volatile const T* sink;
+    sink = &value;
+}
+
+}
+
+#define FE_BENCHMARK(BenchmarkName)                                                                 \
+    static void BenchmarkName();                                                                    \
+    static bool FE_CONCAT(g_registered, BenchmarkName) =                                            \
+        fe::benchmark::BenchmarkRegistry::add(#BenchmarkName, &BenchmarkName);                     \
+    static void BenchmarkName()
@@ -0,0 +1,139 @@
+#include "benchmark.h"
+#include "core/bulk_math.h"
+
+#include <random>
+
+namespace fe::benchmark
+{
+
+constexpr uint32 BULK_MATH_VERTEX_COUNT = 10000000;
+constexpr uint32 BULK_MATH_MATRIX_COUNT = 1000000;
+
+#if defined(__AVX2__)
+constexpr const char* BULK_MATH_KERNEL_NAME = "AVX2";
+#else
+constexpr const char* BULK_MATH_KERNEL_NAME = "SSE";
+#endif
+
+void log_bulk_math_result(const char* name, uint32 count, double perElementTime, double kernelTime)
+{
+    FE_LOG(LogBenchmark, INFO, "{} x{}: per element {:.2f} ms, {} kernel {:.2f} ms ({:.2f}x)",
+        name, count, perElementTime, BULK_MATH_KERNEL_NAME, kernelTime, perElementTime / kernelTime);
+}
+
+// Baselines are per-element DirectXMath loops, the way AABB::create and model loaders process vertices
+FE_BENCHMARK(bulk_math)
+{
+    std::mt19937 randomEngine(11);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+    std::vector<Float3> points(BULK_MATH_VERTEX_COUNT);
+    for (Float3& point : points)
+        point = Float3(distribution(randomEngine), distribution(randomEngine), distribution(randomEngine));
+    std::vector<Float3> outPoints(BULK_MATH_VERTEX_COUNT);
+
+    Float4x4 transform = Matrix::scaling(1.5f, 2.0f, 0.5f) * Matrix::rotation(17.0f, 63.0f, -40.0f) * Matrix::translation(10.0f, -3.0f, 7.0f);
+    Matrix transformMatrix = transform;
+
+    Stopwatch stopwatch;
+    for (uint32 i = 0; i != BULK_MATH_VERTEX_COUNT; ++i)
+        outPoints[i] = Vector3::transform_coord(points[i], transformMatrix);
+    double perElementTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(outPoints.data());
+
+    stopwatch.reset();
+    transform_points(points.data(), BULK_MATH_VERTEX_COUNT, transform, outPoints.data());
+    double kernelTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(outPoints.data());
+    log_bulk_math_result("Transform points", BULK_MATH_VERTEX_COUNT, perElementTime, kernelTime);
+
+    stopwatch.reset();
+    for (uint32 i = 0; i != BULK_MATH_VERTEX_COUNT; ++i)
+        outPoints[i] = Vector3::transform_normal(points[i], transformMatrix);
+    perElementTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(outPoints.data());
+
+    stopwatch.reset();
+    transform_normals(points.data(), BULK_MATH_VERTEX_COUNT, transform, outPoints.data());
+    kernelTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(outPoints.data());
+    log_bulk_math_result("Transform normals", BULK_MATH_VERTEX_COUNT, perElementTime, kernelTime);
+
+    // Same loop as AABB::create had in each parallel chunk
+    stopwatch.reset();
+    Float3 expectedMin(FLOAT_MAX, FLOAT_MAX, FLOAT_MAX);
+    Float3 expectedMax(-FLOAT_MAX, -FLOAT_MAX, -FLOAT_MAX);
+    for (const Float3& point : points)
+    {
+        expectedMin = min(expectedMin, point);
+        expectedMax = max(expectedMax, point);
+    }
+    perElementTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(expectedMin);
+    do_not_optimize(expectedMax);
+
+    stopwatch.reset();
+    Float3 minPoint, maxPoint;
+    compute_bounds(points.data(), BULK_MATH_VERTEX_COUNT, minPoint, maxPoint);
+    kernelTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(minPoint);
+    do_not_optimize(maxPoint);
+    FE_CHECK(minPoint.x == expectedMin.x && minPoint.y == expectedMin.y && minPoint.z == expectedMin.z);
+    FE_CHECK(maxPoint.x == expectedMax.x && maxPoint.y == expectedMax.y && maxPoint.z == expectedMax.z);
+    log_bulk_math_result("Bounds", BULK_MATH_VERTEX_COUNT, perElementTime, kernelTime);
+
+    points.clear();
+    points.shrink_to_fit();
+    outPoints.clear();
+    outPoints.shrink_to_fit();
+
+    std::vector<Float4x4> matrices1(BULK_MATH_MATRIX_COUNT);
+    std::vector<Float4x4> matrices2(BULK_MATH_MATRIX_COUNT);
+    std::vector<Float4x4> products(BULK_MATH_MATRIX_COUNT);
+    for (uint32 i = 0; i != BULK_MATH_MATRIX_COUNT; ++i)
+    {
+        for (uint32 j = 0; j != 16; ++j)
+        {
+            matrices1[i].m[j / 4][j % 4] = distribution(randomEngine);
+            matrices2[i].m[j / 4][j % 4] = distribution(randomEngine);
+        }
+    }
+
+    stopwatch.reset();
+    for (uint32 i = 0; i != BULK_MATH_MATRIX_COUNT; ++i)
+        products[i] = matrices1[i].to_matrix() * matrices2[i].to_matrix();
+    perElementTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(products.data());
+
+    stopwatch.reset();
+    multiply_matrices(matrices1.data(), matrices2.data(), BULK_MATH_MATRIX_COUNT, products.data());
+    kernelTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(products.data());
+    log_bulk_math_result("Matrix multiply", BULK_MATH_MATRIX_COUNT, perElementTime, kernelTime);
+
+    matrices1.clear();
+    matrices1.shrink_to_fit();
+    matrices2.clear();
+    matrices2.shrink_to_fit();
+    products.clear();
+    products.shrink_to_fit();
+
+    std::vector<Float4> quats(BULK_MATH_VERTEX_COUNT);
+    for (Float4& quat : quats)
+        quat = Float4(distribution(randomEngine), distribution(randomEngine), distribution(randomEngine), distribution(randomEngine));
+    std::vector<Float4> outQuats(BULK_MATH_VERTEX_COUNT);
+
+    stopwatch.reset();
+    for (uint32 i = 0; i != BULK_MATH_VERTEX_COUNT; ++i)
+        outQuats[i] = Quat(quats[i].to_vector()).normalize();
+    perElementTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(outQuats.data());
+
+    stopwatch.reset();
+    normalize_quaternions(quats.data(), BULK_MATH_VERTEX_COUNT, outQuats.data());
+    kernelTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(outQuats.data());
+    log_bulk_math_result("Quaternion normalize", BULK_MATH_VERTEX_COUNT, perElementTime, kernelTime);
+}
+
+}
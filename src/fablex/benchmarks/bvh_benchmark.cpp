@@ -0,0 +1,125 @@
+#include "benchmark.h"
+#include "core/primitives/frustum.h"
+#include "core/spatial/bvh.h"
+#include "core/task_composer.h"
+
+#include <random>
+#include <thread>
+
+namespace fe::benchmark
+{
+
+constexpr uint32 BVH_INSTANCE_COUNT = 100000;
+constexpr uint32 BVH_RAY_COUNT = 100000;
+// Testing every instance is slow, so brute force throughput is measured on fewer rays
+constexpr uint32 BVH_BRUTE_FORCE_RAY_COUNT = 500;
+constexpr uint32 BVH_OVERLAP_QUERY_COUNT = 10000;
+
+FE_BENCHMARK(bvh)
+{
+    std::mt19937 randomEngine(11);
+    std::uniform_real_distribution<float> positionDistribution(-2000.0f, 2000.0f);
+    std::uniform_real_distribution<float> heightDistribution(0.0f, 50.0f);
+    std::uniform_real_distribution<float> sizeDistribution(0.5f, 8.0f);
+    std::uniform_real_distribution<float> directionDistribution(-1.0f, 1.0f);
+
+    // Instances are spread over a flat scene, as entities of a level usually are
+    std::vector<AABB> aabbs;
+    aabbs.reserve(BVH_INSTANCE_COUNT);
+    for (uint32 i = 0; i != BVH_INSTANCE_COUNT; ++i)
+    {
+        Float3 center(positionDistribution(randomEngine), heightDistribution(randomEngine), positionDistribution(randomEngine));
+        Float3 halfWidth(sizeDistribution(randomEngine), sizeDistribution(randomEngine), sizeDistribution(randomEngine));
+        aabbs.push_back(AABB(center, halfWidth));
+    }
+
+    std::vector<Ray> rays;
+    rays.reserve(BVH_RAY_COUNT);
+    for (uint32 i = 0; i != BVH_RAY_COUNT; ++i)
+    {
+        Float3 origin(positionDistribution(randomEngine), 25.0f, positionDistribution(randomEngine));
+        Float3 direction(directionDistribution(randomEngine), directionDistribution(randomEngine) * 0.1f, directionDistribution(randomEngine));
+        rays.emplace_back(origin, direction);
+    }
+
+    TaskComposer::init(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    uint32 workerCount = TaskComposer::get_thread_count(TaskGroup::Priority::HIGH);
+
+    BVH bvh;
+    Stopwatch stopwatch;
+    bvh.build(aabbs);
+    double buildTime = stopwatch.elapsed_milliseconds();
+
+    stopwatch.reset();
+    bvh.refit();
+    double refitTime = stopwatch.elapsed_milliseconds();
+
+    TaskComposer::cleanup();
+
+    // Tests every instance, the way picking works without an acceleration structure
+    stopwatch.reset();
+    uint32 bruteForceHitCount = 0;
+    for (uint32 rayIndex = 0; rayIndex != BVH_BRUTE_FORCE_RAY_COUNT; ++rayIndex)
+    {
+        bool isHit = false;
+        for (const AABB& aabb : aabbs)
+            isHit |= aabb.intersects(rays[rayIndex]);
+        bruteForceHitCount += isHit;
+    }
+    double bruteForceRaysPerSecond = BVH_BRUTE_FORCE_RAY_COUNT / stopwatch.elapsed_seconds();
+    do_not_optimize(bruteForceHitCount);
+
+    stopwatch.reset();
+    uint32 closestHitCount = 0;
+    for (const Ray& ray : rays)
+    {
+        BVH::Hit hit;
+        closestHitCount += bvh.closest_hit(ray, hit);
+    }
+    double closestHitRaysPerSecond = BVH_RAY_COUNT / stopwatch.elapsed_seconds();
+
+    stopwatch.reset();
+    uint32 anyHitCount = 0;
+    for (const Ray& ray : rays)
+        anyHitCount += bvh.any_hit(ray);
+    double anyHitRaysPerSecond = BVH_RAY_COUNT / stopwatch.elapsed_seconds();
+    FE_CHECK(anyHitCount == closestHitCount);
+
+    std::vector<uint32> primitiveIndices;
+    stopwatch.reset();
+    for (uint32 i = 0; i != BVH_OVERLAP_QUERY_COUNT; ++i)
+    {
+        primitiveIndices.clear();
+        bvh.query_overlaps(AABB(Float3(rays[i].origin), Float3(20.0f, 20.0f, 20.0f)), primitiveIndices);
+    }
+    double overlapQueriesPerSecond = BVH_OVERLAP_QUERY_COUNT / stopwatch.elapsed_seconds();
+    do_not_optimize(primitiveIndices.data());
+
+    Matrix view = Matrix::look_at_lh(
+        Vector4::create(0.0f, 100.0f, -2000.0f, 1.0f),
+        Vector4::create(0.0f, 0.0f, 0.0f, 1.0f),
+        Vector4::create(0.0f, 1.0f, 0.0f, 0.0f));
+    Frustum frustum(Float4x4(view * Matrix::perspective_for_lh(to_radians(60.0f), 16.0f / 9.0f, 1000.0f, 0.1f)));
+
+    primitiveIndices.clear();
+    stopwatch.reset();
+    bvh.query_frustum(frustum, primitiveIndices);
+    double frustumQueryTime = stopwatch.elapsed_milliseconds();
+
+    stopwatch.reset();
+    uint32 bruteForceVisibleCount = 0;
+    for (const AABB& aabb : aabbs)
+        bruteForceVisibleCount += frustum.intersects(aabb);
+    double bruteForceFrustumTime = stopwatch.elapsed_milliseconds();
+    FE_CHECK(bruteForceVisibleCount == primitiveIndices.size());
+
+    FE_LOG(LogBenchmark, INFO, "{} instances, {} workers: build {:.2f} ms, refit {:.2f} ms, {} nodes, depth {}",
+        BVH_INSTANCE_COUNT, workerCount, buildTime, refitTime, bvh.get_nodes().size(), bvh.get_depth());
+    FE_LOG(LogBenchmark, INFO, "Rays per second: brute force {:.0f}, closest hit {:.0f} ({:.0f}x), any hit {:.0f}; {} of {} rays hit",
+        bruteForceRaysPerSecond, closestHitRaysPerSecond, closestHitRaysPerSecond / bruteForceRaysPerSecond, anyHitRaysPerSecond,
+        closestHitCount, BVH_RAY_COUNT);
+    FE_LOG(LogBenchmark, INFO, "Overlap queries per second {:.0f}; frustum query {:.3f} ms, brute force {:.3f} ms, {} visible",
+        overlapQueriesPerSecond, frustumQueryTime, bruteForceFrustumTime, bruteForceVisibleCount);
+}
+
+}
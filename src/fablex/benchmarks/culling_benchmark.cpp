@@ -0,0 +1,78 @@
+#include "benchmark.h"
+#include "core/primitives/aabb.h"
+#include "core/primitives/frustum.h"
+#include "core/task_composer.h"
+
+#include <random>
+#include <thread>
+
+namespace fe::benchmark
+{
+
+constexpr uint32 CULLED_BOX_COUNT = 1000000;
+
+FE_BENCHMARK(frustum_culling)
+{
+    Matrix view = Matrix::look_at_lh(
+        Vector4::create(0.0f, 0.0f, -10.0f, 1.0f),
+        Vector4::create(0.0f, 0.0f, 0.0f, 1.0f),
+        Vector4::create(0.0f, 1.0f, 0.0f, 0.0f));
+    Matrix projection = Matrix::perspective_for_lh(to_radians(60.0f), 16.0f / 9.0f, 1000.0f, 0.1f);
+    Frustum frustum(Float4x4(view * projection));
+
+    std::mt19937 randomEngine(7);
+    std::uniform_real_distribution<float> positionDistribution(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> sizeDistribution(0.5f, 10.0f);
+
+    std::vector<AABB> aabbs;
+    AABBArray aabbArray;
+    aabbs.reserve(CULLED_BOX_COUNT);
+    aabbArray.reserve(CULLED_BOX_COUNT);
+    for (uint32 i = 0; i != CULLED_BOX_COUNT; ++i)
+    {
+        Float3 center(positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine));
+        float halfWidth = sizeDistribution(randomEngine);
+        aabbs.push_back(AABB(center, Float3(halfWidth, halfWidth, halfWidth)));
+        aabbArray.push_back(aabbs.back());
+    }
+
+    std::vector<uint32> visibleIndices(CULLED_BOX_COUNT);
+
+    // Per-object test on AABB structures, the way a CPU culling loop over model instances would look without the kernel
+    Stopwatch stopwatch;
+    uint32 perBoxVisibleCount = 0;
+    for (uint32 i = 0; i != CULLED_BOX_COUNT; ++i)
+        if (frustum.intersects(aabbs[i]))
+            visibleIndices[perBoxVisibleCount++] = i;
+    double perBoxTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(visibleIndices.data());
+
+    stopwatch.reset();
+    uint32 kernelVisibleCount = cull_aabbs(frustum, aabbArray, 0, CULLED_BOX_COUNT, visibleIndices.data());
+    double kernelTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(visibleIndices.data());
+    FE_CHECK(kernelVisibleCount == perBoxVisibleCount);
+
+    TaskComposer::init(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    uint32 workerCount = TaskComposer::get_thread_count(TaskGroup::Priority::HIGH);
+
+    stopwatch.reset();
+    uint32 parallelVisibleCount = parallel_cull_aabbs(frustum, aabbArray, visibleIndices.data());
+    double parallelTime = stopwatch.elapsed_milliseconds();
+    do_not_optimize(visibleIndices.data());
+    FE_CHECK(parallelVisibleCount == perBoxVisibleCount);
+
+    TaskComposer::cleanup();
+
+#if defined(__AVX2__)
+    const char* kernelName = "AVX2";
+#else
+    const char* kernelName = "SSE";
+#endif
+
+    FE_LOG(LogBenchmark, INFO, "{} boxes, {} visible: per box {:.2f} ms, {} kernel {:.2f} ms ({:.2f}x), {} workers {:.2f} ms ({:.2f}x)",
+        CULLED_BOX_COUNT, perBoxVisibleCount, perBoxTime, kernelName, kernelTime, perBoxTime / kernelTime,
+        workerCount, parallelTime, perBoxTime / parallelTime);
+}
+
+}
@@ -0,0 +1,177 @@
+#include "benchmark.h"
+#include "core/events/event_manager.h"
+
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+
+namespace fe::benchmark
+{
+
+constexpr uint32 EVENT_COUNT_PER_FRAME = 100000;
+constexpr uint32 EVENT_FRAME_COUNT = 10;
+
+class BenchmarkEvent : public IEvent
+{
+public:
+    FE_DECLARE_EVENT(BenchmarkEvent);
+
+    BenchmarkEvent(uint64 payload) : m_payload(payload) { }
+
+    uint64 get_payload() const { return m_payload; }
+
+private:
+    uint64 m_payload = 0;
+};
+
+class BenchmarkBatchEvent : public IEvent
+{
+public:
+    FE_DECLARE_EVENT(BenchmarkBatchEvent);
+
+    BenchmarkBatchEvent(uint64 payload) : m_payload(payload) { }
+
+    uint64 get_payload() const { return m_payload; }
+
+private:
+    uint64 m_payload = 0;
+};
+
+// Replicates the queue used by EventManager before EventQueue
+class MutexEventQueue
+{
+public:
+    template<typename CustomEvent>
+    void enqueue(const CustomEvent& event)
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_events.emplace(new CustomEvent(event));
+    }
+
+    template<typename Handler>
+    uint64 drain(Handler&& handler)
+    {
+        uint64 eventCount = 0;
+        while (!m_events.empty())
+        {
+            handler(*m_events.front());
+            m_events.pop();
+            ++eventCount;
+        }
+        return eventCount;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::queue<std::unique_ptr<IEvent>> m_events;
+};
+
+struct EventTimings
+{
+    double enqueueTime = 0.0;
+    double dispatchTime = 0.0;
+};
+
+// Every frame, producers enqueue EVENT_COUNT_PER_FRAME events and the main thread dispatches them
+// with a hash lookup per event, as EventManager did before handler lookups were cached
+template<typename Queue>
+EventTimings run_event_benchmark(uint32 threadCount)
+{
+    Queue queue;
+    std::unordered_map<uint64, uint64> handlerByEventID;
+    handlerByEventID[BenchmarkEvent::get_type_id_static()] = 0;
+
+    EventTimings timings;
+
+    for (uint32 frameIndex = 0; frameIndex != EVENT_FRAME_COUNT; ++frameIndex)
+    {
+        std::vector<std::thread> threads;
+        Stopwatch stopwatch;
+
+        for (uint32 threadIndex = 0; threadIndex != threadCount; ++threadIndex)
+        {
+            threads.emplace_back([&, threadIndex]
+            {
+                for (uint32 i = threadIndex; i < EVENT_COUNT_PER_FRAME; i += threadCount)
+                    queue.enqueue(BenchmarkEvent(i));
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        timings.enqueueTime += stopwatch.elapsed_milliseconds();
+        stopwatch.reset();
+
+        uint64 payloadSum = queue.drain([&](const IEvent& event)
+        {
+            handlerByEventID[event.get_type_id()] += static_cast<const BenchmarkEvent&>(event).get_payload();
+        });
+
+        timings.dispatchTime += stopwatch.elapsed_milliseconds();
+        do_not_optimize(payloadSum);
+    }
+
+    timings.enqueueTime /= EVENT_FRAME_COUNT;
+    timings.dispatchTime /= EVENT_FRAME_COUNT;
+    return timings;
+}
+
+FE_BENCHMARK(event_queue)
+{
+    for (uint32 threadCount : get_thread_counts())
+    {
+        EventTimings mutexTimings = run_event_benchmark<MutexEventQueue>(threadCount);
+        EventTimings queueTimings = run_event_benchmark<EventQueue>(threadCount);
+
+        FE_LOG(LogBenchmark, INFO, "Threads: {:>3}; enqueue: mutex queue {:.2f} ms, EventQueue {:.2f} ms, speedup {:.2f}x; "
+            "dispatch: mutex queue {:.2f} ms, EventQueue {:.2f} ms, speedup {:.2f}x",
+            threadCount, mutexTimings.enqueueTime, queueTimings.enqueueTime, mutexTimings.enqueueTime / queueTimings.enqueueTime,
+            mutexTimings.dispatchTime, queueTimings.dispatchTime, mutexTimings.dispatchTime / queueTimings.dispatchTime);
+    }
+}
+
+template<typename CustomEvent>
+double run_event_manager_benchmark()
+{
+    double dispatchTime = 0.0;
+
+    for (uint32 frameIndex = 0; frameIndex != EVENT_FRAME_COUNT; ++frameIndex)
+    {
+        for (uint32 i = 0; i != EVENT_COUNT_PER_FRAME; ++i)
+            EventManager::enqueue_event(CustomEvent(i));
+
+        Stopwatch stopwatch;
+        EventManager::dispatch_events();
+        dispatchTime += stopwatch.elapsed_milliseconds();
+    }
+
+    return dispatchTime / EVENT_FRAME_COUNT;
+}
+
+FE_BENCHMARK(event_channel)
+{
+    uint64 payloadSum = 0;
+
+    EventManager::subscribe<BenchmarkEvent>([&](const BenchmarkEvent& event)
+    {
+        payloadSum += event.get_payload();
+    });
+
+    EventManager::subscribe_batch<BenchmarkBatchEvent>([&](std::span<const BenchmarkBatchEvent> events)
+    {
+        for (const BenchmarkBatchEvent& event : events)
+            payloadSum += event.get_payload();
+    });
+
+    double handlerTime = run_event_manager_benchmark<BenchmarkEvent>();
+    double channelTime = run_event_manager_benchmark<BenchmarkBatchEvent>();
+    do_not_optimize(payloadSum);
+
+    FE_LOG(LogBenchmark, INFO, "Dispatch of {} events: per-event handler {:.2f} ms; event channel {:.2f} ms; speedup {:.2f}x",
+        EVENT_COUNT_PER_FRAME, handlerTime, channelTime, handlerTime / channelTime);
+}
+
+}
@@ -0,0 +1,8 @@
+#include "benchmark.h"
+
+int main(int argc, char** argv)
+{
+    std::string filter = argc > 1 ? argv[1] : "";
+    fe::benchmark::BenchmarkRegistry::run(filter);
+    return 0;
+}
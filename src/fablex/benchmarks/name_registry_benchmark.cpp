@@ -0,0 +1,85 @@
+#include "benchmark.h"
+#include "core/name.h"
+
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace fe::benchmark
+{
+
+constexpr uint32 NAME_UNIQUE_COUNT = 4096;
+constexpr uint32 NAME_LOOKUP_COUNT = 1 << 20;
+
+// Replicates the registry used before sharding, with a mutex added to make it thread safe
+class MutexNameRegistry
+{
+public:
+    uint32 to_id(const std::string& strName)
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+
+        auto it = m_nameToId.find(strName);
+        if (it != m_nameToId.end())
+            return it->second;
+
+        m_idToName.push_back(strName);
+        return m_nameToId[strName] = (uint32)m_idToName.size() - 1;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::string, uint32> m_nameToId;
+    std::vector<std::string> m_idToName;
+};
+
+template<typename Handler>
+double run_name_benchmark(uint32 threadCount, const std::vector<std::string>& strNames, Handler handler)
+{
+    std::vector<std::thread> threads;
+    Stopwatch stopwatch;
+
+    for (uint32 threadIndex = 0; threadIndex != threadCount; ++threadIndex)
+    {
+        threads.emplace_back([&, threadIndex]
+        {
+            uint64 idSum = 0;
+            for (uint32 i = 0; i != NAME_LOOKUP_COUNT / threadCount; ++i)
+                idSum += handler(strNames[(i * 7 + threadIndex) % NAME_UNIQUE_COUNT]);
+            do_not_optimize(idSum);
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    return stopwatch.elapsed_milliseconds();
+}
+
+FE_BENCHMARK(name_registry)
+{
+    // Most names are interned by the first pass, the benchmark measures lookups of existing names
+    std::vector<std::string> strNames;
+    for (uint32 i = 0; i != NAME_UNIQUE_COUNT; ++i)
+        strNames.push_back("BenchmarkName_" + std::to_string(i));
+
+    MutexNameRegistry mutexRegistry;
+
+    for (uint32 threadCount : get_thread_counts())
+    {
+        double mutexTime = run_name_benchmark(threadCount, strNames, [&](const std::string& strName)
+        {
+            return mutexRegistry.to_id(strName);
+        });
+
+        double registryTime = run_name_benchmark(threadCount, strNames, [](const std::string& strName)
+        {
+            return Name(strName).to_id();
+        });
+
+        FE_LOG(LogBenchmark, INFO, "Threads: {:>3}; mutex registry {:.2f} ms; NameRegistry {:.2f} ms; speedup {:.2f}x",
+            threadCount, mutexTime, registryTime, mutexTime / registryTime);
+    }
+}
+
+}
@@ -0,0 +1,106 @@
+#include "benchmark.h"
+#include "core/parallel.h"
+
+#include <random>
+
+namespace fe::benchmark
+{
+
+constexpr uint64 PARALLEL_ELEMENT_COUNT = 1 << 24;
+constexpr uint64 PARALLEL_SORT_ELEMENT_COUNT = 1 << 22;
+
+// Work per element grows with its index, so equal chunks have very different costs
+uint32 do_irregular_work(uint64 index)
+{
+    uint32 seed = uint32(index) | 1;
+    for (uint64 i = 0; i != index * 64 / PARALLEL_ELEMENT_COUNT; ++i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+    }
+    return seed;
+}
+
+std::vector<uint32> generate_values(uint64 count)
+{
+    std::mt19937 randomEngine(42);
+    std::vector<uint32> values(count);
+    for (uint32& value : values)
+        value = randomEngine();
+    return values;
+}
+
+FE_BENCHMARK(parallel_algorithms)
+{
+    std::vector<uint32> values = generate_values(PARALLEL_ELEMENT_COUNT);
+    std::vector<uint32> results(PARALLEL_ELEMENT_COUNT);
+
+    auto transformRange = [&](uint64 begin, uint64 end)
+    {
+        for (uint64 i = begin; i != end; ++i)
+            results[i] = values[i] ^ do_irregular_work(i);
+    };
+
+    auto sumRange = [&](uint64 begin, uint64 end, uint64 sum)
+    {
+        for (uint64 i = begin; i != end; ++i)
+            sum += values[i];
+        return sum;
+    };
+
+    Stopwatch stopwatch;
+    transformRange(0, PARALLEL_ELEMENT_COUNT);
+    double serialForTime = stopwatch.elapsed_milliseconds();
+
+    stopwatch.reset();
+    uint64 serialSum = sumRange(0, PARALLEL_ELEMENT_COUNT, 0);
+    double serialReduceTime = stopwatch.elapsed_milliseconds();
+
+    std::vector<uint32> sortedValues(values.begin(), values.begin() + PARALLEL_SORT_ELEMENT_COUNT);
+    stopwatch.reset();
+    std::sort(sortedValues.begin(), sortedValues.end());
+    double serialSortTime = stopwatch.elapsed_milliseconds();
+
+    FE_LOG(LogBenchmark, INFO, "Serial: for {:.2f} ms; reduce {:.2f} ms; sort {:.2f} ms", serialForTime, serialReduceTime, serialSortTime);
+
+    for (uint32 threadCount : get_thread_counts())
+    {
+        TaskComposer::init(threadCount);
+        uint32 workerCount = TaskComposer::get_thread_count(TaskGroup::Priority::HIGH);
+
+        // Fixed chunks, the way loops were split before parallel_for
+        stopwatch.reset();
+        TaskGroup taskGroup;
+        uint32 chunkSize = uint32(PARALLEL_ELEMENT_COUNT / (workerCount + 1));
+        TaskComposer::dispatch(taskGroup, uint32(PARALLEL_ELEMENT_COUNT / chunkSize), 1, [&](TaskExecutionInfo execInfo)
+        {
+            transformRange(uint64(execInfo.globalTaskIndex) * chunkSize, uint64(execInfo.globalTaskIndex + 1) * chunkSize);
+        });
+        TaskComposer::wait(taskGroup);
+        double dispatchTime = stopwatch.elapsed_milliseconds();
+
+        stopwatch.reset();
+        parallel_for(0, PARALLEL_ELEMENT_COUNT, transformRange);
+        double forTime = stopwatch.elapsed_milliseconds();
+
+        stopwatch.reset();
+        uint64 sum = parallel_reduce(0, PARALLEL_ELEMENT_COUNT, uint64(0), sumRange, std::plus<uint64>());
+        double reduceTime = stopwatch.elapsed_milliseconds();
+        FE_CHECK(sum == serialSum);
+
+        std::vector<uint32> parallelSortedValues(values.begin(), values.begin() + PARALLEL_SORT_ELEMENT_COUNT);
+        stopwatch.reset();
+        parallel_sort(parallelSortedValues.begin(), parallelSortedValues.end());
+        double sortTime = stopwatch.elapsed_milliseconds();
+        FE_CHECK(parallelSortedValues == sortedValues);
+
+        do_not_optimize(results);
+        TaskComposer::cleanup();
+
+        FE_LOG(LogBenchmark, INFO, "Workers: {:>3}; fixed chunks {:.2f} ms; for {:.2f} ms ({:.2f}x); reduce {:.2f} ms ({:.2f}x); sort {:.2f} ms ({:.2f}x)",
+            workerCount, dispatchTime, forTime, serialForTime / forTime, reduceTime, serialReduceTime / reduceTime, sortTime, serialSortTime / sortTime);
+    }
+}
+
+}
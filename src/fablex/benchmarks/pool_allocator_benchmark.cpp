@@ -0,0 +1,77 @@
+#include "benchmark.h"
+#include "core/pool_allocator.h"
+#include "core/concurrent_pool_allocator.h"
+
+#include <thread>
+
+namespace fe::benchmark
+{
+
+constexpr uint32 POOL_OPERATION_COUNT = 1 << 20;
+constexpr uint32 POOL_LIVE_OBJECT_COUNT = 64;
+
+struct PoolObject
+{
+    uint64 data[8];
+};
+
+// Each thread keeps a window of live objects and replaces the oldest one on every step,
+// so allocations and frees are interleaved the same way as TaskBatch allocations in TaskComposer
+template<typename Pool>
+double run_pool_benchmark(uint32 threadCount)
+{
+    Pool pool;
+    std::vector<std::thread> threads;
+    std::atomic<uint32> readyThreadCount = 0;
+    std::atomic_bool isStarted = false;
+
+    for (uint32 threadIndex = 0; threadIndex != threadCount; ++threadIndex)
+    {
+        threads.emplace_back([&]
+        {
+            std::vector<PoolObject*> objects(POOL_LIVE_OBJECT_COUNT);
+            for (PoolObject*& object : objects)
+                object = pool.allocate();
+
+            readyThreadCount.fetch_add(1);
+            while (!isStarted.load())
+                std::this_thread::yield();
+
+            for (uint32 i = 0; i != POOL_OPERATION_COUNT / threadCount; ++i)
+            {
+                PoolObject*& object = objects[i % POOL_LIVE_OBJECT_COUNT];
+                pool.free(object);
+                object = pool.allocate();
+                object->data[0] = i;
+            }
+
+            for (PoolObject* object : objects)
+                pool.free(object);
+        });
+    }
+
+    while (readyThreadCount.load() != threadCount)
+        std::this_thread::yield();
+
+    Stopwatch stopwatch;
+    isStarted.store(true);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    return stopwatch.elapsed_milliseconds();
+}
+
+FE_BENCHMARK(pool_allocator)
+{
+    for (uint32 threadCount : get_thread_counts())
+    {
+        double mutexPoolTime = run_pool_benchmark<ThreadSafePoolAllocator<PoolObject, 256>>(threadCount);
+        double concurrentPoolTime = run_pool_benchmark<ConcurrentPoolAllocator<PoolObject, 256>>(threadCount);
+
+        FE_LOG(LogBenchmark, INFO, "Threads: {:>3}; mutex pool {:.2f} ms; concurrent pool {:.2f} ms; speedup {:.2f}x",
+            threadCount, mutexPoolTime, concurrentPoolTime, mutexPoolTime / concurrentPoolTime);
+    }
+}
+
+}
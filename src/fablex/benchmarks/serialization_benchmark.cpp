@@ -0,0 +1,150 @@
+#include "benchmark.h"
+#include "core/object.h"
+#include "core/file_system/archive.h"
+
+namespace fe
+{
+
+// Has the same properties as Entity transform, CameraComponent and MaterialComponent
+class BenchmarkComponent : public Object
+{
+    FE_DECLARE_OBJECT(BenchmarkComponent);
+    FE_DECLARE_PROPERTY_REGISTER(BenchmarkComponent);
+
+public:
+    Float4x4 worldTransform;
+    Float3 position = Float3(0.0f, 0.0f, 0.0f);
+    Quat rotation;
+    Float3 scale = Float3(1.0f, 1.0f, 1.0f);
+    float zNear = 0.1f;
+    float zFar = 10000.0f;
+    float fov = 50.0f;
+    bool isActive = false;
+    float movementSpeed = 10.0f;
+    float mouseSensitivity = 0.1f;
+    std::string name;
+    std::vector<UUID> materialUUIDs;
+
+    // Replicates hand-written serialization used before PropertyLayout, strings and vectors were written by element
+    void serialize_by_field(Archive& archive) const
+    {
+        archive << worldTransform << position << Float4(rotation) << scale;
+        archive << zNear << zFar << fov << isActive << movementSpeed << mouseSensitivity;
+
+        archive << name.length();
+        for (char c : name)
+            archive << c;
+
+        archive << materialUUIDs.size();
+        for (UUID materialUUID : materialUUIDs)
+            archive << materialUUID;
+    }
+
+    void deserialize_by_field(Archive& archive)
+    {
+        Float4 readRotation;
+        archive >> worldTransform >> position >> readRotation >> scale;
+        archive >> zNear >> zFar >> fov >> isActive >> movementSpeed >> mouseSensitivity;
+        rotation = Vector(readRotation);
+
+        uint64 nameLength;
+        archive >> nameLength;
+        name.resize(nameLength);
+        for (char& c : name)
+            archive >> c;
+
+        uint64 materialCount;
+        archive >> materialCount;
+        materialUUIDs.resize(materialCount);
+        for (UUID& materialUUID : materialUUIDs)
+            archive >> materialUUID;
+    }
+};
+
+FE_DEFINE_OBJECT(BenchmarkComponent, Object);
+FE_BEGIN_PROPERTY_REGISTER(BenchmarkComponent)
+{
+    FE_REGISTER_PROPERTY(BenchmarkComponent, worldTransform);
+    FE_REGISTER_PROPERTY(BenchmarkComponent, position);
+    FE_REGISTER_PROPERTY(BenchmarkComponent, rotation);
+    FE_REGISTER_PROPERTY(BenchmarkComponent, scale);
+    FE_REGISTER_PROPERTY(BenchmarkComponent, zNear);
+    FE_REGISTER_PROPERTY(BenchmarkComponent, zFar);
+    FE_REGISTER_PROPERTY(BenchmarkComponent, fov);
+    FE_REGISTER_PROPERTY(BenchmarkComponent, isActive);
+    FE_REGISTER_PROPERTY(BenchmarkComponent, movementSpeed);
+    FE_REGISTER_PROPERTY(BenchmarkComponent, mouseSensitivity);
+    FE_REGISTER_PROPERTY(BenchmarkComponent, name);
+    FE_REGISTER_ARRAY_PROPERTY(BenchmarkComponent, materialUUIDs);
+}
+FE_END_PROPERTY_REGISTER(BenchmarkComponent)
+
+}
+
+namespace fe::benchmark
+{
+
+constexpr uint32 SERIALIZED_COMPONENT_COUNT = 100000;
+
+// Reads back written data without saving it to a file
+class BenchmarkArchive : public Archive
+{
+public:
+    void begin_reading()
+    {
+        m_mode = Mode::READ;
+        m_position = 0;
+        m_fieldLayouts.clear();
+    }
+};
+
+template<typename WriteHandler, typename ReadHandler>
+void run_serialization_benchmark(std::vector<BenchmarkComponent>& components, WriteHandler writeHandler, ReadHandler readHandler,
+    double& outWriteTime, double& outReadTime)
+{
+    BenchmarkArchive archive;
+
+    Stopwatch stopwatch;
+    for (const BenchmarkComponent& component : components)
+        writeHandler(component, archive);
+    outWriteTime = stopwatch.elapsed_milliseconds();
+
+    archive.begin_reading();
+
+    stopwatch.reset();
+    for (BenchmarkComponent& component : components)
+        readHandler(component, archive);
+    outReadTime = stopwatch.elapsed_milliseconds();
+
+    do_not_optimize(components.back().fov);
+}
+
+FE_BENCHMARK(property_serialization)
+{
+    std::vector<BenchmarkComponent> components(SERIALIZED_COMPONENT_COUNT);
+    for (uint32 i = 0; i != SERIALIZED_COMPONENT_COUNT; ++i)
+    {
+        components[i].position = Float3(float(i), 0.0f, 0.0f);
+        components[i].name = "BenchmarkEntity_" + std::to_string(i);
+        components[i].materialUUIDs.assign(4, UUID(i));
+    }
+
+    double fieldWriteTime, fieldReadTime;
+    run_serialization_benchmark(components,
+        [](const BenchmarkComponent& component, Archive& archive) { component.serialize_by_field(archive); },
+        [](BenchmarkComponent& component, Archive& archive) { component.deserialize_by_field(archive); },
+        fieldWriteTime, fieldReadTime);
+
+    double layoutWriteTime, layoutReadTime;
+    run_serialization_benchmark(components,
+        [](const BenchmarkComponent& component, Archive& archive) { component.serialize(archive); },
+        [](BenchmarkComponent& component, Archive& archive) { component.deserialize(archive); },
+        layoutWriteTime, layoutReadTime);
+
+    FE_LOG(LogBenchmark, INFO, "{} components; write: by field {:.2f} ms, PropertyLayout {:.2f} ms, speedup {:.2f}x",
+        SERIALIZED_COMPONENT_COUNT, fieldWriteTime, layoutWriteTime, fieldWriteTime / layoutWriteTime);
+    FE_LOG(LogBenchmark, INFO, "{} components; read: by field {:.2f} ms, PropertyLayout {:.2f} ms, speedup {:.2f}x",
+        SERIALIZED_COMPONENT_COUNT, fieldReadTime, layoutReadTime, fieldReadTime / layoutReadTime);
+}
+
+}
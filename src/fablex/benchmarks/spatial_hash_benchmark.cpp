@@ -0,0 +1,127 @@
+#include "benchmark.h"
+#include "core/spatial/spatial_hash.h"
+#include "core/primitives/frustum.h"
+#include "core/task_composer.h"
+
+#include <random>
+#include <thread>
+
+namespace fe::benchmark
+{
+
+constexpr uint32 SPATIAL_HASH_ENTITY_COUNT = 1000000;
+constexpr uint32 SPATIAL_HASH_QUERY_COUNT = 10000;
+// Scanning all entities is slow, so brute force throughput is measured on fewer queries
+constexpr uint32 SPATIAL_HASH_BRUTE_FORCE_QUERY_COUNT = 20;
+constexpr float SPATIAL_HASH_WORLD_SIZE = 4000.0f;
+constexpr float SPATIAL_HASH_QUERY_RADIUS = 30.0f;
+constexpr float SPATIAL_HASH_CELL_SIZE = 32.0f;
+
+bool intersects_sphere(const AABB& aabb, const Float3& center, float radius)
+{
+    Float3 closestPoint = min(max(center, aabb.minPoint), aabb.maxPoint);
+    return distance_squared(closestPoint, center) <= radius * radius;
+}
+
+// Synthetic world: small props, some bigger objects and point lights with big radii, as World indexes entities
+FE_BENCHMARK(spatial_hash)
+{
+    std::mt19937 randomEngine(5);
+    std::uniform_real_distribution<float> positionDistribution(-SPATIAL_HASH_WORLD_SIZE * 0.5f, SPATIAL_HASH_WORLD_SIZE * 0.5f);
+    std::uniform_real_distribution<float> unitDistribution(0.0f, 1.0f);
+
+    std::vector<AABB> aabbs(SPATIAL_HASH_ENTITY_COUNT);
+    for (uint32 i = 0; i != SPATIAL_HASH_ENTITY_COUNT; ++i)
+    {
+        float halfWidth = i % 100 == 0 ? 10.0f + unitDistribution(randomEngine) * 40.0f : 0.2f + unitDistribution(randomEngine) * 2.0f;
+        Float3 center(positionDistribution(randomEngine), positionDistribution(randomEngine) * 0.05f, positionDistribution(randomEngine));
+        aabbs[i] = AABB(center, Float3(halfWidth, halfWidth, halfWidth));
+    }
+
+    TaskComposer::init(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    uint32 workerCount = TaskComposer::get_thread_count(TaskGroup::Priority::HIGH);
+
+    Stopwatch stopwatch;
+    SpatialHash serialSpatialHash(SPATIAL_HASH_CELL_SIZE);
+    for (uint32 i = 0; i != SPATIAL_HASH_ENTITY_COUNT; ++i)
+        serialSpatialHash.insert(aabbs[i], i);
+    double serialInsertTime = stopwatch.elapsed_milliseconds();
+    serialSpatialHash.clear();
+
+    std::vector<uint64> userData(SPATIAL_HASH_ENTITY_COUNT);
+    for (uint32 i = 0; i != SPATIAL_HASH_ENTITY_COUNT; ++i)
+        userData[i] = i;
+    std::vector<uint32> proxies(SPATIAL_HASH_ENTITY_COUNT);
+
+    stopwatch.reset();
+    SpatialHash spatialHash(SPATIAL_HASH_CELL_SIZE);
+    spatialHash.insert(aabbs.data(), userData.data(), SPATIAL_HASH_ENTITY_COUNT, proxies.data());
+    double bulkInsertTime = stopwatch.elapsed_milliseconds();
+
+    // A frame where every entity is updated, a tenth of them moves by up to a unit
+    for (uint32 i = 0; i < SPATIAL_HASH_ENTITY_COUNT; i += 10)
+    {
+        Float3 offset(unitDistribution(randomEngine) * 2.0f - 1.0f, 0.0f, unitDistribution(randomEngine) * 2.0f - 1.0f);
+        aabbs[i] = AABB(aabbs[i].get_center() + offset, aabbs[i].get_half_width());
+    }
+
+    stopwatch.reset();
+    spatialHash.update(proxies.data(), aabbs.data(), SPATIAL_HASH_ENTITY_COUNT);
+    double updateTime = stopwatch.elapsed_milliseconds();
+
+    std::vector<Float3> queryCenters(SPATIAL_HASH_QUERY_COUNT);
+    for (Float3& center : queryCenters)
+        center = Float3(positionDistribution(randomEngine), 0.0f, positionDistribution(randomEngine));
+
+    stopwatch.reset();
+    uint64 bruteForceHitCount = 0;
+    for (uint32 i = 0; i != SPATIAL_HASH_BRUTE_FORCE_QUERY_COUNT; ++i)
+        for (const AABB& aabb : aabbs)
+            bruteForceHitCount += intersects_sphere(aabb, queryCenters[i], SPATIAL_HASH_QUERY_RADIUS);
+    double bruteForceQueriesPerSecond = SPATIAL_HASH_BRUTE_FORCE_QUERY_COUNT / stopwatch.elapsed_seconds();
+
+    std::vector<uint32> hitProxies;
+    stopwatch.reset();
+    uint64 hitCount = 0;
+    for (uint32 i = 0; i != SPATIAL_HASH_QUERY_COUNT; ++i)
+    {
+        hitProxies.clear();
+        spatialHash.query_sphere(queryCenters[i], SPATIAL_HASH_QUERY_RADIUS, hitProxies);
+        hitCount += hitProxies.size();
+        if (i + 1 == SPATIAL_HASH_BRUTE_FORCE_QUERY_COUNT)
+            FE_CHECK(hitCount == bruteForceHitCount);
+    }
+    double queriesPerSecond = SPATIAL_HASH_QUERY_COUNT / stopwatch.elapsed_seconds();
+
+    Matrix view = Matrix::look_at_lh(
+        Vector4::create(0.0f, 50.0f, -SPATIAL_HASH_WORLD_SIZE * 0.5f, 1.0f),
+        Vector4::create(0.0f, 0.0f, 0.0f, 1.0f),
+        Vector4::create(0.0f, 1.0f, 0.0f, 0.0f));
+    Matrix projection = Matrix::perspective_for_lh(to_radians(60.0f), 16.0f / 9.0f, 1000.0f, 0.1f);
+    Frustum frustum(Float4x4(view * projection));
+
+    stopwatch.reset();
+    uint32 bruteForceVisibleCount = 0;
+    for (const AABB& aabb : aabbs)
+        bruteForceVisibleCount += frustum.intersects(aabb);
+    double bruteForceFrustumTime = stopwatch.elapsed_milliseconds();
+
+    hitProxies.clear();
+    stopwatch.reset();
+    spatialHash.query_frustum(frustum, hitProxies);
+    double frustumTime = stopwatch.elapsed_milliseconds();
+    FE_CHECK(hitProxies.size() == bruteForceVisibleCount);
+
+    TaskComposer::cleanup();
+
+    FE_LOG(LogBenchmark, INFO, "{} entities in {} cells: serial insert {:.2f} ms, bulk insert {:.2f} ms ({:.2f}x, {} workers), update {:.2f} ms",
+        SPATIAL_HASH_ENTITY_COUNT, spatialHash.get_cell_count(), serialInsertTime, bulkInsertTime, serialInsertTime / bulkInsertTime,
+        workerCount, updateTime);
+    FE_LOG(LogBenchmark, INFO, "Radius {} queries per second: scan {:.0f}, spatial hash {:.0f} ({:.0f}x), {:.1f} hits per query",
+        SPATIAL_HASH_QUERY_RADIUS, bruteForceQueriesPerSecond, queriesPerSecond, queriesPerSecond / bruteForceQueriesPerSecond,
+        double(hitCount) / SPATIAL_HASH_QUERY_COUNT);
+    FE_LOG(LogBenchmark, INFO, "Frustum with {} visible: scan {:.2f} ms, spatial hash {:.2f} ms ({:.2f}x)",
+        bruteForceVisibleCount, bruteForceFrustumTime, frustumTime, bruteForceFrustumTime / frustumTime);
+}
+
+}
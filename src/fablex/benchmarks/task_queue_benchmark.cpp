@@ -0,0 +1,224 @@
+#include "benchmark.h"
+#include "core/work_stealing_queue.h"
+#include "core/task_composer.h"
+
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace fe::benchmark
+{
+
+struct BenchmarkTask
+{
+    uint32 depth;
+    uint32 seed;
+};
+
+// Replicates the scheduling scheme TaskComposer used before work stealing:
+// one mutex guarded deque per worker, round robin producers, consumers scan all queues.
+class MutexQueueSystem
+{
+public:
+    MutexQueueSystem(uint32 threadCount) : m_queues(threadCount) { }
+
+    void push(uint32 threadIndex, const BenchmarkTask& task)
+    {
+        Queue& queue = m_queues[m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size()];
+        std::scoped_lock<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+
+    bool pop(uint32 threadIndex, BenchmarkTask& task)
+    {
+        for (uint32 i = 0; i != m_queues.size(); ++i)
+        {
+            Queue& queue = m_queues[(threadIndex + i) % m_queues.size()];
+            std::scoped_lock<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    struct Queue
+    {
+        std::deque<BenchmarkTask> tasks;
+        std::mutex mutex;
+    };
+
+    std::vector<Queue> m_queues;
+    std::atomic<uint64> m_nextQueue{ 0 };
+};
+
+class WorkStealingQueueSystem
+{
+public:
+    WorkStealingQueueSystem(uint32 threadCount)
+    {
+        for (uint32 i = 0; i != threadCount; ++i)
+            m_queues.emplace_back(new WorkStealingQueue<BenchmarkTask>());
+    }
+
+    void push(uint32 threadIndex, const BenchmarkTask& task)
+    {
+        m_queues[threadIndex]->push(task);
+    }
+
+    bool pop(uint32 threadIndex, BenchmarkTask& task)
+    {
+        if (m_queues[threadIndex]->pop(task))
+            return true;
+
+        for (uint32 i = 1; i != m_queues.size(); ++i)
+        {
+            WorkStealingQueue<BenchmarkTask>& victimQueue = *m_queues[(threadIndex + i) % m_queues.size()];
+            while (!victimQueue.empty())
+            {
+                if (victimQueue.steal(task))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    std::vector<std::unique_ptr<WorkStealingQueue<BenchmarkTask>>> m_queues;
+};
+
+constexpr uint32 ROOT_TASK_COUNT = 256;
+constexpr uint32 TASK_TREE_DEPTH = 11;
+constexpr uint32 TASK_WORK_ITERATION_COUNT = 64;
+
+uint64 get_total_task_count()
+{
+    return uint64(ROOT_TASK_COUNT) * ((1ull << (TASK_TREE_DEPTH + 1)) - 1);
+}
+
+uint32 do_task_work(uint32 seed)
+{
+    for (uint32 i = 0; i != TASK_WORK_ITERATION_COUNT; ++i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+    }
+    return seed;
+}
+
+// Thread 0 pushes root tasks, every task pushes two children until the tree depth is reached.
+// Returns millions of tasks per second.
+template<typename QueueSystem>
+double run_task_tree(uint32 threadCount)
+{
+    QueueSystem queueSystem(threadCount);
+    std::atomic<uint64> completedTaskCount{ 0 };
+    std::atomic<uint32> checksum{ 0 };
+    uint64 totalTaskCount = get_total_task_count();
+
+    for (uint32 i = 0; i != ROOT_TASK_COUNT; ++i)
+        queueSystem.push(0, { TASK_TREE_DEPTH, i + 1 });
+
+    Stopwatch stopwatch;
+
+    auto worker = [&](uint32 threadIndex)
+    {
+        BenchmarkTask task;
+        uint32 localChecksum = 0;
+
+        while (completedTaskCount.load(std::memory_order_relaxed) != totalTaskCount)
+        {
+            if (!queueSystem.pop(threadIndex, task))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            uint32 seed = do_task_work(task.seed);
+            localChecksum ^= seed;
+
+            if (task.depth)
+            {
+                queueSystem.push(threadIndex, { task.depth - 1, seed | 1 });
+                queueSystem.push(threadIndex, { task.depth - 1, (seed >> 1) | 1 });
+            }
+
+            completedTaskCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        checksum.fetch_xor(localChecksum);
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32 threadIndex = 1; threadIndex < threadCount; ++threadIndex)
+        threads.emplace_back(worker, threadIndex);
+
+    worker(0);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    double elapsedSeconds = stopwatch.elapsed_seconds();
+    do_not_optimize(checksum);
+    
+    return double(totalTaskCount) / elapsedSeconds / 1e6;
+}
+
+FE_BENCHMARK(task_queue_throughput)
+{
+    FE_LOG(LogBenchmark, INFO, "Task tree, {} tasks", get_total_task_count());
+
+    for (uint32 threadCount : get_thread_counts())
+    {
+        double mutexQueueThroughput = run_task_tree<MutexQueueSystem>(threadCount);
+        double workStealingThroughput = run_task_tree<WorkStealingQueueSystem>(threadCount);
+
+        FE_LOG(LogBenchmark, INFO, "Threads: {:>3}; mutex queues: {:>8.2f} Mtasks/s; work stealing: {:>8.2f} Mtasks/s; speedup: {:.2f}x",
+            threadCount, mutexQueueThroughput, workStealingThroughput, workStealingThroughput / mutexQueueThroughput);
+    }
+}
+
+FE_BENCHMARK(task_composer_dispatch_throughput)
+{
+    constexpr uint32 taskCount = 1 << 20;
+    constexpr uint32 groupSize = 64;
+    constexpr uint32 iterationCount = 16;
+
+    for (uint32 threadCount : get_thread_counts())
+    {
+        TaskComposer::init(threadCount);
+
+        std::atomic<uint32> checksum{ 0 };
+        TaskGroup taskGroup;
+        Stopwatch stopwatch;
+
+        for (uint32 i = 0; i != iterationCount; ++i)
+        {
+            TaskComposer::dispatch(taskGroup, taskCount, groupSize, [&checksum](TaskExecutionInfo execInfo)
+            {
+                uint32 seed = do_task_work(execInfo.globalTaskIndex | 1);
+                if (execInfo.isLastTaskInSubgroup)
+                    checksum.fetch_xor(seed, std::memory_order_relaxed);
+            });
+
+            TaskComposer::wait(taskGroup);
+        }
+
+        double throughput = double(taskCount) * iterationCount / stopwatch.elapsed_seconds() / 1e6;
+        uint32 workerCount = TaskComposer::get_thread_count(TaskGroup::Priority::HIGH);
+        do_not_optimize(checksum);
+
+        TaskComposer::cleanup();
+
+        FE_LOG(LogBenchmark, INFO, "Workers: {:>3}; dispatch: {:>8.2f} Mtasks/s", workerCount, throughput);
+    }
+}
+
+}
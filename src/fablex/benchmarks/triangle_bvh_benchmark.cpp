@@ -0,0 +1,244 @@
+#include "benchmark.h"
+#include "core/spatial/triangle_bvh.h"
+
+#define TINYGLTF_IMPLEMENTATION
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+#include "tiny_gltf.h"
+
+#include <filesystem>
+#include <random>
+
+namespace fe::benchmark
+{
+
+constexpr uint32 TRIANGLE_BVH_RAY_COUNT = 200000;
+// Testing every triangle is slow, so brute force throughput is measured on fewer rays
+constexpr uint32 TRIANGLE_BVH_BRUTE_FORCE_RAY_COUNT = 200;
+
+struct BenchmarkModel
+{
+    std::vector<Float3> positions;
+    std::vector<uint32> indices;
+    std::vector<uint32> meshFirstTriangles;
+    AABB aabb{ Float3(FLOAT_MAX, FLOAT_MAX, FLOAT_MAX), Float3(-FLOAT_MAX, -FLOAT_MAX, -FLOAT_MAX) };
+};
+
+// The benchmark can be started from the repository root or from bin
+std::string find_content_file(const std::string& fileName)
+{
+    for (const char* contentPath : { "content/", "../content/", "../../content/" })
+    {
+        if (std::filesystem::exists(contentPath + fileName))
+            return contentPath + fileName;
+    }
+    return {};
+}
+
+// Merges all meshes the same way as GLTFBridge with ModelImportContext::mergeMeshes
+bool load_benchmark_model(const std::string& path, BenchmarkModel& outModel)
+{
+    tinygltf::TinyGLTF loader;
+    loader.SetImageLoader([](tinygltf::Image*, const int, std::string*, std::string*, int, int, const unsigned char*, int, void*)
+    {
+        return true;
+    }, nullptr);
+
+    tinygltf::Model gltfModel;
+    std::string error, warning;
+    if (!loader.LoadBinaryFromFile(&gltfModel, &error, &warning, path))
+        return false;
+
+    for (const tinygltf::Mesh& gltfMesh : gltfModel.meshes)
+    {
+        for (const tinygltf::Primitive& primitive : gltfMesh.primitives)
+        {
+            auto positionIt = primitive.attributes.find("POSITION");
+            if (primitive.indices < 0 || positionIt == primitive.attributes.end())
+                continue;
+
+            uint32 vertexOffset = (uint32)outModel.positions.size();
+            const tinygltf::Accessor& positionAccessor = gltfModel.accessors[positionIt->second];
+            const tinygltf::BufferView& positionView = gltfModel.bufferViews[positionAccessor.bufferView];
+            const uint8* positionData = gltfModel.buffers[positionView.buffer].data.data() + positionView.byteOffset + positionAccessor.byteOffset;
+            int positionStride = positionAccessor.ByteStride(positionView);
+            for (size_t i = 0; i != positionAccessor.count; ++i)
+            {
+                const Float3& position = *(const Float3*)(positionData + i * positionStride);
+                outModel.positions.push_back(position);
+                outModel.aabb.minPoint = min(outModel.aabb.minPoint, position);
+                outModel.aabb.maxPoint = max(outModel.aabb.maxPoint, position);
+            }
+
+            outModel.meshFirstTriangles.push_back(uint32(outModel.indices.size() / 3));
+            const tinygltf::Accessor& indexAccessor = gltfModel.accessors[primitive.indices];
+            const tinygltf::BufferView& indexView = gltfModel.bufferViews[indexAccessor.bufferView];
+            const uint8* indexData = gltfModel.buffers[indexView.buffer].data.data() + indexView.byteOffset + indexAccessor.byteOffset;
+            int indexStride = indexAccessor.ByteStride(indexView);
+            for (size_t i = 0; i != indexAccessor.count; ++i)
+            {
+                const uint8* index = indexData + i * indexStride;
+                if (indexStride == sizeof(uint8))
+                    outModel.indices.push_back(vertexOffset + *index);
+                else if (indexStride == sizeof(uint16))
+                    outModel.indices.push_back(vertexOffset + *(const uint16*)index);
+                else
+                    outModel.indices.push_back(vertexOffset + *(const uint32*)index);
+            }
+        }
+    }
+
+    return !outModel.indices.empty();
+}
+
+bool intersects_triangle(const Float3& vertex0, const Float3& vertex1, const Float3& vertex2, const Ray& ray, float maxDistance, float& outDistance)
+{
+    Float3 edge1 = vertex1 - vertex0;
+    Float3 edge2 = vertex2 - vertex0;
+
+    Float3 p = Vector3::cross(ray.direction, edge2);
+    float determinant = dot(edge1, p);
+    if (determinant == 0.0f)
+        return false;
+
+    float inverseDeterminant = 1.0f / determinant;
+    Float3 t = ray.origin - vertex0;
+    float u = dot(t, p) * inverseDeterminant;
+    Float3 q = Vector3::cross(t, edge1);
+    float v = dot(ray.direction, q) * inverseDeterminant;
+    float distance = dot(edge2, q) * inverseDeterminant;
+    if (u < 0.0f || v < 0.0f || u + v > 1.0f || distance < ray.tmin || distance > maxDistance)
+        return false;
+
+    outDistance = distance;
+    return true;
+}
+
+// Tests all triangles, the way precise picking works without an acceleration structure
+bool brute_force_closest_hit(const BenchmarkModel& model, const Ray& ray, float& outDistance)
+{
+    outDistance = ray.tmax;
+    bool isHit = false;
+    for (uint64 i = 0; i + 2 < model.indices.size(); i += 3)
+    {
+        const Float3& vertex0 = model.positions[model.indices[i]];
+        const Float3& vertex1 = model.positions[model.indices[i + 1]];
+        const Float3& vertex2 = model.positions[model.indices[i + 2]];
+        isHit |= intersects_triangle(vertex0, vertex1, vertex2, ray, outDistance, outDistance);
+    }
+    return isHit;
+}
+
+void run_triangle_bvh_benchmark(const std::string& fileName)
+{
+    std::string path = find_content_file(fileName);
+    BenchmarkModel model;
+    if (path.empty() || !load_benchmark_model(path, model))
+    {
+        FE_LOG(LogBenchmark, WARNING, "Failed to load {}, run benchmarks from the repository root or from bin.", fileName);
+        return;
+    }
+
+    const uint32 triangleCount = uint32(model.indices.size() / 3);
+
+    // Rays start on a sphere around the model and point at random points of its bounds, as picking rays from a camera
+    Float3 center = model.aabb.get_center();
+    float radius = distance(model.aabb.minPoint, model.aabb.maxPoint);
+    std::mt19937 randomEngine(3);
+    std::uniform_real_distribution<float> unitDistribution(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> xDistribution(model.aabb.minPoint.x, model.aabb.maxPoint.x);
+    std::uniform_real_distribution<float> yDistribution(model.aabb.minPoint.y, model.aabb.maxPoint.y);
+    std::uniform_real_distribution<float> zDistribution(model.aabb.minPoint.z, model.aabb.maxPoint.z);
+
+    std::vector<Ray> rays;
+    rays.reserve(TRIANGLE_BVH_RAY_COUNT);
+    for (uint32 i = 0; i != TRIANGLE_BVH_RAY_COUNT; ++i)
+    {
+        Vector offset = Vector3::normalize(Vector3::create(unitDistribution(randomEngine), unitDistribution(randomEngine), unitDistribution(randomEngine)));
+        Float3 origin = center + Float3(offset) * radius;
+        Float3 target(xDistribution(randomEngine), yDistribution(randomEngine), zDistribution(randomEngine));
+        rays.emplace_back(origin, target - origin);
+    }
+
+    Stopwatch stopwatch;
+    TriangleBVH triangleBVH;
+    triangleBVH.build(model.positions, model.indices, model.meshFirstTriangles);
+    double buildTime = stopwatch.elapsed_milliseconds();
+
+    stopwatch.reset();
+    uint32 bruteForceHitCount = 0;
+    std::vector<float> bruteForceDistances(TRIANGLE_BVH_BRUTE_FORCE_RAY_COUNT);
+    for (uint32 i = 0; i != TRIANGLE_BVH_BRUTE_FORCE_RAY_COUNT; ++i)
+        bruteForceHitCount += brute_force_closest_hit(model, rays[i], bruteForceDistances[i]);
+    double bruteForceRaysPerSecond = TRIANGLE_BVH_BRUTE_FORCE_RAY_COUNT / stopwatch.elapsed_seconds();
+
+    // Binary BVH over triangle AABBs with the same triangle test, shows what 4-wide nodes give
+    std::vector<AABB> triangleAABBs(triangleCount);
+    for (uint32 i = 0; i != triangleCount; ++i)
+    {
+        const Float3& vertex0 = model.positions[model.indices[i * 3]];
+        const Float3& vertex1 = model.positions[model.indices[i * 3 + 1]];
+        const Float3& vertex2 = model.positions[model.indices[i * 3 + 2]];
+        triangleAABBs[i].minPoint = min(min(vertex0, vertex1), vertex2);
+        triangleAABBs[i].maxPoint = max(max(vertex0, vertex1), vertex2);
+    }
+    BVH binaryBVH;
+    binaryBVH.build(triangleAABBs);
+
+    stopwatch.reset();
+    uint32 binaryHitCount = 0;
+    for (const Ray& ray : rays)
+    {
+        BVH::Hit hit;
+        binaryHitCount += binaryBVH.closest_hit(ray, [&](uint32 triangleIndex, const Ray& ray, float& outDistance)
+        {
+            const Float3& vertex0 = model.positions[model.indices[triangleIndex * 3]];
+            const Float3& vertex1 = model.positions[model.indices[triangleIndex * 3 + 1]];
+            const Float3& vertex2 = model.positions[model.indices[triangleIndex * 3 + 2]];
+            return intersects_triangle(vertex0, vertex1, vertex2, ray, ray.tmax, outDistance);
+        }, hit);
+    }
+    double binaryRaysPerSecond = TRIANGLE_BVH_RAY_COUNT / stopwatch.elapsed_seconds();
+
+    stopwatch.reset();
+    uint32 closestHitCount = 0;
+    for (const Ray& ray : rays)
+    {
+        TriangleBVH::Hit hit;
+        closestHitCount += triangleBVH.closest_hit(ray, hit);
+        do_not_optimize(hit);
+    }
+    double closestHitRaysPerSecond = TRIANGLE_BVH_RAY_COUNT / stopwatch.elapsed_seconds();
+
+    stopwatch.reset();
+    uint32 anyHitCount = 0;
+    for (const Ray& ray : rays)
+        anyHitCount += triangleBVH.any_hit(ray);
+    double anyHitRaysPerSecond = TRIANGLE_BVH_RAY_COUNT / stopwatch.elapsed_seconds();
+
+    FE_CHECK(anyHitCount == closestHitCount && binaryHitCount == closestHitCount);
+    for (uint32 i = 0; i != TRIANGLE_BVH_BRUTE_FORCE_RAY_COUNT; ++i)
+    {
+        TriangleBVH::Hit hit;
+        bool isHit = triangleBVH.closest_hit(rays[i], hit);
+        FE_CHECK(!isHit || std::abs(hit.distance - bruteForceDistances[i]) <= 1e-4f * bruteForceDistances[i]);
+        bruteForceHitCount -= isHit;
+    }
+    FE_CHECK(bruteForceHitCount == 0);
+
+    FE_LOG(LogBenchmark, INFO, "{}: {} triangles, build {:.2f} ms, {} nodes, {:.1f} KB ({:.1f} bytes per triangle)",
+        fileName, triangleCount, buildTime, triangleBVH.get_nodes().size(), triangleBVH.get_memory_size() / 1024.0,
+        double(triangleBVH.get_memory_size()) / triangleCount);
+    FE_LOG(LogBenchmark, INFO, "Rays per second: brute force {:.0f}, binary BVH {:.0f}, 4-wide closest hit {:.0f} ({:.0f}x brute force, {:.2f}x binary), any hit {:.0f}; {} of {} rays hit",
+        bruteForceRaysPerSecond, binaryRaysPerSecond, closestHitRaysPerSecond, closestHitRaysPerSecond / bruteForceRaysPerSecond,
+        closestHitRaysPerSecond / binaryRaysPerSecond, anyHitRaysPerSecond, closestHitCount, TRIANGLE_BVH_RAY_COUNT);
+}
+
+FE_BENCHMARK(triangle_bvh)
+{
+    run_triangle_bvh_benchmark("boulder.glb");
+    run_triangle_bvh_benchmark("horse.glb");
+}
+
+}
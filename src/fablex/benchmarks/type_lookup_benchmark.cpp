@@ -0,0 +1,169 @@
+#include "benchmark.h"
+#include "core/object.h"
+
+namespace fe
+{
+
+// Same depth as light components: Object -> Component -> LightComponent -> PointLightComponent
+class LookupBenchmarkComponent : public Object
+{
+    FE_DECLARE_OBJECT(LookupBenchmarkComponent);
+};
+
+class LookupBenchmarkTransform : public LookupBenchmarkComponent
+{
+    FE_DECLARE_OBJECT(LookupBenchmarkTransform);
+};
+
+class LookupBenchmarkCamera : public LookupBenchmarkComponent
+{
+    FE_DECLARE_OBJECT(LookupBenchmarkCamera);
+};
+
+class LookupBenchmarkModel : public LookupBenchmarkComponent
+{
+    FE_DECLARE_OBJECT(LookupBenchmarkModel);
+};
+
+class LookupBenchmarkLight : public LookupBenchmarkComponent
+{
+    FE_DECLARE_OBJECT(LookupBenchmarkLight);
+};
+
+class LookupBenchmarkPointLight : public LookupBenchmarkLight
+{
+    FE_DECLARE_OBJECT(LookupBenchmarkPointLight);
+};
+
+FE_DEFINE_OBJECT(LookupBenchmarkComponent, Object);
+FE_DEFINE_OBJECT(LookupBenchmarkTransform, LookupBenchmarkComponent);
+FE_DEFINE_OBJECT(LookupBenchmarkCamera, LookupBenchmarkComponent);
+FE_DEFINE_OBJECT(LookupBenchmarkModel, LookupBenchmarkComponent);
+FE_DEFINE_OBJECT(LookupBenchmarkLight, LookupBenchmarkComponent);
+FE_DEFINE_OBJECT(LookupBenchmarkPointLight, LookupBenchmarkLight);
+
+}
+
+namespace fe::benchmark
+{
+
+constexpr uint32 LOOKUP_ENTITY_COUNT = 100000;
+
+// Replicates TypeInfo::is_a used before type indices, it walked base types and compared name hashes
+bool is_a_by_base_chain(const TypeInfo* typeInfo, const TypeInfo* baseTypeInfo)
+{
+    for (const TypeInfo* it = typeInfo; it != nullptr; it = it->get_base_type_info())
+        if (it->get_name_hash() == baseTypeInfo->get_name_hash())
+            return true;
+
+    return false;
+}
+
+// Components of an entity stored like Entity stores them
+struct LookupEntity
+{
+    std::vector<Object*> components;
+    std::vector<Object*> componentsByTypeIndex;
+
+    void add_component(Object* component)
+    {
+        const TypeInfo* componentTypeInfo = LookupBenchmarkComponent::get_static_type_info();
+        components.push_back(component);
+
+        if (componentsByTypeIndex.empty())
+            componentsByTypeIndex.resize(componentTypeInfo->get_descendant_count() + 1);
+
+        for (const TypeInfo* it = component->get_type_info(); it != Object::get_static_type_info(); it = it->get_base_type_info())
+        {
+            Object*& slot = componentsByTypeIndex[it->get_type_index() - componentTypeInfo->get_type_index()];
+            if (!slot)
+                slot = component;
+        }
+    }
+
+    Object* get_component_by_scan(const TypeInfo* typeInfo) const
+    {
+        for (Object* component : components)
+            if (is_a_by_base_chain(component->get_type_info(), typeInfo))
+                return component;
+        return nullptr;
+    }
+
+    Object* get_component_by_index(const TypeInfo* typeInfo) const
+    {
+        uint32 slotIndex = typeInfo->get_type_index() - LookupBenchmarkComponent::get_static_type_info()->get_type_index();
+        return slotIndex < componentsByTypeIndex.size() ? componentsByTypeIndex[slotIndex] : nullptr;
+    }
+};
+
+template<typename GetComponentHandler>
+double run_component_lookup_benchmark(const std::vector<LookupEntity>& entities, GetComponentHandler getComponentHandler)
+{
+    // SceneManager asks every entity for camera, model and light components
+    const TypeInfo* typeInfos[] = {
+        LookupBenchmarkCamera::get_static_type_info(),
+        LookupBenchmarkModel::get_static_type_info(),
+        LookupBenchmarkLight::get_static_type_info()
+    };
+
+    uint64 foundCount = 0;
+    Stopwatch stopwatch;
+    for (const LookupEntity& entity : entities)
+        for (const TypeInfo* typeInfo : typeInfos)
+            foundCount += getComponentHandler(entity, typeInfo) != nullptr;
+
+    double time = stopwatch.elapsed_milliseconds();
+    do_not_optimize(foundCount);
+    return time;
+}
+
+FE_BENCHMARK(type_lookup)
+{
+    std::vector<Object*> objects;
+    std::vector<LookupEntity> entities(LOOKUP_ENTITY_COUNT);
+    for (uint32 i = 0; i != LOOKUP_ENTITY_COUNT; ++i)
+    {
+        LookupEntity& entity = entities[i];
+        entity.add_component(objects.emplace_back(create_object<LookupBenchmarkTransform>()));
+        if (i % 2)
+            entity.add_component(objects.emplace_back(create_object<LookupBenchmarkModel>()));
+        if (i % 8 == 0)
+            entity.add_component(objects.emplace_back(create_object<LookupBenchmarkPointLight>()));
+    }
+
+    const TypeInfo* lightTypeInfo = LookupBenchmarkLight::get_static_type_info();
+    uint64 chainMatchCount = 0;
+    Stopwatch stopwatch;
+    for (const Object* object : objects)
+        chainMatchCount += is_a_by_base_chain(object->get_type_info(), lightTypeInfo);
+    double chainTime = stopwatch.elapsed_milliseconds();
+
+    uint64 indexMatchCount = 0;
+    stopwatch.reset();
+    for (const Object* object : objects)
+        indexMatchCount += object->get_type_info()->is_a(lightTypeInfo);
+    double indexTime = stopwatch.elapsed_milliseconds();
+
+    FE_CHECK(chainMatchCount == indexMatchCount);
+    do_not_optimize(indexMatchCount);
+
+    double scanTime = run_component_lookup_benchmark(entities, [](const LookupEntity& entity, const TypeInfo* typeInfo)
+    {
+        return entity.get_component_by_scan(typeInfo);
+    });
+
+    double tableTime = run_component_lookup_benchmark(entities, [](const LookupEntity& entity, const TypeInfo* typeInfo)
+    {
+        return entity.get_component_by_index(typeInfo);
+    });
+
+    FE_LOG(LogBenchmark, INFO, "{} objects; is_a: base chain {:.2f} ms, type index {:.2f} ms, speedup {:.2f}x",
+        objects.size(), chainTime, indexTime, chainTime / indexTime);
+    FE_LOG(LogBenchmark, INFO, "{} entities; get_component: scan {:.2f} ms, type index {:.2f} ms, speedup {:.2f}x",
+        LOOKUP_ENTITY_COUNT, scanTime, tableTime, scanTime / tableTime);
+
+    for (Object* object : objects)
+        destroy_object(object);
+}
+
+}
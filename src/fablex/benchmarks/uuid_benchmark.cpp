@@ -0,0 +1,82 @@
+#include "benchmark.h"
+#include "core/uuid.h"
+
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace fe::benchmark
+{
+
+constexpr uint32 UUID_COUNT = 1000000;
+constexpr uint32 UUID_THREAD_COUNT = 4;
+
+// Replicates UUID generation used before thread-local generators, the mutex makes concurrent use of the engine valid
+class SharedUUIDGenerator
+{
+public:
+    uint64 next()
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        uint64 uuid = m_distribution(m_engine);
+        if (uuid == 0)
+            uuid = m_distribution(m_engine);
+        return uuid;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::mt19937_64 m_engine{ std::random_device()() };
+    std::uniform_int_distribution<uint64> m_distribution;
+};
+
+template<typename GenerateHandler>
+double run_uuid_benchmark(uint32 threadCount, GenerateHandler generateHandler)
+{
+    std::vector<std::vector<UUID>> uuidsByThread(threadCount, std::vector<UUID>(UUID_COUNT / threadCount, UUID::INVALID));
+    std::vector<std::thread> threads;
+
+    Stopwatch stopwatch;
+    for (std::vector<UUID>& uuids : uuidsByThread)
+        threads.emplace_back([&uuids, &generateHandler] { generateHandler(uuids); });
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    double time = stopwatch.elapsed_milliseconds();
+    do_not_optimize(uuidsByThread.back().back());
+    return time;
+}
+
+FE_BENCHMARK(uuid_generation)
+{
+    SharedUUIDGenerator sharedGenerator;
+    auto sharedHandler = [&](std::vector<UUID>& uuids)
+    {
+        for (UUID& uuid : uuids)
+            uuid = UUID(sharedGenerator.next());
+    };
+
+    auto constructorHandler = [](std::vector<UUID>& uuids)
+    {
+        for (UUID& uuid : uuids)
+            uuid = UUID();
+    };
+
+    auto batchHandler = [](std::vector<UUID>& uuids)
+    {
+        UUID::generate(uuids.data(), uuids.size());
+    };
+
+    for (uint32 threadCount : { 1u, UUID_THREAD_COUNT })
+    {
+        double sharedTime = run_uuid_benchmark(threadCount, sharedHandler);
+        double constructorTime = run_uuid_benchmark(threadCount, constructorHandler);
+        double batchTime = run_uuid_benchmark(threadCount, batchHandler);
+
+        FE_LOG(LogBenchmark, INFO, "{} UUIDs, {} threads: shared mt19937_64 {:.2f} ms, thread-local {:.2f} ms, batch {:.2f} ms, speedup {:.2f}x / {:.2f}x",
+            UUID_COUNT, threadCount, sharedTime, constructorTime, batchTime, sharedTime / constructorTime, sharedTime / batchTime);
+    }
+}
+
+}
@@ -0,0 +1,527 @@
+#include "bulk_math.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define FE_BULK_MATH_SSE
+#endif
+
+namespace fe
+{
+
+#ifdef FE_BULK_MATH_SSE
+
+// Loads 4 points stored as xyz xyz xyz xyz and returns them as xxxx yyyy zzzz
+void load_points_soa(const Float3* points, __m128& outX, __m128& outY, __m128& outZ)
+{
+    const float* data = &points->x;
+    __m128 a = _mm_loadu_ps(data);          // x0 y0 z0 x1
+    __m128 b = _mm_loadu_ps(data + 4);      // y1 z1 x2 y2
+    __m128 c = _mm_loadu_ps(data + 8);      // z2 x3 y3 z3
+
+    outX = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    outY = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    outZ = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+// Inverse of load_points_soa
+void store_points_soa(Float3* outPoints, __m128 x, __m128 y, __m128 z)
+{
+    __m128 xy01 = _mm_unpacklo_ps(x, y);
+    __m128 xy23 = _mm_unpackhi_ps(x, y);
+
+    float* data = &outPoints->x;
+    _mm_storeu_ps(data, _mm_shuffle_ps(xy01, _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0)));
+    _mm_storeu_ps(data + 4, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), xy23, _MM_SHUFFLE(1, 0, 2, 0)));
+    _mm_storeu_ps(data + 8, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+#endif // FE_BULK_MATH_SSE
+
+#ifdef __AVX2__
+
+// Same as load_points_soa for 8 points, the first 4 points are in the low lane
+void load_points_soa(const Float3* points, __m256& outX, __m256& outY, __m256& outZ)
+{
+    const float* data = &points->x;
+    __m256 a = _mm256_set_m128(_mm_loadu_ps(data + 12), _mm_loadu_ps(data));
+    __m256 b = _mm256_set_m128(_mm_loadu_ps(data + 16), _mm_loadu_ps(data + 4));
+    __m256 c = _mm256_set_m128(_mm_loadu_ps(data + 20), _mm_loadu_ps(data + 8));
+
+    outX = _mm256_shuffle_ps(a, _mm256_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    outY = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    outZ = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+void store_points_soa(Float3* outPoints, __m256 x, __m256 y, __m256 z)
+{
+    __m256 xy01 = _mm256_unpacklo_ps(x, y);
+    __m256 xy23 = _mm256_unpackhi_ps(x, y);
+    __m256 a = _mm256_shuffle_ps(xy01, _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+    __m256 b = _mm256_shuffle_ps(_mm256_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), xy23, _MM_SHUFFLE(1, 0, 2, 0));
+    __m256 c = _mm256_shuffle_ps(_mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+    float* data = &outPoints->x;
+    _mm_storeu_ps(data, _mm256_castps256_ps128(a));
+    _mm_storeu_ps(data + 4, _mm256_castps256_ps128(b));
+    _mm_storeu_ps(data + 8, _mm256_castps256_ps128(c));
+    _mm_storeu_ps(data + 12, _mm256_extractf128_ps(a, 1));
+    _mm_storeu_ps(data + 16, _mm256_extractf128_ps(b, 1));
+    _mm_storeu_ps(data + 20, _mm256_extractf128_ps(c, 1));
+}
+
+// Transposes 4x4 blocks in each lane, applying it twice gives the original vectors
+void transpose_lanes(__m256& a, __m256& b, __m256& c, __m256& d)
+{
+    __m256 t0 = _mm256_unpacklo_ps(a, b);
+    __m256 t1 = _mm256_unpacklo_ps(c, d);
+    __m256 t2 = _mm256_unpackhi_ps(a, b);
+    __m256 t3 = _mm256_unpackhi_ps(c, d);
+    a = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    b = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    c = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    d = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+#endif // __AVX2__
+
+// Component k of a stream of interleaved vectors with the given component count is minimums[k % componentCount]
+void reduce_interleaved_bounds(const float* minimums, const float* maximums, uint32 valueCount, uint32 componentCount, float* outMin, float* outMax)
+{
+    for (uint32 i = 0; i != valueCount; ++i)
+    {
+        outMin[i % componentCount] = std::min(outMin[i % componentCount], minimums[i]);
+        outMax[i % componentCount] = std::max(outMax[i % componentCount], maximums[i]);
+    }
+}
+
+void transform_points(const Float3* points, uint64 count, const Float4x4& transform, Float3* outPoints)
+{
+    uint64 i = 0;
+    const Float4x4& m = transform;
+
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x, y, z;
+        load_points_soa(points + i, x, y, z);
+
+        __m256 resultX = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(m._31)), _mm256_set1_ps(m._41));
+        __m256 resultY = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(m._32)), _mm256_set1_ps(m._42));
+        __m256 resultZ = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(m._33)), _mm256_set1_ps(m._43));
+        __m256 resultW = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(m._34)), _mm256_set1_ps(m._44));
+        resultX = _mm256_add_ps(_mm256_mul_ps(y, _mm256_set1_ps(m._21)), resultX);
+        resultY = _mm256_add_ps(_mm256_mul_ps(y, _mm256_set1_ps(m._22)), resultY);
+        resultZ = _mm256_add_ps(_mm256_mul_ps(y, _mm256_set1_ps(m._23)), resultZ);
+        resultW = _mm256_add_ps(_mm256_mul_ps(y, _mm256_set1_ps(m._24)), resultW);
+        resultX = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(m._11)), resultX);
+        resultY = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(m._12)), resultY);
+        resultZ = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(m._13)), resultZ);
+        resultW = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(m._14)), resultW);
+
+        store_points_soa(outPoints + i, _mm256_div_ps(resultX, resultW), _mm256_div_ps(resultY, resultW), _mm256_div_ps(resultZ, resultW));
+    }
+#elif defined(FE_BULK_MATH_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y, z;
+        load_points_soa(points + i, x, y, z);
+
+        __m128 resultX = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(m._31)), _mm_set1_ps(m._41));
+        __m128 resultY = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(m._32)), _mm_set1_ps(m._42));
+        __m128 resultZ = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(m._33)), _mm_set1_ps(m._43));
+        __m128 resultW = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(m._34)), _mm_set1_ps(m._44));
+        resultX = _mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(m._21)), resultX);
+        resultY = _mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(m._22)), resultY);
+        resultZ = _mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(m._23)), resultZ);
+        resultW = _mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(m._24)), resultW);
+        resultX = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m._11)), resultX);
+        resultY = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m._12)), resultY);
+        resultZ = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m._13)), resultZ);
+        resultW = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m._14)), resultW);
+
+        store_points_soa(outPoints + i, _mm_div_ps(resultX, resultW), _mm_div_ps(resultY, resultW), _mm_div_ps(resultZ, resultW));
+    }
+#endif
+
+    transform_points_scalar(points + i, count - i, transform, outPoints + i);
+}
+
+void transform_points_scalar(const Float3* points, uint64 count, const Float4x4& transform, Float3* outPoints)
+{
+    const Float4x4& m = transform;
+    for (uint64 i = 0; i != count; ++i)
+    {
+        const Float3 point = points[i];
+        float x = point.x * m._11 + (point.y * m._21 + (point.z * m._31 + m._41));
+        float y = point.x * m._12 + (point.y * m._22 + (point.z * m._32 + m._42));
+        float z = point.x * m._13 + (point.y * m._23 + (point.z * m._33 + m._43));
+        float w = point.x * m._14 + (point.y * m._24 + (point.z * m._34 + m._44));
+        outPoints[i] = Float3(x / w, y / w, z / w);
+    }
+}
+
+void transform_normals(const Float3* normals, uint64 count, const Float4x4& transform, Float3* outNormals)
+{
+    uint64 i = 0;
+    const Float4x4& m = transform;
+
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x, y, z;
+        load_points_soa(normals + i, x, y, z);
+
+        __m256 resultX = _mm256_mul_ps(z, _mm256_set1_ps(m._31));
+        __m256 resultY = _mm256_mul_ps(z, _mm256_set1_ps(m._32));
+        __m256 resultZ = _mm256_mul_ps(z, _mm256_set1_ps(m._33));
+        resultX = _mm256_add_ps(_mm256_mul_ps(y, _mm256_set1_ps(m._21)), resultX);
+        resultY = _mm256_add_ps(_mm256_mul_ps(y, _mm256_set1_ps(m._22)), resultY);
+        resultZ = _mm256_add_ps(_mm256_mul_ps(y, _mm256_set1_ps(m._23)), resultZ);
+        resultX = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(m._11)), resultX);
+        resultY = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(m._12)), resultY);
+        resultZ = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(m._13)), resultZ);
+
+        store_points_soa(outNormals + i, resultX, resultY, resultZ);
+    }
+#elif defined(FE_BULK_MATH_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y, z;
+        load_points_soa(normals + i, x, y, z);
+
+        __m128 resultX = _mm_mul_ps(z, _mm_set1_ps(m._31));
+        __m128 resultY = _mm_mul_ps(z, _mm_set1_ps(m._32));
+        __m128 resultZ = _mm_mul_ps(z, _mm_set1_ps(m._33));
+        resultX = _mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(m._21)), resultX);
+        resultY = _mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(m._22)), resultY);
+        resultZ = _mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(m._23)), resultZ);
+        resultX = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m._11)), resultX);
+        resultY = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m._12)), resultY);
+        resultZ = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m._13)), resultZ);
+
+        store_points_soa(outNormals + i, resultX, resultY, resultZ);
+    }
+#endif
+
+    transform_normals_scalar(normals + i, count - i, transform, outNormals + i);
+}
+
+void transform_normals_scalar(const Float3* normals, uint64 count, const Float4x4& transform, Float3* outNormals)
+{
+    const Float4x4& m = transform;
+    for (uint64 i = 0; i != count; ++i)
+    {
+        const Float3 normal = normals[i];
+        float x = normal.x * m._11 + (normal.y * m._21 + normal.z * m._31);
+        float y = normal.x * m._12 + (normal.y * m._22 + normal.z * m._32);
+        float z = normal.x * m._13 + (normal.y * m._23 + normal.z * m._33);
+        outNormals[i] = Float3(x, y, z);
+    }
+}
+
+void compute_bounds(const Float3* points, uint64 count, Float3& outMin, Float3& outMax)
+{
+    outMin = Float3(FLOAT_MAX, FLOAT_MAX, FLOAT_MAX);
+    outMax = Float3(-FLOAT_MAX, -FLOAT_MAX, -FLOAT_MAX);
+
+    uint64 i = 0;
+    const float* data = &points->x;
+
+    // Points are read as a stream of floats, the pattern of components repeats every 3 registers
+#if defined(__AVX2__)
+    if (count >= 8)
+    {
+        __m256 minimums[3] = { _mm256_set1_ps(FLOAT_MAX), _mm256_set1_ps(FLOAT_MAX), _mm256_set1_ps(FLOAT_MAX) };
+        __m256 maximums[3] = { _mm256_set1_ps(-FLOAT_MAX), _mm256_set1_ps(-FLOAT_MAX), _mm256_set1_ps(-FLOAT_MAX) };
+        for (; i + 8 <= count; i += 8)
+        {
+            for (uint32 j = 0; j != 3; ++j)
+            {
+                __m256 values = _mm256_loadu_ps(data + i * 3 + j * 8);
+                minimums[j] = _mm256_min_ps(minimums[j], values);
+                maximums[j] = _mm256_max_ps(maximums[j], values);
+            }
+        }
+
+        alignas(32) float minimumValues[24];
+        alignas(32) float maximumValues[24];
+        for (uint32 j = 0; j != 3; ++j)
+        {
+            _mm256_store_ps(minimumValues + j * 8, minimums[j]);
+            _mm256_store_ps(maximumValues + j * 8, maximums[j]);
+        }
+        reduce_interleaved_bounds(minimumValues, maximumValues, 24, 3, &outMin.x, &outMax.x);
+    }
+#elif defined(FE_BULK_MATH_SSE)
+    if (count >= 4)
+    {
+        __m128 minimums[3] = { _mm_set1_ps(FLOAT_MAX), _mm_set1_ps(FLOAT_MAX), _mm_set1_ps(FLOAT_MAX) };
+        __m128 maximums[3] = { _mm_set1_ps(-FLOAT_MAX), _mm_set1_ps(-FLOAT_MAX), _mm_set1_ps(-FLOAT_MAX) };
+        for (; i + 4 <= count; i += 4)
+        {
+            for (uint32 j = 0; j != 3; ++j)
+            {
+                __m128 values = _mm_loadu_ps(data + i * 3 + j * 4);
+                minimums[j] = _mm_min_ps(minimums[j], values);
+                maximums[j] = _mm_max_ps(maximums[j], values);
+            }
+        }
+
+        alignas(16) float minimumValues[12];
+        alignas(16) float maximumValues[12];
+        for (uint32 j = 0; j != 3; ++j)
+        {
+            _mm_store_ps(minimumValues + j * 4, minimums[j]);
+            _mm_store_ps(maximumValues + j * 4, maximums[j]);
+        }
+        reduce_interleaved_bounds(minimumValues, maximumValues, 12, 3, &outMin.x, &outMax.x);
+    }
+#endif
+
+    Float3 tailMin, tailMax;
+    compute_bounds_scalar(points + i, count - i, tailMin, tailMax);
+    outMin = min(outMin, tailMin);
+    outMax = max(outMax, tailMax);
+}
+
+void compute_bounds_scalar(const Float3* points, uint64 count, Float3& outMin, Float3& outMax)
+{
+    outMin = Float3(FLOAT_MAX, FLOAT_MAX, FLOAT_MAX);
+    outMax = Float3(-FLOAT_MAX, -FLOAT_MAX, -FLOAT_MAX);
+    for (uint64 i = 0; i != count; ++i)
+    {
+        outMin = Float3(std::min(outMin.x, points[i].x), std::min(outMin.y, points[i].y), std::min(outMin.z, points[i].z));
+        outMax = Float3(std::max(outMax.x, points[i].x), std::max(outMax.y, points[i].y), std::max(outMax.z, points[i].z));
+    }
+}
+
+void compute_bounds(const Float2* points, uint64 count, Float2& outMin, Float2& outMax)
+{
+    outMin = Float2(FLOAT_MAX, FLOAT_MAX);
+    outMax = Float2(-FLOAT_MAX, -FLOAT_MAX);
+
+    uint64 i = 0;
+    const float* data = &points->x;
+
+    // Every register holds whole points, so there is one accumulator
+#if defined(__AVX2__)
+    if (count >= 4)
+    {
+        __m256 minimums = _mm256_set1_ps(FLOAT_MAX);
+        __m256 maximums = _mm256_set1_ps(-FLOAT_MAX);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256 values = _mm256_loadu_ps(data + i * 2);
+            minimums = _mm256_min_ps(minimums, values);
+            maximums = _mm256_max_ps(maximums, values);
+        }
+
+        alignas(32) float minimumValues[8];
+        alignas(32) float maximumValues[8];
+        _mm256_store_ps(minimumValues, minimums);
+        _mm256_store_ps(maximumValues, maximums);
+        reduce_interleaved_bounds(minimumValues, maximumValues, 8, 2, &outMin.x, &outMax.x);
+    }
+#elif defined(FE_BULK_MATH_SSE)
+    if (count >= 2)
+    {
+        __m128 minimums = _mm_set1_ps(FLOAT_MAX);
+        __m128 maximums = _mm_set1_ps(-FLOAT_MAX);
+        for (; i + 2 <= count; i += 2)
+        {
+            __m128 values = _mm_loadu_ps(data + i * 2);
+            minimums = _mm_min_ps(minimums, values);
+            maximums = _mm_max_ps(maximums, values);
+        }
+
+        alignas(16) float minimumValues[4];
+        alignas(16) float maximumValues[4];
+        _mm_store_ps(minimumValues, minimums);
+        _mm_store_ps(maximumValues, maximums);
+        reduce_interleaved_bounds(minimumValues, maximumValues, 4, 2, &outMin.x, &outMax.x);
+    }
+#endif
+
+    Float2 tailMin, tailMax;
+    compute_bounds_scalar(points + i, count - i, tailMin, tailMax);
+    outMin = min(outMin, tailMin);
+    outMax = max(outMax, tailMax);
+}
+
+void compute_bounds_scalar(const Float2* points, uint64 count, Float2& outMin, Float2& outMax)
+{
+    outMin = Float2(FLOAT_MAX, FLOAT_MAX);
+    outMax = Float2(-FLOAT_MAX, -FLOAT_MAX);
+    for (uint64 i = 0; i != count; ++i)
+    {
+        outMin = Float2(std::min(outMin.x, points[i].x), std::min(outMin.y, points[i].y));
+        outMax = Float2(std::max(outMax.x, points[i].x), std::max(outMax.y, points[i].y));
+    }
+}
+
+void multiply_matrices(const Float4x4* matrices1, const Float4x4* matrices2, uint64 count, Float4x4* outMatrices)
+{
+    uint64 i = 0;
+
+#if defined(__AVX2__)
+    // Two rows of the first matrix are multiplied at once, one per lane
+    for (; i != count; ++i)
+    {
+        const float* data1 = &matrices1[i]._11;
+        const float* data2 = &matrices2[i]._11;
+        __m256 row0 = _mm256_broadcast_ps((const __m128*)data2);
+        __m256 row1 = _mm256_broadcast_ps((const __m128*)(data2 + 4));
+        __m256 row2 = _mm256_broadcast_ps((const __m128*)(data2 + 8));
+        __m256 row3 = _mm256_broadcast_ps((const __m128*)(data2 + 12));
+
+        __m256 rows01 = _mm256_loadu_ps(data1);
+        __m256 rows23 = _mm256_loadu_ps(data1 + 8);
+
+        for (__m256* rows : { &rows01, &rows23 })
+        {
+            __m256 xz = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(*rows, *rows, _MM_SHUFFLE(0, 0, 0, 0)), row0),
+                _mm256_mul_ps(_mm256_shuffle_ps(*rows, *rows, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+            __m256 yw = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(*rows, *rows, _MM_SHUFFLE(1, 1, 1, 1)), row1),
+                _mm256_mul_ps(_mm256_shuffle_ps(*rows, *rows, _MM_SHUFFLE(3, 3, 3, 3)), row3));
+            *rows = _mm256_add_ps(xz, yw);
+        }
+
+        float* outData = &outMatrices[i]._11;
+        _mm256_storeu_ps(outData, rows01);
+        _mm256_storeu_ps(outData + 8, rows23);
+    }
+#elif defined(FE_BULK_MATH_SSE)
+    for (; i != count; ++i)
+    {
+        const float* data1 = &matrices1[i]._11;
+        const float* data2 = &matrices2[i]._11;
+        __m128 row0 = _mm_loadu_ps(data2);
+        __m128 row1 = _mm_loadu_ps(data2 + 4);
+        __m128 row2 = _mm_loadu_ps(data2 + 8);
+        __m128 row3 = _mm_loadu_ps(data2 + 12);
+
+        // Rows are loaded before the first store, so the output can be one of the inputs
+        __m128 rows[4] = { _mm_loadu_ps(data1), _mm_loadu_ps(data1 + 4), _mm_loadu_ps(data1 + 8), _mm_loadu_ps(data1 + 12) };
+        for (__m128& row : rows)
+        {
+            __m128 xz = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), row0),
+                _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+            __m128 yw = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), row1),
+                _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), row3));
+            row = _mm_add_ps(xz, yw);
+        }
+
+        float* outData = &outMatrices[i]._11;
+        for (uint32 rowIndex = 0; rowIndex != 4; ++rowIndex)
+            _mm_storeu_ps(outData + rowIndex * 4, rows[rowIndex]);
+    }
+#endif
+
+    multiply_matrices_scalar(matrices1 + i, matrices2 + i, count - i, outMatrices + i);
+}
+
+void multiply_matrices_scalar(const Float4x4* matrices1, const Float4x4* matrices2, uint64 count, Float4x4* outMatrices)
+{
+    for (uint64 i = 0; i != count; ++i)
+    {
+        const Float4x4 a = matrices1[i];
+        const Float4x4 b = matrices2[i];
+        Float4x4& result = outMatrices[i];
+        for (uint32 row = 0; row != 4; ++row)
+        {
+            for (uint32 column = 0; column != 4; ++column)
+            {
+                float xz = a.m[row][0] * b.m[0][column] + a.m[row][2] * b.m[2][column];
+                float yw = a.m[row][1] * b.m[1][column] + a.m[row][3] * b.m[3][column];
+                result.m[row][column] = xz + yw;
+            }
+        }
+    }
+}
+
+void normalize_quaternions(const Float4* quats, uint64 count, Float4* outQuats)
+{
+    uint64 i = 0;
+
+#if defined(__AVX2__)
+    // Each lane transposes its own 2 quaternions of every register into xxxx yyyy zzzz wwww, so 8 quaternions
+    // are normalized at once and transposing again gives the original layout
+    for (; i + 8 <= count; i += 8)
+    {
+        const float* data = &quats[i].x;
+        __m256 x = _mm256_loadu_ps(data);
+        __m256 y = _mm256_loadu_ps(data + 8);
+        __m256 z = _mm256_loadu_ps(data + 16);
+        __m256 w = _mm256_loadu_ps(data + 24);
+        transpose_lanes(x, y, z, w);
+
+        __m256 lengthSquared = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(z, z)),
+            _mm256_add_ps(_mm256_mul_ps(y, y), _mm256_mul_ps(w, w)));
+        __m256 length = _mm256_sqrt_ps(lengthSquared);
+        __m256 nonZeroMask = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_NEQ_OQ);
+
+        x = _mm256_and_ps(_mm256_div_ps(x, length), nonZeroMask);
+        y = _mm256_and_ps(_mm256_div_ps(y, length), nonZeroMask);
+        z = _mm256_and_ps(_mm256_div_ps(z, length), nonZeroMask);
+        w = _mm256_and_ps(_mm256_div_ps(w, length), nonZeroMask);
+        transpose_lanes(x, y, z, w);
+
+        float* outData = &outQuats[i].x;
+        _mm256_storeu_ps(outData, x);
+        _mm256_storeu_ps(outData + 8, y);
+        _mm256_storeu_ps(outData + 16, z);
+        _mm256_storeu_ps(outData + 24, w);
+    }
+#elif defined(FE_BULK_MATH_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        const float* data = &quats[i].x;
+        __m128 x = _mm_loadu_ps(data);
+        __m128 y = _mm_loadu_ps(data + 4);
+        __m128 z = _mm_loadu_ps(data + 8);
+        __m128 w = _mm_loadu_ps(data + 12);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        __m128 lengthSquared = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(z, z)),
+            _mm_add_ps(_mm_mul_ps(y, y), _mm_mul_ps(w, w)));
+        __m128 length = _mm_sqrt_ps(lengthSquared);
+        __m128 nonZeroMask = _mm_cmpneq_ps(length, _mm_setzero_ps());
+
+        x = _mm_and_ps(_mm_div_ps(x, length), nonZeroMask);
+        y = _mm_and_ps(_mm_div_ps(y, length), nonZeroMask);
+        z = _mm_and_ps(_mm_div_ps(z, length), nonZeroMask);
+        w = _mm_and_ps(_mm_div_ps(w, length), nonZeroMask);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        float* outData = &outQuats[i].x;
+        _mm_storeu_ps(outData, x);
+        _mm_storeu_ps(outData + 4, y);
+        _mm_storeu_ps(outData + 8, z);
+        _mm_storeu_ps(outData + 12, w);
+    }
+#endif
+
+    normalize_quaternions_scalar(quats + i, count - i, outQuats + i);
+}
+
+void normalize_quaternions_scalar(const Float4* quats, uint64 count, Float4* outQuats)
+{
+    for (uint64 i = 0; i != count; ++i)
+    {
+        const Float4 quat = quats[i];
+        float length = std::sqrt((quat.x * quat.x + quat.z * quat.z) + (quat.y * quat.y + quat.w * quat.w));
+        if (length == 0.0f)
+        {
+            outQuats[i] = Float4(0.0f, 0.0f, 0.0f, 0.0f);
+            continue;
+        }
+
+        outQuats[i] = Float4(quat.x / length, quat.y / length, quat.z / length, quat.w / length);
+    }
+}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "math.h"
+
+namespace fe
+{
+
+// Kernels over contiguous arrays. They use AVX2 when the engine is built with FE_AVX2, otherwise SSE, and finish
+// counts that are not multiples of the SIMD width with scalar code. Output arrays can be the same as input arrays.
+// *_scalar functions are reference implementations with the same order of operations, used by tests.
+
+// Same as Vector3::transform_coord for each point, the result is divided by w
+void transform_points(const Float3* points, uint64 count, const Float4x4& transform, Float3* outPoints);
+void transform_points_scalar(const Float3* points, uint64 count, const Float4x4& transform, Float3* outPoints);
+
+// Same as Vector3::transform_normal for each normal, the translation is ignored and the result is not normalized
+void transform_normals(const Float3* normals, uint64 count, const Float4x4& transform, Float3* outNormals);
+void transform_normals_scalar(const Float3* normals, uint64 count, const Float4x4& transform, Float3* outNormals);
+
+// If count is 0, outMin is FLOAT_MAX and outMax is -FLOAT_MAX
+void compute_bounds(const Float3* points, uint64 count, Float3& outMin, Float3& outMax);
+void compute_bounds_scalar(const Float3* points, uint64 count, Float3& outMin, Float3& outMax);
+void compute_bounds(const Float2* points, uint64 count, Float2& outMin, Float2& outMax);
+void compute_bounds_scalar(const Float2* points, uint64 count, Float2& outMin, Float2& outMax);
+
+// outMatrices[i] = matrices1[i] * matrices2[i], same as Matrix::multiply
+void multiply_matrices(const Float4x4* matrices1, const Float4x4* matrices2, uint64 count, Float4x4* outMatrices);
+void multiply_matrices_scalar(const Float4x4* matrices1, const Float4x4* matrices2, uint64 count, Float4x4* outMatrices);
+
+// Same as Quat::normalize for each quaternion, zero quaternions stay zero
+void normalize_quaternions(const Float4* quats, uint64 count, Float4* outQuats);
+void normalize_quaternions_scalar(const Float4* quats, uint64 count, Float4* outQuats);
+
+}
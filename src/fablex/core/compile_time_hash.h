@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types.h"
+#include <string_view>
 
 namespace fe
 {
@@ -28,4 +29,19 @@ constexpr uint64 compile_time_fnv1(const char (&str)[len])
     return compile_time_fnv1_inner<len - 1>(0xcbf29ce484222325ull, str);
 }
 
-}
\ No newline at end of file
+constexpr uint64 FNV1A_OFFSET_BASIS = 0xcbf29ce484222325ull;
+constexpr uint64 FNV1A_PRIME = 0x100000001b3ull;
+
+// 64-bit FNV-1a, gives the same result at compile time and at runtime.
+// Hash of a concatenated string can be computed by passing the hash of its prefix.
+constexpr uint64 fnv1a_64(std::string_view str, uint64 hash = FNV1A_OFFSET_BASIS)
+{
+    for (char c : str)
+    {
+        hash ^= uint8(c);
+        hash *= FNV1A_PRIME;
+    }
+    return hash;
+}
+
+}
@@ -0,0 +1,54 @@
+#include "concurrent_pool_allocator.h"
+
+namespace fe
+{
+
+std::mutex g_threadIndexMutex;
+std::vector<uint32> g_freeThreadIndices;
+uint32 g_nextThreadIndex = 0;
+
+// Returns the index to the registry when the thread exits
+struct PoolThreadRegistration
+{
+    uint32 threadIndex = PoolThreadRegistry::s_invalidThreadIndex;
+
+    ~PoolThreadRegistration()
+    {
+        if (threadIndex != PoolThreadRegistry::s_invalidThreadIndex)
+            PoolThreadRegistry::unregister_thread(threadIndex);
+    }
+};
+
+thread_local PoolThreadRegistration g_poolThreadRegistration;
+
+uint32 PoolThreadRegistry::register_thread()
+{
+    uint32 threadIndex;
+
+    {
+        std::scoped_lock<std::mutex> locker(g_threadIndexMutex);
+
+        if (g_freeThreadIndices.empty())
+        {
+            threadIndex = g_nextThreadIndex++;
+        }
+        else
+        {
+            threadIndex = g_freeThreadIndices.back();
+            g_freeThreadIndices.pop_back();
+        }
+    }
+
+    g_poolThreadRegistration.threadIndex = threadIndex;
+    return threadIndex;
+}
+
+void PoolThreadRegistry::unregister_thread(uint32 threadIndex)
+{
+    s_threadIndex = s_invalidThreadIndex;
+
+    std::scoped_lock<std::mutex> locker(g_threadIndexMutex);
+    g_freeThreadIndices.push_back(threadIndex);
+}
+
+}
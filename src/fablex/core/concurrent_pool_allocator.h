@@ -0,0 +1,365 @@
+#pragma once
+
+#include "memory_utils.h"
+#include "types.h"
+#include "macro.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace fe
+{
+
+// Gives each thread a small index that is reused after the thread exits
+class PoolThreadRegistry
+{
+public:
+    static constexpr uint32 s_invalidThreadIndex = ~0u;
+
+    static uint32 get_thread_index()
+    {
+        if (s_threadIndex == s_invalidThreadIndex)
+            s_threadIndex = register_thread();
+        return s_threadIndex;
+    }
+
+private:
+    inline static thread_local uint32 s_threadIndex = s_invalidThreadIndex;
+
+    static uint32 register_thread();
+    static void unregister_thread(uint32 threadIndex);
+
+    friend struct PoolThreadRegistration;
+};
+
+// Pool with the same interface as ThreadSafePoolAllocator that doesn't take a lock on allocate() and free().
+// Each thread keeps two magazines, small lists of free slots, and exchanges full magazines with a shared lock-free stack,
+// so most calls touch only thread local data. Memory blobs are allocated under a mutex, which happens once per PoolSize objects.
+// Threads beyond s_maxCachedThreadCount work with the shared stack directly. Live objects are counted under MemoryTagValue.
+template<typename T, size_t PoolSize = 64, MemoryTag MemoryTagValue = MemoryTag::UNTAGGED>
+class ConcurrentPoolAllocator
+{
+public:
+    ConcurrentPoolAllocator() = default;
+    ConcurrentPoolAllocator(const ConcurrentPoolAllocator&) = delete;
+    ConcurrentPoolAllocator& operator=(const ConcurrentPoolAllocator&) = delete;
+
+    ~ConcurrentPoolAllocator()
+    {
+        for (Slot* memoryBlob : m_memoryBlobs)
+            MemoryUtils::free_aligned_memory(memoryBlob);
+    }
+
+    template<typename... Params>
+    T* allocate(Params&&... params)
+    {
+        Slot* slot = pop_slot();
+        MemoryTracker::on_allocate(MemoryTagValue, sizeof(T));
+        return new(slot->storage) T(std::forward<Params>(params)...);
+    }
+
+    void free(T* ptr)
+    {
+        ptr->~T();
+        push_slot(reinterpret_cast<Slot*>(ptr));
+        MemoryTracker::on_free(MemoryTagValue, sizeof(T));
+    }
+
+    // Returns all objects to the shared stack with one atomic operation
+    void free(T* const* ptrs, uint64 count)
+    {
+        if (!count)
+            return;
+
+        Slot* firstBatch = nullptr;
+        Slot* lastBatch = nullptr;
+
+        for (uint64 batchBeginning = 0; batchBeginning < count; batchBeginning += s_magazineSize)
+        {
+            uint32 batchSize = (uint32)std::min<uint64>(s_magazineSize, count - batchBeginning);
+            Slot* batch = nullptr;
+
+            for (uint32 i = 0; i != batchSize; ++i)
+            {
+                T* ptr = ptrs[batchBeginning + i];
+                ptr->~T();
+
+                Slot* slot = reinterpret_cast<Slot*>(ptr);
+                slot->next = batch;
+                batch = slot;
+            }
+
+            batch->batchSize = batchSize;
+            batch->nextBatch.store(firstBatch, std::memory_order_relaxed);
+            firstBatch = batch;
+
+            if (!lastBatch)
+                lastBatch = batch;
+        }
+
+        push_batches(firstBatch, lastBatch);
+        add_allocated_count(-int64(count));
+        MemoryTracker::on_free(MemoryTagValue, count * sizeof(T), count);
+    }
+
+    void free(const std::vector<T*>& ptrs)
+    {
+        free(ptrs.data(), ptrs.size());
+    }
+
+    // Objects that were allocated and not freed yet
+    uint64 get_live_count() const
+    {
+        int64 liveCount = m_uncachedAllocatedCount.load(std::memory_order_relaxed);
+        for (const ThreadCache& threadCache : m_threadCaches)
+            liveCount += threadCache.allocatedCount.load(std::memory_order_relaxed);
+
+        return (uint64)std::max<int64>(liveCount, 0);
+    }
+
+    // Sampled when a thread refills its magazine, so spikes shorter than a magazine can be missed
+    uint64 get_peak_count() const
+    {
+        return std::max(m_peakCount.load(std::memory_order_relaxed), get_live_count());
+    }
+
+private:
+    // Pointer and tag of the top batch are packed into one 64-bit value to avoid ABA.
+    // User space addresses fit into 48 bits on all supported platforms.
+    static constexpr uint32 s_pointerBitCount = 48;
+    static constexpr uint64 s_pointerMask = (uint64(1) << s_pointerBitCount) - 1;
+
+    static constexpr uint32 s_magazineSize = (uint32)std::min<size_t>(32, PoolSize);
+    static constexpr uint32 s_maxCachedThreadCount = 64;
+
+    struct Slot
+    {
+        alignas(T) uint8 storage[sizeof(T)];
+        // Links are kept outside object storage, so a stale reader of the shared stack never races with a live object
+        std::atomic<Slot*> nextBatch{ nullptr };
+        Slot* next = nullptr;
+        uint32 batchSize = 0;
+    };
+
+    struct alignas(64) ThreadCache
+    {
+        Slot* loaded = nullptr;
+        Slot* previous = nullptr;
+        uint32 loadedCount = 0;
+        uint32 previousCount = 0;
+        // Allocations minus frees made by the thread, written only by the owner
+        std::atomic<int64> allocatedCount{ 0 };
+    };
+
+    std::array<ThreadCache, s_maxCachedThreadCount> m_threadCaches{};
+    alignas(64) std::atomic<uint64> m_sharedBatches{ 0 };
+    alignas(64) std::atomic<int64> m_uncachedAllocatedCount{ 0 };
+    std::atomic<uint64> m_peakCount{ 0 };
+
+    std::mutex m_memoryBlobsMutex;
+    std::vector<Slot*> m_memoryBlobs;
+
+    Slot* pop_slot()
+    {
+        uint32 threadIndex = PoolThreadRegistry::get_thread_index();
+
+        if (threadIndex >= s_maxCachedThreadCount)
+        {
+            uint32 batchSize = 0;
+            Slot* batch = acquire_batch(batchSize);
+
+            if (batchSize > 1)
+            {
+                batch->next->batchSize = batchSize - 1;
+                push_batches(batch->next, batch->next);
+            }
+
+            m_uncachedAllocatedCount.fetch_add(1, std::memory_order_relaxed);
+            return batch;
+        }
+
+        ThreadCache& threadCache = m_threadCaches[threadIndex];
+
+        if (!threadCache.loadedCount)
+        {
+            if (threadCache.previousCount)
+            {
+                std::swap(threadCache.loaded, threadCache.previous);
+                std::swap(threadCache.loadedCount, threadCache.previousCount);
+            }
+            else
+            {
+                threadCache.loaded = acquire_batch(threadCache.loadedCount);
+                update_peak_count();
+            }
+        }
+
+        Slot* slot = threadCache.loaded;
+        threadCache.loaded = slot->next;
+        --threadCache.loadedCount;
+
+        threadCache.allocatedCount.store(threadCache.allocatedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    void push_slot(Slot* slot)
+    {
+        uint32 threadIndex = PoolThreadRegistry::get_thread_index();
+
+        if (threadIndex >= s_maxCachedThreadCount)
+        {
+            slot->next = nullptr;
+            slot->batchSize = 1;
+            push_batches(slot, slot);
+            m_uncachedAllocatedCount.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+
+        ThreadCache& threadCache = m_threadCaches[threadIndex];
+
+        // Previous magazine is either empty or full, so a thread that allocates and frees around
+        // a magazine boundary doesn't go to the shared stack on every call
+        if (threadCache.loadedCount == s_magazineSize)
+        {
+            if (threadCache.previousCount)
+            {
+                threadCache.previous->batchSize = threadCache.previousCount;
+                push_batches(threadCache.previous, threadCache.previous);
+            }
+
+            threadCache.previous = threadCache.loaded;
+            threadCache.previousCount = threadCache.loadedCount;
+            threadCache.loaded = nullptr;
+            threadCache.loadedCount = 0;
+        }
+
+        slot->next = threadCache.loaded;
+        threadCache.loaded = slot;
+        ++threadCache.loadedCount;
+
+        threadCache.allocatedCount.store(threadCache.allocatedCount.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+
+    // Pops a batch from the shared stack or allocates a new memory blob
+    Slot* acquire_batch(uint32& outBatchSize)
+    {
+        uint64 top = m_sharedBatches.load(std::memory_order_acquire);
+
+        while (Slot* batch = get_batch_pointer(top))
+        {
+            Slot* nextBatch = batch->nextBatch.load(std::memory_order_relaxed);
+            if (m_sharedBatches.compare_exchange_weak(top, pack_top(nextBatch, top), std::memory_order_acquire, std::memory_order_acquire))
+            {
+                outBatchSize = batch->batchSize;
+                return batch;
+            }
+        }
+
+        return allocate_memory_blob(outBatchSize);
+    }
+
+    // Pushes a list of batches linked by nextBatch, lastBatch->nextBatch is overwritten
+    void push_batches(Slot* firstBatch, Slot* lastBatch)
+    {
+        uint64 top = m_sharedBatches.load(std::memory_order_relaxed);
+
+        do
+        {
+            lastBatch->nextBatch.store(get_batch_pointer(top), std::memory_order_relaxed);
+        }
+        while (!m_sharedBatches.compare_exchange_weak(top, pack_top(firstBatch, top), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Keeps the first batch for the caller and shares the rest of the blob
+    Slot* allocate_memory_blob(uint32& outBatchSize)
+    {
+        Slot* memoryBlob = static_cast<Slot*>(MemoryUtils::allocate_aligned_memory(PoolSize * sizeof(Slot), alignof(Slot)));
+
+        if (!memoryBlob)
+        {
+            FE_CHECK(0);
+        }
+
+        FE_CHECK(!(uint64(memoryBlob + PoolSize) & ~s_pointerMask));
+
+        {
+            std::scoped_lock<std::mutex> locker(m_memoryBlobsMutex);
+            m_memoryBlobs.push_back(memoryBlob);
+        }
+
+        Slot* firstBatch = nullptr;
+        Slot* lastBatch = nullptr;
+
+        for (uint32 batchBeginning = 0; batchBeginning < PoolSize; batchBeginning += s_magazineSize)
+        {
+            uint32 batchSize = (uint32)std::min<size_t>(s_magazineSize, PoolSize - batchBeginning);
+            Slot* batch = memoryBlob + batchBeginning;
+
+            for (uint32 i = 0; i != batchSize; ++i)
+            {
+                Slot* slot = new(batch + i) Slot();
+                slot->next = i + 1 != batchSize ? batch + i + 1 : nullptr;
+            }
+
+            batch->batchSize = batchSize;
+
+            if (batchBeginning == 0)
+            {
+                outBatchSize = batchSize;
+                continue;
+            }
+
+            if (lastBatch)
+                lastBatch->nextBatch.store(batch, std::memory_order_relaxed);
+            else
+                firstBatch = batch;
+
+            lastBatch = batch;
+        }
+
+        if (firstBatch)
+            push_batches(firstBatch, lastBatch);
+
+        return memoryBlob;
+    }
+
+    void add_allocated_count(int64 count)
+    {
+        uint32 threadIndex = PoolThreadRegistry::get_thread_index();
+
+        if (threadIndex >= s_maxCachedThreadCount)
+        {
+            m_uncachedAllocatedCount.fetch_add(count, std::memory_order_relaxed);
+            return;
+        }
+
+        std::atomic<int64>& allocatedCount = m_threadCaches[threadIndex].allocatedCount;
+        allocatedCount.store(allocatedCount.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+
+    void update_peak_count()
+    {
+        uint64 liveCount = get_live_count();
+        uint64 peakCount = m_peakCount.load(std::memory_order_relaxed);
+
+        while (liveCount > peakCount && !m_peakCount.compare_exchange_weak(peakCount, liveCount, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    static Slot* get_batch_pointer(uint64 top)
+    {
+        return reinterpret_cast<Slot*>(top & s_pointerMask);
+    }
+
+    static uint64 pack_top(Slot* batch, uint64 previousTop)
+    {
+        uint64 tag = (previousTop >> s_pointerBitCount) + 1;
+        return (tag << s_pointerBitCount) | reinterpret_cast<uint64>(batch);
+    }
+};
+
+}
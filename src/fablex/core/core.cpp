@@ -2,6 +2,9 @@
 #include "task_composer.h"
 #include "file_system/file_system.h"
 #include "timer.h"
+#include "profiler.h"
+#include "memory_tracker.h"
+#include "task_tracer.h"
 
 #include <filesystem>
 
@@ -14,8 +17,11 @@ void Core::init()
 {
     FE_LOG(LogCore, INFO, "Starting core systems initialization.");
 
-    TaskComposer::init();
+    TaskTracer::set_thread_name("Main");
+
     FileSystem::init(get_root_path());
+    FELogger::open_log_file(FileSystem::get_absolute_path("logs/fablex.log"));
+    TaskComposer::init(load_task_composer_config());
     Timer::init();
 
     FE_LOG(LogCore, INFO, "Core systems initialization completed");
@@ -24,12 +30,30 @@ void Core::init()
 
 void Core::update()
 {
+    Profiler::begin_frame();
     Timer::update();
 }
 
 void Core::cleanup()
 {
     TaskComposer::cleanup();
+    MemoryTracker::report_leaks();
+    FELogger::close_log_file();
+}
+
+TaskComposerConfig Core::load_task_composer_config()
+{
+    TaskComposerConfig config;
+
+    std::string engineConfigPath = FileSystem::get_absolute_path("configs/engine.json");
+    if (!FileSystem::exists(engineConfigPath))
+        return config;
+
+    std::string engineConfigJsonStr;
+    FileSystem::read(engineConfigPath, engineConfigJsonStr);
+    config.init(nlohmann::json::parse(engineConfigJsonStr));
+
+    return config;
 }
 
 std::string Core::get_root_path()
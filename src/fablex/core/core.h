@@ -1,5 +1,6 @@
 #pragma once
 
+#include "task_composer_config.h"
 #include <string>
 
 namespace fe
@@ -14,6 +15,7 @@ public:
 
 private:
     static std::string get_root_path();
+    static TaskComposerConfig load_task_composer_config();
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "event.h"
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace fe
+{
+
+template<typename EventType>
+using EventBatchDelegate = std::function<void(std::span<const EventType> events)>;
+
+class IEventChannel
+{
+public:
+    virtual ~IEventChannel() { }
+
+    virtual void push(const IEvent& event) = 0;
+    // Passes all pushed events to subscribers and clears the channel
+    virtual void flush() = 0;
+    // Passes one event to subscribers as a batch without touching pushed events
+    virtual void dispatch(const IEvent& event) = 0;
+};
+
+// Collects events of one type contiguously, so subscribers handle all of them in one call.
+// Events keep the order in which they were drained from the event queue.
+template<typename EventType>
+class EventChannel : public IEventChannel
+{
+public:
+    void subscribe(const EventBatchDelegate<EventType>& eventDelegate)
+    {
+        m_eventDelegates.push_back(eventDelegate);
+    }
+
+    virtual void push(const IEvent& event) override
+    {
+        m_events.push_back(static_cast<const EventType&>(event));
+    }
+
+    virtual void flush() override
+    {
+        if (m_events.empty())
+            return;
+
+        for (const EventBatchDelegate<EventType>& eventDelegate : m_eventDelegates)
+            eventDelegate(std::span<const EventType>(m_events));
+
+        // Capacity is kept, so channels stop allocating once they have seen the largest batch
+        m_events.clear();
+    }
+
+    virtual void dispatch(const IEvent& event) override
+    {
+        for (const EventBatchDelegate<EventType>& eventDelegate : m_eventDelegates)
+            eventDelegate(std::span<const EventType>(&static_cast<const EventType&>(event), 1));
+    }
+
+private:
+    std::vector<EventType> m_events;
+    std::vector<EventBatchDelegate<EventType>> m_eventDelegates;
+};
+
+}
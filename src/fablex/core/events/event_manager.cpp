@@ -1,4 +1,5 @@
 #include "event_manager.h"
+#include "core/profiler.h"
 
 namespace fe
 {
@@ -28,36 +29,65 @@ void EventManager::unsubscribe(uint64_t eventID, const std::string& eventHandler
 
 void EventManager::trigger_event(const IEvent& event)
 {
-    std::scoped_lock<std::mutex> locker(s_eventQueueMutex);
+    std::scoped_lock<std::recursive_mutex> locker(s_triggerEventMutex);
 
     auto it = s_handlersByEventID.find(event.get_type_id());
-    if (it == s_handlersByEventID.end())
-        return;
+    if (it != s_handlersByEventID.end())
+    {
+        for (auto& handler : it->second)
+            handler->execute(event);
+    }
 
-    for (auto& handler : it->second)
-        handler->execute(event);
+    // Events pushed by dispatch_events() are not flushed early if a handler triggers an event of the same type
+    auto channelIt = s_channelsByEventID.find(event.get_type_id());
+    if (channelIt != s_channelsByEventID.end())
+        channelIt->second->dispatch(event);
 }
 
 void EventManager::dispatch_events()
 {
-    while (!s_eventsQueue.empty())
+    FE_PROFILE_SCOPE("EventManager::dispatch_events");
+
+    // Bulk operations enqueue runs of events with the same type, so handlers are looked up once per run.
+    // Handlers can enqueue new events, they are dispatched by the next drain.
+    while (true)
     {
-        IEvent* event = s_eventsQueue.front().get();
-        auto it = s_handlersByEventID.find(event->get_type_id());
-        if (it == s_handlersByEventID.end())
-        {
-            s_eventsQueue.pop();
-            continue;
-        }
-        
-        auto& handlers = it->second;
-        for (auto& handler : handlers)
+        uint64 cachedEventID = 0;
+        EventHandlerArray* cachedHandlers = nullptr;
+        IEventChannel* cachedChannel = nullptr;
+        bool isCacheValid = false;
+
+        uint64 eventCount = s_eventQueue.drain([&](const IEvent& event)
         {
-            handler->execute(*event);
-        }
+            uint64 eventID = event.get_type_id();
+            if (eventID != cachedEventID || !isCacheValid)
+            {
+                auto it = s_handlersByEventID.find(eventID);
+                cachedHandlers = it != s_handlersByEventID.end() ? &it->second : nullptr;
+
+                auto channelIt = s_channelsByEventID.find(eventID);
+                cachedChannel = channelIt != s_channelsByEventID.end() ? channelIt->second.get() : nullptr;
+
+                cachedEventID = eventID;
+                isCacheValid = true;
+            }
+
+            if (cachedHandlers)
+            {
+                for (auto& handler : *cachedHandlers)
+                    handler->execute(event);
+            }
 
-        s_eventsQueue.pop();
+            if (cachedChannel)
+                cachedChannel->push(event);
+        });
+
+        if (!eventCount)
+            break;
+
+        for (auto& [eventID, channel] : s_channelsByEventID)
+            channel->flush();
     }
-}    
+}
 
 }
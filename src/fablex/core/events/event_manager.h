@@ -1,11 +1,12 @@
 #pragma once
 
 #include "event_handler.h"
+#include "event_queue.h"
+#include "event_channel.h"
 #include "core/logger.h"
 
 #include <mutex>
 #include <memory>
-#include <queue>
 #include <vector>
 #include <unordered_map>
 
@@ -46,26 +47,42 @@ class EventManager
             subscribe(EventType::get_type_id_static(), eventDelegate);
         }
     
+        // Delegate receives all events of the type drained in one pass, after per-event handlers of that pass are executed
+        template<typename EventType>
+        static void subscribe_batch(const EventBatchDelegate<EventType>& eventDelegate)
+        {
+            std::scoped_lock<std::mutex> locker(s_handlersByEventIDMutex);
+
+            std::unique_ptr<IEventChannel>& channel = s_channelsByEventID[EventType::get_type_id_static()];
+            if (!channel)
+                channel.reset(new EventChannel<EventType>());
+
+            static_cast<EventChannel<EventType>*>(channel.get())->subscribe(eventDelegate);
+        }
+
         static void unsubscribe(uint64 eventID, const std::string& eventHandlerTypeName);
 
+        // Lock-free, the event is copied into a block of the calling thread
         template<typename CustomEvent>
         static void enqueue_event(const CustomEvent& event)
         {
-            std::scoped_lock<std::mutex> locker(s_eventQueueMutex);
-            s_eventsQueue.emplace(new CustomEvent(event));
+            s_eventQueue.enqueue(event);
         }
     
+        // Executes handlers on the calling thread. Calls from different threads are serialized,
+        // handlers can trigger other events.
         static void trigger_event(const IEvent& event);
         static void dispatch_events();
     
     private:
         using EventHandlerArray = std::vector<std::unique_ptr<IEventHandler>>;
 
-        inline static std::queue<std::unique_ptr<IEvent>> s_eventsQueue{};
+        inline static EventQueue s_eventQueue{};
         inline static std::unordered_map<uint64, EventHandlerArray> s_handlersByEventID{};
+        inline static std::unordered_map<uint64, std::unique_ptr<IEventChannel>> s_channelsByEventID{};
         
-        inline static std::mutex s_eventQueueMutex{};
         inline static std::mutex s_handlersByEventIDMutex{};
+        inline static std::recursive_mutex s_triggerEventMutex{};
 };
     
 }
\ No newline at end of file
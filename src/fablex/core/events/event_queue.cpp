@@ -0,0 +1,159 @@
+#include "event_queue.h"
+#include "core/memory_utils.h"
+
+#include <algorithm>
+
+namespace fe
+{
+
+EventQueue::EventQueue()
+    : m_queueID(s_queueCounter.fetch_add(1, std::memory_order_relaxed) + 1), m_isAlive(new std::atomic_bool(true))
+{
+
+}
+
+EventQueue::~EventQueue()
+{
+    // Remaining events are destroyed without being handled
+    drain([](const IEvent&) { });
+
+    m_isAlive->store(false, std::memory_order_release);
+
+    for (Block* block : m_freeBlocks)
+        free_block(block);
+}
+
+EventQueue::Stream::~Stream()
+{
+    Block* block = head;
+    while (block)
+    {
+        Block* nextBlock = block->next.load(std::memory_order_relaxed);
+        free_block(block);
+        block = nextBlock;
+    }
+}
+
+EventQueue::ThreadStreamCache::~ThreadStreamCache()
+{
+    for (ThreadStream& threadStream : threadStreams)
+        threadStream.stream->isOwned.store(false, std::memory_order_release);
+
+    s_lastQueueID = 0;
+    s_lastStream = nullptr;
+}
+
+EventQueue::Stream* EventQueue::acquire_thread_stream()
+{
+    ThreadStreamCache& cache = get_thread_stream_cache();
+
+    auto it = std::find_if(cache.threadStreams.begin(), cache.threadStreams.end(), [&](const ThreadStream& threadStream)
+    {
+        return threadStream.queueID == m_queueID;
+    });
+
+    if (it != cache.threadStreams.end())
+        return it->stream.get();
+
+    // Forget streams of destroyed queues, they are freed when the last reference is released
+    std::erase_if(cache.threadStreams, [](const ThreadStream& threadStream)
+    {
+        return !threadStream.isQueueAlive->load(std::memory_order_acquire);
+    });
+
+    std::shared_ptr<Stream> stream;
+
+    {
+        std::scoped_lock<std::mutex> lock(m_streamsMutex);
+
+        // Streams of exited threads are reused, the consumer keeps draining them as usual
+        for (std::shared_ptr<Stream>& freeStream : m_streams)
+        {
+            if (!freeStream->isOwned.load(std::memory_order_acquire))
+            {
+                freeStream->isOwned.store(true, std::memory_order_relaxed);
+                stream = freeStream;
+                break;
+            }
+        }
+
+        if (!stream)
+        {
+            stream.reset(new Stream());
+            stream->head = stream->tail = acquire_block(s_blockSize);
+            m_streams.push_back(stream);
+        }
+    }
+
+    cache.threadStreams.push_back({ m_queueID, stream, m_isAlive });
+    return stream.get();
+}
+
+void EventQueue::update_drain_streams()
+{
+    std::scoped_lock<std::mutex> lock(m_streamsMutex);
+
+    if (m_drainStreams.size() == m_streams.size())
+        return;
+
+    m_drainStreams.clear();
+    for (std::shared_ptr<Stream>& stream : m_streams)
+        m_drainStreams.push_back(stream.get());
+}
+
+EventQueue::Block* EventQueue::acquire_block(uint32 minCapacity)
+{
+    if (minCapacity <= s_blockSize)
+    {
+        std::scoped_lock<std::mutex> lock(m_freeBlocksMutex);
+        if (!m_freeBlocks.empty())
+        {
+            Block* block = m_freeBlocks.back();
+            m_freeBlocks.pop_back();
+
+            block->committedOffset.store(0, std::memory_order_relaxed);
+            block->next.store(nullptr, std::memory_order_relaxed);
+            block->writeOffset = 0;
+            return block;
+        }
+    }
+
+    m_blockCount.fetch_add(1, std::memory_order_relaxed);
+    return allocate_block(std::max(minCapacity, s_blockSize));
+}
+
+void EventQueue::release_block(Block* block)
+{
+    // Blocks of oversized events are not reused
+    if (block->capacity != s_blockSize)
+    {
+        m_blockCount.fetch_sub(1, std::memory_order_relaxed);
+        free_block(block);
+        return;
+    }
+
+    std::scoped_lock<std::mutex> lock(m_freeBlocksMutex);
+    m_freeBlocks.push_back(block);
+}
+
+EventQueue::Block* EventQueue::allocate_block(uint32 capacity)
+{
+    void* memory = MemoryUtils::allocate_aligned_memory(sizeof(Block) + capacity, alignof(Block));
+    Block* block = new(memory) Block();
+    block->capacity = capacity;
+    return block;
+}
+
+void EventQueue::free_block(Block* block)
+{
+    block->~Block();
+    MemoryUtils::free_aligned_memory(block);
+}
+
+EventQueue::ThreadStreamCache& EventQueue::get_thread_stream_cache()
+{
+    thread_local ThreadStreamCache cache;
+    return cache;
+}
+
+}
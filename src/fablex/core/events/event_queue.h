@@ -0,0 +1,197 @@
+#pragma once
+
+#include "event.h"
+#include "core/types.h"
+#include "core/macro.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace fe
+{
+
+// Multi-producer single-consumer queue that copies events into blocks owned by the producing thread.
+// enqueue() doesn't lock or allocate until the block of the thread is full. Events of one producer are drained
+// in FIFO order, events of different producers are not ordered relative to each other.
+// Drained blocks are recycled, so the queue works like a per-frame arena that is reset by drain().
+class EventQueue
+{
+public:
+    constexpr static uint32 s_blockSize = 64 * 1024;
+
+    EventQueue();
+    ~EventQueue();
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    template<typename CustomEvent>
+    void enqueue(const CustomEvent& event)
+    {
+        static_assert(alignof(CustomEvent) <= s_recordAlignment);
+
+        constexpr uint32 recordSize = align_record_size(sizeof(Record) + sizeof(CustomEvent));
+
+        Stream& stream = get_thread_stream();
+        Block* block = reserve(stream, recordSize);
+
+        uint8* recordPtr = block->get_data() + block->writeOffset;
+        Record* record = new(recordPtr) Record();
+        record->event = new(recordPtr + sizeof(Record)) CustomEvent(event);
+        record->size = recordSize;
+
+        block->writeOffset += recordSize;
+        block->committedOffset.store(block->writeOffset, std::memory_order_release);
+    }
+
+    // Must be called from one thread at a time. Calls the handler for each event that was enqueued before the call
+    // and for some events enqueued during it. Returns the number of drained events.
+    template<typename Handler>
+    uint64 drain(Handler&& handler)
+    {
+        update_drain_streams();
+
+        uint64 eventCount = 0;
+        for (Stream* stream : m_drainStreams)
+        {
+            while (true)
+            {
+                Block* block = stream->head;
+
+                // Producer publishes the next block after the last commit to this one, so the offset loaded after it is final
+                Block* nextBlock = block->next.load(std::memory_order_acquire);
+                uint32 committedOffset = block->committedOffset.load(std::memory_order_acquire);
+
+                while (stream->readOffset != committedOffset)
+                {
+                    Record* record = reinterpret_cast<Record*>(block->get_data() + stream->readOffset);
+                    handler(*record->event);
+                    record->event->~IEvent();
+
+                    stream->readOffset += record->size;
+                    ++eventCount;
+                }
+
+                if (!nextBlock)
+                    break;
+
+                stream->head = nextBlock;
+                stream->readOffset = 0;
+                release_block(block);
+            }
+        }
+
+        return eventCount;
+    }
+
+    // Number of blocks allocated from the heap, stops growing in the steady state
+    uint64 get_block_count() const { return m_blockCount.load(std::memory_order_relaxed); }
+
+private:
+    constexpr static uint32 s_recordAlignment = 16;
+
+    struct Record
+    {
+        IEvent* event = nullptr;
+        uint32 size = 0;
+    };
+
+    struct alignas(s_recordAlignment) Block
+    {
+        std::atomic<uint32> committedOffset{ 0 };
+        std::atomic<Block*> next{ nullptr };
+        uint32 capacity = 0;
+        // Used only by the producer
+        uint32 writeOffset = 0;
+
+        uint8* get_data() { return reinterpret_cast<uint8*>(this + 1); }
+    };
+
+    struct Stream
+    {
+        // Used only by the producer
+        Block* tail = nullptr;
+        // Used only by the consumer
+        Block* head = nullptr;
+        uint32 readOffset = 0;
+
+        std::atomic_bool isOwned{ true };
+
+        ~Stream();
+    };
+
+    // Streams are shared with threads, so a thread can exit after the queue is destroyed and the other way round
+    struct ThreadStream
+    {
+        uint64 queueID = 0;
+        std::shared_ptr<Stream> stream;
+        std::shared_ptr<std::atomic_bool> isQueueAlive;
+    };
+
+    struct ThreadStreamCache
+    {
+        std::vector<ThreadStream> threadStreams;
+
+        ~ThreadStreamCache();
+    };
+
+    inline static std::atomic<uint64> s_queueCounter{ 0 };
+
+    inline static thread_local uint64 s_lastQueueID = 0;
+    inline static thread_local Stream* s_lastStream = nullptr;
+
+    uint64 m_queueID = 0;
+    std::shared_ptr<std::atomic_bool> m_isAlive;
+
+    std::mutex m_streamsMutex;
+    std::vector<std::shared_ptr<Stream>> m_streams;
+    // Used only by the consumer
+    std::vector<Stream*> m_drainStreams;
+
+    std::mutex m_freeBlocksMutex;
+    std::vector<Block*> m_freeBlocks;
+    std::atomic<uint64> m_blockCount{ 0 };
+
+    constexpr static uint32 align_record_size(uint64 size)
+    {
+        return uint32((size + s_recordAlignment - 1) & ~uint64(s_recordAlignment - 1));
+    }
+
+    Stream& get_thread_stream()
+    {
+        if (s_lastQueueID != m_queueID)
+        {
+            s_lastStream = acquire_thread_stream();
+            s_lastQueueID = m_queueID;
+        }
+        return *s_lastStream;
+    }
+
+    Block* reserve(Stream& stream, uint32 recordSize)
+    {
+        Block* block = stream.tail;
+        if (block->writeOffset + recordSize <= block->capacity)
+            return block;
+
+        Block* newBlock = acquire_block(recordSize);
+        block->next.store(newBlock, std::memory_order_release);
+        stream.tail = newBlock;
+        return newBlock;
+    }
+
+    Stream* acquire_thread_stream();
+    void update_drain_streams();
+
+    Block* acquire_block(uint32 minCapacity);
+    void release_block(Block* block);
+
+    static Block* allocate_block(uint32 capacity);
+    static void free_block(Block* block);
+
+    static ThreadStreamCache& get_thread_stream_cache();
+};
+
+}
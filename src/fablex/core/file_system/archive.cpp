@@ -6,7 +6,7 @@
 namespace fe
 {
 
-constexpr uint64 g_archiveVersion = 1;
+constexpr uint64 g_archiveVersion = Archive::s_propertyLayoutVersion;
 
 Archive::Archive() : m_mode(Mode::WRITE)
 {
@@ -101,6 +101,19 @@ void Archive::save(const std::string& path)
     FileSystem::write(path, generalData);
 }
 
+bool Archive::add_field_layout(uint64 layoutHash, const std::vector<FieldDescriptor>& fieldDescriptors)
+{
+    return m_fieldLayouts.try_emplace(layoutHash, fieldDescriptors).second;
+}
+
+const std::vector<Archive::FieldDescriptor>* Archive::get_field_layout(uint64 layoutHash) const
+{
+    auto it = m_fieldLayouts.find(layoutHash);
+    if (it == m_fieldLayouts.end())
+        return nullptr;
+    return &it->second;
+}
+
 void Archive::create_empty()
 {
     m_data.resize(128);
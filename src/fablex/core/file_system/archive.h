@@ -6,6 +6,7 @@
 #include "core/logger.h"
 #include "core/name.h"
 #include <string>
+#include <unordered_map>
 
 namespace fe
 {
@@ -35,6 +36,20 @@ public:
         uint64 thumbnailDecompressedSize = 0;
     };
 
+    // Archives written before this version store object properties field by field
+    constexpr static uint64 s_propertyLayoutVersion = 2;
+
+    // Describes a field of an object written by PropertyLayout. Descriptors are stored once per layout,
+    // so objects written with an outdated layout can be read field by field.
+    struct FieldDescriptor
+    {
+        uint64 nameHash = 0;
+        uint32 size = 0;
+        uint8 type = 0;
+        uint8 valueType = 0;
+        uint16 padding = 0;
+    };
+
     // Creates empty binary archive for writing
     Archive();
     Archive(const std::string& path, Mode mode = Mode::READ);
@@ -53,6 +68,8 @@ public:
 
     const Header& get_header() const { return m_header; }
     uint64 get_version() const { return m_header.version; }
+    // True while the read position hasn't reached the end of the data
+    bool has_unread_data() const { return m_position < m_data.size(); }
     UUID get_uuid() const { return m_header.uuid; }
 
     template<typename Enum>
@@ -68,6 +85,48 @@ public:
     void set_thumbnail(const std::vector<uint8>& thumbnailData);
     void get_thumbnail(std::vector<uint8>& outThumbnailData);
 
+    // Raw bytes without any conversion, used for bulk copies of trivially copyable data
+    void write_bytes(const void* data, uint64 size)
+    {
+        FE_CHECK(m_mode == Mode::WRITE);
+        FE_CHECK(!m_data.empty());
+
+        const uint64 newPos = m_position + size;
+        if (newPos >= m_data.size())
+        {
+            uint64 newSize = m_data.size() * 2;
+            while (newPos >= newSize)
+                newSize *= 2;
+            m_data.resize(newSize);
+        }
+
+        if (size)
+            memcpy(m_data.data() + m_position, data, size);
+        m_position = newPos;
+    }
+
+    void read_bytes(void* outData, uint64 size)
+    {
+        FE_CHECK(m_mode == Mode::READ);
+        FE_CHECK(m_position + size <= m_data.size());
+
+        if (size)
+            memcpy(outData, m_data.data() + m_position, size);
+        m_position += size;
+    }
+
+    void skip_bytes(uint64 size)
+    {
+        FE_CHECK(m_mode == Mode::READ);
+        FE_CHECK(m_position + size <= m_data.size());
+        m_position += size;
+    }
+
+    // Returns false if the archive already has a field layout with this hash
+    bool add_field_layout(uint64 layoutHash, const std::vector<FieldDescriptor>& fieldDescriptors);
+    // Returns nullptr if the layout has not been written or read yet
+    const std::vector<FieldDescriptor>* get_field_layout(uint64 layoutHash) const;
+
     Archive& operator<<(bool data)
     {
         write(static_cast<uint32>(data ? 1 : 0));
@@ -233,8 +292,7 @@ public:
     Archive& operator<<(const std::string& data)
     {
         (*this) << data.length();
-        for (const char& x : data)
-            (*this) << x;
+        write_bytes(data.data(), data.length());
         return *this;
     }
 
@@ -248,8 +306,15 @@ public:
     Archive& operator<<(const std::vector<T>& data)
     {
         (*this) << data.size();
-        for (const T& x : data)
-            (*this) << x;
+        if constexpr (is_written_as_is<T>())
+        {
+            write_bytes(data.data(), data.size() * sizeof(T));
+        }
+        else
+        {
+            for (const T& x : data)
+                (*this) << x;
+        }
         return *this;
     }
 
@@ -444,8 +509,15 @@ public:
         (*this) >> size;
         outData.resize(size);
         
-        for (uint32 i = 0; i != size; ++i)
-            (*this) >> outData[i];
+        if constexpr (is_written_as_is<T>())
+        {
+            read_bytes(outData.data(), size * sizeof(T));
+        }
+        else
+        {
+            for (uint32 i = 0; i != size; ++i)
+                (*this) >> outData[i];
+        }
 
         return *this;
     }
@@ -455,10 +527,7 @@ public:
         uint64 len;
         (*this) >> len;
         outData.resize(len);
-
-        for (uint32 i = 0; i != len; ++i)
-            (*this) >> outData[i];
-
+        read_bytes(outData.data(), len);
         return *this;
     }
 
@@ -471,6 +540,23 @@ protected:
     std::vector<uint8> m_data;
     uint64 m_position = 0;
 
+    std::unordered_map<uint64, std::vector<FieldDescriptor>> m_fieldLayouts;
+
+    // Types that operator<< writes without conversion, so vectors of them are copied with one memcpy.
+    // bool and 32-bit integers are widened and are written element by element.
+    template<typename T>
+    constexpr static bool is_written_as_is()
+    {
+        return std::is_same_v<T, char> || std::is_same_v<T, unsigned char> || std::is_same_v<T, short>
+            || std::is_same_v<T, unsigned short> || std::is_same_v<T, long long> || std::is_same_v<T, unsigned long long>
+            || std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, UUID>
+            || std::is_same_v<T, Float2> || std::is_same_v<T, Float3> || std::is_same_v<T, Float4>
+            || std::is_same_v<T, Int2> || std::is_same_v<T, Int3> || std::is_same_v<T, Int4>
+            || std::is_same_v<T, UInt2> || std::is_same_v<T, UInt3> || std::is_same_v<T, UInt4>
+            || std::is_same_v<T, Float3x3> || std::is_same_v<T, Float3x4> || std::is_same_v<T, Float4x3>
+            || std::is_same_v<T, Float4x4>;
+    }
+
     template<typename T>
     void write(const T& data)
     {
@@ -492,7 +578,8 @@ protected:
         FE_CHECK(!m_data.empty());
         FE_CHECK(m_position < m_data.size());
 
-        outData = *reinterpret_cast<const T*>(m_data.data() + m_position);
+        // Data is not aligned after strings and raw bytes
+        memcpy(&outData, m_data.data() + m_position, sizeof(T));
         m_position += sizeof(T);
     }
 
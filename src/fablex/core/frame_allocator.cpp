@@ -0,0 +1,117 @@
+#include "frame_allocator.h"
+
+#include <algorithm>
+
+namespace fe
+{
+
+// Returns the arena to FrameAllocator when the thread exits, so arenas are not leaked when TaskComposer is reinitialized
+struct FrameArenaRegistration
+{
+    ScratchArena* arena = nullptr;
+
+    ~FrameArenaRegistration()
+    {
+        if (arena)
+            FrameAllocator::release_arena(arena);
+    }
+};
+
+thread_local FrameArenaRegistration g_frameArenaRegistration;
+
+ScratchArena::ScratchArena(uint64 blockSize)
+{
+    add_block(blockSize);
+}
+
+uint8* ScratchArena::allocate(uint64 size, uint64 alignment)
+{
+    FE_CHECK(alignment <= s_blockAlignment);
+
+    while (true)
+    {
+        if (uint8* ptr = m_blocks[m_currentBlock]->allocate(size, alignment))
+            return ptr;
+
+        if (m_currentBlock + 1 == m_blocks.size())
+            add_block(std::max(m_blocks.back()->get_capacity() * 2, size + alignment));
+
+        ++m_currentBlock;
+    }
+}
+
+void ScratchArena::reset()
+{
+    if (m_blocks.size() > 1)
+    {
+        uint64 capacity = get_capacity();
+        m_blocks.clear();
+        add_block(capacity);
+    }
+
+    m_blocks.front()->reset();
+    m_currentBlock = 0;
+}
+
+uint64 ScratchArena::get_capacity() const
+{
+    uint64 capacity = 0;
+    for (const std::unique_ptr<LinearAllocator>& block : m_blocks)
+        capacity += block->get_capacity();
+    return capacity;
+}
+
+void ScratchArena::add_block(uint64 capacity)
+{
+    std::unique_ptr<LinearAllocator>& block = m_blocks.emplace_back(new LinearAllocator());
+    block->reserve(capacity, s_blockAlignment);
+}
+
+void FrameAllocator::reset()
+{
+    std::scoped_lock<std::mutex> lock(s_arenasMutex);
+    for (std::unique_ptr<ScratchArena>& arena : s_arenas)
+        arena->reset();
+}
+
+uint64 FrameAllocator::get_block_count()
+{
+    std::scoped_lock<std::mutex> lock(s_arenasMutex);
+
+    uint64 blockCount = 0;
+    for (const std::unique_ptr<ScratchArena>& arena : s_arenas)
+        blockCount += arena->get_block_count();
+    return blockCount;
+}
+
+ScratchArena* FrameAllocator::acquire_arena()
+{
+    ScratchArena* arena = nullptr;
+
+    {
+        std::scoped_lock<std::mutex> lock(s_arenasMutex);
+
+        if (s_freeArenas.empty())
+        {
+            arena = s_arenas.emplace_back(new ScratchArena()).get();
+        }
+        else
+        {
+            arena = s_freeArenas.back();
+            s_freeArenas.pop_back();
+        }
+    }
+
+    g_frameArenaRegistration.arena = arena;
+    return arena;
+}
+
+void FrameAllocator::release_arena(ScratchArena* arena)
+{
+    s_threadArena = nullptr;
+
+    std::scoped_lock<std::mutex> lock(s_arenasMutex);
+    s_freeArenas.push_back(arena);
+}
+
+}
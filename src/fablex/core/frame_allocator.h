@@ -0,0 +1,112 @@
+#pragma once
+
+#include "linear_allocator.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace fe
+{
+
+// Linear allocator that chains a new block when the current one is full instead of returning nullptr.
+// After reset(), blocks are merged into one, so an arena stops touching the heap once it has seen its largest frame.
+class ScratchArena
+{
+public:
+    constexpr static uint64 s_defaultBlockSize = 64 * 1024;
+    constexpr static uint64 s_blockAlignment = 64;
+
+    ScratchArena(uint64 blockSize = s_defaultBlockSize);
+
+    uint8* allocate(uint64 size, uint64 alignment);
+    void reset();
+
+    uint64 get_block_count() const { return m_blocks.size(); }
+    uint64 get_capacity() const;
+
+private:
+    std::vector<std::unique_ptr<LinearAllocator>> m_blocks;
+    uint64 m_currentBlock = 0;
+
+    void add_block(uint64 capacity);
+};
+
+// Per-thread scratch arenas for data that lives until the end of the current frame.
+// Renderer resets all arenas in end_frame(), when no task uses frame memory.
+class FrameAllocator
+{
+public:
+    static uint8* allocate(uint64 size, uint64 alignment)
+    {
+        return get_thread_arena().allocate(size, alignment);
+    }
+
+    template<typename T>
+    static T* allocate(uint64 count = 1)
+    {
+        return reinterpret_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Invalidates all frame allocations of all threads
+    static void reset();
+
+    static ScratchArena& get_thread_arena()
+    {
+        if (!s_threadArena)
+            s_threadArena = acquire_arena();
+        return *s_threadArena;
+    }
+
+    // Number of blocks allocated by all arenas, stops growing in the steady state
+    static uint64 get_block_count();
+
+private:
+    inline static std::mutex s_arenasMutex;
+    inline static std::vector<std::unique_ptr<ScratchArena>> s_arenas;
+    inline static std::vector<ScratchArena*> s_freeArenas;
+
+    inline static thread_local ScratchArena* s_threadArena = nullptr;
+
+    static ScratchArena* acquire_arena();
+    static void release_arena(ScratchArena* arena);
+
+    friend struct FrameArenaRegistration;
+};
+
+// Allocates from the arena of the calling thread, deallocate() is a no-op.
+// Containers that are members must be released before FrameAllocator::reset().
+template<typename T>
+class FrameStlAllocator
+{
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    FrameStlAllocator() = default;
+
+    template<typename U>
+    FrameStlAllocator(const FrameStlAllocator<U>&) { }
+
+    T* allocate(size_t count)
+    {
+        return FrameAllocator::allocate<T>(count);
+    }
+
+    void deallocate(T*, size_t) { }
+
+    template<typename U>
+    bool operator==(const FrameStlAllocator<U>&) const { return true; }
+
+    template<typename U>
+    bool operator!=(const FrameStlAllocator<U>&) const { return false; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+using FrameUnorderedMap = std::unordered_map<Key, Value, Hash, KeyEqual, FrameStlAllocator<std::pair<const Key, Value>>>;
+
+}
@@ -8,5 +8,6 @@ class Property;
 class Attribute;
 class Object;
 class TaskGroup;
+class TaskGraph;
 
 }
\ No newline at end of file
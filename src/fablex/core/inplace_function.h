@@ -0,0 +1,143 @@
+#pragma once
+
+#include "types.h"
+#include "macro.h"
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace fe
+{
+
+template<typename Signature, size_t Capacity>
+class InplaceFunction;
+
+// Move-only std::function replacement that never allocates. Callable is stored
+// in the inline buffer, callables that do not fit fail to compile. Callable is invoked
+// through a const reference, so mutable lambdas are rejected.
+template<typename Result, typename... Args, size_t Capacity>
+class InplaceFunction<Result(Args...), Capacity>
+{
+public:
+    InplaceFunction() = default;
+    InplaceFunction(std::nullptr_t) { }
+
+    template<typename Callable, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, InplaceFunction>>>
+    InplaceFunction(Callable&& callable)
+    {
+        using CallableType = std::decay_t<Callable>;
+
+        static_assert(sizeof(CallableType) <= Capacity, "Callable is too large for InplaceFunction, capture less data or capture it by pointer");
+        static_assert(alignof(CallableType) <= alignof(std::max_align_t), "Callable alignment is not supported by InplaceFunction");
+        static_assert(std::is_invocable_r_v<Result, CallableType&, Args...>, "Callable has incompatible signature");
+        static_assert(std::is_invocable_r_v<Result, const CallableType&, Args...>, "Callable must be invocable as const, mutable lambdas are not supported");
+
+        new(m_storage) CallableType(std::forward<Callable>(callable));
+        m_invoker = &invoke<CallableType>;
+
+        // Trivial callables, for example lambdas that capture only pointers and references, are moved with memcpy
+        if constexpr (!std::is_trivially_copyable_v<CallableType> || !std::is_trivially_destructible_v<CallableType>)
+            m_manager = &manage<CallableType>;
+    }
+
+    InplaceFunction(InplaceFunction&& other) noexcept
+    {
+        move_from(other);
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction(const InplaceFunction&) = delete;
+    InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+    ~InplaceFunction()
+    {
+        reset();
+    }
+
+    Result operator()(Args... args) const
+    {
+        FE_CHECK(m_invoker);
+        return m_invoker(m_storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const
+    {
+        return m_invoker != nullptr;
+    }
+
+    void reset()
+    {
+        if (m_manager)
+            m_manager(Operation::DESTROY, m_storage, nullptr);
+
+        m_invoker = nullptr;
+        m_manager = nullptr;
+    }
+
+    static constexpr size_t get_capacity() { return Capacity; }
+
+private:
+    enum class Operation
+    {
+        MOVE,
+        DESTROY
+    };
+
+    using Invoker = Result(*)(const void*, Args&&...);
+    using Manager = void(*)(Operation, void*, void*);
+
+    alignas(std::max_align_t) std::byte m_storage[Capacity];
+    Invoker m_invoker = nullptr;
+    Manager m_manager = nullptr;
+
+    template<typename CallableType>
+    static Result invoke(const void* storage, Args&&... args)
+    {
+        return (*static_cast<const CallableType*>(storage))(std::forward<Args>(args)...);
+    }
+
+    template<typename CallableType>
+    static void manage(Operation operation, void* dst, void* src)
+    {
+        switch (operation)
+        {
+        case Operation::MOVE:
+            new(dst) CallableType(std::move(*static_cast<CallableType*>(src)));
+            static_cast<CallableType*>(src)->~CallableType();
+            break;
+        case Operation::DESTROY:
+            static_cast<CallableType*>(dst)->~CallableType();
+            break;
+        }
+    }
+
+    void move_from(InplaceFunction& other)
+    {
+        if (!other.m_invoker)
+            return;
+
+        if (other.m_manager)
+            other.m_manager(Operation::MOVE, m_storage, other.m_storage);
+        else
+            std::memcpy(m_storage, other.m_storage, Capacity);
+
+        m_invoker = other.m_invoker;
+        m_manager = other.m_manager;
+        other.m_invoker = nullptr;
+        other.m_manager = nullptr;
+    }
+};
+
+}
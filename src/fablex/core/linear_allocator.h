@@ -42,6 +42,20 @@ public:
         return nullptr;
     }
 
+    // Aligns the offset instead of the size, alignment must not exceed the buffer alignment passed to reserve()
+    uint8* allocate(uint64 size, uint64 alignment)
+    {
+        FE_CHECK(alignment <= m_alignment);
+
+        uint64 offset = align(m_offset, alignment);
+        if (offset + size <= m_capacity)
+        {
+            m_offset = offset + size;
+            return &m_buffer[offset];
+        }
+        return nullptr;
+    }
+
     void free(uint64 size)
     {
         size = align(size, m_alignment);
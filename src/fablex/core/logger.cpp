@@ -0,0 +1,359 @@
+#include "logger.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace fe
+{
+
+constexpr uint64 g_logRecordCount = 1024;
+constexpr uint32 g_logInlineTextSize = 200;
+constexpr uint64 g_logBatchSize = 64 * 1024;
+
+struct LogTypeInfo
+{
+    fmt::color color;
+    const char* strName;
+};
+
+constexpr std::array<LogTypeInfo, 5> g_logTypeInfos = {{
+    {fmt::color::white_smoke, "INFO"},
+    {fmt::color::lime_green, "SUCCESS"},
+    {fmt::color::orchid, "WARNING"},
+    {fmt::color::red, "ERROR"},
+    {fmt::color::dark_red, "FATAL"}
+}};
+
+struct LogLine
+{
+    const char* categoryName;
+    fmt::color categoryColor;
+    FELogType logType;
+    std::string_view text;
+};
+
+// Console and file output. Lines are formatted into batches, so the background thread does one write per batch.
+class LogSinks
+{
+public:
+    ~LogSinks()
+    {
+        close_file();
+    }
+
+    bool open_file(const std::string& path)
+    {
+        std::filesystem::path filePath(path);
+        if (filePath.has_parent_path())
+        {
+            std::error_code errorCode;
+            std::filesystem::create_directories(filePath.parent_path(), errorCode);
+        }
+
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (!file)
+            return false;
+
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        if (m_file)
+            std::fclose(m_file);
+        m_file = file;
+        return true;
+    }
+
+    void close_file()
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        if (m_file)
+        {
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+    }
+
+    static void format(const LogLine& line, fmt::memory_buffer& consoleBuffer, fmt::memory_buffer& fileBuffer)
+    {
+        const LogTypeInfo& logTypeInfo = g_logTypeInfos[line.logType];
+
+        fmt::format_to(fmt::appender(consoleBuffer), fg(line.categoryColor), "[{}]", line.categoryName);
+        fmt::format_to(fmt::appender(consoleBuffer), fg(logTypeInfo.color), "[{}]: ", logTypeInfo.strName);
+        fmt::format_to(fmt::appender(consoleBuffer), fg(logTypeInfo.color), "{}", line.text);
+        consoleBuffer.push_back('\n');
+
+        fmt::format_to(fmt::appender(fileBuffer), "[{}][{}]: {}\n", line.categoryName, logTypeInfo.strName, line.text);
+    }
+
+    void write(fmt::memory_buffer& consoleBuffer, fmt::memory_buffer& fileBuffer, bool shouldFlush)
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+
+        if (consoleBuffer.size())
+            std::fwrite(consoleBuffer.data(), 1, consoleBuffer.size(), stdout);
+
+        if (m_file && fileBuffer.size())
+            std::fwrite(fileBuffer.data(), 1, fileBuffer.size(), m_file);
+
+        if (shouldFlush)
+        {
+            std::fflush(stdout);
+            if (m_file)
+                std::fflush(m_file);
+        }
+
+        consoleBuffer.clear();
+        fileBuffer.clear();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::FILE* m_file = nullptr;
+};
+
+// Bounded multi-producer single-consumer ring of log records. A producer claims a record by advancing
+// the enqueue position and publishes it by storing the record sequence, so producers never take a lock.
+// When the ring is full, producers yield until the background thread frees records.
+class LogWriter
+{
+public:
+    LogWriter(LogSinks& sinks) : m_sinks(sinks)
+    {
+        for (uint64 i = 0; i != g_logRecordCount; ++i)
+            m_records[i].sequence.store(i, std::memory_order_relaxed);
+
+        m_thread = std::thread([this] { run(); });
+    }
+
+    ~LogWriter()
+    {
+        uint64 position = 0;
+        Record& record = acquire_record(position);
+        record.type = RecordType::STOP;
+        publish_record(record, position);
+
+        m_thread.join();
+    }
+
+    void push(const LogLine& line)
+    {
+        uint64 position = 0;
+        Record& record = acquire_record(position);
+
+        record.type = RecordType::MESSAGE;
+        record.line = line;
+
+        // Long messages are rare, they are the only case when logging allocates memory
+        uint32 textSize = uint32(line.text.size());
+        char* text = record.inlineText;
+        if (textSize > g_logInlineTextSize)
+        {
+            record.longText.reset(new char[textSize]);
+            text = record.longText.get();
+        }
+
+        std::memcpy(text, line.text.data(), textSize);
+        record.line.text = std::string_view(text, textSize);
+
+        publish_record(record, position);
+    }
+
+    void flush()
+    {
+        std::atomic_bool isFlushed = false;
+
+        uint64 position = 0;
+        Record& record = acquire_record(position);
+        record.type = RecordType::FLUSH;
+        record.isFlushed = &isFlushed;
+        publish_record(record, position);
+
+        isFlushed.wait(false, std::memory_order_acquire);
+    }
+
+private:
+    enum class RecordType : uint8
+    {
+        MESSAGE,
+        FLUSH,
+        STOP
+    };
+
+    struct alignas(64) Record
+    {
+        std::atomic<uint64> sequence{ 0 };
+        RecordType type = RecordType::MESSAGE;
+        LogLine line;
+        std::atomic_bool* isFlushed = nullptr;
+        std::unique_ptr<char[]> longText;
+        char inlineText[g_logInlineTextSize];
+    };
+
+    LogSinks& m_sinks;
+    std::unique_ptr<Record[]> m_records{ new Record[g_logRecordCount] };
+
+    alignas(64) std::atomic<uint64> m_enqueuePosition{ 0 };
+    // Used only by the background thread
+    alignas(64) uint64 m_dequeuePosition = 0;
+
+    std::thread m_thread;
+
+    Record& acquire_record(uint64& outPosition)
+    {
+        uint64 position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Record& record = m_records[position % g_logRecordCount];
+            int64 difference = int64(record.sequence.load(std::memory_order_acquire)) - int64(position);
+
+            if (difference == 0)
+            {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    outPosition = position;
+                    return record;
+                }
+            }
+            else
+            {
+                // Ring is full or another producer claimed the record
+                if (difference < 0)
+                    std::this_thread::yield();
+
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish_record(Record& record, uint64 position)
+    {
+        record.sequence.store(position + 1, std::memory_order_release);
+        m_enqueuePosition.notify_one();
+    }
+
+    void run()
+    {
+        fmt::memory_buffer consoleBuffer;
+        fmt::memory_buffer fileBuffer;
+
+        while (true)
+        {
+            Record& record = m_records[m_dequeuePosition % g_logRecordCount];
+
+            if (record.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1)
+            {
+                // Batch is written before waiting, so messages don't stay in buffers while nothing is logged
+                m_sinks.write(consoleBuffer, fileBuffer, true);
+
+                uint64 enqueuePosition = m_enqueuePosition.load(std::memory_order_acquire);
+                if (enqueuePosition == m_dequeuePosition)
+                    m_enqueuePosition.wait(enqueuePosition, std::memory_order_acquire);
+                else
+                    std::this_thread::yield();
+
+                continue;
+            }
+
+            RecordType recordType = record.type;
+
+            switch (recordType)
+            {
+            case RecordType::MESSAGE:
+                LogSinks::format(record.line, consoleBuffer, fileBuffer);
+                if (consoleBuffer.size() > g_logBatchSize)
+                    m_sinks.write(consoleBuffer, fileBuffer, false);
+                break;
+            case RecordType::FLUSH:
+                m_sinks.write(consoleBuffer, fileBuffer, true);
+                record.isFlushed->store(true, std::memory_order_release);
+                record.isFlushed->notify_all();
+                break;
+            case RecordType::STOP:
+                m_sinks.write(consoleBuffer, fileBuffer, true);
+                break;
+            }
+
+            record.longText.reset();
+            record.sequence.store(m_dequeuePosition + g_logRecordCount, std::memory_order_release);
+            ++m_dequeuePosition;
+
+            if (recordType == RecordType::STOP)
+                return;
+        }
+    }
+};
+
+std::atomic_bool g_isLogWriterDestroyed = false;
+
+LogSinks& get_log_sinks()
+{
+    static LogSinks sinks;
+    return sinks;
+}
+
+// Sinks are constructed before the writer, so they are destroyed after it
+struct LogWriterHolder
+{
+    LogWriter writer{ get_log_sinks() };
+
+    ~LogWriterHolder()
+    {
+        g_isLogWriterDestroyed.store(true);
+    }
+};
+
+LogWriter* get_log_writer()
+{
+    // Messages logged from destructors of static objects after the writer is destroyed are written synchronously
+    if (g_isLogWriterDestroyed.load(std::memory_order_relaxed))
+        return nullptr;
+
+    static LogWriterHolder writerHolder;
+    return &writerHolder.writer;
+}
+
+void write_log_line_sync(const LogLine& line)
+{
+    fmt::memory_buffer consoleBuffer;
+    fmt::memory_buffer fileBuffer;
+    LogSinks::format(line, consoleBuffer, fileBuffer);
+    get_log_sinks().write(consoleBuffer, fileBuffer, true);
+}
+
+}
+
+bool FELogger::open_log_file(const std::string& path)
+{
+    return fe::get_log_sinks().open_file(path);
+}
+
+void FELogger::close_log_file()
+{
+    flush();
+    fe::get_log_sinks().close_file();
+}
+
+void FELogger::flush()
+{
+    if (fe::LogWriter* writer = fe::get_log_writer())
+        writer->flush();
+}
+
+void FELogger::push(const Message& message)
+{
+    fe::LogLine line{ message.categoryName, message.categoryColor, message.logType, message.text };
+
+    if (fe::LogWriter* writer = fe::get_log_writer())
+        writer->push(line);
+    else
+        fe::write_log_line_sync(line);
+}
+
+void FELogger::write_fatal(const Message& message)
+{
+    flush();
+    fe::write_log_line_sync({ message.categoryName, message.categoryColor, message.logType, message.text });
+}
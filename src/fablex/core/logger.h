@@ -1,11 +1,14 @@
 #pragma once
 
+#include "types.h"
+
 #include "fmt/base.h"
 #include "fmt/color.h"
 #include "fmt/core.h"
 
 #include <array>
-#include <random>
+#include <atomic>
+#include <string>
 #include <string_view>
 
 enum FELogType
@@ -17,83 +20,118 @@ enum FELogType
     FATAL
 };
 
-#define FE_DEFINE_LOG_CATEGORY(CategoryName)               \
-struct CategoryName                                        \
-{                                                          \
-    constexpr static const char* name = #CategoryName;     \
-    inline static fmt::color color = fmt::color::black;    \
+// Logs with a lower type are compiled out. Release builds strip INFO unless the minimum type is set explicitly.
+#ifndef FE_LOG_MIN_TYPE
+    #ifdef NDEBUG
+        #define FE_LOG_MIN_TYPE SUCCESS
+    #else
+        #define FE_LOG_MIN_TYPE INFO
+    #endif
+#endif
+
+constexpr std::array<fmt::color, 18> g_logCategoryColors = {
+    fmt::color::aqua,
+    fmt::color::aquamarine,
+    fmt::color::blue_violet,
+    fmt::color::burly_wood,
+    fmt::color::cadet_blue,
+    fmt::color::chartreuse,
+    fmt::color::coral,
+    fmt::color::cornflower_blue,
+    fmt::color::crimson,
+    fmt::color::cyan,
+    fmt::color::dark_salmon,
+    fmt::color::dark_sea_green,
+    fmt::color::deep_sky_blue,
+    fmt::color::light_sea_green,
+    fmt::color::medium_orchid,
+    fmt::color::plum,
+    fmt::color::tomato,
+    fmt::color::yellow_green
+};
+
+// Color is picked from the hash of the category name, so a category has the same color in every run
+constexpr fmt::color get_log_category_color(std::string_view categoryName)
+{
+    uint32 hash = 2166136261u;
+    for (char c : categoryName)
+        hash = (hash ^ uint8(c)) * 16777619u;
+
+    return g_logCategoryColors[hash % g_logCategoryColors.size()];
+}
+
+#define FE_DEFINE_LOG_CATEGORY(CategoryName)                                            \
+struct CategoryName                                                                     \
+{                                                                                       \
+    constexpr static const char* name = #CategoryName;                                  \
+    constexpr static fmt::color color = get_log_category_color(#CategoryName);          \
+    inline static std::atomic<FELogType> minLogType{ INFO };                            \
 };
 
 FE_DEFINE_LOG_CATEGORY(LogDefault)
 
-#define FE_LOG(LogCategory, LogType, Message, ...) FELogger::log<LogCategory, LogType>(Message, ##__VA_ARGS__)
+#define FE_LOG(LogCategory, LogType, Message, ...)                                      \
+    do                                                                                  \
+    {                                                                                   \
+        if constexpr (LogType >= FE_LOG_MIN_TYPE)                                       \
+            FELogger::log<LogCategory, LogType>(Message, ##__VA_ARGS__);                \
+    } while (0)
 
+// Formats messages on the calling thread and passes them to a background thread through a lock-free ring buffer.
+// The background thread writes them to the console and to the log file. FATAL messages are written synchronously
+// after all previous messages, then the process is aborted.
 class FELogger
 {
 public:
     template<typename LogCategory, FELogType LogType, typename... Params>
     static void log(std::string_view msg, Params... params)
     {
-        set_log_category_color<LogCategory>();
-        fmt::print(fg(LogCategory::color), "[{}]", LogCategory::name);
+        if (LogType != FATAL && LogType < LogCategory::minLogType.load(std::memory_order_relaxed))
+            return;
+
+        fmt::memory_buffer buffer;
+        fmt::format_to(fmt::appender(buffer), fmt::runtime(msg), params...);
 
-        const LogTypeInfo& logTypeInfo = s_logTypeInfos[LogType];
-        fmt::print(fg(logTypeInfo.color), "[{}]: ", logTypeInfo.strName);
-        fmt::print(fg(logTypeInfo.color), fmt::runtime(msg), params...);
-        fmt::print("\n");
+        Message message;
+        message.categoryName = LogCategory::name;
+        message.categoryColor = LogCategory::color;
+        message.logType = LogType;
+        message.text = std::string_view(buffer.data(), buffer.size());
 
-        if (LogType == FELogType::FATAL)
+        if constexpr (LogType == FELogType::FATAL)
+        {
+            write_fatal(message);
             abort();
+        }
+        else
+        {
+            push(message);
+        }
     }
 
-private:
-    constexpr static std::array<fmt::color, 18> s_logCategoryColors = {
-        fmt::color::aqua,
-        fmt::color::aquamarine,
-        fmt::color::blue_violet,
-        fmt::color::burly_wood,
-        fmt::color::cadet_blue,
-        fmt::color::chartreuse,
-        fmt::color::coral,
-        fmt::color::cornflower_blue,
-        fmt::color::crimson,
-        fmt::color::cyan,
-        fmt::color::dark_salmon,
-        fmt::color::dark_sea_green,
-        fmt::color::deep_sky_blue,
-        fmt::color::light_sea_green,
-        fmt::color::medium_orchid,
-        fmt::color::plum,
-        fmt::color::tomato,
-        fmt::color::yellow_green
-    };
-
-    struct LogTypeInfo
+    // Runtime filter, messages of the category with a lower type are skipped. FATAL messages are never skipped.
+    template<typename LogCategory>
+    static void set_min_log_type(FELogType logType)
     {
-        fmt::color color;
-        const char* strName;
-    };
+        LogCategory::minLogType.store(logType, std::memory_order_relaxed);
+    }
 
-    constexpr static std::array<LogTypeInfo, 5> s_logTypeInfos = {{
-        {fmt::color::white_smoke, "INFO"},
-        {fmt::color::lime_green, "SUCCESS"},
-        {fmt::color::orchid, "WARNING"},
-        {fmt::color::red, "ERROR"},
-        {fmt::color::dark_red, "FATAL"}
-    }};
+    // Messages are appended to the file in addition to the console. Returns false if the file can't be opened.
+    static bool open_log_file(const std::string& path);
+    static void close_log_file();
 
-    template<typename LogCategory>
-    static void set_log_category_color()
-    {
-        if (LogCategory::color != fmt::color::black)
-        {
-            return;
-        }
+    // Waits until all messages logged before the call are written
+    static void flush();
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<size_t> dist(0, s_logCategoryColors.size() - 1);
+private:
+    struct Message
+    {
+        const char* categoryName;
+        fmt::color categoryColor;
+        FELogType logType;
+        std::string_view text;
+    };
 
-        LogCategory::color = s_logCategoryColors[dist(gen)];
-    }
+    static void push(const Message& message);
+    static void write_fatal(const Message& message);
 };
@@ -12,9 +12,9 @@ T* memory_new(Params... params)
     return new(MemoryUtils::allocate_aligned_memory(sizeof(T), alignof(T))) T(params...);
 }
 
-inline void* memory_new(uint64 size, uint64 alignment)
+inline void* memory_new(uint64 size, uint64 alignment, MemoryTag memoryTag = MemoryTag::UNTAGGED)
 {
-    return MemoryUtils::allocate_aligned_memory(size, alignment);
+    return MemoryUtils::allocate_aligned_memory(size, alignment, memoryTag);
 }
 
 template<typename T>
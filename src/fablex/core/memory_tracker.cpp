@@ -0,0 +1,89 @@
+#include "memory_tracker.h"
+#include "logger.h"
+
+#include <fstream>
+
+FE_DEFINE_LOG_CATEGORY(LogMemoryTracker)
+
+namespace fe
+{
+
+constexpr std::array<const char*, MemoryTracker::s_tagCount> g_memoryTagNames = {
+    "Untagged",
+    "Assets/Models",
+    "Assets/Textures",
+    "Renderer/SceneBuffers",
+    "ECS",
+    "Tasks"
+};
+
+const char* MemoryTracker::get_tag_name(MemoryTag tag)
+{
+    FE_CHECK(tag < MemoryTag::COUNT);
+    return g_memoryTagNames[uint32(tag)];
+}
+
+#ifdef FE_MEMORY_TRACKING
+
+std::array<MemoryTracker::TagCounters, MemoryTracker::s_tagCount> MemoryTracker::s_tagCounters{};
+
+MemoryTracker::TagStats MemoryTracker::get_tag_stats(MemoryTag tag)
+{
+    const TagCounters& counters = s_tagCounters[uint32(tag)];
+
+    TagStats tagStats;
+    tagStats.tagName = get_tag_name(tag);
+    tagStats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    tagStats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    tagStats.liveAllocationCount = counters.liveAllocationCount.load(std::memory_order_relaxed);
+    tagStats.totalAllocationCount = counters.totalAllocationCount.load(std::memory_order_relaxed);
+    return tagStats;
+}
+
+uint32 MemoryTracker::report_leaks()
+{
+    uint32 leakedTagCount = 0;
+
+    for (uint32 tagIndex = uint32(MemoryTag::UNTAGGED) + 1; tagIndex != s_tagCount; ++tagIndex)
+    {
+        TagStats tagStats = get_tag_stats(MemoryTag(tagIndex));
+        if (!tagStats.liveAllocationCount)
+            continue;
+
+        FE_LOG(LogMemoryTracker, WARNING, "{}: {} allocations, {} bytes are not freed",
+            tagStats.tagName, tagStats.liveAllocationCount, tagStats.liveBytes);
+        ++leakedTagCount;
+    }
+
+    if (!leakedTagCount)
+        FE_LOG(LogMemoryTracker, INFO, "No tagged memory leaks");
+
+    return leakedTagCount;
+}
+
+bool MemoryTracker::export_report(const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        FE_LOG(LogMemoryTracker, ERROR, "MemoryTracker::export_report(): Failed to open {}", path);
+        return false;
+    }
+
+    file << "{\"tags\":[";
+    for (uint32 tagIndex = 0; tagIndex != s_tagCount; ++tagIndex)
+    {
+        TagStats tagStats = get_tag_stats(MemoryTag(tagIndex));
+        file << fmt::format("{}\n{{\"name\":\"{}\",\"liveBytes\":{},\"peakBytes\":{},\"liveAllocations\":{},\"totalAllocations\":{}}}",
+            tagIndex ? "," : "", tagStats.tagName, tagStats.liveBytes, tagStats.peakBytes,
+            tagStats.liveAllocationCount, tagStats.totalAllocationCount);
+    }
+    file << "\n]}\n";
+
+    FE_LOG(LogMemoryTracker, INFO, "Exported memory report to {}", path);
+    return true;
+}
+
+#endif
+
+}
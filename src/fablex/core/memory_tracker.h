@@ -0,0 +1,98 @@
+#pragma once
+
+#include "types.h"
+#include "macro.h"
+
+#include <array>
+#include <atomic>
+#include <string>
+
+// Tracking is compiled out in shipping builds, MemoryTracker functions become empty and allocations don't carry a header
+#ifndef FE_SHIPPING
+    #define FE_MEMORY_TRACKING
+#endif
+
+namespace fe
+{
+
+enum class MemoryTag : uint8
+{
+    UNTAGGED,
+    ASSETS_MODELS,
+    ASSETS_TEXTURES,
+    RENDERER_SCENE_BUFFERS,
+    ECS,
+    TASKS,
+
+    COUNT
+};
+
+// Counts live and peak bytes of tagged allocations. MemoryUtils reports aligned allocations, pools report their objects
+// and the RHI reports buffers created with a tag. Counters are atomic, so allocations can be tracked from any thread.
+class MemoryTracker
+{
+public:
+    constexpr static uint32 s_tagCount = uint32(MemoryTag::COUNT);
+
+    struct TagStats
+    {
+        const char* tagName = nullptr;
+        uint64 liveBytes = 0;
+        uint64 peakBytes = 0;
+        uint64 liveAllocationCount = 0;
+        uint64 totalAllocationCount = 0;
+    };
+
+    static const char* get_tag_name(MemoryTag tag);
+
+#ifdef FE_MEMORY_TRACKING
+    // Size is the total size of all allocations
+    static void on_allocate(MemoryTag tag, uint64 size, uint64 allocationCount = 1)
+    {
+        TagCounters& counters = s_tagCounters[uint32(tag)];
+        uint64 liveBytes = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        counters.liveAllocationCount.fetch_add(allocationCount, std::memory_order_relaxed);
+        counters.totalAllocationCount.fetch_add(allocationCount, std::memory_order_relaxed);
+
+        uint64 peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+        while (peakBytes < liveBytes && !counters.peakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed));
+    }
+
+    static void on_free(MemoryTag tag, uint64 size, uint64 allocationCount = 1)
+    {
+        TagCounters& counters = s_tagCounters[uint32(tag)];
+        counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+        counters.liveAllocationCount.fetch_sub(allocationCount, std::memory_order_relaxed);
+    }
+
+    static TagStats get_tag_stats(MemoryTag tag);
+
+    // Logs every tag except UNTAGGED that has live allocations and returns the number of such tags.
+    // Untagged memory is skipped because static pools and queues release it after Core::cleanup().
+    static uint32 report_leaks();
+
+    // Writes stats of all tags as JSON. Returns false if the file can't be opened.
+    static bool export_report(const std::string& path);
+#else
+    static void on_allocate(MemoryTag tag, uint64 size, uint64 allocationCount = 1) { }
+    static void on_free(MemoryTag tag, uint64 size, uint64 allocationCount = 1) { }
+    static TagStats get_tag_stats(MemoryTag tag) { return TagStats{ get_tag_name(tag) }; }
+    static uint32 report_leaks() { return 0; }
+    static bool export_report(const std::string& path) { return false; }
+#endif
+
+private:
+    struct alignas(64) TagCounters
+    {
+        std::atomic<uint64> liveBytes{ 0 };
+        std::atomic<uint64> peakBytes{ 0 };
+        std::atomic<uint64> liveAllocationCount{ 0 };
+        std::atomic<uint64> totalAllocationCount{ 0 };
+    };
+
+#ifdef FE_MEMORY_TRACKING
+    static std::array<TagCounters, s_tagCount> s_tagCounters;
+#endif
+};
+
+}
@@ -1,24 +1,84 @@
 #include "memory_utils.h"
 
+#include <algorithm>
+#include <cstdint>
+
 #ifdef _WIN32
 	#include <malloc.h>
+#else
+	#include <cstdlib>
 #endif
 
 namespace fe
 {
 
-void* MemoryUtils::allocate_aligned_memory(size_t size, size_t alignment)
+#ifdef FE_MEMORY_TRACKING
+
+// Stored right before the returned pointer, so free_aligned_memory() knows what to untrack
+struct AllocationHeader
+{
+	uint64 size;
+	uint32 headerSize;
+	MemoryTag memoryTag;
+};
+
+#endif
+
+void* allocate_platform_memory(size_t size, size_t alignment)
 {
 #if defined(_WIN32)
 	return _aligned_malloc(size, alignment);
+#else
+	alignment = std::max(alignment, sizeof(void*));
+	return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
 #endif
 }
 
-void MemoryUtils::free_aligned_memory(void* ptr)
+void free_platform_memory(void* ptr)
 {
 #if defined(_WIN32)
 	_aligned_free(ptr);
+#else
+	std::free(ptr);
 #endif
 }
 
-}
\ No newline at end of file
+void* MemoryUtils::allocate_aligned_memory(size_t size, size_t alignment, MemoryTag memoryTag)
+{
+#ifdef FE_MEMORY_TRACKING
+	// Header takes a whole alignment unit, so the returned pointer keeps the requested alignment
+	alignment = std::max(alignment, alignof(AllocationHeader));
+	size_t headerSize = std::max(alignment, sizeof(AllocationHeader));
+
+	uint8* memory = static_cast<uint8*>(allocate_platform_memory(size + headerSize, alignment));
+	if (!memory)
+		return nullptr;
+
+	uint8* ptr = memory + headerSize;
+	AllocationHeader* header = reinterpret_cast<AllocationHeader*>(ptr) - 1;
+	header->size = size;
+	header->headerSize = uint32(headerSize);
+	header->memoryTag = memoryTag;
+
+	MemoryTracker::on_allocate(memoryTag, size);
+	return ptr;
+#else
+	return allocate_platform_memory(size, alignment);
+#endif
+}
+
+void MemoryUtils::free_aligned_memory(void* ptr)
+{
+#ifdef FE_MEMORY_TRACKING
+	if (!ptr)
+		return;
+
+	AllocationHeader* header = static_cast<AllocationHeader*>(ptr) - 1;
+	MemoryTracker::on_free(header->memoryTag, header->size);
+	free_platform_memory(static_cast<uint8*>(ptr) - header->headerSize);
+#else
+	free_platform_memory(ptr);
+#endif
+}
+
+}
@@ -1,12 +1,17 @@
 #pragma once
 
+#include "memory_tracker.h"
+
+#include <cstddef>
+
 namespace fe
 {
 
 class MemoryUtils
 {
 public:
-    static void* allocate_aligned_memory(size_t size, size_t alignment);
+    // When memory tracking is enabled, the allocation is counted under the tag until it is freed
+    static void* allocate_aligned_memory(size_t size, size_t alignment, MemoryTag memoryTag = MemoryTag::UNTAGGED);
     static void free_aligned_memory(void* ptr);
 };
 
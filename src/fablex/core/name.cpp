@@ -1,60 +1,36 @@
 #include "name.h"
 #include "macro.h"
-#include "name_registry.h"
+#include <charconv>
 
 namespace fe
 {
 
-Name::Name() : m_id(s_invalidID)
+Name::Name(const std::string& strName) : m_id(NameRegistry::to_id(strName))
 {
 
 }
 
-Name::Name(const std::string& strName) : m_id(s_invalidID)
-{
-    m_id = NameRegistry::to_id(strName);
-}
-
-Name::Name(const char* strName) : m_id(s_invalidID)
-{
-    m_id = NameRegistry::to_id(strName);
-}
-
-Name::Name(Name::ID id) : m_id(id)
-{
-
-}
-
-Name::Name(const Name& other) : m_id(other.m_id)
+Name::Name(const char* strName) : m_id(NameRegistry::to_id(strName))
 {
 
 }
 
-Name::Name(Name&& other) : m_id(other.m_id)
+Name::Name(std::string_view strName) : m_id(NameRegistry::to_id(strName))
 {
 
 }
 
-Name& Name::operator=(const Name& other)
+Name Name::with_suffix(std::string_view suffix) const
 {
-    m_id = other.m_id;
-    return *this;
-}
-
-Name& Name::operator=(Name&& other)
-{
-    m_id = other.m_id;
-    return *this;
-}
-
-bool Name::operator==(const Name& other) const
-{
-    return this->m_id == other.m_id;
+    FE_CHECK(is_valid());
+    return Name(NameRegistry::append(m_id, suffix));
 }
 
-bool Name::operator<(const Name& other) const
+Name Name::with_suffix(uint64 suffix) const
 {
-    return this->m_id < other.m_id;
+    char buffer[20];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), suffix);
+    return with_suffix(std::string_view(buffer, result.ptr - buffer));
 }
 
 const std::string& Name::to_string() const
@@ -63,15 +39,10 @@ const std::string& Name::to_string() const
     return NameRegistry::to_string(m_id);
 }
 
-Name::ID Name::to_id() const
+std::string_view Name::to_string_view() const
 {
     FE_CHECK(is_valid());
-    return m_id;
+    return NameRegistry::to_string_view(m_id);
 }
 
-bool Name::is_valid() const
-{
-    return m_id != s_invalidID;
 }
-
-}
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "types.h"
+#include "macro.h"
+#include "compile_time_hash.h"
+#include "name_registry.h"
 #include "fmt/format.h"
 #include <string>
+#include <string_view>
 
 namespace fe
 {
@@ -10,32 +14,69 @@ namespace fe
 class Name
 {
 public:
-    using ID = uint32;
-    static constexpr ID s_invalidID = ~0u;
+    // 64-bit FNV-1a hash of the string, so names are compared and hashed without the registry
+    using ID = uint64;
+    static constexpr ID s_invalidID = ~0ull;
 
-    Name();
+    constexpr Name() = default;
     Name(const std::string& strName);
     Name(const char* strName);
-    explicit Name(ID id);
-    
-    Name(const Name& other);
-    Name(Name&& other);
+    Name(std::string_view strName);
+    constexpr explicit Name(ID id) : m_id(id) { }
 
-    Name& operator=(const Name& other);
-    Name& operator=(Name&& other);
+    constexpr bool operator==(const Name& other) const { return m_id == other.m_id; }
+    constexpr bool operator<(const Name& other) const { return m_id < other.m_id; }
 
-    bool operator==(const Name& other) const;
-    bool operator<(const Name& other) const;
+    // Faster than creating a name from a concatenated string, the string is built only when the name is seen for the first time
+    Name with_suffix(std::string_view suffix) const;
+    // Appends the decimal number without allocating a string, for example frame or mip indices
+    Name with_suffix(uint64 suffix) const;
 
     const std::string& to_string() const;
-    ID to_id() const;
+    std::string_view to_string_view() const;
 
-    bool is_valid() const;
+    constexpr ID to_id() const
+    {
+        FE_CHECK(is_valid());
+        return m_id;
+    }
+
+    constexpr bool is_valid() const { return m_id != s_invalidID; }
 
 private:
-    ID m_id;
+    ID m_id = s_invalidID;
+};
+
+template<size_t Length>
+struct NameLiteral
+{
+    char str[Length];
+
+    constexpr NameLiteral(const char (&inStr)[Length])
+    {
+        for (size_t i = 0; i != Length; ++i)
+            str[i] = inStr[i];
+    }
+
+    constexpr std::string_view view() const { return std::string_view(str, Length - 1); }
+};
+
+// Registers the string of each literal once during static initialization
+template<NameLiteral Literal>
+struct NameLiteralRegistration
+{
+    inline static const bool isRegistered = NameRegistry::register_name(fnv1a_64(Literal.view()), Literal.view());
 };
 
+// Name that is resolved at compile time, for example "SwapChainPass"_name
+template<NameLiteral Literal>
+constexpr Name operator""_name()
+{
+    // Taking the address instantiates the registration without making the literal a runtime expression
+    (void)&NameLiteralRegistration<Literal>::isRegistered;
+    return Name(fnv1a_64(Literal.view()));
+}
+
 }
 
 namespace std
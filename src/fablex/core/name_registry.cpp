@@ -1,25 +1,175 @@
 #include "name_registry.h"
+#include "compile_time_hash.h"
+#include "macro.h"
 
 namespace fe
 {
 
-uint32 NameRegistry::to_id(const std::string& strName)
+constexpr uint32 g_invalidEntryIndex = ~0u;
+
+std::array<NameRegistry::Shard, NameRegistry::s_shardCount> NameRegistry::s_shards{};
+std::array<std::atomic<NameRegistry::Entry*>, NameRegistry::s_maxChunkCount> NameRegistry::s_chunks{};
+std::atomic<uint32> NameRegistry::s_nameCount{ 0 };
+
+uint64 pack_slot(uint32 entryIndex, uint32 idTag)
+{
+    return (uint64(idTag) << 32) | (entryIndex + 1);
+}
+
+uint64 NameRegistry::to_id(std::string_view strName)
+{
+    uint64 id = fnv1a_64(strName);
+    register_name(id, strName);
+    return id;
+}
+
+uint64 NameRegistry::append(uint64 baseID, std::string_view suffix)
 {
-    auto it = s_nameToId.find(strName);
-    if (it != s_nameToId.end())
+    uint64 id = fnv1a_64(suffix, baseID);
+
+    // Strings are concatenated only the first time, later calls cost one hash of the suffix and one lookup
+    if (!contains(id))
+        register_name(id, to_string(baseID) + std::string(suffix));
+
+    FE_CHECK_MSG(to_string(id) == to_string(baseID) + std::string(suffix), "Name hash collision");
+    return id;
+}
+
+bool NameRegistry::register_name(uint64 id, std::string_view strName)
+{
+    Shard& shard = get_shard(id);
+
+    uint32 entryIndex = find(shard.table.load(std::memory_order_acquire), id);
+    if (entryIndex == g_invalidEntryIndex)
     {
-        return it->second;
+        std::scoped_lock<std::mutex> lock(shard.mutex);
+
+        // Another thread could add the same name while this one was waiting for the lock
+        entryIndex = find(shard.table.load(std::memory_order_relaxed), id);
+        if (entryIndex == g_invalidEntryIndex)
+            entryIndex = add_entry(shard, id, strName);
     }
 
-    s_idToName.push_back(strName);
-    s_nameToId[strName] = s_idToName.size() - 1;
+    FE_CHECK_MSG(get_entry(entryIndex).string == strName, "Name hash collision");
+    return true;
+}
+
+const std::string& NameRegistry::to_string(uint64 id)
+{
+    uint32 entryIndex = find(get_shard(id).table.load(std::memory_order_acquire), id);
+
+    if (entryIndex == g_invalidEntryIndex)
+    {
+        FE_CHECK_MSG(0, "Name is not registered");
+        static const std::string emptyString;
+        return emptyString;
+    }
+
+    return get_entry(entryIndex).string;
+}
 
-    return (uint32)s_idToName.size() - 1;
+bool NameRegistry::contains(uint64 id)
+{
+    return find(get_shard(id).table.load(std::memory_order_acquire), id) != g_invalidEntryIndex;
 }
 
-const std::string& NameRegistry::to_string(uint32 id)
+const NameRegistry::Entry& NameRegistry::get_entry(uint32 entryIndex)
 {
-    return s_idToName.at(id);
+    const Entry* chunk = s_chunks[entryIndex / s_chunkSize].load(std::memory_order_acquire);
+    FE_CHECK(chunk);
+
+    return chunk[entryIndex % s_chunkSize];
 }
 
-}
\ No newline at end of file
+uint32 NameRegistry::find(const Table* table, uint64 id)
+{
+    if (!table)
+        return g_invalidEntryIndex;
+
+    uint32 idTag = uint32(id);
+    uint32 mask = table->capacity - 1;
+
+    for (uint32 index = idTag & mask; ; index = (index + 1) & mask)
+    {
+        uint64 slot = table->slots[index].load(std::memory_order_acquire);
+        if (!slot)
+            return g_invalidEntryIndex;
+
+        uint32 entryIndex = uint32(slot) - 1;
+        if (uint32(slot >> 32) == idTag && get_entry(entryIndex).id == id)
+            return entryIndex;
+    }
+}
+
+void NameRegistry::insert(Table* table, uint32 entryIndex, uint32 idTag)
+{
+    uint32 mask = table->capacity - 1;
+    uint32 index = idTag & mask;
+
+    while (table->slots[index].load(std::memory_order_relaxed))
+        index = (index + 1) & mask;
+
+    table->slots[index].store(pack_slot(entryIndex, idTag), std::memory_order_release);
+}
+
+uint32 NameRegistry::add_entry(Shard& shard, uint64 id, std::string_view strName)
+{
+    uint32 entryIndex = s_nameCount.load(std::memory_order_relaxed);
+
+    // Entries are shared by all shards, so indices are reserved with CAS to keep s_nameCount equal to the number of stored strings
+    Entry* chunk = nullptr;
+    while (true)
+    {
+        FE_CHECK(entryIndex / s_chunkSize < s_maxChunkCount);
+
+        std::atomic<Entry*>& chunkPtr = s_chunks[entryIndex / s_chunkSize];
+        chunk = chunkPtr.load(std::memory_order_acquire);
+        if (!chunk)
+        {
+            Entry* newChunk = new Entry[s_chunkSize];
+            if (chunkPtr.compare_exchange_strong(chunk, newChunk, std::memory_order_acq_rel))
+                chunk = newChunk;
+            else
+                delete[] newChunk;
+        }
+
+        if (s_nameCount.compare_exchange_weak(entryIndex, entryIndex + 1, std::memory_order_relaxed))
+            break;
+    }
+
+    Entry& entry = chunk[entryIndex % s_chunkSize];
+    entry.id = id;
+    entry.string = strName;
+
+    Table* table = shard.table.load(std::memory_order_relaxed);
+
+    // Load factor is kept below 0.5, the new table is filled before it is published
+    if (!table || (shard.nameCount + 1) * 2 > table->capacity)
+    {
+        Table* newTable = new Table();
+        newTable->capacity = table ? table->capacity * 2 : s_initialTableCapacity;
+        newTable->slots.reset(new std::atomic<uint64>[newTable->capacity]());
+
+        if (table)
+        {
+            for (uint32 i = 0; i != table->capacity; ++i)
+            {
+                uint64 slot = table->slots[i].load(std::memory_order_relaxed);
+                if (slot)
+                    insert(newTable, uint32(slot) - 1, uint32(slot >> 32));
+            }
+
+            newTable->previousTable = table;
+        }
+
+        shard.table.store(newTable, std::memory_order_release);
+        table = newTable;
+    }
+
+    insert(table, entryIndex, uint32(id));
+    ++shard.nameCount;
+
+    return entryIndex;
+}
+
+}
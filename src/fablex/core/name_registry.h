@@ -1,22 +1,75 @@
 #pragma once
 
 #include "types.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <vector>
-#include "unordered_map"
+#include <string_view>
 
 namespace fe
 {
 
+// Maps Name ids, 64-bit FNV-1a hashes of strings, back to strings. Names don't need the registry to be compared or hashed,
+// it is only used to get strings and to keep them for names created at runtime.
+// Lookups are lock-free, new strings are inserted under one of s_shardCount mutexes.
+// Strings are never moved or freed, so references returned by to_string() stay valid until the process exits.
+// In debug builds, registering two different strings with the same hash triggers FE_CHECK.
+// All state is constant initialized, so names can be registered during static initialization of any translation unit.
 class NameRegistry
 {
 public:
-    static uint32 to_id(const std::string& strName);
-    static const std::string& to_string(uint32 id);
+    static uint64 to_id(std::string_view strName);
+    // Id of the name that is the base name followed by the suffix
+    static uint64 append(uint64 baseID, std::string_view suffix);
+
+    static bool register_name(uint64 id, std::string_view strName);
+
+    // Wait-free
+    static const std::string& to_string(uint64 id);
+    static std::string_view to_string_view(uint64 id) { return to_string(id); }
+
+    static bool contains(uint64 id);
+    static uint32 get_name_count() { return s_nameCount.load(std::memory_order_acquire); }
 
 private:
-    inline static std::unordered_map<std::string, uint32> s_nameToId{};
-    inline static std::vector<std::string> s_idToName{};
+    constexpr static uint32 s_shardCount = 64;
+    constexpr static uint32 s_initialTableCapacity = 64;
+    constexpr static uint32 s_chunkSize = 4096;
+    constexpr static uint32 s_maxChunkCount = 4096;
+
+    struct Entry
+    {
+        uint64 id = 0;
+        std::string string;
+    };
+
+    // Open addressing table, each slot packs the low 32 bits of the id and entry index + 1. Zero slot is empty.
+    struct Table
+    {
+        uint32 capacity = 0;
+        std::unique_ptr<std::atomic<uint64>[]> slots;
+        // Replaced table can still be read by concurrent lookups, so it is kept alive
+        Table* previousTable = nullptr;
+    };
+
+    struct alignas(64) Shard
+    {
+        std::mutex mutex;
+        std::atomic<Table*> table{ nullptr };
+        uint32 nameCount = 0;
+    };
+
+    static std::array<Shard, s_shardCount> s_shards;
+    static std::array<std::atomic<Entry*>, s_maxChunkCount> s_chunks;
+    static std::atomic<uint32> s_nameCount;
+
+    static Shard& get_shard(uint64 id) { return s_shards[id >> 58]; }
+    static const Entry& get_entry(uint32 entryIndex);
+    static uint32 find(const Table* table, uint64 id);
+    static void insert(Table* table, uint32 entryIndex, uint32 idTag);
+    static uint32 add_entry(Shard& shard, uint64 id, std::string_view strName);
 };
 
-}
\ No newline at end of file
+}
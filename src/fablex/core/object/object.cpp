@@ -1,4 +1,5 @@
 #include "object.h"
+#include "property_layout.h"
 #include "core/file_system/archive.h"
 
 namespace fe
@@ -9,11 +10,13 @@ FE_DEFINE_ROOT_OBJECT(Object);
 void Object::serialize(Archive& archive) const
 {
     FE_CHECK(archive.is_write_mode());
+    get_type_info()->get_property_layout().serialize(this, archive);
 }
 
 void Object::deserialize(Archive& archive)
 {
     FE_CHECK(archive.is_read_mode());
+    get_type_info()->get_property_layout().deserialize(this, archive);
 }
 
 }
\ No newline at end of file
@@ -94,7 +94,9 @@ T* create_object()
 
 inline Object* create_object(Name name)
 {
-    return TypeManager::create_object_by_name(name.to_string().c_str());
+    const TypeInfo* typeInfo = TypeManager::get_type_info(name);
+    FE_CHECK(typeInfo);
+    return TypeManager::create_object(typeInfo);
 }
 
 inline void destroy_object(Object* object)
@@ -144,6 +144,7 @@ public:
     virtual uint64 get_offset() const override { return 0; }
     virtual uint64 get_size() const override { return 0; }
     virtual uint64 get_element_count(Object* object) const { return 0; }
+    virtual void resize(Object* object, uint64 elementCount) { }
     virtual void* get_data(Object* object) { return nullptr; }
     virtual const void* get_data(Object* object) const { return nullptr; }
     
@@ -276,6 +277,10 @@ constexpr auto setup_attributes(Attrs&&... attrs)
         {                                                                                           \
             return get_array<ValueType>(object).size();                                             \
         }                                                                                           \
+        virtual void resize(Object* object, uint64 elementCount) override                           \
+        {                                                                                           \
+            get_array<ValueType>(object).resize(elementCount);                                      \
+        }                                                                                           \
         FE_DEFINE_ATTR_METHODS(__VA_ARGS__)                                                         \
         virtual void* get_array_value_internal(Object* object, uint64 index) const override         \
         {                                                                                           \
@@ -0,0 +1,252 @@
+#include "property_layout.h"
+#include "property.h"
+#include "type_info.h"
+#include "core/compile_time_hash.h"
+#include <algorithm>
+
+namespace fe
+{
+
+bool is_trivially_copyable_property(PropertyType type)
+{
+    return type != PropertyType::STRING && type != PropertyType::ARRAY;
+}
+
+bool is_same_field(const Archive::FieldDescriptor& first, const Archive::FieldDescriptor& second)
+{
+    return first.nameHash == second.nameHash
+        && first.size == second.size
+        && first.type == second.type
+        && first.valueType == second.valueType;
+}
+
+PropertyLayout::PropertyLayout(const TypeInfo* typeInfo) : m_typeInfo(typeInfo)
+{
+    FE_CHECK(typeInfo);
+
+    std::vector<const TypeInfo*> typeInfos;
+    for (const TypeInfo* it = typeInfo; it != nullptr; it = it->get_base_type_info())
+        typeInfos.push_back(it);
+
+    // TypeInfo stores only properties of its own type, base properties go first
+    for (auto it = typeInfos.rbegin(); it != typeInfos.rend(); ++it)
+        for (Property* property : (*it)->get_properties())
+            m_properties.push_back(property);
+
+    auto variableSizeBegin = std::stable_partition(m_properties.begin(), m_properties.end(), [](const Property* property)
+    {
+        return is_trivially_copyable_property(property->get_type());
+    });
+
+    std::stable_sort(m_properties.begin(), variableSizeBegin, [](const Property* first, const Property* second)
+    {
+        return first->get_offset() < second->get_offset();
+    });
+
+    m_trivialPropertyCount = variableSizeBegin - m_properties.begin();
+
+    for (uint64 i = 0; i != m_trivialPropertyCount; ++i)
+    {
+        const Property* property = m_properties[i];
+        if (!m_spans.empty() && m_spans.back().offset + m_spans.back().size == property->get_offset())
+            m_spans.back().size += property->get_size();
+        else
+            m_spans.push_back({ property->get_offset(), property->get_size() });
+    }
+
+    for (Property* property : m_properties)
+    {
+        Archive::FieldDescriptor& fieldDescriptor = m_fieldDescriptors.emplace_back();
+        fieldDescriptor.nameHash = fnv1a_64(property->get_name());
+        // Size of an array field is the size of its element
+        fieldDescriptor.size = (uint32)property->get_size();
+        fieldDescriptor.type = (uint8)property->get_type();
+        fieldDescriptor.valueType = property->get_type() == PropertyType::ARRAY
+            ? (uint8)static_cast<const ArrayProperty*>(property)->get_value_type()
+            : fieldDescriptor.type;
+    }
+
+    m_hash = fnv1a_64(std::string_view(
+        reinterpret_cast<const char*>(m_fieldDescriptors.data()),
+        m_fieldDescriptors.size() * sizeof(Archive::FieldDescriptor)
+    ));
+}
+
+void PropertyLayout::serialize(const Object* object, Archive& archive) const
+{
+    FE_CHECK(object);
+
+    // Types without properties don't write anything, so archives of such types don't depend on the layout
+    if (is_empty())
+        return;
+
+    // Descriptors are written only with the first object of the layout, the flag lets readers skip the lookup
+    const bool isNewLayout = archive.add_field_layout(m_hash, m_fieldDescriptors);
+    archive << m_hash << uint8(isNewLayout);
+
+    if (isNewLayout)
+    {
+        archive << m_fieldDescriptors.size();
+        archive.write_bytes(m_fieldDescriptors.data(), m_fieldDescriptors.size() * sizeof(Archive::FieldDescriptor));
+    }
+
+    const uint8* objectData = reinterpret_cast<const uint8*>(object);
+    for (const Span& span : m_spans)
+        archive.write_bytes(objectData + span.offset, span.size);
+
+    for (uint64 i = m_trivialPropertyCount; i != m_properties.size(); ++i)
+        write_variable_size_property(object, m_properties[i], archive);
+}
+
+void PropertyLayout::deserialize(Object* object, Archive& archive) const
+{
+    FE_CHECK(object);
+
+    // Older archives have no property block, types read their fields in the old order themselves
+    if (is_empty() || archive.get_version() < Archive::s_propertyLayoutVersion)
+        return;
+
+    uint64 layoutHash = 0;
+    uint8 isNewLayout = 0;
+    archive >> layoutHash >> isNewLayout;
+
+    if (isNewLayout)
+    {
+        uint64 fieldCount = 0;
+        archive >> fieldCount;
+
+        std::vector<Archive::FieldDescriptor> fieldDescriptors(fieldCount);
+        archive.read_bytes(fieldDescriptors.data(), fieldCount * sizeof(Archive::FieldDescriptor));
+        archive.add_field_layout(layoutHash, fieldDescriptors);
+
+        if (layoutHash != m_hash)
+        {
+            FE_LOG(LogDefault, WARNING, "PropertyLayout::deserialize(): Properties of {} were changed after the archive was saved, "
+                "they are read field by field", m_typeInfo->get_str_name());
+        }
+    }
+
+    if (layoutHash != m_hash)
+    {
+        const std::vector<Archive::FieldDescriptor>* fieldDescriptors = archive.get_field_layout(layoutHash);
+        FE_CHECK(fieldDescriptors);
+        read_fields(object, archive, *fieldDescriptors);
+        return;
+    }
+
+    uint8* objectData = reinterpret_cast<uint8*>(object);
+    for (const Span& span : m_spans)
+        archive.read_bytes(objectData + span.offset, span.size);
+
+    for (uint64 i = m_trivialPropertyCount; i != m_properties.size(); ++i)
+        read_variable_size_property(object, m_properties[i], archive);
+}
+
+void PropertyLayout::read_fields(Object* object, Archive& archive, const std::vector<Archive::FieldDescriptor>& fieldDescriptors) const
+{
+    uint8* objectData = reinterpret_cast<uint8*>(object);
+
+    for (const Archive::FieldDescriptor& fieldDescriptor : fieldDescriptors)
+    {
+        Property* property = nullptr;
+        for (uint64 i = 0; i != m_fieldDescriptors.size(); ++i)
+        {
+            if (is_same_field(m_fieldDescriptors[i], fieldDescriptor))
+            {
+                property = m_properties[i];
+                break;
+            }
+        }
+
+        if (is_trivially_copyable_property(PropertyType(fieldDescriptor.type)))
+        {
+            if (property)
+                archive.read_bytes(objectData + property->get_offset(), fieldDescriptor.size);
+            else
+                archive.skip_bytes(fieldDescriptor.size);
+        }
+        else if (property)
+        {
+            read_variable_size_property(object, property, archive);
+        }
+        else
+        {
+            skip_variable_size_field(fieldDescriptor, archive);
+        }
+    }
+}
+
+void PropertyLayout::write_variable_size_property(const Object* object, Property* property, Archive& archive) const
+{
+    if (property->get_type() == PropertyType::STRING)
+    {
+        archive << *reinterpret_cast<const std::string*>(reinterpret_cast<const uint8*>(object) + property->get_offset());
+        return;
+    }
+
+    // Array properties take non-const objects but don't change them
+    Object* arrayOwner = const_cast<Object*>(object);
+    ArrayProperty* arrayProperty = static_cast<ArrayProperty*>(property);
+    uint64 elementCount = arrayProperty->get_element_count(arrayOwner);
+    archive << elementCount;
+
+    if (arrayProperty->get_value_type() == PropertyType::STRING)
+    {
+        for (uint64 i = 0; i != elementCount; ++i)
+            archive << arrayProperty->get_value<std::string>(arrayOwner, i);
+    }
+    else
+    {
+        archive.write_bytes(arrayProperty->get_data(arrayOwner), elementCount * arrayProperty->get_size());
+    }
+}
+
+void PropertyLayout::read_variable_size_property(Object* object, Property* property, Archive& archive) const
+{
+    if (property->get_type() == PropertyType::STRING)
+    {
+        archive >> *reinterpret_cast<std::string*>(reinterpret_cast<uint8*>(object) + property->get_offset());
+        return;
+    }
+
+    ArrayProperty* arrayProperty = static_cast<ArrayProperty*>(property);
+    uint64 elementCount = 0;
+    archive >> elementCount;
+    arrayProperty->resize(object, elementCount);
+
+    if (arrayProperty->get_value_type() == PropertyType::STRING)
+    {
+        for (uint64 i = 0; i != elementCount; ++i)
+            archive >> arrayProperty->get_value<std::string>(object, i);
+    }
+    else
+    {
+        archive.read_bytes(arrayProperty->get_data(object), elementCount * arrayProperty->get_size());
+    }
+}
+
+void PropertyLayout::skip_variable_size_field(const Archive::FieldDescriptor& fieldDescriptor, Archive& archive) const
+{
+    uint64 count = 0;
+    archive >> count;
+
+    if (PropertyType(fieldDescriptor.type) == PropertyType::STRING)
+    {
+        archive.skip_bytes(count);
+    }
+    else if (PropertyType(fieldDescriptor.valueType) == PropertyType::STRING)
+    {
+        for (uint64 i = 0; i != count; ++i)
+        {
+            uint64 length = 0;
+            archive >> length;
+            archive.skip_bytes(length);
+        }
+    }
+    else
+    {
+        archive.skip_bytes(count * fieldDescriptor.size);
+    }
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "core/types.h"
+#include "core/file_system/archive.h"
+#include <vector>
+
+namespace fe
+{
+
+class Object;
+class TypeInfo;
+class Property;
+
+// Writes and reads registered properties of a type, including properties of its base types.
+// Trivially copyable properties are sorted by offset and properties that are adjacent in memory are merged into spans,
+// each span is copied with one memcpy. Strings and arrays are written after them.
+// Each object starts with the layout hash. The first object of a layout in an archive is followed by field descriptors,
+// so objects written with an outdated layout are read field by field, removed or changed fields are skipped.
+class PropertyLayout
+{
+public:
+    PropertyLayout(const TypeInfo* typeInfo);
+
+    uint64 get_hash() const { return m_hash; }
+    bool is_empty() const { return m_properties.empty(); }
+
+    void serialize(const Object* object, Archive& archive) const;
+    void deserialize(Object* object, Archive& archive) const;
+
+private:
+    struct Span
+    {
+        uint64 offset;
+        uint64 size;
+    };
+
+    const TypeInfo* m_typeInfo = nullptr;
+    uint64 m_hash = 0;
+
+    // In the same order as fields are written
+    std::vector<Property*> m_properties;
+    std::vector<Archive::FieldDescriptor> m_fieldDescriptors;
+
+    std::vector<Span> m_spans;
+    // Properties after this index are strings and arrays
+    uint64 m_trivialPropertyCount = 0;
+
+    void read_fields(Object* object, Archive& archive, const std::vector<Archive::FieldDescriptor>& fieldDescriptors) const;
+    void write_variable_size_property(const Object* object, Property* property, Archive& archive) const;
+    void read_variable_size_property(Object* object, Property* property, Archive& archive) const;
+    void skip_variable_size_field(const Archive::FieldDescriptor& fieldDescriptor, Archive& archive) const;
+};
+
+}
@@ -1,9 +1,15 @@
 #include "type_info.h"
 #include "property.h"
+#include "property_layout.h"
+#include "type_manager.h"
+#include "core/compile_time_hash.h"
+#include <mutex>
 
 namespace fe
 {
 
+std::mutex g_propertyLayoutMutex;
+
 TypeInfo::TypeInfo(
     const char* name,
     AllocatorHandler allocatorHandler,
@@ -17,18 +23,17 @@ TypeInfo::TypeInfo(
     m_classSize = size;
     m_classAlignment = alignment;
     m_baseTypeInfo = baseTypeInfo;
-    m_nameHash = std::hash<std::string>()(name);
+    m_nameHash = fnv1a_64(name);
 }
 
 bool TypeInfo::is_a(const TypeInfo* typeInfo) const
 {
     FE_CHECK(typeInfo);
+    TypeManager::update_type_indices();
+    FE_CHECK(m_typeIndex != ~0u && typeInfo->m_typeIndex != ~0u);
 
-    for (const TypeInfo* it = this; it != nullptr; it = it->m_baseTypeInfo)
-        if (it->get_name_hash() == typeInfo->get_name_hash())
-            return true;
-
-    return false;
+    // Unsigned subtraction wraps around if this type has a lower index, so one comparison checks both bounds
+    return m_typeIndex - typeInfo->m_typeIndex <= typeInfo->m_descendantCount;
 }
 
 bool TypeInfo::is_exactly(const TypeInfo* typeInfo) const
@@ -37,6 +42,18 @@ bool TypeInfo::is_exactly(const TypeInfo* typeInfo) const
     return typeInfo->get_name_hash() == get_name_hash();
 }
 
+uint32 TypeInfo::get_type_index() const
+{
+    TypeManager::update_type_indices();
+    return m_typeIndex;
+}
+
+uint32 TypeInfo::get_descendant_count() const
+{
+    TypeManager::update_type_indices();
+    return m_descendantCount;
+}
+
 Property* TypeInfo::get_property(const char* propertyName) const
 {
     for (Property* property : m_properties)
@@ -51,6 +68,19 @@ Property* TypeInfo::get_property(Name propertyName) const
     return get_property(propertyName.to_string().c_str());
 }
 
+const PropertyLayout& TypeInfo::get_property_layout() const
+{
+    // Objects of the same type can be serialized by several tasks
+    if (PropertyLayout* propertyLayout = m_propertyLayout.load(std::memory_order_acquire))
+        return *propertyLayout;
+
+    std::scoped_lock<std::mutex> lock(g_propertyLayoutMutex);
+    if (!m_propertyLayout.load(std::memory_order_relaxed))
+        m_propertyLayout.store(memory_new<PropertyLayout>(this), std::memory_order_release);
+
+    return *m_propertyLayout.load(std::memory_order_relaxed);
+}
+
 void TypeInfo::add_property(Property* property)
 {
     if (get_property(property->get_name().c_str()) == nullptr)
@@ -62,6 +92,9 @@ void TypeInfo::cleanup_properties() const
     for (Property* property : m_properties)
         memory_delete(property);
     m_properties.clear();
+
+    if (PropertyLayout* propertyLayout = m_propertyLayout.exchange(nullptr))
+        memory_delete(propertyLayout);
 }
 
 void add_property(TypeInfo* typeInfo, Property* property)
@@ -2,6 +2,7 @@
 
 #include "core/name.h"
 #include "core/types.h"
+#include <atomic>
 #include <functional>
 
 namespace fe
@@ -11,6 +12,7 @@ class Property;
 class Object;
 class TypeInfo;
 class TypeManager;
+class PropertyLayout;
 
 void add_property(TypeInfo* typeInfo, Property* property);
 
@@ -32,13 +34,19 @@ public:
 
     const char* get_str_name() const { return m_name; };
     Name get_name() const { return m_name; }
+    // Same as the id of the Name of the type
     uint64 get_name_hash() const { return m_nameHash; }
+
+    // Dense index of the type, descendants of the type have indices from index + 1 to index + descendant count
+    uint32 get_type_index() const;
+    uint32 get_descendant_count() const;
     
     uint64 get_class_size() const { return m_classSize; }
     uint64 get_class_alignment() const { return m_classAlignment; }
     AllocatorHandler get_allocator_handler() const { return m_allocatorHandler; }
     const TypeInfo* get_base_type_info() const { return m_baseTypeInfo; }
 
+    // Compares type indices, doesn't walk base types
     bool is_a(const TypeInfo* typeInfo) const;
     bool is_exactly(const TypeInfo* typeInfo) const;
 
@@ -58,6 +66,9 @@ public:
     Property* get_property(Name propertyName) const;
     const std::vector<Property*>& get_properties() const { return m_properties; }
 
+    // Built on the first call, all properties must be registered by then. Includes properties of base types.
+    const PropertyLayout& get_property_layout() const;
+
 protected:
     const char* m_name;
     AllocatorHandler m_allocatorHandler;
@@ -67,7 +78,12 @@ protected:
     const TypeInfo* m_baseTypeInfo = nullptr;
     uint64 m_nameHash;
 
+    // Assigned by TypeManager
+    mutable uint32 m_typeIndex = ~0u;
+    mutable uint32 m_descendantCount = 0;
+
     mutable std::vector<Property*> m_properties;
+    mutable std::atomic<PropertyLayout*> m_propertyLayout = nullptr;
 
     void add_property(Property* property);
     void cleanup_properties() const;
@@ -2,10 +2,18 @@
 #include "object.h"
 #include "type_info.h"
 #include "core/macro.h"
+#include "core/compile_time_hash.h"
+#include "core/logger.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+#include <mutex>
 
 namespace fe
 {
 
+std::mutex g_typeIndexMutex;
+
 void TypeManager::cleanup()
 {
     for (const TypeInfo* typeInfo : s_typeInfos)
@@ -14,18 +22,29 @@ void TypeManager::cleanup()
 
 const TypeInfo* TypeManager::get_type_info(const char* typeName)
 {
-    auto it = s_indexByTypeName.find(typeName);
-    if (it == s_indexByTypeName.end())
-        return nullptr;
-    return s_typeInfos.at(it->second);
+    FE_CHECK(typeName);
+    return get_type_info(Name(fnv1a_64(typeName)));
 }
 
 const TypeInfo* TypeManager::get_type_info(Name typeName)
 {
-    auto it = s_indexByTypeName.find(typeName.to_string());
-    if (it == s_indexByTypeName.end())
+    auto it = s_typeInfoByNameHash.find(typeName.to_id());
+    if (it == s_typeInfoByNameHash.end())
         return nullptr;
-    return s_typeInfos.at(it->second);
+    return it->second;
+}
+
+const TypeInfo* TypeManager::get_type_info_by_index(uint32 typeIndex)
+{
+    update_type_indices();
+    FE_CHECK(typeIndex < s_typeInfosByIndex.size());
+    return s_typeInfosByIndex[typeIndex];
+}
+
+uint32 TypeManager::get_type_count()
+{
+    update_type_indices();
+    return (uint32)s_typeInfosByIndex.size();
 }
 
 Object* TypeManager::create_object(const TypeInfo* typeInfo)
@@ -45,12 +64,82 @@ void TypeManager::register_type(const TypeInfo* typeInfo)
 {
     FE_CHECK(typeInfo);
 
-    auto it = s_indexByTypeName.find(typeInfo->get_str_name());
-    if (it != s_indexByTypeName.end())
-        return;
+    auto [it, isInserted] = s_typeInfoByNameHash.emplace(typeInfo->get_name_hash(), typeInfo);
+    if (!isInserted)
+    {
+        // The same type may be registered more than once, a different type with the same hash would be unreachable
+        if (std::strcmp(it->second->get_str_name(), typeInfo->get_str_name()) == 0)
+            return;
+
+        FE_LOG(LogDefault, FATAL, "TypeManager::register_type(): Types {} and {} have the same name hash {}.",
+            it->second->get_str_name(), typeInfo->get_str_name(), typeInfo->get_name_hash());
+    }
+
+    // Indices are assigned once and may be read without locks, and tables indexed by them
+    // (e.g. Entity components) would become stale, so types can't be registered after first use
+    if (s_areTypeIndicesValid.load(std::memory_order_acquire))
+        FE_LOG(LogDefault, FATAL, "TypeManager::register_type(): Type {} is registered after type indices were assigned.", typeInfo->get_str_name());
 
     s_typeInfos.push_back(typeInfo);
-    s_indexByTypeName[typeInfo->get_str_name()] = (uint32)s_typeInfos.size() - 1;
 }
 
-}
\ No newline at end of file
+void TypeManager::assign_type_indices()
+{
+    std::scoped_lock<std::mutex> lock(g_typeIndexMutex);
+    if (s_areTypeIndicesValid.load(std::memory_order_relaxed))
+        return;
+
+    // Root types are not registered, they are added as base types of registered ones
+    std::vector<const TypeInfo*> typeInfos;
+    std::unordered_set<const TypeInfo*> visitedTypeInfos;
+    std::unordered_map<const TypeInfo*, std::vector<const TypeInfo*>> childrenByTypeInfo;
+    for (const TypeInfo* typeInfo : s_typeInfos)
+    {
+        for (const TypeInfo* it = typeInfo; it != nullptr; it = it->get_base_type_info())
+        {
+            if (!visitedTypeInfos.insert(it).second)
+                break;
+
+            typeInfos.push_back(it);
+            if (it->get_base_type_info())
+                childrenByTypeInfo[it->get_base_type_info()].push_back(it);
+        }
+    }
+
+    // Sorted by name, so indices don't depend on the order of static initialization
+    auto compareNames = [](const TypeInfo* first, const TypeInfo* second)
+    {
+        return strcmp(first->get_str_name(), second->get_str_name()) < 0;
+    };
+
+    std::vector<const TypeInfo*> rootTypeInfos;
+    for (const TypeInfo* typeInfo : typeInfos)
+        if (!typeInfo->get_base_type_info())
+            rootTypeInfos.push_back(typeInfo);
+
+    std::sort(rootTypeInfos.begin(), rootTypeInfos.end(), compareNames);
+    for (auto& [typeInfo, children] : childrenByTypeInfo)
+        std::sort(children.begin(), children.end(), compareNames);
+
+    // Pre-order traversal, all descendants of a type get indices right after the index of the type
+    s_typeInfosByIndex.clear();
+    s_typeInfosByIndex.reserve(typeInfos.size());
+
+    auto assignIndices = [&](const TypeInfo* typeInfo, auto& assignIndices) -> void
+    {
+        typeInfo->m_typeIndex = (uint32)s_typeInfosByIndex.size();
+        s_typeInfosByIndex.push_back(typeInfo);
+
+        for (const TypeInfo* child : childrenByTypeInfo[typeInfo])
+            assignIndices(child, assignIndices);
+
+        typeInfo->m_descendantCount = (uint32)s_typeInfosByIndex.size() - typeInfo->m_typeIndex - 1;
+    };
+
+    for (const TypeInfo* rootTypeInfo : rootTypeInfos)
+        assignIndices(rootTypeInfo, assignIndices);
+
+    s_areTypeIndicesValid.store(true, std::memory_order_release);
+}
+
+}
@@ -3,7 +3,7 @@
 #include "core/name.h"
 #include "core/types.h"
 #include <vector>
-#include <string>
+#include <atomic>
 #include <unordered_map>
 
 namespace fe
@@ -17,17 +17,35 @@ class TypeManager
 public:
     static void cleanup();
 
+    // Don't allocate, types are found by the hash of the name which is the same as the Name id
     static const TypeInfo* get_type_info(const char* typeName);
     static const TypeInfo* get_type_info(Name typeName);
-    
+    static const TypeInfo* get_type_info_by_index(uint32 typeIndex);
+
+    // Includes base types that are not registered, for example Object
+    static uint32 get_type_count();
+
     static Object* create_object(const TypeInfo* typeInfo);
     static Object* create_object_by_name(const char* typeName);
 
+    // Must be called before type indices are used, usually by static initializers
     static void register_type(const TypeInfo* typeInfo);
 
+    // Type indices are assigned once on first use, after all types are registered by static initializers
+    static void update_type_indices()
+    {
+        if (!s_areTypeIndicesValid.load(std::memory_order_acquire))
+            assign_type_indices();
+    }
+
 private:
-    inline static std::unordered_map<std::string, uint32> s_indexByTypeName{};
+    inline static std::unordered_map<uint64, const TypeInfo*> s_typeInfoByNameHash{};
     inline static std::vector<const TypeInfo*> s_typeInfos{};
+
+    inline static std::vector<const TypeInfo*> s_typeInfosByIndex{};
+    inline static std::atomic<bool> s_areTypeIndicesValid{ false };
+
+    static void assign_type_indices();
 };
 
-}
\ No newline at end of file
+}
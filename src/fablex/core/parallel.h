@@ -0,0 +1,283 @@
+#pragma once
+
+#include "task_composer.h"
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+namespace fe
+{
+
+// Minimal range size that is worth splitting when parallel algorithm gets grainSize = 0
+constexpr uint64 PARALLEL_MIN_GRAIN_SIZE = 1024;
+
+inline uint64 calculate_parallel_grain_size(uint64 count, uint64 grainSize, TaskGroup::Priority priority)
+{
+    if (grainSize)
+        return grainSize;
+
+    // Main thread joins workers in TaskComposer::wait
+    uint64 threadCount = TaskComposer::get_thread_count(priority) + 1;
+    return std::max(count / (threadCount * 16), PARALLEL_MIN_GRAIN_SIZE);
+}
+
+// Lazy binary splitting: the range is processed in grain sized chunks and the upper half
+// of what is left is split into a new task only if some worker can take it.
+// So the number of tasks adapts to the load instead of being fixed by the caller.
+template<typename Body>
+void parallel_for_range(TaskGroup& taskGroup, uint64 begin, uint64 end, uint64 grainSize, const Body& body)
+{
+    while (end - begin > grainSize)
+    {
+        if (TaskComposer::should_split_work(taskGroup.get_priority()))
+        {
+            uint64 middle = begin + (end - begin) / 2;
+            TaskComposer::execute(taskGroup, [&taskGroup, &body, middle, end, grainSize](TaskExecutionInfo)
+            {
+                parallel_for_range(taskGroup, middle, end, grainSize, body);
+            });
+            end = middle;
+        }
+        else
+        {
+            body(begin, begin + grainSize);
+            begin += grainSize;
+        }
+    }
+
+    if (begin != end)
+        body(begin, end);
+}
+
+// Calls body(rangeBegin, rangeEnd) for subranges of [begin, end). Returns when the whole range is processed.
+// Body can be called concurrently from different threads, so subranges must be independent.
+template<typename Body>
+void parallel_for(
+    uint64 begin,
+    uint64 end,
+    const Body& body,
+    uint64 grainSize = 0,
+    TaskGroup::Priority priority = TaskGroup::Priority::HIGH
+)
+{
+    if (begin >= end)
+        return;
+
+    grainSize = calculate_parallel_grain_size(end - begin, grainSize, priority);
+
+    if (end - begin <= grainSize || !TaskComposer::get_thread_count(priority))
+    {
+        body(begin, end);
+        return;
+    }
+
+    TaskGroup taskGroup(priority);
+    parallel_for_range(taskGroup, begin, end, grainSize, body);
+    TaskComposer::wait(taskGroup);
+}
+
+// Calls rangeReduce(rangeBegin, rangeEnd, identity) -> T for chunks of [begin, end) and combines chunk results
+// with combine(T, T) -> T. Chunks are fixed and combined in order, so the result does not depend on scheduling
+// even if combine is not commutative or is not exactly associative, for example float addition.
+template<typename T, typename RangeReduce, typename Combine>
+T parallel_reduce(
+    uint64 begin,
+    uint64 end,
+    const T& identity,
+    const RangeReduce& rangeReduce,
+    const Combine& combine,
+    uint64 grainSize = 0,
+    TaskGroup::Priority priority = TaskGroup::Priority::HIGH
+)
+{
+    if (begin >= end)
+        return identity;
+
+    uint64 count = end - begin;
+    grainSize = calculate_parallel_grain_size(count, grainSize, priority);
+    uint64 chunkCount = (count + grainSize - 1) / grainSize;
+
+    if (chunkCount == 1 || !TaskComposer::get_thread_count(priority))
+        return rangeReduce(begin, end, identity);
+
+    std::vector<T> partialResults(chunkCount, identity);
+    T* partialResultsData = partialResults.data();
+
+    TaskGroup taskGroup(priority);
+    TaskComposer::dispatch(taskGroup, uint32(chunkCount), 1, [&, partialResultsData](TaskExecutionInfo execInfo)
+    {
+        uint64 chunkBegin = begin + execInfo.globalTaskIndex * grainSize;
+        uint64 chunkEnd = std::min(chunkBegin + grainSize, end);
+        partialResultsData[execInfo.globalTaskIndex] = rangeReduce(chunkBegin, chunkEnd, identity);
+    });
+    TaskComposer::wait(taskGroup);
+
+    T result = identity;
+    for (const T& partialResult : partialResults)
+        result = combine(result, partialResult);
+
+    return result;
+}
+
+// out[i] = in[0] op in[1] op ... op in[i]. in and out can point to the same array.
+// Two passes: chunk totals are computed in parallel, scanned serially, then each chunk is scanned from its offset.
+template<typename T, typename Op>
+void parallel_inclusive_scan(
+    const T* in,
+    T* out,
+    uint64 count,
+    const Op& op,
+    const T& identity,
+    uint64 grainSize = 0,
+    TaskGroup::Priority priority = TaskGroup::Priority::HIGH
+)
+{
+    if (!count)
+        return;
+
+    grainSize = calculate_parallel_grain_size(count, grainSize, priority);
+    uint64 chunkCount = (count + grainSize - 1) / grainSize;
+
+    auto scanChunk = [&](uint64 chunkBegin, uint64 chunkEnd, T offset)
+    {
+        for (uint64 i = chunkBegin; i != chunkEnd; ++i)
+        {
+            offset = op(offset, in[i]);
+            out[i] = offset;
+        }
+    };
+
+    if (chunkCount == 1 || !TaskComposer::get_thread_count(priority))
+    {
+        scanChunk(0, count, identity);
+        return;
+    }
+
+    std::vector<T> chunkOffsets(chunkCount, identity);
+    T* chunkOffsetsData = chunkOffsets.data();
+
+    TaskGroup taskGroup(priority);
+    TaskComposer::dispatch(taskGroup, uint32(chunkCount), 1, [&, chunkOffsetsData](TaskExecutionInfo execInfo)
+    {
+        uint64 chunkBegin = execInfo.globalTaskIndex * grainSize;
+        uint64 chunkEnd = std::min(chunkBegin + grainSize, count);
+
+        T chunkTotal = identity;
+        for (uint64 i = chunkBegin; i != chunkEnd; ++i)
+            chunkTotal = op(chunkTotal, in[i]);
+
+        chunkOffsetsData[execInfo.globalTaskIndex] = chunkTotal;
+    });
+    TaskComposer::wait(taskGroup);
+
+    T offset = identity;
+    for (T& chunkOffset : chunkOffsets)
+    {
+        T chunkTotal = chunkOffset;
+        chunkOffset = offset;
+        offset = op(offset, chunkTotal);
+    }
+
+    TaskComposer::dispatch(taskGroup, uint32(chunkCount), 1, [&, chunkOffsetsData](TaskExecutionInfo execInfo)
+    {
+        uint64 chunkBegin = execInfo.globalTaskIndex * grainSize;
+        uint64 chunkEnd = std::min(chunkBegin + grainSize, count);
+        scanChunk(chunkBegin, chunkEnd, chunkOffsetsData[execInfo.globalTaskIndex]);
+    });
+    TaskComposer::wait(taskGroup);
+}
+
+// Sorts chunks with std::sort in parallel, then merges pairs of sorted runs in parallel until one run is left.
+// Not stable, same as std::sort.
+template<typename RandomIt, typename Compare>
+void parallel_sort(
+    RandomIt first,
+    RandomIt last,
+    const Compare& compare,
+    uint64 grainSize = 0,
+    TaskGroup::Priority priority = TaskGroup::Priority::HIGH
+)
+{
+    using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+
+    uint64 count = uint64(last - first);
+    if (count < 2)
+        return;
+
+    grainSize = calculate_parallel_grain_size(count, grainSize, priority);
+    uint64 runCount = (count + grainSize - 1) / grainSize;
+
+    if (runCount == 1 || !TaskComposer::get_thread_count(priority))
+    {
+        std::sort(first, last, compare);
+        return;
+    }
+
+    TaskGroup taskGroup(priority);
+    TaskComposer::dispatch(taskGroup, uint32(runCount), 1, [&](TaskExecutionInfo execInfo)
+    {
+        uint64 runBegin = execInfo.globalTaskIndex * grainSize;
+        uint64 runEnd = std::min(runBegin + grainSize, count);
+        std::sort(first + runBegin, first + runEnd, compare);
+    });
+    TaskComposer::wait(taskGroup);
+
+    std::vector<ValueType> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+    ValueType* bufferData = buffer.data();
+    bool isSortedInBuffer = true;
+
+    for (uint64 runSize = grainSize; runSize < count; runSize *= 2)
+    {
+        uint64 mergeCount = (count + runSize * 2 - 1) / (runSize * 2);
+
+        TaskComposer::dispatch(taskGroup, uint32(mergeCount), 1, [&, bufferData, runSize, isSortedInBuffer](TaskExecutionInfo execInfo)
+        {
+            uint64 mergeBegin = execInfo.globalTaskIndex * runSize * 2;
+            uint64 mergeMiddle = std::min(mergeBegin + runSize, count);
+            uint64 mergeEnd = std::min(mergeBegin + runSize * 2, count);
+
+            if (isSortedInBuffer)
+            {
+                std::merge(
+                    std::make_move_iterator(bufferData + mergeBegin),
+                    std::make_move_iterator(bufferData + mergeMiddle),
+                    std::make_move_iterator(bufferData + mergeMiddle),
+                    std::make_move_iterator(bufferData + mergeEnd),
+                    first + mergeBegin,
+                    compare
+                );
+            }
+            else
+            {
+                std::merge(
+                    std::make_move_iterator(first + mergeBegin),
+                    std::make_move_iterator(first + mergeMiddle),
+                    std::make_move_iterator(first + mergeMiddle),
+                    std::make_move_iterator(first + mergeEnd),
+                    bufferData + mergeBegin,
+                    compare
+                );
+            }
+        });
+        TaskComposer::wait(taskGroup);
+
+        isSortedInBuffer = !isSortedInBuffer;
+    }
+
+    if (isSortedInBuffer)
+    {
+        parallel_for(0, count, [&, bufferData](uint64 rangeBegin, uint64 rangeEnd)
+        {
+            std::move(bufferData + rangeBegin, bufferData + rangeEnd, first + rangeBegin);
+        }, 0, priority);
+    }
+}
+
+template<typename RandomIt>
+void parallel_sort(RandomIt first, RandomIt last)
+{
+    parallel_sort(first, last, std::less<>());
+}
+
+}
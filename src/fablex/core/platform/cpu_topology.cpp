@@ -0,0 +1,190 @@
+#include "cpu_topology.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#elif defined(WIN32)
+#include "platform_win32.h"
+#include <set>
+#endif
+
+namespace fe
+{
+
+#if defined(__linux__)
+
+bool read_sysfs_value(const std::string& path, int32& outValue)
+{
+    std::ifstream file(path);
+    return bool(file >> outValue);
+}
+
+// Parses sysfs cpulist format, for example "0-3,8,10-11"
+std::vector<uint32> parse_cpu_list(const std::string& cpuList)
+{
+    std::vector<uint32> cpus;
+    std::stringstream stream(cpuList);
+    std::string range;
+
+    while (std::getline(stream, range, ','))
+    {
+        if (range.empty() || range == "\n")
+            continue;
+
+        size_t separator = range.find('-');
+        uint32 first = std::stoul(range.substr(0, separator));
+        uint32 last = separator == std::string::npos ? first : std::stoul(range.substr(separator + 1));
+
+        for (uint32 cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+
+    return cpus;
+}
+
+std::map<uint32, uint32> read_numa_node_by_cpu()
+{
+    std::map<uint32, uint32> numaNodeByCPU;
+    const std::filesystem::path nodesPath = "/sys/devices/system/node";
+
+    std::error_code errorCode;
+    for (const auto& entry : std::filesystem::directory_iterator(nodesPath, errorCode))
+    {
+        std::string directoryName = entry.path().filename().string();
+        if (directoryName.rfind("node", 0) != 0 || directoryName.size() == 4 || !std::isdigit(directoryName[4]))
+            continue;
+
+        std::ifstream file(entry.path() / "cpulist");
+        std::string cpuList;
+        if (!std::getline(file, cpuList))
+            continue;
+
+        uint32 numaNode = std::stoul(directoryName.substr(4));
+        for (uint32 cpu : parse_cpu_list(cpuList))
+            numaNodeByCPU[cpu] = numaNode;
+    }
+
+    return numaNodeByCPU;
+}
+
+#endif
+
+CPUTopology CPUTopology::detect()
+{
+    CPUTopology topology;
+
+#if defined(__linux__)
+    cpu_set_t affinityMask;
+    CPU_ZERO(&affinityMask);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &affinityMask) == 0)
+    {
+        std::map<uint32, uint32> numaNodeByCPU = read_numa_node_by_cpu();
+        std::map<std::pair<int32, int32>, uint32> coreIndexByID;
+        std::set<uint32> numaNodes;
+
+        for (uint32 cpu = 0; cpu != CPU_SETSIZE; ++cpu)
+        {
+            if (!CPU_ISSET(cpu, &affinityMask))
+                continue;
+
+            const std::string topologyPath = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+
+            // Without sysfs, each logical processor is treated as a separate core
+            int32 packageID = 0;
+            int32 coreID = int32(cpu);
+            read_sysfs_value(topologyPath + "physical_package_id", packageID);
+            read_sysfs_value(topologyPath + "core_id", coreID);
+
+            auto numaNodeIt = numaNodeByCPU.find(cpu);
+            uint32 numaNode = numaNodeIt != numaNodeByCPU.end() ? numaNodeIt->second : 0;
+            numaNodes.insert(numaNode);
+
+            auto [coreIt, isNewCore] = coreIndexByID.try_emplace({ packageID, coreID }, (uint32)topology.m_physicalCores.size());
+            if (isNewCore)
+                topology.m_physicalCores.emplace_back().numaNode = numaNode;
+
+            topology.m_physicalCores[coreIt->second].logicalProcessors.push_back(cpu);
+            ++topology.m_logicalProcessorCount;
+        }
+
+        std::stable_sort(topology.m_physicalCores.begin(), topology.m_physicalCores.end(), [](const PhysicalCore& a, const PhysicalCore& b)
+        {
+            return a.numaNode < b.numaNode;
+        });
+
+        topology.m_numaNodeCount = std::max(1u, (uint32)numaNodes.size());
+    }
+#elif defined(WIN32)
+    // Only processor group 0 is used because TaskComposer pins threads with SetThreadAffinityMask
+    DWORD bufferSize = 0;
+    GetLogicalProcessorInformationEx(RelationAll, nullptr, &bufferSize);
+    std::vector<uint8> buffer(bufferSize);
+
+    if (bufferSize && GetLogicalProcessorInformationEx(RelationAll, reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data()), &bufferSize))
+    {
+        std::vector<std::pair<KAFFINITY, uint32>> numaNodeMasks;
+        std::set<uint32> numaNodes;
+
+        for (uint64 offset = 0; offset < bufferSize;)
+        {
+            auto info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+            if (info->Relationship == RelationNumaNode && info->NumaNode.GroupMask.Group == 0)
+                numaNodeMasks.emplace_back(info->NumaNode.GroupMask.Mask, info->NumaNode.NodeNumber);
+            offset += info->Size;
+        }
+
+        for (uint64 offset = 0; offset < bufferSize;)
+        {
+            auto info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+            offset += info->Size;
+
+            if (info->Relationship != RelationProcessorCore || info->Processor.GroupMask[0].Group != 0)
+                continue;
+
+            KAFFINITY coreMask = info->Processor.GroupMask[0].Mask;
+            PhysicalCore& core = topology.m_physicalCores.emplace_back();
+
+            for (const auto& [numaNodeMask, numaNode] : numaNodeMasks)
+                if (numaNodeMask & coreMask)
+                    core.numaNode = numaNode;
+
+            numaNodes.insert(core.numaNode);
+
+            for (uint32 processor = 0; processor != sizeof(KAFFINITY) * 8; ++processor)
+                if (coreMask & (KAFFINITY(1) << processor))
+                    core.logicalProcessors.push_back(processor);
+
+            topology.m_logicalProcessorCount += (uint32)core.logicalProcessors.size();
+        }
+
+        std::stable_sort(topology.m_physicalCores.begin(), topology.m_physicalCores.end(), [](const PhysicalCore& a, const PhysicalCore& b)
+        {
+            return a.numaNode < b.numaNode;
+        });
+
+        topology.m_numaNodeCount = std::max(1u, (uint32)numaNodes.size());
+    }
+#endif
+
+    if (topology.m_physicalCores.empty())
+    {
+        topology.m_logicalProcessorCount = std::max(1u, std::thread::hardware_concurrency());
+        topology.m_numaNodeCount = 1;
+
+        for (uint32 i = 0; i != topology.m_logicalProcessorCount; ++i)
+            topology.m_physicalCores.emplace_back().logicalProcessors.push_back(i);
+    }
+
+    return topology;
+}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "core/types.h"
+#include <vector>
+
+namespace fe
+{
+
+struct PhysicalCore
+{
+    uint32 numaNode = 0;
+    // More than one logical processor if SMT is enabled
+    std::vector<uint32> logicalProcessors;
+};
+
+// Processors that the process can run on. On Linux, topology is read from sysfs and the process affinity mask is respected.
+// On Windows, it is read with GetLogicalProcessorInformationEx for processor group 0. On other platforms or if detection fails,
+// each logical processor is treated as a separate physical core of one NUMA node.
+class CPUTopology
+{
+public:
+    static CPUTopology detect();
+
+    uint32 get_logical_processor_count() const { return m_logicalProcessorCount; }
+    uint32 get_physical_core_count() const { return (uint32)m_physicalCores.size(); }
+    uint32 get_numa_node_count() const { return m_numaNodeCount; }
+
+    // Sorted by NUMA node, so neighbouring cores share a memory controller
+    const std::vector<PhysicalCore>& get_physical_cores() const { return m_physicalCores; }
+
+private:
+    std::vector<PhysicalCore> m_physicalCores;
+    uint32 m_logicalProcessorCount = 0;
+    uint32 m_numaNodeCount = 1;
+};
+
+}
@@ -9,7 +9,8 @@
 namespace fe
 {
 
-template<typename T, size_t PoolSize = 64>
+// Live objects are counted under MemoryTagValue, memory blobs are untagged because pools keep them until destruction
+template<typename T, size_t PoolSize = 64, MemoryTag MemoryTagValue = MemoryTag::UNTAGGED>
 class PoolAllocator
 {
 public:
@@ -55,6 +56,7 @@ public:
         new(objPtr) T(std::forward<Params>(params)...);
             
         ++m_allocatedObjectCount;
+        MemoryTracker::on_allocate(MemoryTagValue, sizeof(T));
         return objPtr;
     }
 
@@ -63,6 +65,7 @@ public:
         ptr->~T();
         m_freePointers.push_back(ptr);
         --m_allocatedObjectCount;
+        MemoryTracker::on_free(MemoryTagValue, sizeof(T));
     }
 
 private:
@@ -84,23 +87,23 @@ private:
     }
 };
 
-template<typename T, size_t PoolSize = 64>
-class ThreadSafePoolAllocator : private PoolAllocator<T, PoolSize>
+template<typename T, size_t PoolSize = 64, MemoryTag MemoryTagValue = MemoryTag::UNTAGGED>
+class ThreadSafePoolAllocator : private PoolAllocator<T, PoolSize, MemoryTagValue>
 {
 public:
-    ThreadSafePoolAllocator() : PoolAllocator<T, PoolSize>() { }
+    ThreadSafePoolAllocator() : PoolAllocator<T, PoolSize, MemoryTagValue>() { }
 
     template<typename... Params>
     T* allocate(Params&&... params)
     {
         std::scoped_lock<std::mutex> locker{m_threadLock};
-        return PoolAllocator<T, PoolSize>::allocate(std::forward<Params>(params)...);
+        return PoolAllocator<T, PoolSize, MemoryTagValue>::allocate(std::forward<Params>(params)...);
     }
 
     void free(T* ptr)
     {
         std::scoped_lock<std::mutex> locker{m_threadLock};
-        return PoolAllocator<T, PoolSize>::free(ptr);
+        return PoolAllocator<T, PoolSize, MemoryTagValue>::free(ptr);
     }
 
 private:
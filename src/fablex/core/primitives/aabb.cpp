@@ -1,6 +1,8 @@
 #include "aabb.h"
 #include "ray.h"
 #include "sphere.h"
+#include "core/parallel.h"
+#include "core/bulk_math.h"
 
 namespace fe
 {
@@ -22,14 +24,13 @@ AABB::AABB(const Float3& center, const Float3& halfWidth)
 
 void AABB::create(const std::vector<Float3>& vertexPositions)
 {
-    minPoint = { FLOAT_MAX, FLOAT_MAX, FLOAT_MAX };
-    maxPoint = { FLOAT_MIN, FLOAT_MIN, FLOAT_MIN };
-
-    for (auto& pos : vertexPositions)
+    *this = parallel_reduce(0, vertexPositions.size(), AABB(), [&](uint64 begin, uint64 end, AABB aabb)
     {
-        minPoint = min(minPoint, pos);
-        maxPoint = max(maxPoint, pos);
-    }
+        AABB chunkAABB;
+        compute_bounds(vertexPositions.data() + begin, end - begin, chunkAABB.minPoint, chunkAABB.maxPoint);
+        return merge(aabb, chunkAABB);
+    },
+    &AABB::merge);
 }
 
 void AABB::create(const Float3& center, const Float3& halfWidth)
@@ -49,7 +50,7 @@ AABB AABB::transform(const Matrix& mat) const
         Vector3::transform(minPoint, mat),
         Vector3::transform(Vector4::create(minPoint.x, maxPoint.y, minPoint.z, 1), mat),
         Vector3::transform(Vector4::create(minPoint.x, maxPoint.y, maxPoint.z, 1), mat),
-        Vector3::transform(Vector4::create(minPoint.x, minPoint.z, maxPoint.z, 1), mat),
+        Vector3::transform(Vector4::create(minPoint.x, minPoint.y, maxPoint.z, 1), mat),
         Vector3::transform(Vector4::create(maxPoint.x, minPoint.y, maxPoint.z, 1), mat),
         Vector3::transform(Vector4::create(maxPoint.x, minPoint.y, minPoint.z, 1), mat),
         Vector3::transform(Vector4::create(maxPoint.x, maxPoint.y, minPoint.z, 1), mat),
@@ -114,7 +115,7 @@ AABB::IntersectionType AABB::intersects(const AABB& aabb) const
 
     if (aMax.x < bMin.x || aMin.x > bMax.x
         || aMax.y < bMin.y || aMin.y > bMax.y
-        || aMax.z < bMax.z || aMin.z > aMax.z)
+        || aMax.z < bMin.z || aMin.z > bMax.z)
     {
         return IntersectionType::OUTSIDE;
     }
@@ -140,7 +141,18 @@ bool AABB::intersects(const Ray& ray) const
     if (!is_valid())
         return false;
 
-    return true;
+    // Slab test, the ray is clipped by pairs of planes of each axis
+    float tNear = ray.tmin;
+    float tFar = ray.tmax;
+    for (uint32 axis = 0; axis != 3; ++axis)
+    {
+        float t1 = ((&minPoint.x)[axis] - (&ray.origin.x)[axis]) * (&ray.directionInverse.x)[axis];
+        float t2 = ((&maxPoint.x)[axis] - (&ray.origin.x)[axis]) * (&ray.directionInverse.x)[axis];
+        tNear = std::max(tNear, std::min(t1, t2));
+        tFar = std::min(tFar, std::max(t1, t2));
+    }
+
+    return tNear <= tFar;
 }
 
 bool AABB::intersects(const Sphere& sphere) const
@@ -12,7 +12,7 @@ struct Sphere;
 struct AABB
 {
     Float3 minPoint{ FLOAT_MAX, FLOAT_MAX, FLOAT_MAX };
-    Float3 maxPoint{ FLOAT_MIN, FLOAT_MIN, FLOAT_MIN };
+    Float3 maxPoint{ -FLOAT_MAX, -FLOAT_MAX, -FLOAT_MAX };
 
     enum class IntersectionType
     {
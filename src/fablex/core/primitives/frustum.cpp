@@ -0,0 +1,267 @@
+#include "frustum.h"
+#include "aabb.h"
+#include "core/parallel.h"
+
+#include <cstring>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define FE_CULLING_SSE
+#endif
+
+namespace fe
+{
+
+// Coordinates of the box corner that is the farthest along the plane normal. If this corner is behind the plane,
+// the whole box is behind it, so each plane costs one dot product per box.
+struct CullingPlane
+{
+    const float* x;
+    const float* y;
+    const float* z;
+    Float4 plane;
+};
+
+void fill_culling_planes(const Frustum& frustum, const AABBArray& aabbs, CullingPlane* outCullingPlanes)
+{
+    for (uint32 i = 0; i != Frustum::s_planeCount; ++i)
+    {
+        const Float4& plane = frustum.planes[i];
+        CullingPlane& cullingPlane = outCullingPlanes[i];
+        cullingPlane.x = plane.x >= 0.0f ? aabbs.maxX.data() : aabbs.minX.data();
+        cullingPlane.y = plane.y >= 0.0f ? aabbs.maxY.data() : aabbs.minY.data();
+        cullingPlane.z = plane.z >= 0.0f ? aabbs.maxZ.data() : aabbs.minZ.data();
+        cullingPlane.plane = plane;
+    }
+}
+
+// Terms are added in the same order as in SIMD lanes, so scalar and SIMD results are the same
+float get_plane_distance(const Float4& plane, float x, float y, float z)
+{
+    return (plane.x * x + plane.y * y) + (plane.z * z + plane.w);
+}
+
+// Writes the index of every lane and advances only for visible ones, so there is no branch per box
+uint32 append_visible_indices(uint32 visibleMask, uint32 firstIndex, uint32 laneCount, uint32* outVisibleIndices, uint32 visibleCount)
+{
+    for (uint32 lane = 0; lane != laneCount; ++lane)
+    {
+        outVisibleIndices[visibleCount] = firstIndex + lane;
+        visibleCount += (visibleMask >> lane) & 1;
+    }
+    return visibleCount;
+}
+
+Frustum::Frustum(const Float4x4& viewProjection)
+{
+    create(viewProjection);
+}
+
+void Frustum::create(const Float4x4& viewProjection)
+{
+    using namespace DirectX;
+
+    XMMATRIX projViewT = XMMatrixTranspose(XMLoadFloat4x4(&viewProjection));
+    XMStoreFloat4(&planes[0], XMPlaneNormalize(XMVectorAdd(projViewT.r[3], projViewT.r[0])));
+    XMStoreFloat4(&planes[1], XMPlaneNormalize(XMVectorSubtract(projViewT.r[3], projViewT.r[0])));
+    XMStoreFloat4(&planes[2], XMPlaneNormalize(XMVectorAdd(projViewT.r[3], projViewT.r[1])));
+    XMStoreFloat4(&planes[3], XMPlaneNormalize(XMVectorSubtract(projViewT.r[3], projViewT.r[1])));
+    XMStoreFloat4(&planes[4], XMPlaneNormalize(projViewT.r[2]));
+    XMStoreFloat4(&planes[5], XMPlaneNormalize(XMVectorSubtract(projViewT.r[3], projViewT.r[2])));
+}
+
+bool Frustum::intersects(const AABB& aabb) const
+{
+    for (const Float4& plane : planes)
+    {
+        float x = plane.x >= 0.0f ? aabb.maxPoint.x : aabb.minPoint.x;
+        float y = plane.y >= 0.0f ? aabb.maxPoint.y : aabb.minPoint.y;
+        float z = plane.z >= 0.0f ? aabb.maxPoint.z : aabb.minPoint.z;
+
+        if (get_plane_distance(plane, x, y, z) < 0.0f)
+            return false;
+    }
+
+    return true;
+}
+
+AABB::IntersectionType Frustum::classify(const AABB& aabb) const
+{
+    AABB::IntersectionType intersectionType = AABB::IntersectionType::INSIDE;
+    for (const Float4& plane : planes)
+    {
+        bool isPositiveX = plane.x >= 0.0f;
+        bool isPositiveY = plane.y >= 0.0f;
+        bool isPositiveZ = plane.z >= 0.0f;
+
+        float farDistance = get_plane_distance(
+            plane,
+            isPositiveX ? aabb.maxPoint.x : aabb.minPoint.x,
+            isPositiveY ? aabb.maxPoint.y : aabb.minPoint.y,
+            isPositiveZ ? aabb.maxPoint.z : aabb.minPoint.z);
+
+        if (farDistance < 0.0f)
+            return AABB::IntersectionType::OUTSIDE;
+
+        float nearDistance = get_plane_distance(
+            plane,
+            isPositiveX ? aabb.minPoint.x : aabb.maxPoint.x,
+            isPositiveY ? aabb.minPoint.y : aabb.maxPoint.y,
+            isPositiveZ ? aabb.minPoint.z : aabb.maxPoint.z);
+
+        if (nearDistance < 0.0f)
+            intersectionType = AABB::IntersectionType::INTERSECTS;
+    }
+
+    return intersectionType;
+}
+
+void AABBArray::push_back(const AABB& aabb)
+{
+    minX.push_back(aabb.minPoint.x);
+    minY.push_back(aabb.minPoint.y);
+    minZ.push_back(aabb.minPoint.z);
+    maxX.push_back(aabb.maxPoint.x);
+    maxY.push_back(aabb.maxPoint.y);
+    maxZ.push_back(aabb.maxPoint.z);
+}
+
+void AABBArray::reserve(uint64 count)
+{
+    minX.reserve(count);
+    minY.reserve(count);
+    minZ.reserve(count);
+    maxX.reserve(count);
+    maxY.reserve(count);
+    maxZ.reserve(count);
+}
+
+void AABBArray::clear()
+{
+    minX.clear();
+    minY.clear();
+    minZ.clear();
+    maxX.clear();
+    maxY.clear();
+    maxZ.clear();
+}
+
+uint32 cull_aabbs(const Frustum& frustum, const AABBArray& aabbs, uint32 begin, uint32 end, uint32* outVisibleIndices)
+{
+    FE_CHECK(begin <= end && end <= aabbs.size());
+    FE_CHECK(outVisibleIndices || begin == end);
+
+    CullingPlane cullingPlanes[Frustum::s_planeCount];
+    fill_culling_planes(frustum, aabbs, cullingPlanes);
+
+    uint32 visibleCount = 0;
+    uint32 index = begin;
+
+#if defined(__AVX2__)
+    __m256 normalsX[Frustum::s_planeCount], normalsY[Frustum::s_planeCount], normalsZ[Frustum::s_planeCount], distances[Frustum::s_planeCount];
+    for (uint32 i = 0; i != Frustum::s_planeCount; ++i)
+    {
+        normalsX[i] = _mm256_set1_ps(cullingPlanes[i].plane.x);
+        normalsY[i] = _mm256_set1_ps(cullingPlanes[i].plane.y);
+        normalsZ[i] = _mm256_set1_ps(cullingPlanes[i].plane.z);
+        distances[i] = _mm256_set1_ps(cullingPlanes[i].plane.w);
+    }
+
+    for (; index + 8 <= end; index += 8)
+    {
+        __m256 outside = _mm256_setzero_ps();
+        for (uint32 i = 0; i != Frustum::s_planeCount; ++i)
+        {
+            const CullingPlane& cullingPlane = cullingPlanes[i];
+            __m256 xy = _mm256_add_ps(
+                _mm256_mul_ps(normalsX[i], _mm256_loadu_ps(cullingPlane.x + index)),
+                _mm256_mul_ps(normalsY[i], _mm256_loadu_ps(cullingPlane.y + index)));
+            __m256 zw = _mm256_add_ps(_mm256_mul_ps(normalsZ[i], _mm256_loadu_ps(cullingPlane.z + index)), distances[i]);
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(xy, zw), _mm256_setzero_ps(), _CMP_LT_OQ));
+        }
+
+        uint32 visibleMask = ~uint32(_mm256_movemask_ps(outside)) & 0xFF;
+        visibleCount = append_visible_indices(visibleMask, index, 8, outVisibleIndices, visibleCount);
+    }
+#elif defined(FE_CULLING_SSE)
+    __m128 normalsX[Frustum::s_planeCount], normalsY[Frustum::s_planeCount], normalsZ[Frustum::s_planeCount], distances[Frustum::s_planeCount];
+    for (uint32 i = 0; i != Frustum::s_planeCount; ++i)
+    {
+        normalsX[i] = _mm_set1_ps(cullingPlanes[i].plane.x);
+        normalsY[i] = _mm_set1_ps(cullingPlanes[i].plane.y);
+        normalsZ[i] = _mm_set1_ps(cullingPlanes[i].plane.z);
+        distances[i] = _mm_set1_ps(cullingPlanes[i].plane.w);
+    }
+
+    for (; index + 4 <= end; index += 4)
+    {
+        __m128 outside = _mm_setzero_ps();
+        for (uint32 i = 0; i != Frustum::s_planeCount; ++i)
+        {
+            const CullingPlane& cullingPlane = cullingPlanes[i];
+            __m128 xy = _mm_add_ps(
+                _mm_mul_ps(normalsX[i], _mm_loadu_ps(cullingPlane.x + index)),
+                _mm_mul_ps(normalsY[i], _mm_loadu_ps(cullingPlane.y + index)));
+            __m128 zw = _mm_add_ps(_mm_mul_ps(normalsZ[i], _mm_loadu_ps(cullingPlane.z + index)), distances[i]);
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(xy, zw), _mm_setzero_ps()));
+        }
+
+        uint32 visibleMask = ~uint32(_mm_movemask_ps(outside)) & 0xF;
+        visibleCount = append_visible_indices(visibleMask, index, 4, outVisibleIndices, visibleCount);
+    }
+#endif
+
+    for (; index != end; ++index)
+    {
+        uint32 isVisible = 1;
+        for (const CullingPlane& cullingPlane : cullingPlanes)
+        {
+            float distance = get_plane_distance(cullingPlane.plane, cullingPlane.x[index], cullingPlane.y[index], cullingPlane.z[index]);
+            isVisible &= distance >= 0.0f;
+        }
+
+        visibleCount = append_visible_indices(isVisible, index, 1, outVisibleIndices, visibleCount);
+    }
+
+    return visibleCount;
+}
+
+uint32 parallel_cull_aabbs(const Frustum& frustum, const AABBArray& aabbs, uint32* outVisibleIndices, uint64 grainSize)
+{
+    const uint32 count = (uint32)aabbs.size();
+    if (!count)
+        return 0;
+
+    grainSize = calculate_parallel_grain_size(count, grainSize, TaskGroup::Priority::HIGH);
+    uint32 chunkCount = uint32((count + grainSize - 1) / grainSize);
+
+    if (chunkCount == 1 || !TaskComposer::get_thread_count(TaskGroup::Priority::HIGH))
+        return cull_aabbs(frustum, aabbs, 0, count, outVisibleIndices);
+
+    std::vector<uint32> visibleCounts(chunkCount);
+    uint32* visibleCountsData = visibleCounts.data();
+
+    // Each chunk writes indices to its own part of the output, a chunk can't have more visible boxes than its size
+    TaskGroup taskGroup;
+    TaskComposer::dispatch(taskGroup, chunkCount, 1, [&, visibleCountsData](TaskExecutionInfo execInfo)
+    {
+        uint32 chunkBegin = uint32(execInfo.globalTaskIndex * grainSize);
+        uint32 chunkEnd = uint32(std::min<uint64>(chunkBegin + grainSize, count));
+        visibleCountsData[execInfo.globalTaskIndex] = cull_aabbs(frustum, aabbs, chunkBegin, chunkEnd, outVisibleIndices + chunkBegin);
+    });
+    TaskComposer::wait(taskGroup);
+
+    // Chunks are moved to the front in order, so indices stay sorted and the destination never passes the source
+    uint32 visibleCount = visibleCounts[0];
+    for (uint32 chunkIndex = 1; chunkIndex != chunkCount; ++chunkIndex)
+    {
+        memmove(outVisibleIndices + visibleCount, outVisibleIndices + chunkIndex * grainSize, visibleCounts[chunkIndex] * sizeof(uint32));
+        visibleCount += visibleCounts[chunkIndex];
+    }
+
+    return visibleCount;
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "aabb.h"
+#include <vector>
+
+namespace fe
+{
+
+struct Frustum
+{
+    constexpr static uint32 s_planeCount = 6;
+
+    // Normals in xyz point inside, a point is inside the plane if dot(xyz, point) + w >= 0
+    Float4 planes[s_planeCount];
+
+    Frustum() = default;
+    // Planes are extracted the same way as in ShaderCamera::create_frustum
+    Frustum(const Float4x4& viewProjection);
+
+    void create(const Float4x4& viewProjection);
+
+    // False only if the box is completely behind one of the planes
+    bool intersects(const AABB& aabb) const;
+    // INSIDE if the box is in front of all planes, OUTSIDE if intersects returns false
+    AABB::IntersectionType classify(const AABB& aabb) const;
+};
+
+// AABBs in structure of arrays form, so the culling kernel loads the same coordinate of several boxes at once
+struct AABBArray
+{
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> minZ;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<float> maxZ;
+
+    void push_back(const AABB& aabb);
+    void reserve(uint64 count);
+    void clear();
+
+    uint64 size() const { return minX.size(); }
+};
+
+// Writes indices of boxes from [begin, end) that pass Frustum::intersects in ascending order and returns their count.
+// Tests 8 boxes per iteration with AVX2 when the engine is built with FE_AVX2, otherwise 4 boxes with SSE.
+uint32 cull_aabbs(const Frustum& frustum, const AABBArray& aabbs, uint32 begin, uint32 end, uint32* outVisibleIndices);
+
+// Same as cull_aabbs for all boxes, chunks are culled in parallel on TaskComposer and compacted after that.
+// outVisibleIndices must have space for all boxes.
+uint32 parallel_cull_aabbs(const Frustum& frustum, const AABBArray& aabbs, uint32* outVisibleIndices, uint64 grainSize = 0);
+
+}
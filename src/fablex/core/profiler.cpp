@@ -0,0 +1,293 @@
+#include "profiler.h"
+#include "timer.h"
+#include "task_tracer.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+FE_DEFINE_LOG_CATEGORY(LogProfiler)
+
+namespace fe
+{
+
+std::array<Profiler::Frame, Profiler::s_frameHistorySize> Profiler::s_frames{};
+
+void Profiler::set_enabled(bool isEnabled)
+{
+    if (isEnabled == is_enabled())
+        return;
+
+    if (isEnabled)
+    {
+        // Events recorded before the profiler was disabled would get into the first frame
+        {
+            std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+            for (std::unique_ptr<ThreadBuffer>& threadBuffer : s_threadBuffers)
+            {
+                std::scoped_lock<std::mutex> bufferLock(threadBuffer->mutex);
+                threadBuffer->events.clear();
+            }
+        }
+
+        s_frameCount = 0;
+        s_frameBeginTime = Timer::get_time();
+        s_scopeHistoriesByName.clear();
+        s_scopeHistoriesByNamePtr.clear();
+    }
+
+    s_isEnabled.store(isEnabled);
+    FE_LOG(LogProfiler, INFO, "Profiler {}", isEnabled ? "enabled" : "disabled");
+}
+
+void Profiler::begin_frame()
+{
+    if (!is_enabled())
+        return;
+
+    Frame& frame = s_frames[s_frameCount % s_frameHistorySize];
+    frame.frameNumber = s_frameCount;
+    frame.beginTime = s_frameBeginTime;
+    frame.endTime = Timer::get_time();
+
+    {
+        std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+
+        frame.threads.resize(s_threadBuffers.size());
+        for (uint32 threadIndex = 0; threadIndex != s_threadBuffers.size(); ++threadIndex)
+        {
+            ThreadBuffer* threadBuffer = s_threadBuffers[threadIndex].get();
+            ThreadFrame& threadFrame = frame.threads[threadIndex];
+            threadFrame.threadIndex = threadIndex;
+
+            // Vectors are swapped, so the buffer gets the storage of the oldest frame and doesn't allocate
+            std::scoped_lock<std::mutex> bufferLock(threadBuffer->mutex);
+            std::swap(threadFrame.events, threadBuffer->events);
+            threadBuffer->events.clear();
+        }
+    }
+
+    update_scope_histories(frame);
+
+    s_frameBeginTime = frame.endTime;
+    ++s_frameCount;
+}
+
+void Profiler::begin_scope(const char* name)
+{
+    ThreadBuffer* threadBuffer = get_thread_buffer();
+    threadBuffer->openScopes.push_back({ name, Timer::get_time() });
+}
+
+void Profiler::end_scope()
+{
+    uint64 endTime = Timer::get_time();
+
+    ThreadBuffer* threadBuffer = get_thread_buffer();
+    FE_CHECK(!threadBuffer->openScopes.empty());
+
+    OpenScope openScope = threadBuffer->openScopes.back();
+    threadBuffer->openScopes.pop_back();
+
+    std::scoped_lock<std::mutex> lock(threadBuffer->mutex);
+    threadBuffer->events.push_back({ openScope.name, openScope.beginTime, endTime, (uint32)threadBuffer->openScopes.size() });
+}
+
+const Profiler::Frame* Profiler::get_last_frame()
+{
+    if (!s_frameCount)
+        return nullptr;
+
+    return &s_frames[(s_frameCount - 1) % s_frameHistorySize];
+}
+
+const std::string& Profiler::get_thread_name(uint32 threadIndex)
+{
+    std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+    FE_CHECK(threadIndex < s_threadBuffers.size());
+    return s_threadBuffers[threadIndex]->threadName;
+}
+
+void Profiler::get_frame_times(std::vector<float>& outFrameTimes)
+{
+    outFrameTimes.clear();
+
+    uint64 frameCount = std::min<uint64>(s_frameCount, s_frameHistorySize);
+    for (uint64 frameNumber = s_frameCount - frameCount; frameNumber != s_frameCount; ++frameNumber)
+    {
+        const Frame& frame = s_frames[frameNumber % s_frameHistorySize];
+        outFrameTimes.push_back(float(double(frame.endTime - frame.beginTime) / 1000000.0));
+    }
+}
+
+void Profiler::get_scope_stats(std::vector<ScopeStats>& outScopeStats)
+{
+    outScopeStats.clear();
+
+    std::vector<float> frameTimes;
+    for (auto& [name, scopeHistory] : s_scopeHistoriesByName)
+    {
+        if (!scopeHistory->sampleCount)
+            continue;
+
+        frameTimes.assign(scopeHistory->frameTimes.begin(), scopeHistory->frameTimes.begin() + scopeHistory->sampleCount);
+        std::sort(frameTimes.begin(), frameTimes.end());
+
+        double timeSum = 0.0;
+        uint64 callCount = 0;
+        for (uint32 i = 0; i != scopeHistory->sampleCount; ++i)
+        {
+            timeSum += frameTimes[i];
+            callCount += scopeHistory->callCounts[i];
+        }
+
+        uint64 p99Index = (uint64)std::ceil(frameTimes.size() * 0.99) - 1;
+
+        ScopeStats& scopeStats = outScopeStats.emplace_back();
+        scopeStats.name = name;
+        scopeStats.minTime = frameTimes.front();
+        scopeStats.avgTime = timeSum / scopeHistory->sampleCount;
+        scopeStats.p99Time = frameTimes[p99Index];
+        scopeStats.maxTime = frameTimes.back();
+        scopeStats.callsPerFrame = double(callCount) / scopeHistory->sampleCount;
+        scopeStats.frameCount = scopeHistory->sampleCount;
+    }
+
+    std::sort(outScopeStats.begin(), outScopeStats.end(), [](const ScopeStats& first, const ScopeStats& second)
+    {
+        return first.avgTime > second.avgTime;
+    });
+}
+
+bool Profiler::export_capture(const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        FE_LOG(LogProfiler, ERROR, "Profiler::export_capture(): Failed to open {}", path);
+        return false;
+    }
+
+    uint64 frameCount = std::min<uint64>(s_frameCount, s_frameHistorySize);
+    uint64 firstFrameNumber = s_frameCount - frameCount;
+    uint64 captureBeginTime = frameCount ? s_frames[firstFrameNumber % s_frameHistorySize].beginTime : 0;
+
+    std::vector<ScopeStats> scopeStats;
+    get_scope_stats(scopeStats);
+
+    file << fmt::format("{{\"displayTimeUnit\":\"ns\",\"frameCount\":{},\"scopes\":[", frameCount);
+    for (uint64 i = 0; i != scopeStats.size(); ++i)
+    {
+        const ScopeStats& stats = scopeStats[i];
+        file << fmt::format("{}\n{{\"name\":\"{}\",\"minMs\":{:.4f},\"avgMs\":{:.4f},\"p99Ms\":{:.4f},\"maxMs\":{:.4f},"
+            "\"callsPerFrame\":{:.2f},\"frames\":{}}}",
+            i ? "," : "", stats.name, stats.minTime, stats.avgTime, stats.p99Time, stats.maxTime, stats.callsPerFrame, stats.frameCount);
+    }
+
+    file << "\n],\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Profiler\"}}";
+
+    {
+        std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+        for (const std::unique_ptr<ThreadBuffer>& threadBuffer : s_threadBuffers)
+        {
+            file << fmt::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                threadBuffer->threadIndex, threadBuffer->threadName);
+        }
+    }
+
+    for (uint64 frameNumber = firstFrameNumber; frameNumber != s_frameCount; ++frameNumber)
+    {
+        const Frame& frame = s_frames[frameNumber % s_frameHistorySize];
+
+        // Chrome trace timestamps are in microseconds
+        file << fmt::format(",\n{{\"name\":\"Frame {}\",\"ph\":\"X\",\"pid\":1,\"tid\":-1,\"ts\":{:.3f},\"dur\":{:.3f}}}",
+            frame.frameNumber, double(frame.beginTime - captureBeginTime) / 1000.0, double(frame.endTime - frame.beginTime) / 1000.0);
+
+        for (const ThreadFrame& threadFrame : frame.threads)
+        {
+            for (const ScopeEvent& event : threadFrame.events)
+            {
+                // Scopes that began before the capture are clamped to its beginning
+                uint64 beginTime = std::max(event.beginTime, captureBeginTime);
+                file << fmt::format(",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                    event.name, threadFrame.threadIndex, double(beginTime - captureBeginTime) / 1000.0,
+                    double(event.endTime - beginTime) / 1000.0);
+            }
+        }
+    }
+
+    file << "\n]}\n";
+
+    FE_LOG(LogProfiler, INFO, "Exported {} profiler frames to {}", frameCount, path);
+    return true;
+}
+
+Profiler::ThreadBuffer* Profiler::get_thread_buffer()
+{
+    if (s_threadBuffer)
+        return s_threadBuffer;
+
+    std::unique_ptr<ThreadBuffer> threadBuffer = std::make_unique<ThreadBuffer>();
+
+    std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+    threadBuffer->threadIndex = (uint32)s_threadBuffers.size();
+
+    const std::string& threadName = TaskTracer::get_thread_name();
+    threadBuffer->threadName = threadName.empty() ? "thread_" + std::to_string(threadBuffer->threadIndex) : threadName;
+
+    s_threadBuffer = s_threadBuffers.emplace_back(std::move(threadBuffer)).get();
+    return s_threadBuffer;
+}
+
+Profiler::ScopeHistory* Profiler::get_scope_history(const char* name)
+{
+    auto it = s_scopeHistoriesByNamePtr.find(name);
+    if (it != s_scopeHistoriesByNamePtr.end())
+        return it->second;
+
+    // The same literal can have different addresses in different translation units
+    std::unique_ptr<ScopeHistory>& scopeHistory = s_scopeHistoriesByName[name];
+    if (!scopeHistory)
+    {
+        scopeHistory = std::make_unique<ScopeHistory>();
+        scopeHistory->name = name;
+    }
+
+    s_scopeHistoriesByNamePtr[name] = scopeHistory.get();
+    return scopeHistory.get();
+}
+
+void Profiler::update_scope_histories(const Frame& frame)
+{
+    s_frameScopeHistories.clear();
+
+    for (const ThreadFrame& threadFrame : frame.threads)
+    {
+        for (const ScopeEvent& event : threadFrame.events)
+        {
+            ScopeHistory* scopeHistory = get_scope_history(event.name);
+            if (scopeHistory->lastFrameNumber != frame.frameNumber)
+            {
+                scopeHistory->lastFrameNumber = frame.frameNumber;
+                scopeHistory->frameTime = 0;
+                scopeHistory->frameCallCount = 0;
+                s_frameScopeHistories.push_back(scopeHistory);
+            }
+
+            scopeHistory->frameTime += event.endTime - event.beginTime;
+            ++scopeHistory->frameCallCount;
+        }
+    }
+
+    for (ScopeHistory* scopeHistory : s_frameScopeHistories)
+    {
+        scopeHistory->frameTimes[scopeHistory->nextSampleIndex] = float(double(scopeHistory->frameTime) / 1000000.0);
+        scopeHistory->callCounts[scopeHistory->nextSampleIndex] = scopeHistory->frameCallCount;
+        scopeHistory->nextSampleIndex = (scopeHistory->nextSampleIndex + 1) % s_frameHistorySize;
+        scopeHistory->sampleCount = std::min(scopeHistory->sampleCount + 1, s_frameHistorySize);
+    }
+}
+
+}
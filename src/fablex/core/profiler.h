@@ -0,0 +1,165 @@
+#pragma once
+
+#include "types.h"
+#include "macro.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fe
+{
+
+// Records nested CPU scopes of all threads per frame and keeps rolling statistics for each scope name.
+// Scopes are grouped into frames by begin_frame(), scopes that cross a frame boundary belong to the frame where they end.
+// When the profiler is disabled, a scope costs one relaxed atomic load.
+class Profiler
+{
+public:
+    constexpr static uint32 s_frameHistorySize = 256;
+
+    struct ScopeEvent
+    {
+        // Must point to a string with static storage duration, for example a string literal
+        const char* name;
+        uint64 beginTime;
+        uint64 endTime;
+        uint32 depth;
+    };
+
+    struct ThreadFrame
+    {
+        uint32 threadIndex = 0;
+        std::vector<ScopeEvent> events;
+    };
+
+    struct Frame
+    {
+        uint64 frameNumber = 0;
+        uint64 beginTime = 0;
+        uint64 endTime = 0;
+        std::vector<ThreadFrame> threads;
+    };
+
+    // Times are in milliseconds, statistics are calculated over frames in which the scope was executed
+    struct ScopeStats
+    {
+        std::string name;
+        double minTime = 0.0;
+        double avgTime = 0.0;
+        double p99Time = 0.0;
+        double maxTime = 0.0;
+        double callsPerFrame = 0.0;
+        uint32 frameCount = 0;
+    };
+
+    static void set_enabled(bool isEnabled);
+
+    static bool is_enabled()
+    {
+        return s_isEnabled.load(std::memory_order_relaxed);
+    }
+
+    // Finishes the current frame and starts a new one. Core::update() calls it once per frame.
+    // Functions below that read frames must be called from the same thread.
+    static void begin_frame();
+
+    static void begin_scope(const char* name);
+    static void end_scope();
+
+    // Returns nullptr if no frame has been finished since the profiler was enabled
+    static const Frame* get_last_frame();
+    static const std::string& get_thread_name(uint32 threadIndex);
+
+    // Durations of finished frames in milliseconds, from the oldest to the newest
+    static void get_frame_times(std::vector<float>& outFrameTimes);
+    // Sorted by average time, the most expensive scope is the first
+    static void get_scope_stats(std::vector<ScopeStats>& outScopeStats);
+
+    // Writes scope statistics and all frames in the history. Events are in Chrome trace event format,
+    // so the capture can be opened in chrome://tracing or ui.perfetto.dev. Returns false if the file can't be opened.
+    static bool export_capture(const std::string& path);
+
+private:
+    struct OpenScope
+    {
+        const char* name;
+        uint64 beginTime;
+    };
+
+    struct ThreadBuffer
+    {
+        std::string threadName;
+        uint32 threadIndex = 0;
+
+        // Taken by the owner thread when a scope ends and by begin_frame(), so it is almost never contended
+        std::mutex mutex;
+        std::vector<ScopeEvent> events;
+
+        // Used only by the owner thread
+        std::vector<OpenScope> openScopes;
+    };
+
+    struct ScopeHistory
+    {
+        std::string name;
+        std::array<float, s_frameHistorySize> frameTimes{};
+        std::array<uint32, s_frameHistorySize> callCounts{};
+        uint32 sampleCount = 0;
+        uint32 nextSampleIndex = 0;
+
+        // Accumulated while the current frame is processed
+        uint64 lastFrameNumber = ~0ull;
+        uint64 frameTime = 0;
+        uint32 frameCallCount = 0;
+    };
+
+    inline static std::atomic_bool s_isEnabled = false;
+
+    inline static std::mutex s_threadBuffersMutex;
+    inline static std::vector<std::unique_ptr<ThreadBuffer>> s_threadBuffers;
+    inline static thread_local ThreadBuffer* s_threadBuffer = nullptr;
+
+    // Used only by the thread that calls begin_frame()
+    static std::array<Frame, s_frameHistorySize> s_frames;
+    inline static uint64 s_frameCount = 0;
+    inline static uint64 s_frameBeginTime = 0;
+    inline static std::unordered_map<std::string, std::unique_ptr<ScopeHistory>> s_scopeHistoriesByName;
+    inline static std::unordered_map<const char*, ScopeHistory*> s_scopeHistoriesByNamePtr;
+    inline static std::vector<ScopeHistory*> s_frameScopeHistories;
+
+    static ThreadBuffer* get_thread_buffer();
+    static ScopeHistory* get_scope_history(const char* name);
+    static void update_scope_histories(const Frame& frame);
+};
+
+class ProfileScope
+{
+public:
+    ProfileScope(const char* name) : m_isActive(Profiler::is_enabled())
+    {
+        if (m_isActive)
+            Profiler::begin_scope(name);
+    }
+
+    ~ProfileScope()
+    {
+        if (m_isActive)
+            Profiler::end_scope();
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    bool m_isActive;
+};
+
+}
+
+// Name must be a string literal, for example FE_PROFILE_SCOPE("SceneManager::upload")
+#define FE_PROFILE_SCOPE(ScopeName) fe::ProfileScope FE_CONCAT(profileScope, __LINE__)(ScopeName)
@@ -0,0 +1,333 @@
+#include "bvh.h"
+#include "core/primitives/frustum.h"
+#include "core/task_composer.h"
+
+#include <numeric>
+
+namespace fe
+{
+
+constexpr uint32 BVH_BIN_COUNT = 16;
+// Smaller subtrees are built by the task that built their parent
+constexpr uint32 BVH_PARALLEL_BUILD_MIN_PRIMITIVE_COUNT = 4096;
+// Set in stack entries of frustum queries when the node is completely inside the frustum
+constexpr uint32 BVH_INSIDE_NODE_FLAG = 1u << 31;
+
+float get_axis(const Float3& vec, uint32 axis)
+{
+    return (&vec.x)[axis];
+}
+
+float get_half_surface_area(const Float3& minPoint, const Float3& maxPoint)
+{
+    float x = maxPoint.x - minPoint.x;
+    float y = maxPoint.y - minPoint.y;
+    float z = maxPoint.z - minPoint.z;
+    return x * y + y * z + z * x;
+}
+
+void expand(Float3& minPoint, Float3& maxPoint, const Float3& pointMin, const Float3& pointMax)
+{
+    minPoint = Float3(std::min(minPoint.x, pointMin.x), std::min(minPoint.y, pointMin.y), std::min(minPoint.z, pointMin.z));
+    maxPoint = Float3(std::max(maxPoint.x, pointMax.x), std::max(maxPoint.y, pointMax.y), std::max(maxPoint.z, pointMax.z));
+}
+
+bool overlaps(const Float3& aMin, const Float3& aMax, const Float3& bMin, const Float3& bMax)
+{
+    return aMin.x <= bMax.x && aMax.x >= bMin.x
+        && aMin.y <= bMax.y && aMax.y >= bMin.y
+        && aMin.z <= bMax.z && aMax.z >= bMin.z;
+}
+
+void BVH::build(const std::vector<AABB>& primitiveAABBs)
+{
+    const uint32 primitiveCount = (uint32)primitiveAABBs.size();
+
+    m_primitiveAABBs = primitiveAABBs;
+    m_primitiveIndices.resize(primitiveCount);
+    std::iota(m_primitiveIndices.begin(), m_primitiveIndices.end(), 0);
+    m_nodes.clear();
+    m_depth = 0;
+
+    if (!primitiveCount)
+        return;
+
+    m_centroids.resize(primitiveCount);
+    for (uint32 i = 0; i != primitiveCount; ++i)
+        m_centroids[i] = primitiveAABBs[i].get_center();
+
+    // A binary tree with one primitive per leaf has 2n - 1 nodes, unused nodes are removed after building
+    m_nodes.resize(primitiveCount * 2 - 1);
+    m_nodeCount.store(1, std::memory_order_relaxed);
+    m_buildDepth.store(0, std::memory_order_relaxed);
+
+    if (primitiveCount >= BVH_PARALLEL_BUILD_MIN_PRIMITIVE_COUNT * 2 && TaskComposer::get_thread_count(TaskGroup::Priority::HIGH))
+    {
+        TaskGroup taskGroup;
+        build_node(0, 0, primitiveCount, 0, &taskGroup);
+        TaskComposer::wait(taskGroup);
+    }
+    else
+    {
+        build_node(0, 0, primitiveCount, 0, nullptr);
+    }
+
+    m_nodes.resize(m_nodeCount.load(std::memory_order_relaxed));
+    m_depth = m_buildDepth.load(std::memory_order_relaxed);
+    m_centroids = {};
+}
+
+void BVH::build_node(uint32 nodeIndex, uint32 begin, uint32 end, uint32 depth, TaskGroup* taskGroup)
+{
+    Node& node = m_nodes[nodeIndex];
+    node.minPoint = Float3(FLOAT_MAX, FLOAT_MAX, FLOAT_MAX);
+    node.maxPoint = Float3(-FLOAT_MAX, -FLOAT_MAX, -FLOAT_MAX);
+    for (uint32 i = begin; i != end; ++i)
+    {
+        const AABB& aabb = m_primitiveAABBs[m_primitiveIndices[i]];
+        expand(node.minPoint, node.maxPoint, aabb.minPoint, aabb.maxPoint);
+    }
+
+    uint32 buildDepth = m_buildDepth.load(std::memory_order_relaxed);
+    while (buildDepth < depth && !m_buildDepth.compare_exchange_weak(buildDepth, depth, std::memory_order_relaxed));
+
+    // Depth is limited, so traversal stacks have a fixed size
+    uint32 middle = begin;
+    if (end - begin > s_maxLeafPrimitiveCount && depth + 1 < s_maxDepth)
+        middle = split_by_sah(begin, end);
+
+    if (middle == begin)
+    {
+        node.firstIndex = begin;
+        node.primitiveCount = end - begin;
+        return;
+    }
+
+    uint32 childIndex = m_nodeCount.fetch_add(2, std::memory_order_relaxed);
+    node.firstIndex = childIndex;
+    node.primitiveCount = 0;
+
+    if (taskGroup && end - middle >= BVH_PARALLEL_BUILD_MIN_PRIMITIVE_COUNT)
+    {
+        TaskComposer::execute(*taskGroup, [this, childIndex, middle, end, depth, taskGroup](TaskExecutionInfo)
+        {
+            build_node(childIndex + 1, middle, end, depth + 1, taskGroup);
+        });
+    }
+    else
+    {
+        build_node(childIndex + 1, middle, end, depth + 1, taskGroup);
+    }
+
+    build_node(childIndex, begin, middle, depth + 1, taskGroup);
+}
+
+uint32 BVH::split_by_sah(uint32 begin, uint32 end)
+{
+    Float3 centroidMin(FLOAT_MAX, FLOAT_MAX, FLOAT_MAX);
+    Float3 centroidMax(-FLOAT_MAX, -FLOAT_MAX, -FLOAT_MAX);
+    for (uint32 i = begin; i != end; ++i)
+    {
+        const Float3& centroid = m_centroids[m_primitiveIndices[i]];
+        expand(centroidMin, centroidMax, centroid, centroid);
+    }
+
+    struct Bin
+    {
+        Float3 minPoint{ FLOAT_MAX, FLOAT_MAX, FLOAT_MAX };
+        Float3 maxPoint{ -FLOAT_MAX, -FLOAT_MAX, -FLOAT_MAX };
+        uint32 primitiveCount = 0;
+    };
+
+    float bestCost = FLOAT_MAX;
+    uint32 bestAxis = 0;
+    uint32 bestSplit = 0;
+
+    for (uint32 axis = 0; axis != 3; ++axis)
+    {
+        float axisMin = get_axis(centroidMin, axis);
+        float extent = get_axis(centroidMax, axis) - axisMin;
+        if (extent <= 0.0f)
+            continue;
+
+        Bin bins[BVH_BIN_COUNT];
+        float scale = BVH_BIN_COUNT / extent;
+        for (uint32 i = begin; i != end; ++i)
+        {
+            uint32 primitiveIndex = m_primitiveIndices[i];
+            uint32 binIndex = std::min(uint32((get_axis(m_centroids[primitiveIndex], axis) - axisMin) * scale), BVH_BIN_COUNT - 1);
+            Bin& bin = bins[binIndex];
+            expand(bin.minPoint, bin.maxPoint, m_primitiveAABBs[primitiveIndex].minPoint, m_primitiveAABBs[primitiveIndex].maxPoint);
+            ++bin.primitiveCount;
+        }
+
+        // Cost of a split after bin i is known after sweeping from both sides
+        float leftCosts[BVH_BIN_COUNT - 1];
+        Bin leftBin;
+        for (uint32 i = 0; i != BVH_BIN_COUNT - 1; ++i)
+        {
+            expand(leftBin.minPoint, leftBin.maxPoint, bins[i].minPoint, bins[i].maxPoint);
+            leftBin.primitiveCount += bins[i].primitiveCount;
+            leftCosts[i] = leftBin.primitiveCount ? leftBin.primitiveCount * get_half_surface_area(leftBin.minPoint, leftBin.maxPoint) : FLOAT_MAX;
+        }
+
+        Bin rightBin;
+        for (uint32 i = BVH_BIN_COUNT - 1; i != 0; --i)
+        {
+            expand(rightBin.minPoint, rightBin.maxPoint, bins[i].minPoint, bins[i].maxPoint);
+            rightBin.primitiveCount += bins[i].primitiveCount;
+            if (!rightBin.primitiveCount || leftCosts[i - 1] == FLOAT_MAX)
+                continue;
+
+            float cost = leftCosts[i - 1] + rightBin.primitiveCount * get_half_surface_area(rightBin.minPoint, rightBin.maxPoint);
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = i - 1;
+            }
+        }
+    }
+
+    uint32* indices = m_primitiveIndices.data();
+    uint32* middle = indices + begin;
+
+    if (bestCost != FLOAT_MAX)
+    {
+        float axisMin = get_axis(centroidMin, bestAxis);
+        float scale = BVH_BIN_COUNT / (get_axis(centroidMax, bestAxis) - axisMin);
+        middle = std::partition(indices + begin, indices + end, [&](uint32 primitiveIndex)
+        {
+            uint32 binIndex = std::min(uint32((get_axis(m_centroids[primitiveIndex], bestAxis) - axisMin) * scale), BVH_BIN_COUNT - 1);
+            return binIndex <= bestSplit;
+        });
+    }
+
+    // All centroids are in one point, primitives are split in half so the leaf stays small
+    if (middle == indices + begin || middle == indices + end)
+        return begin + (end - begin) / 2;
+
+    return uint32(middle - indices);
+}
+
+void BVH::refit()
+{
+    for (uint32 nodeIndex = (uint32)m_nodes.size(); nodeIndex-- != 0;)
+    {
+        Node& node = m_nodes[nodeIndex];
+        node.minPoint = Float3(FLOAT_MAX, FLOAT_MAX, FLOAT_MAX);
+        node.maxPoint = Float3(-FLOAT_MAX, -FLOAT_MAX, -FLOAT_MAX);
+
+        // Children are always allocated after their parent, so they are already refitted
+        if (node.is_leaf())
+        {
+            for (uint32 i = node.firstIndex; i != node.firstIndex + node.primitiveCount; ++i)
+            {
+                const AABB& aabb = m_primitiveAABBs[m_primitiveIndices[i]];
+                expand(node.minPoint, node.maxPoint, aabb.minPoint, aabb.maxPoint);
+            }
+        }
+        else
+        {
+            const Node& leftNode = m_nodes[node.firstIndex];
+            const Node& rightNode = m_nodes[node.firstIndex + 1];
+            expand(node.minPoint, node.maxPoint, leftNode.minPoint, leftNode.maxPoint);
+            expand(node.minPoint, node.maxPoint, rightNode.minPoint, rightNode.maxPoint);
+        }
+    }
+}
+
+bool BVH::closest_hit(const Ray& ray, Hit& outHit) const
+{
+    return closest_hit(ray, [this](uint32 primitiveIndex, const Ray& ray, float& outDistance)
+    {
+        const AABB& aabb = m_primitiveAABBs[primitiveIndex];
+        return intersects(aabb.minPoint, aabb.maxPoint, ray, ray.tmax, outDistance);
+    }, outHit);
+}
+
+bool BVH::any_hit(const Ray& ray) const
+{
+    return any_hit(ray, [this](uint32 primitiveIndex, const Ray& ray, float& outDistance)
+    {
+        const AABB& aabb = m_primitiveAABBs[primitiveIndex];
+        return intersects(aabb.minPoint, aabb.maxPoint, ray, ray.tmax, outDistance);
+    });
+}
+
+void BVH::query_overlaps(const AABB& aabb, std::vector<uint32>& outPrimitiveIndices) const
+{
+    if (m_nodes.empty())
+        return;
+
+    uint32 stack[s_maxDepth];
+    uint32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize)
+    {
+        const Node& node = m_nodes[stack[--stackSize]];
+        if (!overlaps(node.minPoint, node.maxPoint, aabb.minPoint, aabb.maxPoint))
+            continue;
+
+        if (!node.is_leaf())
+        {
+            stack[stackSize++] = node.firstIndex + 1;
+            stack[stackSize++] = node.firstIndex;
+            continue;
+        }
+
+        for (uint32 i = node.firstIndex; i != node.firstIndex + node.primitiveCount; ++i)
+        {
+            const AABB& primitiveAABB = m_primitiveAABBs[m_primitiveIndices[i]];
+            if (overlaps(primitiveAABB.minPoint, primitiveAABB.maxPoint, aabb.minPoint, aabb.maxPoint))
+                outPrimitiveIndices.push_back(m_primitiveIndices[i]);
+        }
+    }
+}
+
+void BVH::query_frustum(const Frustum& frustum, std::vector<uint32>& outPrimitiveIndices) const
+{
+    if (m_nodes.empty())
+        return;
+
+    uint32 stack[s_maxDepth];
+    uint32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize)
+    {
+        uint32 stackEntry = stack[--stackSize];
+        const Node& node = m_nodes[stackEntry & ~BVH_INSIDE_NODE_FLAG];
+
+        // Primitives of nodes that are completely inside are added without tests
+        uint32 insideFlag = stackEntry & BVH_INSIDE_NODE_FLAG;
+        if (!insideFlag)
+        {
+            AABB nodeAABB;
+            nodeAABB.minPoint = node.minPoint;
+            nodeAABB.maxPoint = node.maxPoint;
+
+            AABB::IntersectionType intersectionType = frustum.classify(nodeAABB);
+            if (intersectionType == AABB::IntersectionType::OUTSIDE)
+                continue;
+            if (intersectionType == AABB::IntersectionType::INSIDE)
+                insideFlag = BVH_INSIDE_NODE_FLAG;
+        }
+
+        if (!node.is_leaf())
+        {
+            stack[stackSize++] = (node.firstIndex + 1) | insideFlag;
+            stack[stackSize++] = node.firstIndex | insideFlag;
+            continue;
+        }
+
+        for (uint32 i = node.firstIndex; i != node.firstIndex + node.primitiveCount; ++i)
+        {
+            if (insideFlag || frustum.intersects(m_primitiveAABBs[m_primitiveIndices[i]]))
+                outPrimitiveIndices.push_back(m_primitiveIndices[i]);
+        }
+    }
+}
+
+}
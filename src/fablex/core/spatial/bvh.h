@@ -0,0 +1,195 @@
+#pragma once
+
+#include "core/primitives/aabb.h"
+#include "core/primitives/ray.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace fe
+{
+
+struct Frustum;
+class TaskGroup;
+
+// Bounding volume hierarchy over primitive AABBs, for example world space AABBs of model instances.
+// Built with binned SAH, subtrees of big nodes are built in parallel on TaskComposer. When primitives move,
+// refit updates node bounds without changing the tree, build again if queries become slow after big moves.
+// Queries don't allocate except for output arrays and can be called from several threads at once.
+class BVH
+{
+public:
+    constexpr static uint32 s_maxLeafPrimitiveCount = 4;
+    constexpr static uint32 s_maxDepth = 64;
+
+    struct Node
+    {
+        Float3 minPoint;
+        // First child for inner nodes, the second child is next to it. First primitive index for leaves.
+        uint32 firstIndex;
+        Float3 maxPoint;
+        // 0 for inner nodes
+        uint32 primitiveCount;
+
+        bool is_leaf() const { return primitiveCount != 0; }
+    };
+
+    struct Hit
+    {
+        uint32 primitiveIndex = ~0u;
+        // In units of the ray direction
+        float distance = FLOAT_MAX;
+    };
+
+    void build(const std::vector<AABB>& primitiveAABBs);
+
+    // Node bounds are updated from primitive AABBs, the count of primitives must be the same as in build
+    void set_primitive_aabb(uint32 primitiveIndex, const AABB& aabb) { m_primitiveAABBs[primitiveIndex] = aabb; }
+    void refit();
+
+    // Hit distance is the distance to the primitive AABB
+    bool closest_hit(const Ray& ray, Hit& outHit) const;
+    bool any_hit(const Ray& ray) const;
+
+    // primitiveIntersector(uint32 primitiveIndex, const Ray& ray, float& outDistance) -> bool tests the primitive
+    // when the ray hits its AABB. Used to find hits with geometry inside of boxes.
+    template<typename PrimitiveIntersector>
+    bool closest_hit(const Ray& ray, const PrimitiveIntersector& primitiveIntersector, Hit& outHit) const;
+    template<typename PrimitiveIntersector>
+    bool any_hit(const Ray& ray, const PrimitiveIntersector& primitiveIntersector) const;
+
+    // Append indices of primitives whose AABBs overlap the box or pass Frustum::intersects
+    void query_overlaps(const AABB& aabb, std::vector<uint32>& outPrimitiveIndices) const;
+    void query_frustum(const Frustum& frustum, std::vector<uint32>& outPrimitiveIndices) const;
+
+    const std::vector<Node>& get_nodes() const { return m_nodes; }
+    // Leaves reference ranges of this array
+    const std::vector<uint32>& get_primitive_indices() const { return m_primitiveIndices; }
+    uint32 get_primitive_count() const { return (uint32)m_primitiveAABBs.size(); }
+    const AABB& get_primitive_aabb(uint32 primitiveIndex) const { return m_primitiveAABBs[primitiveIndex]; }
+    uint32 get_depth() const { return m_depth; }
+
+private:
+    std::vector<Node> m_nodes;
+    // Leaves reference ranges of this array
+    std::vector<uint32> m_primitiveIndices;
+    std::vector<AABB> m_primitiveAABBs;
+    uint32 m_depth = 0;
+
+    // Used only while building
+    std::vector<Float3> m_centroids;
+    std::atomic<uint32> m_nodeCount{ 0 };
+    std::atomic<uint32> m_buildDepth{ 0 };
+
+    void build_node(uint32 nodeIndex, uint32 begin, uint32 end, uint32 depth, TaskGroup* taskGroup);
+    // Returns the first index of the right part, or begin if the range must be a leaf
+    uint32 split_by_sah(uint32 begin, uint32 end);
+
+    // Returns false if the ray misses the box, otherwise outDistance is where the ray enters it
+    static bool intersects(const Float3& minPoint, const Float3& maxPoint, const Ray& ray, float maxDistance, float& outDistance)
+    {
+        float t1 = (minPoint.x - ray.origin.x) * ray.directionInverse.x;
+        float t2 = (maxPoint.x - ray.origin.x) * ray.directionInverse.x;
+        float tNear = std::min(t1, t2);
+        float tFar = std::max(t1, t2);
+
+        t1 = (minPoint.y - ray.origin.y) * ray.directionInverse.y;
+        t2 = (maxPoint.y - ray.origin.y) * ray.directionInverse.y;
+        tNear = std::max(tNear, std::min(t1, t2));
+        tFar = std::min(tFar, std::max(t1, t2));
+
+        t1 = (minPoint.z - ray.origin.z) * ray.directionInverse.z;
+        t2 = (maxPoint.z - ray.origin.z) * ray.directionInverse.z;
+        tNear = std::max(tNear, std::min(t1, t2));
+        tFar = std::min(tFar, std::max(t1, t2));
+
+        outDistance = std::max(tNear, ray.tmin);
+        return outDistance <= std::min(tFar, maxDistance);
+    }
+
+    template<bool IsAnyHit, typename PrimitiveIntersector>
+    bool traverse(const Ray& ray, const PrimitiveIntersector& primitiveIntersector, Hit& outHit) const;
+};
+
+template<typename PrimitiveIntersector>
+bool BVH::closest_hit(const Ray& ray, const PrimitiveIntersector& primitiveIntersector, Hit& outHit) const
+{
+    return traverse<false>(ray, primitiveIntersector, outHit);
+}
+
+template<typename PrimitiveIntersector>
+bool BVH::any_hit(const Ray& ray, const PrimitiveIntersector& primitiveIntersector) const
+{
+    Hit hit;
+    return traverse<true>(ray, primitiveIntersector, hit);
+}
+
+template<bool IsAnyHit, typename PrimitiveIntersector>
+bool BVH::traverse(const Ray& ray, const PrimitiveIntersector& primitiveIntersector, Hit& outHit) const
+{
+    if (m_nodes.empty())
+        return false;
+
+    float closestDistance = ray.tmax;
+    bool isHit = false;
+
+    float rootDistance;
+    if (!intersects(m_nodes[0].minPoint, m_nodes[0].maxPoint, ray, closestDistance, rootDistance))
+        return false;
+
+    uint32 stack[s_maxDepth];
+    uint32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize)
+    {
+        const Node& node = m_nodes[stack[--stackSize]];
+
+        if (node.is_leaf())
+        {
+            for (uint32 i = node.firstIndex; i != node.firstIndex + node.primitiveCount; ++i)
+            {
+                uint32 primitiveIndex = m_primitiveIndices[i];
+                float distance;
+                if (!primitiveIntersector(primitiveIndex, ray, distance) || distance < ray.tmin || distance > closestDistance)
+                    continue;
+
+                isHit = true;
+                closestDistance = distance;
+                outHit.primitiveIndex = primitiveIndex;
+                outHit.distance = distance;
+
+                if constexpr (IsAnyHit)
+                    return true;
+            }
+            continue;
+        }
+
+        const Node& leftNode = m_nodes[node.firstIndex];
+        const Node& rightNode = m_nodes[node.firstIndex + 1];
+        float leftDistance, rightDistance;
+        bool isLeftHit = intersects(leftNode.minPoint, leftNode.maxPoint, ray, closestDistance, leftDistance);
+        bool isRightHit = intersects(rightNode.minPoint, rightNode.maxPoint, ray, closestDistance, rightDistance);
+
+        // The nearer child is pushed last, so it is visited first and shortens the ray for the other one
+        if (isLeftHit && isRightHit)
+        {
+            bool isLeftNearer = leftDistance <= rightDistance;
+            stack[stackSize++] = isLeftNearer ? node.firstIndex + 1 : node.firstIndex;
+            stack[stackSize++] = isLeftNearer ? node.firstIndex : node.firstIndex + 1;
+        }
+        else if (isLeftHit)
+        {
+            stack[stackSize++] = node.firstIndex;
+        }
+        else if (isRightHit)
+        {
+            stack[stackSize++] = node.firstIndex + 1;
+        }
+    }
+
+    return isHit;
+}
+
+}
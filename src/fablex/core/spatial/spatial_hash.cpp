@@ -0,0 +1,547 @@
+#include "spatial_hash.h"
+#include "core/primitives/frustum.h"
+#include "core/parallel.h"
+
+#include <atomic>
+
+namespace fe
+{
+
+bool overlaps(const AABB& a, const AABB& b)
+{
+    return a.minPoint.x <= b.maxPoint.x && a.maxPoint.x >= b.minPoint.x
+        && a.minPoint.y <= b.maxPoint.y && a.maxPoint.y >= b.minPoint.y
+        && a.minPoint.z <= b.maxPoint.z && a.maxPoint.z >= b.minPoint.z;
+}
+
+bool contains(const AABB& outer, const AABB& inner)
+{
+    return outer.minPoint.x <= inner.minPoint.x && outer.maxPoint.x >= inner.maxPoint.x
+        && outer.minPoint.y <= inner.minPoint.y && outer.maxPoint.y >= inner.maxPoint.y
+        && outer.minPoint.z <= inner.minPoint.z && outer.maxPoint.z >= inner.maxPoint.z;
+}
+
+bool intersects_sphere(const AABB& aabb, const Float3& center, float radius)
+{
+    Float3 closestPoint = min(max(center, aabb.minPoint), aabb.maxPoint);
+    return aabb.is_valid() && distance_squared(closestPoint, center) <= radius * radius;
+}
+
+SpatialHash::SpatialHash(float cellSize)
+{
+    FE_CHECK(cellSize > 0.0f);
+
+    for (uint32 level = 0; level != s_levelCount; ++level)
+    {
+        m_cellSizes[level] = cellSize * float(1u << level);
+        m_inverseCellSizes[level] = 1.0f / m_cellSizes[level];
+    }
+
+    m_cells.emplace_back();
+    m_cellSlots.resize(s_minCellTableCapacity);
+}
+
+uint32 SpatialHash::insert(const AABB& aabb, uint64 userData)
+{
+    uint32 proxy = allocate_proxy(userData);
+    uint64 cellKey = get_cell_key(aabb);
+    add_entry(find_or_create_cell(cellKey), cellKey, proxy, aabb);
+    return proxy;
+}
+
+void SpatialHash::insert(const AABB* aabbs, const uint64* userData, uint32 count, uint32* outProxies)
+{
+    struct KeyedAABB
+    {
+        uint64 key;
+        uint32 index;
+    };
+
+    std::vector<KeyedAABB> keyedAABBs(count);
+    parallel_for(0, count, [&](uint64 begin, uint64 end)
+    {
+        for (uint64 i = begin; i != end; ++i)
+            keyedAABBs[i] = { get_cell_key(aabbs[i]), uint32(i) };
+    });
+
+    // Index order inside of a cell keeps the result the same for any number of workers
+    parallel_sort(keyedAABBs.begin(), keyedAABBs.end(), [](const KeyedAABB& a, const KeyedAABB& b)
+    {
+        return a.key < b.key || (a.key == b.key && a.index < b.index);
+    });
+
+    for (uint32 i = 0; i != count; ++i)
+        outProxies[i] = allocate_proxy(userData ? userData[i] : 0);
+
+    // Cells are found once per run of equal keys, after that runs are written to their cells in parallel
+    struct CellRun
+    {
+        uint32 cellIndex;
+        uint32 begin;
+        uint32 end;
+        uint32 firstEntryIndex;
+    };
+
+    std::vector<CellRun> cellRuns;
+    for (uint32 begin = 0; begin != count;)
+    {
+        uint32 end = begin + 1;
+        while (end != count && keyedAABBs[end].key == keyedAABBs[begin].key)
+            ++end;
+
+        uint32 cellIndex = find_or_create_cell(keyedAABBs[begin].key);
+        std::vector<uint32>& cellProxies = m_cells[cellIndex].proxies;
+        cellRuns.push_back({ cellIndex, begin, end, uint32(cellProxies.size()) });
+        cellProxies.resize(cellProxies.size() + end - begin);
+        begin = end;
+    }
+
+    parallel_for(0, cellRuns.size(), [&](uint64 begin, uint64 end)
+    {
+        for (uint64 runIndex = begin; runIndex != end; ++runIndex)
+        {
+            const CellRun& cellRun = cellRuns[runIndex];
+            std::vector<uint32>& cellProxies = m_cells[cellRun.cellIndex].proxies;
+            for (uint32 i = cellRun.begin; i != cellRun.end; ++i)
+            {
+                const KeyedAABB& keyedAABB = keyedAABBs[i];
+                uint32 proxy = outProxies[keyedAABB.index];
+                uint32 entryIndex = cellRun.firstEntryIndex + i - cellRun.begin;
+                cellProxies[entryIndex] = proxy;
+
+                Proxy& proxyData = m_proxies[proxy];
+                proxyData.aabb = aabbs[keyedAABB.index];
+                proxyData.cellKey = keyedAABB.key;
+                proxyData.cellIndex = cellRun.cellIndex;
+                proxyData.entryIndex = entryIndex;
+            }
+        }
+    }, 64);
+}
+
+void SpatialHash::update(uint32 proxy, const AABB& aabb)
+{
+    FE_CHECK(proxy < m_proxies.size() && m_proxies[proxy].cellIndex != s_invalidProxy);
+
+    uint64 cellKey = get_cell_key(aabb);
+    Proxy& proxyData = m_proxies[proxy];
+    if (proxyData.cellKey == cellKey)
+    {
+        proxyData.aabb = aabb;
+        return;
+    }
+
+    remove_entry(proxy);
+    add_entry(find_or_create_cell(cellKey), cellKey, proxy, aabb);
+}
+
+void SpatialHash::update(const uint32* proxies, const AABB* aabbs, uint32 count)
+{
+    // Most AABBs move inside of their cells, others change cells serially after that
+    std::vector<uint32> movedIndices(count);
+    std::atomic<uint32> movedCount{ 0 };
+
+    parallel_for(0, count, [&](uint64 begin, uint64 end)
+    {
+        for (uint64 i = begin; i != end; ++i)
+        {
+            if (proxies[i] == s_invalidProxy)
+                continue;
+
+            Proxy& proxyData = m_proxies[proxies[i]];
+            FE_CHECK(proxyData.cellIndex != s_invalidProxy);
+
+            if (proxyData.cellKey == get_cell_key(aabbs[i]))
+                proxyData.aabb = aabbs[i];
+            else
+                movedIndices[movedCount.fetch_add(1, std::memory_order_relaxed)] = uint32(i);
+        }
+    });
+
+    movedIndices.resize(movedCount.load(std::memory_order_relaxed));
+    std::sort(movedIndices.begin(), movedIndices.end());
+
+    for (uint32 index : movedIndices)
+    {
+        uint64 cellKey = get_cell_key(aabbs[index]);
+        remove_entry(proxies[index]);
+        add_entry(find_or_create_cell(cellKey), cellKey, proxies[index], aabbs[index]);
+    }
+}
+
+void SpatialHash::remove(uint32 proxy)
+{
+    FE_CHECK(proxy < m_proxies.size() && m_proxies[proxy].cellIndex != s_invalidProxy);
+
+    remove_entry(proxy);
+
+    Proxy& proxyData = m_proxies[proxy];
+    proxyData.cellIndex = s_invalidProxy;
+    proxyData.entryIndex = m_firstFreeProxy;
+    m_firstFreeProxy = proxy;
+    --m_proxyCount;
+}
+
+void SpatialHash::clear()
+{
+    m_cells.resize(1);
+    m_cells[s_outsideCellIndex].proxies.clear();
+    m_freeCellIndices.clear();
+    m_cellSlots.assign(s_minCellTableCapacity, CellSlot());
+    m_cellCount = 0;
+    std::fill(std::begin(m_levelCellCounts), std::end(m_levelCellCounts), 0);
+
+    m_proxies.clear();
+    m_firstFreeProxy = s_invalidProxy;
+    m_proxyCount = 0;
+}
+
+void SpatialHash::query_overlaps(const AABB& aabb, std::vector<uint32>& outProxies) const
+{
+    if (!aabb.is_valid())
+        return;
+
+    for (uint32 proxy : m_cells[s_outsideCellIndex].proxies)
+        if (overlaps(m_proxies[proxy].aabb, aabb))
+            outProxies.push_back(proxy);
+
+    for_each_cell(aabb, [&](const Cell& cell, const AABB& looseCellBounds)
+    {
+        // AABBs of the cell can't stick out of its loose bounds
+        if (contains(aabb, looseCellBounds))
+        {
+            outProxies.insert(outProxies.end(), cell.proxies.begin(), cell.proxies.end());
+            return;
+        }
+
+        for (uint32 proxy : cell.proxies)
+            if (overlaps(m_proxies[proxy].aabb, aabb))
+                outProxies.push_back(proxy);
+    });
+}
+
+void SpatialHash::query_sphere(const Float3& center, float radius, std::vector<uint32>& outProxies) const
+{
+    if (radius < 0.0f)
+        return;
+
+    for (uint32 proxy : m_cells[s_outsideCellIndex].proxies)
+        if (intersects_sphere(m_proxies[proxy].aabb, center, radius))
+            outProxies.push_back(proxy);
+
+    AABB sphereAABB;
+    sphereAABB.minPoint = Float3(center.x - radius, center.y - radius, center.z - radius);
+    sphereAABB.maxPoint = Float3(center.x + radius, center.y + radius, center.z + radius);
+
+    for_each_cell(sphereAABB, [&](const Cell& cell, const AABB&)
+    {
+        for (uint32 proxy : cell.proxies)
+            if (intersects_sphere(m_proxies[proxy].aabb, center, radius))
+                outProxies.push_back(proxy);
+    });
+}
+
+void SpatialHash::query_frustum(const Frustum& frustum, std::vector<uint32>& outProxies) const
+{
+    for (uint32 proxy : m_cells[s_outsideCellIndex].proxies)
+        if (frustum.intersects(m_proxies[proxy].aabb))
+            outProxies.push_back(proxy);
+
+    // Frustums can be long, so all cells are classified by their loose bounds instead of looking up a cell range
+    for (uint32 cellIndex = s_outsideCellIndex + 1; cellIndex < m_cells.size(); ++cellIndex)
+    {
+        const Cell& cell = m_cells[cellIndex];
+        if (cell.proxies.empty())
+            continue;
+
+        AABB::IntersectionType intersectionType = frustum.classify(get_loose_cell_bounds(cell));
+        if (intersectionType == AABB::IntersectionType::OUTSIDE)
+            continue;
+
+        if (intersectionType == AABB::IntersectionType::INSIDE)
+        {
+            outProxies.insert(outProxies.end(), cell.proxies.begin(), cell.proxies.end());
+            continue;
+        }
+
+        for (uint32 proxy : cell.proxies)
+            if (frustum.intersects(m_proxies[proxy].aabb))
+                outProxies.push_back(proxy);
+    }
+}
+
+uint64 SpatialHash::get_cell_key(const AABB& aabb) const
+{
+    if (!aabb.is_valid())
+        return s_outsideCellKey;
+
+    float extent = std::max({ aabb.maxPoint.x - aabb.minPoint.x, aabb.maxPoint.y - aabb.minPoint.y, aabb.maxPoint.z - aabb.minPoint.z });
+    uint32 level = 0;
+    while (level != s_levelCount && m_cellSizes[level] < extent)
+        ++level;
+
+    if (level == s_levelCount)
+        return s_outsideCellKey;
+
+    Float3 center = aabb.get_center();
+    float maxCenter = float(s_maxCoordinate) * m_cellSizes[level];
+    if (!(std::abs(center.x) < maxCenter && std::abs(center.y) < maxCenter && std::abs(center.z) < maxCenter))
+        return s_outsideCellKey;
+
+    return make_cell_key(
+        level,
+        get_cell_coordinate(center.x, level),
+        get_cell_coordinate(center.y, level),
+        get_cell_coordinate(center.z, level)
+    );
+}
+
+int32 SpatialHash::get_cell_coordinate(float value, uint32 level) const
+{
+    float coordinate = std::floor(value * m_inverseCellSizes[level]);
+    return int32(std::clamp(coordinate, -float(s_maxCoordinate), float(s_maxCoordinate)));
+}
+
+uint64 SpatialHash::make_cell_key(uint32 level, int32 x, int32 y, int32 z)
+{
+    constexpr uint64 coordinateMask = (1ull << s_coordinateBitCount) - 1;
+    constexpr int32 coordinateOffset = s_maxCoordinate + 1;
+
+    return uint64(level) << (s_coordinateBitCount * 3)
+        | (uint64(x + coordinateOffset) & coordinateMask) << (s_coordinateBitCount * 2)
+        | (uint64(y + coordinateOffset) & coordinateMask) << s_coordinateBitCount
+        | (uint64(z + coordinateOffset) & coordinateMask);
+}
+
+uint64 SpatialHash::hash_cell_key(uint64 key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return key;
+}
+
+uint32 SpatialHash::find_cell(uint64 key) const
+{
+    uint64 slotMask = m_cellSlots.size() - 1;
+    for (uint64 slotIndex = hash_cell_key(key) & slotMask;; slotIndex = (slotIndex + 1) & slotMask)
+    {
+        const CellSlot& slot = m_cellSlots[slotIndex];
+        if (slot.key == key)
+            return slot.cellIndex;
+        if (slot.key == s_outsideCellKey)
+            return s_invalidCellIndex;
+    }
+}
+
+uint32 SpatialHash::find_or_create_cell(uint64 key)
+{
+    if (key == s_outsideCellKey)
+        return s_outsideCellIndex;
+
+    if ((m_cellCount + 1) * 2 > m_cellSlots.size())
+        resize_cell_table(uint32(m_cellSlots.size() * 2));
+
+    uint64 slotMask = m_cellSlots.size() - 1;
+    uint64 slotIndex = hash_cell_key(key) & slotMask;
+    for (; m_cellSlots[slotIndex].key != s_outsideCellKey; slotIndex = (slotIndex + 1) & slotMask)
+    {
+        if (m_cellSlots[slotIndex].key == key)
+            return m_cellSlots[slotIndex].cellIndex;
+    }
+
+    // Cells are reused with their proxy arrays, so entities moving around don't allocate
+    uint32 cellIndex;
+    if (m_freeCellIndices.empty())
+    {
+        cellIndex = uint32(m_cells.size());
+        m_cells.emplace_back();
+    }
+    else
+    {
+        cellIndex = m_freeCellIndices.back();
+        m_freeCellIndices.pop_back();
+    }
+
+    m_cellSlots[slotIndex] = { key, cellIndex };
+    ++m_cellCount;
+
+    constexpr uint64 coordinateMask = (1ull << s_coordinateBitCount) - 1;
+    constexpr int32 coordinateOffset = s_maxCoordinate + 1;
+
+    Cell& cell = m_cells[cellIndex];
+    cell.level = uint32(key >> (s_coordinateBitCount * 3));
+    cell.x = int32((key >> (s_coordinateBitCount * 2)) & coordinateMask) - coordinateOffset;
+    cell.y = int32((key >> s_coordinateBitCount) & coordinateMask) - coordinateOffset;
+    cell.z = int32(key & coordinateMask) - coordinateOffset;
+    ++m_levelCellCounts[cell.level];
+
+    return cellIndex;
+}
+
+void SpatialHash::erase_cell(uint64 key)
+{
+    uint64 slotMask = m_cellSlots.size() - 1;
+    uint64 slotIndex = hash_cell_key(key) & slotMask;
+    while (m_cellSlots[slotIndex].key != key)
+        slotIndex = (slotIndex + 1) & slotMask;
+
+    // Backward shift: following slots move into the hole unless that puts them before their home slot
+    for (uint64 nextSlotIndex = (slotIndex + 1) & slotMask; m_cellSlots[nextSlotIndex].key != s_outsideCellKey; nextSlotIndex = (nextSlotIndex + 1) & slotMask)
+    {
+        uint64 homeSlotIndex = hash_cell_key(m_cellSlots[nextSlotIndex].key) & slotMask;
+        if (((nextSlotIndex - homeSlotIndex) & slotMask) >= ((nextSlotIndex - slotIndex) & slotMask))
+        {
+            m_cellSlots[slotIndex] = m_cellSlots[nextSlotIndex];
+            slotIndex = nextSlotIndex;
+        }
+    }
+
+    m_cellSlots[slotIndex] = CellSlot();
+    --m_cellCount;
+}
+
+void SpatialHash::resize_cell_table(uint32 capacity)
+{
+    std::vector<CellSlot> oldCellSlots(capacity);
+    oldCellSlots.swap(m_cellSlots);
+
+    uint64 slotMask = capacity - 1;
+    for (const CellSlot& oldSlot : oldCellSlots)
+    {
+        if (oldSlot.key == s_outsideCellKey)
+            continue;
+
+        uint64 slotIndex = hash_cell_key(oldSlot.key) & slotMask;
+        while (m_cellSlots[slotIndex].key != s_outsideCellKey)
+            slotIndex = (slotIndex + 1) & slotMask;
+        m_cellSlots[slotIndex] = oldSlot;
+    }
+}
+
+uint32 SpatialHash::allocate_proxy(uint64 userData)
+{
+    ++m_proxyCount;
+
+    if (m_firstFreeProxy != s_invalidProxy)
+    {
+        uint32 proxy = m_firstFreeProxy;
+        m_firstFreeProxy = m_proxies[proxy].entryIndex;
+        m_proxies[proxy].userData = userData;
+        return proxy;
+    }
+
+    Proxy& proxyData = m_proxies.emplace_back();
+    proxyData.userData = userData;
+    proxyData.cellKey = s_outsideCellKey;
+    proxyData.cellIndex = s_invalidProxy;
+    proxyData.entryIndex = 0;
+    return uint32(m_proxies.size() - 1);
+}
+
+void SpatialHash::add_entry(uint32 cellIndex, uint64 cellKey, uint32 proxy, const AABB& aabb)
+{
+    std::vector<uint32>& cellProxies = m_cells[cellIndex].proxies;
+    cellProxies.push_back(proxy);
+
+    Proxy& proxyData = m_proxies[proxy];
+    proxyData.aabb = aabb;
+    proxyData.cellKey = cellKey;
+    proxyData.cellIndex = cellIndex;
+    proxyData.entryIndex = uint32(cellProxies.size() - 1);
+}
+
+void SpatialHash::remove_entry(uint32 proxy)
+{
+    const Proxy& proxyData = m_proxies[proxy];
+    uint32 cellIndex = proxyData.cellIndex;
+    std::vector<uint32>& cellProxies = m_cells[cellIndex].proxies;
+
+    // The last proxy of the cell takes the place of the removed one
+    uint32 lastProxy = cellProxies.back();
+    cellProxies[proxyData.entryIndex] = lastProxy;
+    m_proxies[lastProxy].entryIndex = proxyData.entryIndex;
+    cellProxies.pop_back();
+
+    if (cellProxies.empty() && cellIndex != s_outsideCellIndex)
+    {
+        erase_cell(proxyData.cellKey);
+        m_freeCellIndices.push_back(cellIndex);
+        --m_levelCellCounts[m_cells[cellIndex].level];
+    }
+}
+
+template<typename CellVisitor>
+void SpatialHash::for_each_cell(const AABB& aabb, const CellVisitor& cellVisitor) const
+{
+    // Levels where the box covers more cells than exist are checked by iterating existing cells
+    uint32 scannedLevelMask = 0;
+
+    for (uint32 level = 0; level != s_levelCount; ++level)
+    {
+        if (!m_levelCellCounts[level])
+            continue;
+
+        float looseSize = m_cellSizes[level] * s_looseFactor;
+        int32 minX = get_cell_coordinate(aabb.minPoint.x - looseSize, level);
+        int32 minY = get_cell_coordinate(aabb.minPoint.y - looseSize, level);
+        int32 minZ = get_cell_coordinate(aabb.minPoint.z - looseSize, level);
+        int32 maxX = get_cell_coordinate(aabb.maxPoint.x + looseSize, level);
+        int32 maxY = get_cell_coordinate(aabb.maxPoint.y + looseSize, level);
+        int32 maxZ = get_cell_coordinate(aabb.maxPoint.z + looseSize, level);
+
+        uint64 rangeCellCount = uint64(maxX - minX + 1) * uint64(maxY - minY + 1) * uint64(maxZ - minZ + 1);
+        if (rangeCellCount > m_levelCellCounts[level])
+        {
+            scannedLevelMask |= 1u << level;
+            continue;
+        }
+
+        for (int32 z = minZ; z <= maxZ; ++z)
+        {
+            for (int32 y = minY; y <= maxY; ++y)
+            {
+                for (int32 x = minX; x <= maxX; ++x)
+                {
+                    uint32 cellIndex = find_cell(make_cell_key(level, x, y, z));
+                    if (cellIndex == s_invalidCellIndex)
+                        continue;
+
+                    const Cell& cell = m_cells[cellIndex];
+                    cellVisitor(cell, get_loose_cell_bounds(cell));
+                }
+            }
+        }
+    }
+
+    if (!scannedLevelMask)
+        return;
+
+    for (uint32 cellIndex = s_outsideCellIndex + 1; cellIndex < m_cells.size(); ++cellIndex)
+    {
+        const Cell& cell = m_cells[cellIndex];
+        if (cell.proxies.empty() || !(scannedLevelMask & (1u << cell.level)))
+            continue;
+
+        AABB looseCellBounds = get_loose_cell_bounds(cell);
+        if (overlaps(looseCellBounds, aabb))
+            cellVisitor(cell, looseCellBounds);
+    }
+}
+
+AABB SpatialHash::get_loose_cell_bounds(const Cell& cell) const
+{
+    float cellSize = m_cellSizes[cell.level];
+    float looseSize = cellSize * s_looseFactor;
+
+    AABB looseCellBounds;
+    looseCellBounds.minPoint = Float3(cell.x * cellSize - looseSize, cell.y * cellSize - looseSize, cell.z * cellSize - looseSize);
+    looseCellBounds.maxPoint = Float3(
+        (cell.x + 1) * cellSize + looseSize,
+        (cell.y + 1) * cellSize + looseSize,
+        (cell.z + 1) * cellSize + looseSize
+    );
+    return looseCellBounds;
+}
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "core/primitives/aabb.h"
+
+#include <vector>
+
+namespace fe
+{
+
+struct Frustum;
+
+// Dynamic index of AABBs for proximity queries, for example entities near a light or inside a selection box.
+// Hierarchical hashed grid: the size of level cells doubles from level to level, an AABB is stored in the cell
+// of the smallest level that is not smaller than the AABB, found by the AABB center. So an AABB never sticks out
+// of its cell by more than half of the cell size, and queries check a fixed neighbourhood of cells on each level.
+// Moving an AABB costs one key computation, it is written in place if the cell is the same.
+// AABBs that are too big or too far for the grid are kept in one list that every query tests.
+// Queries don't allocate except for output arrays and can be called from several threads at once,
+// changes must not run concurrently with queries or other changes.
+class SpatialHash
+{
+public:
+    constexpr static uint32 s_invalidProxy = ~0u;
+    constexpr static uint32 s_levelCount = 16;
+
+    // cellSize is the cell size of the first level, a few times bigger than typical AABBs so cells hold several of them
+    SpatialHash(float cellSize = 16.0f);
+
+    // Returns a proxy that identifies the AABB until it is removed. Proxies of removed AABBs are reused.
+    uint32 insert(const AABB& aabb, uint64 userData = 0);
+    // Same as insert for each AABB, cell keys are computed and sorted in parallel on TaskComposer.
+    // userData can be null.
+    void insert(const AABB* aabbs, const uint64* userData, uint32 count, uint32* outProxies);
+
+    void update(uint32 proxy, const AABB& aabb);
+    // Same as update for each proxy, AABBs that stay in their cells are written in parallel on TaskComposer.
+    // Proxies must be unique, s_invalidProxy is skipped.
+    void update(const uint32* proxies, const AABB* aabbs, uint32 count);
+
+    void remove(uint32 proxy);
+    void clear();
+
+    // Append proxies whose AABBs overlap the box, intersect the sphere or pass Frustum::intersects
+    void query_overlaps(const AABB& aabb, std::vector<uint32>& outProxies) const;
+    void query_sphere(const Float3& center, float radius, std::vector<uint32>& outProxies) const;
+    void query_frustum(const Frustum& frustum, std::vector<uint32>& outProxies) const;
+
+    const AABB& get_aabb(uint32 proxy) const { return m_proxies[proxy].aabb; }
+    uint64 get_user_data(uint32 proxy) const { return m_proxies[proxy].userData; }
+
+    uint32 get_proxy_count() const { return m_proxyCount; }
+    // Not counting the list of AABBs that don't fit the grid
+    uint32 get_cell_count() const { return m_cellCount; }
+    float get_cell_size(uint32 level) const { return m_cellSizes[level]; }
+
+private:
+    // Cell of AABBs that don't fit the grid, it is not in the cell table
+    constexpr static uint32 s_outsideCellIndex = 0;
+    constexpr static uint64 s_outsideCellKey = ~0ull;
+    constexpr static uint32 s_invalidCellIndex = ~0u;
+    constexpr static uint32 s_minCellTableCapacity = 1024;
+    // Cell coordinates are stored in 19 bits and the level above them
+    constexpr static uint32 s_coordinateBitCount = 19;
+    constexpr static int32 s_maxCoordinate = (1 << (s_coordinateBitCount - 1)) - 1;
+    // How far AABBs can stick out of their cells in cell sizes. Half of the cell plus a margin for float rounding
+    // of cell coordinates, which is up to 1/64 of the cell at the largest coordinates.
+    constexpr static float s_looseFactor = 0.5f + 1.0f / 16.0f;
+
+    // AABBs are stored in proxies, so updates that don't change cells read and write proxies in order
+    struct Proxy
+    {
+        AABB aabb;
+        uint64 userData;
+        uint64 cellKey;
+        // s_invalidProxy for removed proxies
+        uint32 cellIndex;
+        // Index in the proxy list of the cell, next free proxy for removed proxies
+        uint32 entryIndex;
+    };
+
+    struct Cell
+    {
+        std::vector<uint32> proxies;
+        uint32 level = s_levelCount;
+        int32 x = 0;
+        int32 y = 0;
+        int32 z = 0;
+    };
+
+    // Slot of the open addressing cell table, empty slots have s_outsideCellKey
+    struct CellSlot
+    {
+        uint64 key = s_outsideCellKey;
+        uint32 cellIndex = s_invalidCellIndex;
+    };
+
+    float m_cellSizes[s_levelCount];
+    float m_inverseCellSizes[s_levelCount];
+    uint32 m_levelCellCounts[s_levelCount] = {};
+
+    // The first cell is the list of AABBs that don't fit the grid
+    std::vector<Cell> m_cells;
+    std::vector<uint32> m_freeCellIndices;
+    // Linear probing, capacity is a power of two and at least twice the cell count
+    std::vector<CellSlot> m_cellSlots;
+    uint32 m_cellCount = 0;
+
+    std::vector<Proxy> m_proxies;
+    uint32 m_firstFreeProxy = s_invalidProxy;
+    uint32 m_proxyCount = 0;
+
+    // Returns s_outsideCellKey for AABBs that don't fit the grid
+    uint64 get_cell_key(const AABB& aabb) const;
+    // Clamped to the range of coordinates that keys can store
+    int32 get_cell_coordinate(float value, uint32 level) const;
+    static uint64 make_cell_key(uint32 level, int32 x, int32 y, int32 z);
+    // Cell keys are well distributed in their low bits only for small worlds
+    static uint64 hash_cell_key(uint64 key);
+
+    uint32 find_cell(uint64 key) const;
+    uint32 find_or_create_cell(uint64 key);
+    void erase_cell(uint64 key);
+    void resize_cell_table(uint32 capacity);
+
+    uint32 allocate_proxy(uint64 userData);
+    void add_entry(uint32 cellIndex, uint64 cellKey, uint32 proxy, const AABB& aabb);
+    void remove_entry(uint32 proxy);
+
+    // Calls cellVisitor(const Cell&, const AABB& looseCellBounds) for cells whose loose bounds overlap the box
+    template<typename CellVisitor>
+    void for_each_cell(const AABB& aabb, const CellVisitor& cellVisitor) const;
+    AABB get_loose_cell_bounds(const Cell& cell) const;
+};
+
+}
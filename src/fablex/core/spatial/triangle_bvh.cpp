@@ -0,0 +1,335 @@
+#include "triangle_bvh.h"
+
+#include <xmmintrin.h>
+
+namespace fe
+{
+
+Float3 cross(const Float3& vec1, const Float3& vec2)
+{
+    return Float3(vec1.y * vec2.z - vec1.z * vec2.y, vec1.z * vec2.x - vec1.x * vec2.z, vec1.x * vec2.y - vec1.y * vec2.x);
+}
+
+// Moller-Trumbore, both sides of the triangle are hit
+bool intersects(const TriangleBVH::Triangle& triangle, const Ray& ray, float maxDistance, float& outDistance, Float2& outBarycentrics)
+{
+    Float3 p = cross(ray.direction, triangle.edge2);
+    float determinant = dot(triangle.edge1, p);
+    if (determinant == 0.0f)
+        return false;
+
+    float inverseDeterminant = 1.0f / determinant;
+    Float3 t = ray.origin - triangle.vertex0;
+    float u = dot(t, p) * inverseDeterminant;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+
+    Float3 q = cross(t, triangle.edge1);
+    float v = dot(ray.direction, q) * inverseDeterminant;
+    if (v < 0.0f || u + v > 1.0f)
+        return false;
+
+    float distance = dot(triangle.edge2, q) * inverseDeterminant;
+    if (distance < ray.tmin || distance > maxDistance)
+        return false;
+
+    outDistance = distance;
+    outBarycentrics = Float2(u, v);
+    return true;
+}
+
+void TriangleBVH::build(const std::vector<Float3>& positions, const std::vector<uint32>& indices, const std::vector<uint32>& meshFirstTriangles)
+{
+    const uint32 triangleCount = uint32(indices.size() / 3);
+
+    m_nodes.clear();
+    m_triangles.clear();
+    m_triangleIndices.clear();
+    m_meshFirstTriangles = meshFirstTriangles;
+
+    if (!triangleCount)
+        return;
+
+    std::vector<Triangle> triangles(triangleCount);
+    std::vector<AABB> triangleAABBs(triangleCount);
+    for (uint32 i = 0; i != triangleCount; ++i)
+    {
+        const Float3& vertex0 = positions[indices[i * 3]];
+        const Float3& vertex1 = positions[indices[i * 3 + 1]];
+        const Float3& vertex2 = positions[indices[i * 3 + 2]];
+
+        triangles[i].vertex0 = vertex0;
+        triangles[i].edge1 = vertex1 - vertex0;
+        triangles[i].edge2 = vertex2 - vertex0;
+
+        triangleAABBs[i].minPoint = min(min(vertex0, vertex1), vertex2);
+        triangleAABBs[i].maxPoint = max(max(vertex0, vertex1), vertex2);
+    }
+
+    BVH bvh;
+    bvh.build(triangleAABBs);
+
+    m_triangles.reserve(triangleCount);
+    m_triangleIndices.reserve(triangleCount);
+    collapse_node(bvh, triangles, 0);
+    m_nodes.shrink_to_fit();
+}
+
+uint32 TriangleBVH::collapse_node(const BVH& bvh, const std::vector<Triangle>& triangles, uint32 bvhNodeIndex)
+{
+    const std::vector<BVH::Node>& bvhNodes = bvh.get_nodes();
+
+    uint32 bvhChildren[s_childCount];
+    uint32 childCount = 0;
+    if (bvhNodes[bvhNodeIndex].is_leaf())
+    {
+        // Only the root can be a leaf
+        bvhChildren[childCount++] = bvhNodeIndex;
+    }
+    else
+    {
+        bvhChildren[childCount++] = bvhNodes[bvhNodeIndex].firstIndex;
+        bvhChildren[childCount++] = bvhNodes[bvhNodeIndex].firstIndex + 1;
+    }
+
+    // Inner children with the biggest surface area are replaced with their children, they are hit by rays most often
+    while (childCount != s_childCount)
+    {
+        uint32 bestChild = s_childCount;
+        float bestArea = -1.0f;
+        for (uint32 i = 0; i != childCount; ++i)
+        {
+            const BVH::Node& bvhChild = bvhNodes[bvhChildren[i]];
+            if (bvhChild.is_leaf())
+                continue;
+
+            Float3 size = bvhChild.maxPoint - bvhChild.minPoint;
+            float area = size.x * size.y + size.y * size.z + size.z * size.x;
+            if (area > bestArea)
+            {
+                bestArea = area;
+                bestChild = i;
+            }
+        }
+
+        if (bestChild == s_childCount)
+            break;
+
+        uint32 firstIndex = bvhNodes[bvhChildren[bestChild]].firstIndex;
+        bvhChildren[bestChild] = firstIndex;
+        bvhChildren[childCount++] = firstIndex + 1;
+    }
+
+    // Children are collapsed recursively and can reallocate m_nodes, so the node is filled locally
+    uint32 nodeIndex = (uint32)m_nodes.size();
+    m_nodes.emplace_back();
+
+    Node node{};
+    node.childCount = childCount;
+    for (uint32 i = 0; i != childCount; ++i)
+    {
+        const BVH::Node& bvhChild = bvhNodes[bvhChildren[i]];
+        node.minX[i] = bvhChild.minPoint.x;
+        node.minY[i] = bvhChild.minPoint.y;
+        node.minZ[i] = bvhChild.minPoint.z;
+        node.maxX[i] = bvhChild.maxPoint.x;
+        node.maxY[i] = bvhChild.maxPoint.y;
+        node.maxZ[i] = bvhChild.maxPoint.z;
+
+        if (!bvhChild.is_leaf())
+        {
+            node.children[i] = collapse_node(bvh, triangles, bvhChildren[i]);
+            continue;
+        }
+
+        node.children[i] = (uint32)m_triangles.size();
+        node.triangleCounts[i] = bvhChild.primitiveCount;
+        for (uint32 j = bvhChild.firstIndex; j != bvhChild.firstIndex + bvhChild.primitiveCount; ++j)
+        {
+            uint32 triangleIndex = bvh.get_primitive_indices()[j];
+            m_triangles.push_back(triangles[triangleIndex]);
+            m_triangleIndices.push_back(triangleIndex);
+        }
+    }
+
+    m_nodes[nodeIndex] = node;
+    return nodeIndex;
+}
+
+bool TriangleBVH::closest_hit(const Ray& ray, Hit& outHit) const
+{
+    return traverse<false>(ray, outHit);
+}
+
+bool TriangleBVH::any_hit(const Ray& ray) const
+{
+    Hit hit;
+    return traverse<true>(ray, hit);
+}
+
+uint64 TriangleBVH::get_memory_size() const
+{
+    return m_nodes.capacity() * sizeof(Node)
+        + m_triangles.capacity() * sizeof(Triangle)
+        + m_triangleIndices.capacity() * sizeof(uint32)
+        + m_meshFirstTriangles.capacity() * sizeof(uint32);
+}
+
+template<bool IsAnyHit>
+bool TriangleBVH::traverse(const Ray& ray, Hit& outHit) const
+{
+    if (m_nodes.empty())
+        return false;
+
+    const __m128 originX = _mm_set1_ps(ray.origin.x);
+    const __m128 originY = _mm_set1_ps(ray.origin.y);
+    const __m128 originZ = _mm_set1_ps(ray.origin.z);
+    const __m128 directionInverseX = _mm_set1_ps(ray.directionInverse.x);
+    const __m128 directionInverseY = _mm_set1_ps(ray.directionInverse.y);
+    const __m128 directionInverseZ = _mm_set1_ps(ray.directionInverse.z);
+    const __m128 minDistance = _mm_set1_ps(ray.tmin);
+
+    float closestDistance = ray.tmax;
+    uint32 closestTriangle = ~0u;
+    Float2 closestBarycentrics;
+
+    uint32 stack[s_maxStackSize];
+    uint32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize)
+    {
+        const Node& node = m_nodes[stack[--stackSize]];
+
+        // Slab test of all children at once
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minX), originX), directionInverseX);
+        __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxX), originX), directionInverseX);
+        __m128 nearDistances = _mm_min_ps(t1, t2);
+        __m128 farDistances = _mm_max_ps(t1, t2);
+
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minY), originY), directionInverseY);
+        t2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxY), originY), directionInverseY);
+        nearDistances = _mm_max_ps(nearDistances, _mm_min_ps(t1, t2));
+        farDistances = _mm_min_ps(farDistances, _mm_max_ps(t1, t2));
+
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minZ), originZ), directionInverseZ);
+        t2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxZ), originZ), directionInverseZ);
+        nearDistances = _mm_max_ps(_mm_max_ps(nearDistances, _mm_min_ps(t1, t2)), minDistance);
+        farDistances = _mm_min_ps(_mm_min_ps(farDistances, _mm_max_ps(t1, t2)), _mm_set1_ps(closestDistance));
+
+        uint32 hitMask = uint32(_mm_movemask_ps(_mm_cmple_ps(nearDistances, farDistances))) & ((1u << node.childCount) - 1);
+        if (!hitMask)
+            continue;
+
+        alignas(16) float childDistances[s_childCount];
+        _mm_store_ps(childDistances, nearDistances);
+
+        // Leaves are tested right away, inner children are sorted so the nearest one is popped first
+        uint32 innerChildren[s_childCount];
+        float innerDistances[s_childCount];
+        uint32 innerChildCount = 0;
+
+        for (uint32 i = 0; i != s_childCount; ++i)
+        {
+            if (!(hitMask & (1u << i)))
+                continue;
+
+            if (!node.triangleCounts[i])
+            {
+                uint32 insertIndex = innerChildCount++;
+                for (; insertIndex != 0 && innerDistances[insertIndex - 1] < childDistances[i]; --insertIndex)
+                {
+                    innerChildren[insertIndex] = innerChildren[insertIndex - 1];
+                    innerDistances[insertIndex] = innerDistances[insertIndex - 1];
+                }
+                innerChildren[insertIndex] = node.children[i];
+                innerDistances[insertIndex] = childDistances[i];
+                continue;
+            }
+
+            for (uint32 triangleIndex = node.children[i]; triangleIndex != node.children[i] + node.triangleCounts[i]; ++triangleIndex)
+            {
+                if (!intersects(m_triangles[triangleIndex], ray, closestDistance, closestDistance, closestBarycentrics))
+                    continue;
+
+                closestTriangle = triangleIndex;
+
+                if constexpr (IsAnyHit)
+                    return true;
+            }
+        }
+
+        // Sorted from the farthest one
+        for (uint32 i = 0; i != innerChildCount; ++i)
+            stack[stackSize++] = innerChildren[i];
+    }
+
+    if (closestTriangle == ~0u)
+        return false;
+
+    const Triangle& triangle = m_triangles[closestTriangle];
+    Float3 normal = Vector3::normalize(Vector3::cross(triangle.edge1, triangle.edge2));
+    if (dot(normal, ray.direction) > 0.0f)
+        normal *= -1.0f;
+
+    outHit.triangleIndex = m_triangleIndices[closestTriangle];
+    outHit.meshIndex = 0;
+    if (!m_meshFirstTriangles.empty())
+    {
+        auto meshIt = std::upper_bound(m_meshFirstTriangles.begin(), m_meshFirstTriangles.end(), outHit.triangleIndex);
+        outHit.meshIndex = uint32(meshIt - m_meshFirstTriangles.begin()) - 1;
+    }
+    outHit.distance = closestDistance;
+    outHit.barycentrics = closestBarycentrics;
+    outHit.normal = normal;
+    return true;
+}
+
+bool closest_instance_hit(
+    const BVH& instanceBVH,
+    const TriangleBVHInstance* instances,
+    const Ray& ray,
+    TriangleBVH::Hit& outHit,
+    uint32& outInstanceIndex
+)
+{
+    TriangleBVH::Hit closestHit;
+
+    BVH::Hit instanceHit;
+    bool isHit = instanceBVH.closest_hit(ray, [&](uint32 instanceIndex, const Ray& ray, float& outDistance)
+    {
+        const TriangleBVHInstance& instance = instances[instanceIndex];
+        if (!instance.triangleBVH)
+            return false;
+
+        // Instances farther than the closest hit can't be hit, so the local ray is shortened
+        Matrix inverseTransform = instance.inverseTransform;
+        Ray localRay(
+            Vector3::transform_coord(ray.origin, inverseTransform),
+            Vector3::transform_normal(ray.direction, inverseTransform),
+            ray.tmin,
+            std::min(ray.tmax, closestHit.distance)
+        );
+
+        TriangleBVH::Hit hit;
+        if (!instance.triangleBVH->closest_hit(localRay, hit))
+            return false;
+
+        closestHit = hit;
+        outDistance = hit.distance;
+        return true;
+    }, instanceHit);
+
+    if (!isHit)
+        return false;
+
+    // Normals are transformed with the inverse transpose, so non-uniform scale keeps them perpendicular
+    Matrix normalTransform = Matrix(instances[instanceHit.primitiveIndex].inverseTransform).transpose();
+    closestHit.normal = Vector3::normalize(Vector3::transform_normal(closestHit.normal, normalTransform));
+
+    outHit = closestHit;
+    outInstanceIndex = instanceHit.primitiveIndex;
+    return true;
+}
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "bvh.h"
+
+namespace fe
+{
+
+// BVH over triangles of indexed geometry for precise CPU ray queries, for example picking and placement in the editor.
+// Built as a binary SAH BVH and collapsed to nodes with 4 children, so one SSE slab test checks all children.
+// Triangles are stored in leaf order as a vertex and two edges, the layout Moller-Trumbore intersection reads.
+class TriangleBVH
+{
+public:
+    constexpr static uint32 s_childCount = 4;
+
+    struct alignas(16) Node
+    {
+        float minX[s_childCount];
+        float minY[s_childCount];
+        float minZ[s_childCount];
+        float maxX[s_childCount];
+        float maxY[s_childCount];
+        float maxZ[s_childCount];
+        // Node index for inner children, first triangle for leaves
+        uint32 children[s_childCount];
+        // 0 for inner children
+        uint32 triangleCounts[s_childCount];
+        // Used children are at the beginning
+        uint32 childCount;
+    };
+
+    struct Triangle
+    {
+        Float3 vertex0;
+        Float3 edge1;
+        Float3 edge2;
+    };
+
+    struct Hit
+    {
+        // Index of the triangle in the index buffer divided by 3
+        uint32 triangleIndex = ~0u;
+        uint32 meshIndex = ~0u;
+        // In units of the ray direction
+        float distance = FLOAT_MAX;
+        // Weights of the second and the third vertex, the first one is 1 - x - y
+        Float2 barycentrics{ 0.0f, 0.0f };
+        // Unit geometric normal facing the ray origin
+        Float3 normal{ 0.0f, 0.0f, 0.0f };
+    };
+
+    // meshFirstTriangles are sorted first triangles of meshes that share the index buffer, used to fill Hit::meshIndex.
+    // Hit::meshIndex is 0 if there are no meshes.
+    void build(const std::vector<Float3>& positions, const std::vector<uint32>& indices, const std::vector<uint32>& meshFirstTriangles = {});
+
+    bool closest_hit(const Ray& ray, Hit& outHit) const;
+    bool any_hit(const Ray& ray) const;
+
+    uint32 get_triangle_count() const { return (uint32)m_triangles.size(); }
+    const std::vector<Node>& get_nodes() const { return m_nodes; }
+    // Size of nodes and triangles, used for memory budgets
+    uint64 get_memory_size() const;
+
+private:
+    // A child is pushed after its parent is popped, so at most 3 siblings per level wait on the stack
+    constexpr static uint32 s_maxStackSize = BVH::s_maxDepth * (s_childCount - 1) + 1;
+
+    std::vector<Node> m_nodes;
+    std::vector<Triangle> m_triangles;
+    // Index of each stored triangle in the index buffer divided by 3
+    std::vector<uint32> m_triangleIndices;
+    std::vector<uint32> m_meshFirstTriangles;
+
+    // Returns the index of the new node. Leaves append their triangles to m_triangles.
+    uint32 collapse_node(const BVH& bvh, const std::vector<Triangle>& triangles, uint32 bvhNodeIndex);
+
+    template<bool IsAnyHit>
+    bool traverse(const Ray& ray, Hit& outHit) const;
+};
+
+// Model geometry placed in the world. Transform is local to world, inverseTransform is world to local.
+struct TriangleBVHInstance
+{
+    const TriangleBVH* triangleBVH = nullptr;
+    Float4x4 transform;
+    Float4x4 inverseTransform;
+};
+
+// Finds the closest triangle of instances whose world space AABBs are primitives of instanceBVH.
+// Rays are transformed to the space of each instance without normalizing the direction, so distances stay in units
+// of the world ray direction. The normal is in world space.
+bool closest_instance_hit(
+    const BVH& instanceBVH,
+    const TriangleBVHInstance* instances,
+    const Ray& ray,
+    TriangleBVH::Hit& outHit,
+    uint32& outInstanceIndex
+);
+
+}
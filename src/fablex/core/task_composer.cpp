@@ -1,8 +1,18 @@
 #include "task_composer.h"
 #include "platform/platform.h"
+#include "platform/cpu_topology.h"
 #include "logger.h"
+#include "profiler.h"
 #include <algorithm>
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace fe
 {
 
@@ -11,12 +21,145 @@ uint32 get_priority_count()
     return uint32(TaskGroup::Priority::COUNT);
 }
 
+constexpr uint32 UNPINNED_LOGICAL_PROCESSOR = ~0u;
+
+// Thread names are limited to 15 characters on Linux
+std::string get_worker_thread_name(TaskGroup::Priority priority, uint32 threadID)
+{
+    switch (priority)
+    {
+    case TaskGroup::Priority::HIGH:
+        return "fe::high_" + std::to_string(threadID);
+    case TaskGroup::Priority::LOW:
+        return "fe::low_" + std::to_string(threadID);
+    case TaskGroup::Priority::STREAMING:
+        return "fe::stream_" + std::to_string(threadID);
+    default:
+        FE_CHECK(0);
+        return "fe::worker";
+    }
+}
+
+uint32 get_worker_logical_processor(
+    const TaskComposerConfig& config,
+    const CPUTopology& topology,
+    TaskGroup::Priority priority,
+    uint32 threadID
+)
+{
+    uint32 logicalProcessorCount = topology.get_logical_processor_count();
+    uint32 physicalCoreCount = topology.get_physical_core_count();
+
+    switch (config.threadPlacement)
+    {
+    case ThreadPlacement::NONE:
+        return UNPINNED_LOGICAL_PROCESSOR;
+    case ThreadPlacement::CORE_INDEX:
+    {
+        uint32 core = priority == TaskGroup::Priority::STREAMING ? logicalProcessorCount - 1 - threadID : threadID + 1;
+        return core % logicalProcessorCount;
+    }
+    case ThreadPlacement::TOPOLOGY_AWARE:
+    {
+        if (priority != TaskGroup::Priority::HIGH)
+            return UNPINNED_LOGICAL_PROCESSOR;
+
+        return topology.get_physical_cores()[(threadID + 1) % physicalCoreCount].logicalProcessors[0];
+    }
+    default:
+        FE_CHECK(0);
+        return UNPINNED_LOGICAL_PROCESSOR;
+    }
+}
+
+#if defined(__linux__)
+// Called from the worker thread because nice value can only be set by thread id
+void configure_worker_thread(
+    const TaskComposerConfig& config,
+    TaskGroup::Priority priority,
+    uint32 threadID,
+    uint32 logicalProcessor
+)
+{
+    pthread_t thread = pthread_self();
+
+    std::string threadName = get_worker_thread_name(priority, threadID);
+    pthread_setname_np(thread, threadName.c_str());
+
+    if (logicalProcessor != UNPINNED_LOGICAL_PROCESSOR)
+    {
+        cpu_set_t affinityMask;
+        CPU_ZERO(&affinityMask);
+        CPU_SET(logicalProcessor, &affinityMask);
+
+        if (pthread_setaffinity_np(thread, sizeof(cpu_set_t), &affinityMask) != 0)
+            FE_LOG(LogTasks, WARNING, "Failed to pin thread {} to logical processor {}", threadName, logicalProcessor);
+    }
+
+    if (priority == TaskGroup::Priority::HIGH)
+        return;
+
+    switch (config.backgroundThreadScheduling)
+    {
+    case BackgroundThreadScheduling::NORMAL:
+        break;
+    case BackgroundThreadScheduling::NICE:
+    {
+        if (setpriority(PRIO_PROCESS, pid_t(syscall(SYS_gettid)), config.backgroundThreadNiceValue) != 0)
+            FE_LOG(LogTasks, WARNING, "Failed to set nice value {} for thread {}", config.backgroundThreadNiceValue, threadName);
+        break;
+    }
+    case BackgroundThreadScheduling::IDLE:
+    {
+        sched_param schedulingParams{};
+        if (pthread_setschedparam(thread, SCHED_IDLE, &schedulingParams) != 0)
+            FE_LOG(LogTasks, WARNING, "Failed to set SCHED_IDLE for thread {}", threadName);
+        break;
+    }
+    default:
+        FE_CHECK(0);
+        break;
+    }
+}
+#endif
+
+// Xorshift, good enough to pick steal victims without touching shared state
+uint32 get_random_victim_index(uint32 threadCount)
+{
+    static thread_local uint32 state = uint32(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state % threadCount;
+}
+
 void TaskComposer::init(uint32 maxThreadCount)
+{
+    TaskComposerConfig config;
+    config.maxThreadCount = maxThreadCount;
+    init(config);
+}
+
+void TaskComposer::init(const TaskComposerConfig& config)
 {
     FE_LOG(LogTasks, INFO, "Starting Task Composer initialization");
 
-    maxThreadCount = std::max(1u, maxThreadCount);
-    uint32 coreCount = std::thread::hardware_concurrency();
+    s_isAlive.store(true);
+
+    uint32 maxThreadCount = std::max(1u, config.maxThreadCount);
+    CPUTopology topology = CPUTopology::detect();
+    uint32 logicalProcessorCount = topology.get_logical_processor_count();
+    uint32 physicalCoreCount = topology.get_physical_core_count();
+
+    FE_LOG(LogTasks, INFO, "CPU topology: {} logical processors; {} physical cores; {} NUMA nodes", 
+        logicalProcessorCount, physicalCoreCount, topology.get_numa_node_count());
+
+    // Main thread keeps one core. Low priority workers fill logical processors that are left after high priority
+    // and streaming workers, so the number of workers does not exceed the number of logical processors.
+    uint32 highPriorityThreadCount = std::max(1u, physicalCoreCount - 1);
+    uint32 streamingThreadCount = 1;
+    uint32 lowPriorityThreadCount = logicalProcessorCount > highPriorityThreadCount + streamingThreadCount + 1 
+        ? logicalProcessorCount - highPriorityThreadCount - streamingThreadCount - 1 : 1;
 
     for (uint32 i = 0; i != get_priority_count(); ++i)
     {
@@ -26,13 +169,13 @@ void TaskComposer::init(uint32 maxThreadCount)
         switch (priority)
         {
         case TaskGroup::Priority::HIGH:
-            priorityCtx.threadCount = coreCount - 1;
+            priorityCtx.threadCount = highPriorityThreadCount;
             break;
         case TaskGroup::Priority::LOW:
-            priorityCtx.threadCount = coreCount - 2;
+            priorityCtx.threadCount = lowPriorityThreadCount;
             break;
         case TaskGroup::Priority::STREAMING:
-            priorityCtx.threadCount = 1;
+            priorityCtx.threadCount = streamingThreadCount;
             break;
         default:
             FE_CHECK(0);
@@ -40,71 +183,54 @@ void TaskComposer::init(uint32 maxThreadCount)
         }
 
         priorityCtx.threadCount = std::clamp(priorityCtx.threadCount, 1u, maxThreadCount);
-        priorityCtx.taskQueueGroup.reset(new TaskQueueGroup(priorityCtx.threadCount));
         priorityCtx.threads.reserve(priorityCtx.threadCount);
+        priorityCtx.workerQueues.reserve(priorityCtx.threadCount);
+
+        for (uint32 threadID = 0; threadID != priorityCtx.threadCount; ++threadID)
+            priorityCtx.workerQueues.emplace_back(new WorkStealingQueue<Task>());
 
         for (uint32 threadID = 0; threadID != priorityCtx.threadCount; ++threadID)
         {
-            priorityCtx.threads.emplace_back([threadID, &priorityCtx]
+            uint32 logicalProcessor = get_worker_logical_processor(config, topology, priority, threadID);
+
+            priorityCtx.threads.emplace_back([threadID, priority, logicalProcessor, config, &priorityCtx]
             {
+#if defined(__linux__)
+                configure_worker_thread(config, priority, threadID, logicalProcessor);
+#endif
+                TaskTracer::set_thread_name(get_worker_thread_name(priority, threadID));
+                s_workerPriorityContext = &priorityCtx;
+                s_workerIndex = threadID;
+
                 while (s_isAlive.load())
                 {
+                    uint32 workEpoch = priorityCtx.workEpoch.load();
                     priorityCtx.execute_tasks(threadID);
-    
-                    std::unique_lock<std::mutex> lock(priorityCtx.mutex);
-                    priorityCtx.wakeCondition.wait(lock);
+
+                    priorityCtx.idleWorkerCount.fetch_add(1, std::memory_order_relaxed);
+                    priorityCtx.workEpoch.wait(workEpoch);
+                    priorityCtx.idleWorkerCount.fetch_sub(1, std::memory_order_relaxed);
                 }
             });
 
-            auto threadHandle = priorityCtx.threads.back().native_handle();
-            uint64 core = threadID + 1;
-            if (priority == TaskGroup::Priority::STREAMING)
-                core = coreCount - 1 - threadID;
-
 #if defined(_WIN32)
-            DWORD_PTR affinityMask = 1ull << core;
-            DWORD_PTR affinityResult = SetThreadAffinityMask(threadHandle, affinityMask);
-            FE_CHECK(affinityResult);
-            
-            switch (priority)
-            {
-            case TaskGroup::Priority::HIGH:
-            {
-                BOOL priorityResult = SetThreadPriority(threadHandle, THREAD_PRIORITY_NORMAL);
-                FE_CHECK(priorityResult != 0);
-
-                std::wstring threadName = L"fe::thread_high_" + std::to_wstring(threadID);
-                HRESULT result = SetThreadDescription(threadHandle, threadName.c_str());
-                FE_CHECK(SUCCEEDED(result));
+            auto threadHandle = priorityCtx.threads.back().native_handle();
 
-                break;
-            }
-            case TaskGroup::Priority::LOW:
+            if (logicalProcessor != UNPINNED_LOGICAL_PROCESSOR)
             {
-                BOOL priorityResult = SetThreadPriority(threadHandle, THREAD_PRIORITY_LOWEST);
-                FE_CHECK(priorityResult != 0);
-
-                std::wstring threadName = L"fe::thread_low_" + std::to_wstring(threadID);
-                HRESULT result = SetThreadDescription(threadHandle, threadName.c_str());
-                FE_CHECK(SUCCEEDED(result));
-
-                break;
+                DWORD_PTR affinityMask = 1ull << logicalProcessor;
+                DWORD_PTR affinityResult = SetThreadAffinityMask(threadHandle, affinityMask);
+                FE_CHECK(affinityResult);
             }
-            case TaskGroup::Priority::STREAMING:
-            {
-                BOOL priorityResult = SetThreadPriority(threadHandle, THREAD_PRIORITY_LOWEST);
-                FE_CHECK(priorityResult != 0);
 
-                std::wstring threadName = L"fe::thread_streaming_" + std::to_wstring(threadID);
-                HRESULT result = SetThreadDescription(threadHandle, threadName.c_str());
-                FE_CHECK(SUCCEEDED(result));
+            int threadPriority = priority == TaskGroup::Priority::HIGH ? THREAD_PRIORITY_NORMAL : THREAD_PRIORITY_LOWEST;
+            BOOL priorityResult = SetThreadPriority(threadHandle, threadPriority);
+            FE_CHECK(priorityResult != 0);
 
-                break;
-            }
-            default:
-                FE_CHECK(0);
-                break;
-            }
+            std::string threadName = get_worker_thread_name(priority, threadID);
+            std::wstring threadNameW(threadName.begin(), threadName.end());
+            HRESULT result = SetThreadDescription(threadHandle, threadNameW.c_str());
+            FE_CHECK(SUCCEEDED(result));
 #endif
         }
     }
@@ -116,70 +242,76 @@ void TaskComposer::init(uint32 maxThreadCount)
 void TaskComposer::cleanup()
 {
     s_isAlive.store(false);
-    bool executeWakeLoop = true;
 
-    std::thread waker([&]()
+    for (PriorityContext& priorityCtx : s_priorityContexts)
     {
-        while (executeWakeLoop)
-            for (PriorityContext& priorityCtx : s_priorityContexts)
-                priorityCtx.wakeCondition.notify_all();
-    });
+        priorityCtx.workEpoch.fetch_add(1);
+        priorityCtx.workEpoch.notify_all();
+    }
 
     for (PriorityContext& priorityCtx : s_priorityContexts)
         for (auto& thread : priorityCtx.threads)
             thread.join();
 
-    executeWakeLoop = false;
-    waker.join();
-
     for (PriorityContext& priorityCtx : s_priorityContexts)
     {
-        priorityCtx.taskQueueGroup.reset();
+        priorityCtx.workerQueues.clear();
         priorityCtx.threads.clear();
         priorityCtx.threadCount = 0;
     }
 }
 
-void TaskComposer::execute(TaskGroup& taskGroup, const TaskHandler& taskHandler)
+void TaskComposer::execute(TaskGroup& taskGroup, TaskHandler taskHandler, const char* label)
 {
-    taskGroup.increase_task_count(1);
+    if (taskGroup.is_cancelled())
+        return;
 
-    Task task;
-    task.taskHandler = taskHandler;
-    task.taskGroup = &taskGroup;
-    task.taskSubgroupBeginning = 0;
-    task.taskSubgroupEnd = 1;
-    task.taskSubgroupID = 0;
+    TaskBatch* taskBatch = s_taskBatchPool.allocate();
+    taskBatch->ownedTaskHandler = std::move(taskHandler);
+    taskBatch->taskHandler = &taskBatch->ownedTaskHandler;
+    taskBatch->label = label;
 
-    PriorityContext* priorityCtx = get_priority_context(taskGroup.get_priority());
-    
-    priorityCtx->taskQueueGroup->get_next_queue().push_back(task);
-    priorityCtx->wakeCondition.notify_one();
+    submit(taskGroup, 1, 1, taskBatch);
 }
 
-void TaskComposer::dispatch(TaskGroup& taskGroup, uint32 taskCount, uint32 groupSize, const TaskHandler& taskHandler)
+void TaskComposer::dispatch(TaskGroup& taskGroup, uint32 taskCount, uint32 groupSize, TaskHandler taskHandler, const char* label)
 {
-    if (taskCount == 0 || groupSize == 0)
+    if (taskCount == 0 || groupSize == 0 || taskGroup.is_cancelled())
         return;
 
-    PriorityContext* priorityCtx = get_priority_context(taskGroup.get_priority());
+    // All subgroup tasks share one handler copy
+    TaskBatch* taskBatch = s_taskBatchPool.allocate();
+    taskBatch->ownedTaskHandler = std::move(taskHandler);
+    taskBatch->taskHandler = &taskBatch->ownedTaskHandler;
+    taskBatch->label = label;
 
-    uint32 groupCount = calculate_group_count(taskCount, groupSize);
-    taskGroup.increase_task_count(groupCount);
+    submit(taskGroup, taskCount, groupSize, taskBatch);
+}
 
-    Task task;
-    task.taskHandler = taskHandler;
-    task.taskGroup = &taskGroup;
-    
-    for (auto groupID = 0; groupID != groupCount; ++groupID)
+void TaskComposer::execute(TaskGroup& taskGroup, TaskGraph& taskGraph)
+{
+    // Checked once per execution instead of per dependency, nodes of a cycle would never be submitted
+    FE_CHECK(!taskGraph.has_cycle());
+
+    if (taskGroup.is_cancelled())
+        return;
+
+    // Keeps taskGroup busy while root nodes are submitted, otherwise it could look completed between two roots
+    taskGroup.increase_task_count(1);
+
+    for (TaskGraph::NodeHandle nodeHandle = 0; nodeHandle != taskGraph.get_node_count(); ++nodeHandle)
     {
-        task.taskSubgroupBeginning = groupID * groupSize;
-        task.taskSubgroupEnd = std::min(task.taskSubgroupBeginning + groupSize, taskCount);
-        task.taskSubgroupID = groupID;
-        priorityCtx->taskQueueGroup->get_next_queue().push_back(task);
+        TaskGraph::Node* node = taskGraph.get_node(nodeHandle);
+        node->unresolvedPredecessorCount.store(node->predecessorCount, std::memory_order_relaxed);
     }
 
-    priorityCtx->wakeCondition.notify_one();
+    for (TaskGraph::NodeHandle nodeHandle = 0; nodeHandle != taskGraph.get_node_count(); ++nodeHandle)
+    {
+        if (!taskGraph.get_node(nodeHandle)->predecessorCount)
+            submit_graph_node(taskGroup, taskGraph, nodeHandle);
+    }
+
+    complete_tasks(taskGroup, 1);
 }
 
 bool TaskComposer::is_busy(TaskGroup& taskGroup)
@@ -189,55 +321,286 @@ bool TaskComposer::is_busy(TaskGroup& taskGroup)
 
 void TaskComposer::wait(TaskGroup& taskGroup)
 {
-    if (is_busy(taskGroup))
+    FE_PROFILE_SCOPE("TaskComposer::wait");
+
+    PriorityContext* priorityCtx = get_priority_context(taskGroup.get_priority());
+    uint32 workerIndex = get_worker_index(priorityCtx);
+
+    // Waits are traced too, they show where the calling thread is blocked by tasks
+    bool isTracing = TaskTracer::is_capturing() && is_busy(taskGroup);
+    uint64 beginTime = isTracing ? TaskTracer::get_time() : 0;
+    TaskGroup::Priority priority = taskGroup.get_priority();
+
+    while (is_busy(taskGroup))
     {
-        PriorityContext* priorityCtx = get_priority_context(taskGroup.get_priority());
+        // Helps workers while there are ready tasks of the same priority
+        if (priorityCtx->execute_next_task(workerIndex))
+            continue;
 
-        priorityCtx->wakeCondition.notify_all();
-        priorityCtx->execute_tasks(priorityCtx->taskQueueGroup->get_next_queue_index());
+        // Remaining tasks are being executed by other threads, park until some TaskGroup is completed
+        uint32 completionEpoch = priorityCtx->completionEpoch.load();
+        if (!is_busy(taskGroup))
+            break;
 
-        while (is_busy(taskGroup))
-        {
-            std::this_thread::yield();
-        }
+        priorityCtx->completionEpoch.wait(completionEpoch);
+    }
+
+    if (isTracing)
+    {
+        TaskTracer::Event event;
+        event.label = "TaskComposer::wait";
+        event.taskGroupID = uint64(&taskGroup);
+        event.enqueueTime = 0;
+        event.beginTime = beginTime;
+        event.endTime = TaskTracer::get_time();
+        event.priority = uint32(priority);
+        event.taskCount = 0;
+        TaskTracer::record_event(event);
     }
 }
 
+bool TaskComposer::should_split_work(TaskGroup::Priority priority)
+{
+    PriorityContext* priorityCtx = get_priority_context(priority);
+    uint32 workerIndex = get_worker_index(priorityCtx);
+
+    if (workerIndex != s_invalidWorkerIndex)
+        return priorityCtx->workerQueues[workerIndex]->empty();
+
+    return priorityCtx->idleWorkerCount.load(std::memory_order_relaxed) > 0;
+}
+
 uint32 TaskComposer::calculate_group_count(uint32 taskCount, uint32 groupSize)
 {
     return (taskCount + groupSize - 1) / groupSize;
 }    
 
+void TaskComposer::submit(TaskGroup& taskGroup, uint32 taskCount, uint32 groupSize, TaskBatch* taskBatch)
+{
+    PriorityContext* priorityCtx = get_priority_context(taskGroup.get_priority());
+
+    uint32 groupCount = calculate_group_count(taskCount, groupSize);
+    taskGroup.increase_task_count(groupCount);
+
+    taskBatch->taskGroup = &taskGroup;
+    taskBatch->pendingTaskCount.store(groupCount, std::memory_order_relaxed);
+
+    if (TaskTracer::is_capturing())
+        taskBatch->enqueueTime = TaskTracer::get_time();
+
+    std::array<Task, 64> tasks;
+    uint32 chunkTaskCount = 0;
+    
+    for (uint32 groupID = 0; groupID != groupCount; ++groupID)
+    {
+        Task& task = tasks[chunkTaskCount++];
+        task.taskBatch = taskBatch;
+        task.taskSubgroupBeginning = groupID * groupSize;
+        task.taskSubgroupEnd = std::min(task.taskSubgroupBeginning + groupSize, taskCount);
+        task.taskSubgroupID = groupID;
+
+        if (chunkTaskCount == tasks.size())
+        {
+            priorityCtx->push_tasks(tasks.data(), chunkTaskCount);
+            chunkTaskCount = 0;
+        }
+    }
+
+    if (chunkTaskCount)
+        priorityCtx->push_tasks(tasks.data(), chunkTaskCount);
+
+    priorityCtx->wake_workers(groupCount);
+}
+
+void TaskComposer::submit_graph_node(TaskGroup& taskGroup, TaskGraph& taskGraph, TaskGraph::NodeHandle nodeHandle)
+{
+    TaskGraph::Node* node = taskGraph.get_node(nodeHandle);
+
+    if (!node->taskCount)
+    {
+        complete_graph_node(taskGroup, taskGraph, nodeHandle);
+        return;
+    }
+
+    TaskBatch* taskBatch = s_taskBatchPool.allocate();
+    taskBatch->taskHandler = &node->taskHandler;
+    taskBatch->taskGraph = &taskGraph;
+    taskBatch->taskGraphNode = nodeHandle;
+    taskBatch->label = node->label;
+
+    submit(taskGroup, node->taskCount, node->groupSize, taskBatch);
+}
+
+void TaskComposer::complete_graph_node(TaskGroup& taskGroup, TaskGraph& taskGraph, TaskGraph::NodeHandle nodeHandle)
+{
+    // Successors are not submitted, their predecessor counters are reset on the next execution of the graph
+    if (taskGroup.is_cancelled())
+        return;
+
+    for (TaskGraph::NodeHandle successor : taskGraph.get_node(nodeHandle)->successors)
+    {
+        TaskGraph::Node* successorNode = taskGraph.get_node(successor);
+        if (successorNode->unresolvedPredecessorCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            submit_graph_node(taskGroup, taskGraph, successor);
+    }
+}
+
 TaskComposer::PriorityContext* TaskComposer::get_priority_context(TaskGroup::Priority priority)
 {
     return &s_priorityContexts.at(uint32(priority));
 }
 
-void TaskComposer::PriorityContext::execute_tasks(uint32 beginningQueueIndex)
+uint32 TaskComposer::get_worker_index(PriorityContext* priorityCtx)
+{
+    return s_workerPriorityContext == priorityCtx ? s_workerIndex : s_invalidWorkerIndex;
+}
+
+void TaskComposer::execute_task(const Task& task)
 {
+    TaskBatch* taskBatch = task.taskBatch;
+
+    bool isTracing = TaskTracer::is_capturing();
+    uint64 beginTime = isTracing ? TaskTracer::get_time() : 0;
+
     TaskExecutionInfo executionInfo;
+    executionInfo.taskGroup = taskBatch->taskGroup;
+    executionInfo.taskSubgroupID = task.taskSubgroupID;
+
+    // Tasks of a cancelled group are only popped and completed, so wait() returns as soon as running handlers finish
+    for (auto taskIndex = task.taskSubgroupBeginning; taskIndex != task.taskSubgroupEnd; ++taskIndex)
+    {
+        if (taskBatch->taskGroup->is_cancelled())
+            break;
+
+        executionInfo.globalTaskIndex = taskIndex;
+        executionInfo.taskIndexRelativeToSubgroup = taskIndex - task.taskSubgroupBeginning;
+        executionInfo.isFirstTaskInSubgroup = taskIndex == task.taskSubgroupBeginning;
+        executionInfo.isLastTaskInSubgroup = taskIndex == task.taskSubgroupEnd - 1;
+        (*taskBatch->taskHandler)(executionInfo);
+    }
+
+    TaskGroup* taskGroup = taskBatch->taskGroup;
+
+    if (isTracing)
+    {
+        TaskTracer::Event event;
+        event.label = taskBatch->label;
+        event.taskGroupID = uint64(taskGroup);
+        event.enqueueTime = taskBatch->enqueueTime;
+        event.beginTime = beginTime;
+        event.endTime = TaskTracer::get_time();
+        event.priority = uint32(taskGroup->get_priority());
+        event.taskCount = task.taskSubgroupEnd - task.taskSubgroupBeginning;
+        TaskTracer::record_event(event);
+    }
+
+    // TaskGroup can be destroyed by a waiting thread as soon as its counter reaches zero, so it must be the last access.
+    // Graph successors are submitted before that, so the group stays busy until the whole graph is completed.
+    if (taskBatch->pendingTaskCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        if (taskBatch->taskGraph)
+            complete_graph_node(*taskGroup, *taskBatch->taskGraph, taskBatch->taskGraphNode);
+
+        s_taskBatchPool.free(taskBatch);
+    }
+
+    complete_tasks(*taskGroup, 1);
+}
+
+void TaskComposer::complete_tasks(TaskGroup& taskGroup, uint32 taskCount)
+{
+    // Priority must be read before decreasing because taskGroup can be destroyed right after its counter reaches zero
+    PriorityContext* priorityCtx = get_priority_context(taskGroup.get_priority());
+
+    if (taskGroup.decrease_task_count(taskCount) == 0)
+    {
+        priorityCtx->completionEpoch.fetch_add(1);
+        priorityCtx->completionEpoch.notify_all();
+    }
+}
+
+void TaskComposer::PriorityContext::push_tasks(const Task* tasks, uint32 taskCount)
+{
+    uint32 workerIndex = get_worker_index(this);
+
+    if (workerIndex == s_invalidWorkerIndex)
+    {
+        injectionQueue.push_back(tasks, taskCount);
+        return;
+    }
+
+    WorkStealingQueue<Task>& workerQueue = *workerQueues[workerIndex];
+    for (uint32 i = 0; i != taskCount; ++i)
+        workerQueue.push(tasks[i]);
+}
+
+bool TaskComposer::PriorityContext::execute_next_task(uint32 workerIndex)
+{
     Task task;
-    for (auto i = 0; i != threadCount; ++i)
+
+    if (workerIndex != s_invalidWorkerIndex)
     {
-        TaskQueue& taskQueue = taskQueueGroup->get_queue(beginningQueueIndex);
-        while (taskQueue.pop_front(task))
+        WorkStealingQueue<Task>& workerQueue = *workerQueues[workerIndex];
+        if (workerQueue.pop(task))
+        {
+            execute_task(task);
+            return true;
+        }
+
+        // Moves several injected tasks to the own queue, so other workers can steal them without the injection queue lock
+        std::array<Task, 32> injectedTasks;
+        uint32 injectedTaskCount = injectionQueue.pop_front(injectedTasks.data(), (uint32)injectedTasks.size());
+        if (injectedTaskCount)
         {
-            executionInfo.taskSubgroupID = task.taskSubgroupID;
+            for (uint32 i = 1; i != injectedTaskCount; ++i)
+                workerQueue.push(injectedTasks[i]);
+
+            if (injectedTaskCount > 1)
+                wake_workers(injectedTaskCount - 1);
+
+            execute_task(injectedTasks[0]);
+            return true;
+        }
+    }
+    else if (injectionQueue.pop_front(task))
+    {
+        execute_task(task);
+        return true;
+    }
 
-            for (auto taskIndex = task.taskSubgroupBeginning; taskIndex != task.taskSubgroupEnd; ++taskIndex)
+    uint32 victimIndex = get_random_victim_index(threadCount);
+    for (uint32 i = 0; i != threadCount; ++i, victimIndex = (victimIndex + 1) % threadCount)
+    {
+        if (victimIndex == workerIndex)
+            continue;
+
+        WorkStealingQueue<Task>& victimQueue = *workerQueues[victimIndex];
+        while (!victimQueue.empty())
+        {
+            if (victimQueue.steal(task))
             {
-                executionInfo.globalTaskIndex = taskIndex;
-                executionInfo.taskIndexRelativeToSubgroup = taskIndex - task.taskSubgroupBeginning;
-                executionInfo.isFirstTaskInSubgroup = taskIndex == task.taskSubgroupBeginning;
-                executionInfo.isLastTaskInSubgroup = taskIndex == task.taskSubgroupEnd - 1;
-                task.taskHandler(executionInfo);
+                execute_task(task);
+                return true;
             }
-            
-            task.taskGroup->decrease_task_count(1);
         }
-
-        ++beginningQueueIndex;
     }
+
+    return false;
+}
+
+void TaskComposer::PriorityContext::wake_workers(uint32 taskCount)
+{
+    workEpoch.fetch_add(1);
+
+    if (taskCount > 1)
+        workEpoch.notify_all();
+    else
+        workEpoch.notify_one();
+}
+
+void TaskComposer::PriorityContext::execute_tasks(uint32 workerIndex)
+{
+    while (execute_next_task(workerIndex));
 }
 
 }
\ No newline at end of file
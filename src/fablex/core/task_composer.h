@@ -1,9 +1,12 @@
 #pragma once
 
 #include "task_types.h"
-#include "pool_allocator.h"
+#include "task_graph.h"
+#include "work_stealing_queue.h"
+#include "concurrent_pool_allocator.h"
+#include "task_composer_config.h"
+#include "task_tracer.h"
 
-#include <condition_variable>
 #include <thread>
 
 namespace fe
@@ -13,9 +16,14 @@ class TaskComposer
 {
 public:
     static void init(uint32 maxThreadCount = ~0u);
+    static void init(const TaskComposerConfig& config);
     static void cleanup();
-    static void execute(TaskGroup& taskGroup, const TaskHandler& taskHandler);
-    static void dispatch(TaskGroup& taskGroup, uint32 taskCount, uint32 groupSize, const TaskHandler& taskHandler);
+    // Label is shown in task traces and must point to a string literal, see TaskTracer
+    static void execute(TaskGroup& taskGroup, TaskHandler taskHandler, const char* label = nullptr);
+    static void dispatch(TaskGroup& taskGroup, uint32 taskCount, uint32 groupSize, TaskHandler taskHandler, const char* label = nullptr);
+    // Submits graph nodes that have no predecessors, other nodes are submitted when their predecessors are completed.
+    // TaskGraph must be alive until taskGroup is completed.
+    static void execute(TaskGroup& taskGroup, TaskGraph& taskGraph);
     static bool is_busy(TaskGroup& taskGroup);
     static void wait(TaskGroup& taskGroup);
 
@@ -34,25 +42,56 @@ public:
         return get_priority_context(priority)->threadCount;
     }
 
+    // Used by parallel algorithms to decide if a range must be split into a new task.
+    // Returns true if the calling worker's queue is empty, so there is nothing for thieves to take,
+    // or if the calling thread is not a worker of this priority and some workers are idle.
+    static bool should_split_work(TaskGroup::Priority priority);
+
 private:
+    static constexpr uint32 s_invalidWorkerIndex = ~0u;
+
     struct PriorityContext
     {
         uint32 threadCount;
-        std::mutex mutex;
         std::vector<std::thread> threads;
-        std::condition_variable wakeCondition;
-        std::unique_ptr<TaskQueueGroup> taskQueueGroup;
+
+        // Incremented when tasks are pushed. Idle workers park on it with std::atomic::wait,
+        // reading it before looking for tasks, so a push between the lookup and parking is never missed.
+        std::atomic<uint32> workEpoch;
+        // Incremented when any TaskGroup of this priority is completed, threads in TaskComposer::wait park on it.
+        // TaskGroup itself can't be used for that because it can be destroyed right after its counter reaches zero.
+        std::atomic<uint32> completionEpoch;
+        // Workers parked on workEpoch, used to decide if splitting work is useful
+        std::atomic<uint32> idleWorkerCount;
         
-        void execute_tasks(uint32 beginningQueueIndex);
+        // One queue per worker thread. Owners push and pop without locks, idle workers steal.
+        std::vector<std::unique_ptr<WorkStealingQueue<Task>>> workerQueues;
+        // Tasks submitted from threads that are not workers of this priority
+        TaskQueue injectionQueue;
+
+        bool execute_next_task(uint32 workerIndex);
+        void execute_tasks(uint32 workerIndex);
+        void push_tasks(const Task* tasks, uint32 taskCount);
+        void wake_workers(uint32 taskCount);
     };
 
     using PriotityContextArray = std::array<PriorityContext, uint32(TaskGroup::Priority::COUNT)>;
 
-    inline static ThreadSafePoolAllocator<TaskGroup, 128> s_taskGroupPool{};
+    inline static ConcurrentPoolAllocator<TaskGroup, 128, MemoryTag::TASKS> s_taskGroupPool{};
+    inline static ConcurrentPoolAllocator<TaskBatch, 256, MemoryTag::TASKS> s_taskBatchPool{};
     inline static PriotityContextArray s_priorityContexts{};
     inline static std::atomic_bool s_isAlive = true;
 
+    inline static thread_local PriorityContext* s_workerPriorityContext = nullptr;
+    inline static thread_local uint32 s_workerIndex = s_invalidWorkerIndex;
+
     static uint32 calculate_group_count(uint32 taskCount, uint32 groupSize);
+    static void submit(TaskGroup& taskGroup, uint32 taskCount, uint32 groupSize, TaskBatch* taskBatch);
+    static void submit_graph_node(TaskGroup& taskGroup, TaskGraph& taskGraph, TaskGraph::NodeHandle nodeHandle);
+    static void complete_graph_node(TaskGroup& taskGroup, TaskGraph& taskGraph, TaskGraph::NodeHandle nodeHandle);
+    static uint32 get_worker_index(PriorityContext* priorityCtx);
+    static void execute_task(const Task& task);
+    static void complete_tasks(TaskGroup& taskGroup, uint32 taskCount);
 
     static PriorityContext* get_priority_context(TaskGroup::Priority priority);
 };
@@ -0,0 +1,47 @@
+#include "task_composer_config.h"
+#include "json_serialization.h"
+
+FE_SERIALIZE_ENUM(fe, fe::ThreadPlacement,
+{
+    {fe::ThreadPlacement::NONE, "NONE"},
+    {fe::ThreadPlacement::CORE_INDEX, "CORE_INDEX"},
+    {fe::ThreadPlacement::TOPOLOGY_AWARE, "TOPOLOGY_AWARE"}
+})
+
+FE_SERIALIZE_ENUM(fe, fe::BackgroundThreadScheduling,
+{
+    {fe::BackgroundThreadScheduling::NORMAL, "NORMAL"},
+    {fe::BackgroundThreadScheduling::NICE, "NICE"},
+    {fe::BackgroundThreadScheduling::IDLE, "IDLE"}
+})
+
+namespace fe
+{
+
+constexpr const char* g_taskComposerKey = "TaskComposer";
+constexpr const char* g_threadPlacementKey = "ThreadPlacement";
+constexpr const char* g_backgroundThreadSchedulingKey = "BackgroundThreadScheduling";
+constexpr const char* g_backgroundThreadNiceValueKey = "BackgroundThreadNiceValue";
+constexpr const char* g_maxThreadCountKey = "MaxThreadCount";
+
+void TaskComposerConfig::init(const nlohmann::json& engineConfigJson)
+{
+    if (!engineConfigJson.contains(g_taskComposerKey))
+        return;
+
+    const nlohmann::json& taskComposerConfigJson = engineConfigJson[g_taskComposerKey];
+
+    if (taskComposerConfigJson.contains(g_threadPlacementKey))
+        threadPlacement = taskComposerConfigJson[g_threadPlacementKey];
+
+    if (taskComposerConfigJson.contains(g_backgroundThreadSchedulingKey))
+        backgroundThreadScheduling = taskComposerConfigJson[g_backgroundThreadSchedulingKey];
+
+    if (taskComposerConfigJson.contains(g_backgroundThreadNiceValueKey))
+        backgroundThreadNiceValue = taskComposerConfigJson[g_backgroundThreadNiceValueKey];
+
+    if (taskComposerConfigJson.contains(g_maxThreadCountKey))
+        maxThreadCount = taskComposerConfigJson[g_maxThreadCountKey];
+}
+
+}
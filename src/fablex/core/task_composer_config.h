@@ -0,0 +1,43 @@
+#pragma once
+
+#include "types.h"
+#include "nlohmann/json_fwd.hpp"
+
+namespace fe
+{
+
+enum class ThreadPlacement
+{
+    // Workers are not pinned
+    NONE,
+    // Worker N is pinned to logical processor N + 1, streaming workers are pinned to the last logical processors
+    CORE_INDEX,
+    // High priority workers are pinned to distinct physical cores, the first core is left for the main thread.
+    // Low priority and streaming workers are not pinned, so they can use SMT siblings and cores left by high priority workers
+    TOPOLOGY_AWARE
+};
+
+// How low priority and streaming workers are deprioritized on Linux.
+// On Windows, they always use THREAD_PRIORITY_LOWEST.
+enum class BackgroundThreadScheduling
+{
+    NORMAL,
+    // SCHED_OTHER with backgroundThreadNiceValue
+    NICE,
+    // SCHED_IDLE, runs only when cores are not needed by other threads. Opt-in because workers,
+    // including streaming ones, can starve under sustained load and stall asset streaming.
+    IDLE
+};
+
+struct TaskComposerConfig
+{
+    ThreadPlacement threadPlacement = ThreadPlacement::TOPOLOGY_AWARE;
+    BackgroundThreadScheduling backgroundThreadScheduling = BackgroundThreadScheduling::NICE;
+    int32 backgroundThreadNiceValue = 10;
+    uint32 maxThreadCount = ~0u;
+
+    // Reads optional "TaskComposer" section, missing keys keep default values
+    void init(const nlohmann::json& engineConfigJson);
+};
+
+}
@@ -0,0 +1,102 @@
+#include "task_graph.h"
+
+namespace fe
+{
+
+TaskGraph::~TaskGraph()
+{
+    m_nodeAllocator.free(m_nodes);
+}
+
+TaskGraph::NodeHandle TaskGraph::add_task(TaskHandler taskHandler, const char* label)
+{
+    return add_node(1, 1, std::move(taskHandler), label);
+}
+
+TaskGraph::NodeHandle TaskGraph::add_dispatch(uint32 taskCount, uint32 groupSize, TaskHandler taskHandler, const char* label)
+{
+    FE_CHECK(groupSize || !taskCount);
+    return add_node(taskCount, groupSize, std::move(taskHandler), label);
+}
+
+void TaskGraph::add_dependency(NodeHandle predecessor, NodeHandle successor)
+{
+    FE_CHECK(predecessor != successor);
+
+    get_node(predecessor)->successors.push_back(successor);
+    ++get_node(successor)->predecessorCount;
+}
+
+void TaskGraph::add_dependencies(const std::vector<NodeHandle>& predecessors, NodeHandle successor)
+{
+    for (NodeHandle predecessor : predecessors)
+        add_dependency(predecessor, successor);
+}
+
+void TaskGraph::clear()
+{
+    // Captures are released now, successor arrays keep their capacity
+    for (uint32 i = 0; i != m_nodeCount; ++i)
+    {
+        Node* node = m_nodes[i];
+        node->taskHandler = nullptr;
+        node->predecessorCount = 0;
+        node->successors.clear();
+    }
+
+    m_nodeCount = 0;
+}
+
+TaskGraph::NodeHandle TaskGraph::add_node(uint32 taskCount, uint32 groupSize, TaskHandler taskHandler, const char* label)
+{
+    NodeHandle nodeHandle = m_nodeCount++;
+
+    if (nodeHandle == m_nodes.size())
+        m_nodes.push_back(m_nodeAllocator.allocate());
+
+    Node* node = m_nodes[nodeHandle];
+    node->taskHandler = std::move(taskHandler);
+    node->taskCount = taskCount;
+    node->groupSize = groupSize;
+    node->label = label;
+
+    return nodeHandle;
+}
+
+TaskGraph::Node* TaskGraph::get_node(NodeHandle nodeHandle) const
+{
+    FE_CHECK(nodeHandle < m_nodeCount);
+    return m_nodes[nodeHandle];
+}
+
+bool TaskGraph::has_cycle() const
+{
+    // Kahn's algorithm, graph has a cycle if not all nodes can be sorted
+    std::vector<uint32> predecessorCounts(m_nodeCount);
+    std::vector<NodeHandle> readyNodes;
+
+    for (NodeHandle nodeHandle = 0; nodeHandle != m_nodeCount; ++nodeHandle)
+    {
+        predecessorCounts[nodeHandle] = m_nodes[nodeHandle]->predecessorCount;
+        if (!predecessorCounts[nodeHandle])
+            readyNodes.push_back(nodeHandle);
+    }
+
+    uint32 sortedNodeCount = 0;
+    while (!readyNodes.empty())
+    {
+        NodeHandle nodeHandle = readyNodes.back();
+        readyNodes.pop_back();
+        ++sortedNodeCount;
+
+        for (NodeHandle successor : m_nodes[nodeHandle]->successors)
+        {
+            if (--predecessorCounts[successor] == 0)
+                readyNodes.push_back(successor);
+        }
+    }
+
+    return sortedNodeCount != m_nodeCount;
+}
+
+}
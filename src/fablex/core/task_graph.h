@@ -0,0 +1,68 @@
+#pragma once
+
+#include "task_types.h"
+#include "concurrent_pool_allocator.h"
+#include "macro.h"
+
+#include <vector>
+
+namespace fe
+{
+
+// Describes tasks and the order in which they must be executed. A node is released
+// as soon as all its predecessors are completed, so the thread that submitted the graph
+// does not have to wait between stages. Use TaskComposer::execute(TaskGroup&, TaskGraph&)
+// to run the graph and TaskComposer::wait(TaskGroup&) to wait for all its nodes.
+// A graph can be executed many times but it must not be modified or executed again
+// until the previous execution is completed.
+// Nodes are kept after clear(), so a graph that is rebuilt every frame doesn't allocate in the steady state.
+class TaskGraph
+{
+public:
+    using NodeHandle = uint32;
+
+    TaskGraph() = default;
+    ~TaskGraph();
+
+    // Node with one task. Label is shown in task traces, see TaskTracer
+    NodeHandle add_task(TaskHandler taskHandler, const char* label = nullptr);
+
+    // Node with taskCount tasks split into subgroups, same as TaskComposer::dispatch
+    NodeHandle add_dispatch(uint32 taskCount, uint32 groupSize, TaskHandler taskHandler, const char* label = nullptr);
+
+    // Successor is executed only after predecessor is completed.
+    // Cycles are detected in debug builds by TaskComposer::execute.
+    void add_dependency(NodeHandle predecessor, NodeHandle successor);
+    void add_dependencies(const std::vector<NodeHandle>& predecessors, NodeHandle successor);
+
+    // Removes all nodes and keeps their memory for the next build
+    void clear();
+
+    uint32 get_node_count() const { return m_nodeCount; }
+    bool is_empty() const { return !m_nodeCount; }
+
+private:
+    friend class TaskComposer;
+
+    struct Node
+    {
+        TaskHandler taskHandler;
+        uint32 taskCount = 1;
+        uint32 groupSize = 1;
+        const char* label = nullptr;
+        uint32 predecessorCount = 0;
+        std::atomic<uint32> unresolvedPredecessorCount{ 0 };
+        std::vector<NodeHandle> successors;
+    };
+
+    ConcurrentPoolAllocator<Node, 64, MemoryTag::TASKS> m_nodeAllocator;
+    // Nodes after m_nodeCount were used by previous builds and are reused by add_node()
+    std::vector<Node*> m_nodes;
+    uint32 m_nodeCount = 0;
+
+    NodeHandle add_node(uint32 taskCount, uint32 groupSize, TaskHandler taskHandler, const char* label);
+    Node* get_node(NodeHandle nodeHandle) const;
+    bool has_cycle() const;
+};
+
+}
@@ -0,0 +1,212 @@
+#include "task_tracer.h"
+#include "task_types.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+namespace fe
+{
+
+// Returns the buffer to TaskTracer when the thread exits
+struct TaskTracerThreadRegistration
+{
+    TaskTracer::ThreadBuffer* threadBuffer = nullptr;
+
+    ~TaskTracerThreadRegistration()
+    {
+        if (threadBuffer)
+            TaskTracer::release_thread_buffer(threadBuffer);
+    }
+};
+
+thread_local TaskTracerThreadRegistration g_taskTracerThreadRegistration;
+
+const char* get_priority_name(uint32 priority)
+{
+    switch ((TaskGroup::Priority)priority)
+    {
+    case TaskGroup::Priority::HIGH:
+        return "HIGH";
+    case TaskGroup::Priority::LOW:
+        return "LOW";
+    case TaskGroup::Priority::STREAMING:
+        return "STREAMING";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+void TaskTracer::start_capture()
+{
+    if (is_capturing())
+        return;
+
+    {
+        // No thread writes events while capture is stopped, so buffers can be reset
+        std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+        for (std::unique_ptr<ThreadBuffer>& threadBuffer : s_threadBuffers)
+            threadBuffer->eventCount = 0;
+    }
+
+    s_captureBeginTime = get_time();
+    s_isCapturing.store(true);
+
+    FE_LOG(LogTasks, INFO, "Task trace capture started");
+}
+
+void TaskTracer::stop_capture()
+{
+    if (!is_capturing())
+        return;
+
+    // Pairs with record_event(): either the writer sees that capture is stopped, or this thread sees isRecording
+    s_isCapturing.store(false);
+
+    std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+    for (std::unique_ptr<ThreadBuffer>& threadBuffer : s_threadBuffers)
+    {
+        while (threadBuffer->isRecording.load())
+            std::this_thread::yield();
+    }
+
+    FE_LOG(LogTasks, INFO, "Task trace capture stopped");
+}
+
+bool TaskTracer::export_chrome_trace(const std::string& path)
+{
+    stop_capture();
+
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        FE_LOG(LogTasks, ERROR, "TaskTracer::export_chrome_trace(): Failed to open {}", path);
+        return false;
+    }
+
+    std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+
+    uint64 eventCount = 0;
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"TaskComposer\"}}";
+
+    for (const std::unique_ptr<ThreadBuffer>& threadBuffer : s_threadBuffers)
+    {
+        if (!threadBuffer->eventCount)
+            continue;
+
+        file << fmt::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+            threadBuffer->threadIndex, threadBuffer->threadName);
+
+        uint64 firstEvent = threadBuffer->eventCount > s_bufferCapacity ? threadBuffer->eventCount - s_bufferCapacity : 0;
+        for (uint64 i = firstEvent; i != threadBuffer->eventCount; ++i)
+        {
+            const Event& event = threadBuffer->events[i & (s_bufferCapacity - 1)];
+            if (event.beginTime < s_captureBeginTime)
+                continue;
+
+            // Chrome trace timestamps are in microseconds
+            double beginTime = double(event.beginTime - s_captureBeginTime) / 1000.0;
+            double duration = double(event.endTime - event.beginTime) / 1000.0;
+            double queuedTime = event.enqueueTime && event.enqueueTime <= event.beginTime
+                ? double(event.beginTime - event.enqueueTime) / 1000.0 : 0.0;
+
+            file << fmt::format(
+                ",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f},"
+                "\"args\":{{\"taskGroup\":\"{:#x}\",\"taskCount\":{},\"queuedUs\":{:.3f}}}}}",
+                event.label ? event.label : "Task",
+                get_priority_name(event.priority),
+                threadBuffer->threadIndex,
+                beginTime,
+                duration,
+                event.taskGroupID,
+                event.taskCount,
+                queuedTime
+            );
+
+            ++eventCount;
+        }
+    }
+
+    file << "\n]}\n";
+
+    FE_LOG(LogTasks, INFO, "Exported {} task trace events to {}", eventCount, path);
+    return true;
+}
+
+uint64 TaskTracer::get_time()
+{
+    return Timer::get_time();
+}
+
+void TaskTracer::record_event(const Event& event)
+{
+    ThreadBuffer* threadBuffer = get_thread_buffer();
+
+    threadBuffer->isRecording.store(true);
+
+    if (s_isCapturing.load())
+        threadBuffer->events[threadBuffer->eventCount++ & (s_bufferCapacity - 1)] = event;
+
+    threadBuffer->isRecording.store(false, std::memory_order_release);
+}
+
+void TaskTracer::set_thread_name(const std::string& threadName)
+{
+    s_threadName = threadName;
+
+    if (s_threadBuffer)
+    {
+        std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+        s_threadBuffer->threadName = threadName;
+    }
+}
+
+uint32 TaskTracer::get_thread_buffer_count()
+{
+    std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+    return (uint32)s_threadBuffers.size();
+}
+
+TaskTracer::ThreadBuffer* TaskTracer::get_thread_buffer()
+{
+    if (s_threadBuffer)
+        return s_threadBuffer;
+
+    std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+
+    // Events of exited threads are kept until the end of the capture, so their buffers are reused only if they are not needed
+    auto freeThreadBufferIt = std::find_if(s_freeThreadBuffers.begin(), s_freeThreadBuffers.end(), [](const ThreadBuffer* threadBuffer)
+    {
+        return !is_capturing() || !threadBuffer->eventCount;
+    });
+
+    ThreadBuffer* threadBuffer = nullptr;
+    if (freeThreadBufferIt != s_freeThreadBuffers.end())
+    {
+        threadBuffer = *freeThreadBufferIt;
+        s_freeThreadBuffers.erase(freeThreadBufferIt);
+        threadBuffer->eventCount = 0;
+    }
+    else
+    {
+        threadBuffer = s_threadBuffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+        threadBuffer->events.resize(s_bufferCapacity);
+        threadBuffer->threadIndex = (uint32)s_threadBuffers.size() - 1;
+    }
+
+    threadBuffer->threadName = s_threadName.empty() ? "thread_" + std::to_string(threadBuffer->threadIndex) : s_threadName;
+
+    g_taskTracerThreadRegistration.threadBuffer = threadBuffer;
+    s_threadBuffer = threadBuffer;
+    return s_threadBuffer;
+}
+
+void TaskTracer::release_thread_buffer(ThreadBuffer* threadBuffer)
+{
+    std::scoped_lock<std::mutex> lock(s_threadBuffersMutex);
+    s_freeThreadBuffers.push_back(threadBuffer);
+}
+
+}
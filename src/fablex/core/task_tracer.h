@@ -0,0 +1,89 @@
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fe
+{
+
+// Records execution of TaskComposer tasks into per-thread ring buffers and exports them in Chrome trace event format,
+// which can be opened in chrome://tracing or ui.perfetto.dev. When capture is not active, TaskComposer
+// only does one relaxed atomic load per task and per submission.
+class TaskTracer
+{
+public:
+    struct Event
+    {
+        // Must point to a string with static storage duration, for example a string literal
+        const char* label;
+        uint64 taskGroupID;
+        uint64 enqueueTime;
+        uint64 beginTime;
+        uint64 endTime;
+        uint32 priority;
+        uint32 taskCount;
+    };
+
+    // Clears events of the previous capture
+    static void start_capture();
+    // Waits until all threads finish writing events that were started before the call
+    static void stop_capture();
+
+    static bool is_capturing()
+    {
+        return s_isCapturing.load(std::memory_order_relaxed);
+    }
+
+    // Stops capture if it is active. Returns false if the file can't be opened.
+    static bool export_chrome_trace(const std::string& path);
+
+    // Nanoseconds from an arbitrary point, same clock for all threads
+    static uint64 get_time();
+
+    static void record_event(const Event& event);
+
+    // Name of the calling thread in exported traces, TaskComposer sets names of its workers
+    static void set_thread_name(const std::string& threadName);
+    // Empty if the name was not set
+    static const std::string& get_thread_name() { return s_threadName; }
+
+    // Number of allocated thread buffers, stops growing when TaskComposer recreates its workers
+    static uint32 get_thread_buffer_count();
+
+private:
+    // Each buffer keeps the last s_bufferCapacity events of its thread
+    static constexpr uint64 s_bufferCapacity = 1 << 16;
+
+    struct ThreadBuffer
+    {
+        std::string threadName;
+        uint32 threadIndex;
+        std::vector<Event> events;
+        uint64 eventCount = 0;
+        // Set while the owner thread writes an event, stop_capture() waits until it is cleared
+        std::atomic_bool isRecording{ false };
+    };
+
+    inline static std::atomic_bool s_isCapturing = false;
+    inline static uint64 s_captureBeginTime = 0;
+
+    inline static std::mutex s_threadBuffersMutex;
+    inline static std::vector<std::unique_ptr<ThreadBuffer>> s_threadBuffers;
+    // Buffers of exited threads, reused by new threads, so buffers are not leaked when TaskComposer is reinitialized
+    inline static std::vector<ThreadBuffer*> s_freeThreadBuffers;
+
+    inline static thread_local ThreadBuffer* s_threadBuffer = nullptr;
+    inline static thread_local std::string s_threadName;
+
+    static ThreadBuffer* get_thread_buffer();
+    static void release_thread_buffer(ThreadBuffer* threadBuffer);
+
+    friend struct TaskTracerThreadRegistration;
+};
+
+}
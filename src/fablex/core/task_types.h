@@ -2,19 +2,26 @@
 
 #include "types.h"
 #include "logger.h"
+#include "inplace_function.h"
 
-#include <functional>
 #include <unordered_set>
+#include <atomic>
 #include <mutex>
-#include <deque>
+#include <vector>
+#include <algorithm>
 
 namespace fe
 {
 
 FE_DEFINE_LOG_CATEGORY(LogTasks);
 
+class TaskGraph;
+class TaskGroup;
+
 struct TaskExecutionInfo
 {
+    // Long-running handlers can poll taskGroup->is_cancelled() to stop early
+    const TaskGroup* taskGroup;
     uint32 globalTaskIndex;
     uint32 taskSubgroupID;
     uint32 taskIndexRelativeToSubgroup;
@@ -22,7 +29,55 @@ struct TaskExecutionInfo
     bool isLastTaskInSubgroup;
 };
 
-using TaskHandler = std::function<void(TaskExecutionInfo)>;
+// Read-only view of a cancellation flag owned by CancellationSource or TaskGroup.
+// Default constructed token is never cancelled.
+class CancellationToken
+{
+public:
+    CancellationToken() = default;
+    CancellationToken(const std::atomic_bool* isCancelled) : m_isCancelled(isCancelled) { }
+
+    bool is_cancelled() const
+    {
+        return m_isCancelled && m_isCancelled->load(std::memory_order_relaxed);
+    }
+
+private:
+    const std::atomic_bool* m_isCancelled = nullptr;
+};
+
+class CancellationSource
+{
+public:
+    void cancel()
+    {
+        m_isCancelled.store(true, std::memory_order_relaxed);
+    }
+
+    void reset()
+    {
+        m_isCancelled.store(false, std::memory_order_relaxed);
+    }
+
+    bool is_cancelled() const
+    {
+        return m_isCancelled.load(std::memory_order_relaxed);
+    }
+
+    // Source must outlive all tokens
+    CancellationToken get_token() const
+    {
+        return CancellationToken(&m_isCancelled);
+    }
+
+private:
+    std::atomic_bool m_isCancelled{ false };
+};
+
+// Captures must fit into this size, so submitting tasks never allocates memory
+constexpr size_t TASK_HANDLER_CAPACITY = 128;
+
+using TaskHandler = InplaceFunction<void(TaskExecutionInfo), TASK_HANDLER_CAPACITY>;
 
 class TaskGroup
 {
@@ -43,9 +98,10 @@ public:
         m_pendingTaskCount.fetch_add(taskCount);
     }
 
-    void decrease_task_count(uint32_t taskCount)
+    // Returns pending task count after decreasing
+    uint32_t decrease_task_count(uint32_t taskCount)
     {
-        m_pendingTaskCount.fetch_sub(taskCount);
+        return m_pendingTaskCount.fetch_sub(taskCount) - taskCount;
     }
 
     uint32_t get_pending_task_count() const
@@ -58,79 +114,149 @@ public:
         return m_priority;
     }
 
+    // Tasks of a cancelled group are dropped from queues without calling their handlers,
+    // new tasks are not submitted. Handlers that are already running are not interrupted.
+    // Cancellation is sticky, call reset_cancellation() before reusing the group.
+    void cancel()
+    {
+        m_cancellationSource.cancel();
+    }
+
+    void reset_cancellation()
+    {
+        m_cancellationSource.reset();
+    }
+
+    bool is_cancelled() const
+    {
+        return m_cancellationSource.is_cancelled() || m_linkedCancellationToken.is_cancelled();
+    }
+
+    // Group is also treated as cancelled when the linked token is cancelled,
+    // for example, when the operation that owns the group is cancelled from another thread.
+    void link_cancellation_token(CancellationToken token)
+    {
+        m_linkedCancellationToken = token;
+    }
+
+    // Token of the group's own cancellation flag, does not include the linked token
+    CancellationToken get_cancellation_token() const
+    {
+        return m_cancellationSource.get_token();
+    }
+
 private:
     std::atomic<uint32> m_pendingTaskCount{ 0 };
     Priority m_priority;
+    CancellationSource m_cancellationSource;
+    CancellationToken m_linkedCancellationToken;
 };
 
-struct Task
+// Shared by all tasks created in one TaskComposer::execute or TaskComposer::dispatch call
+struct TaskBatch
 {
-    TaskHandler taskHandler;
+    // Points to ownedTaskHandler or to the handler of a TaskGraph node
+    const TaskHandler* taskHandler = nullptr;
+    TaskHandler ownedTaskHandler;
     TaskGroup* taskGroup;
-    uint32_t taskSubgroupID;
-    uint32_t taskSubgroupBeginning;
-    uint32_t taskSubgroupEnd;
+    std::atomic<uint32> pendingTaskCount{ 0 };
+
+    // Set if the batch was created for a TaskGraph node
+    TaskGraph* taskGraph = nullptr;
+    uint32 taskGraphNode = 0;
+
+    // Used only by TaskTracer
+    const char* label = nullptr;
+    uint64 enqueueTime = 0;
 };
 
+struct Task
+{
+    TaskBatch* taskBatch;
+    uint32 taskSubgroupID;
+    uint32 taskSubgroupBeginning;
+    uint32 taskSubgroupEnd;
+};
+
+// Multi-producer multi-consumer queue. TaskComposer uses it for tasks submitted from threads
+// that do not own a work-stealing queue of the task priority. Tasks are stored in a ring buffer
+// that only grows, so pushing does not allocate memory once the queue has reached its working size.
 class TaskQueue
 {
 public:
+    TaskQueue(uint32 capacity = 1024) : m_tasks(capacity) 
+    { 
+        FE_CHECK((capacity & (capacity - 1)) == 0);
+    }
+
     void push_back(const Task& task)
+    {
+        push_back(&task, 1);
+    }
+
+    void push_back(const Task* tasks, uint32 taskCount)
     {
         std::scoped_lock<std::mutex> lock(m_mutex);
-        m_tasks.push_back(task);
+        
+        if (m_size + taskCount > m_tasks.size())
+            grow(m_size + taskCount);
+
+        for (uint32 i = 0; i != taskCount; ++i)
+            m_tasks[(m_head + m_size + i) & (m_tasks.size() - 1)] = tasks[i];
+
+        m_size += taskCount;
     }
 
     bool pop_front(Task& task)
     {
-        std::scoped_lock<std::mutex> lock(m_mutex);
-        if (m_tasks.empty())
-            return false;
-        task = std::move(m_tasks.front());
-        m_tasks.pop_front();
-        return true;
+        return pop_front(&task, 1) != 0;
     }
 
-    bool empty()
+    // Pops up to maxTaskCount tasks, returns the number of popped tasks
+    uint32 pop_front(Task* tasks, uint32 maxTaskCount)
     {
         std::scoped_lock<std::mutex> lock(m_mutex);
-        return m_tasks.empty();
-    }
 
-private:
-    std::deque<Task> m_tasks;
-    std::mutex m_mutex;
-};
+        uint32 taskCount = std::min(maxTaskCount, m_size);
+        for (uint32 i = 0; i != taskCount; ++i)
+            tasks[i] = m_tasks[(m_head + i) & (m_tasks.size() - 1)];
 
-class TaskQueueGroup
-{
-public:
-    TaskQueueGroup(uint32_t threadCount) : m_threadCount(threadCount)
-    {
-        m_taskQueues.reserve(threadCount);
-        for (auto i = 0; i != threadCount; ++i)
-            m_taskQueues.emplace_back(new TaskQueue());
+        m_head = (m_head + taskCount) & (m_tasks.size() - 1);
+        m_size -= taskCount;
+        return taskCount;
     }
 
-    TaskQueue& get_queue(uint32_t index)
+    bool empty()
     {
-        return *m_taskQueues[index % m_threadCount];
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        return m_size == 0;
     }
 
-    TaskQueue& get_next_queue()
+    uint32 size()
     {
-        return *m_taskQueues[m_nextQueue.fetch_add(1) % m_threadCount];
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        return m_size;
     }
 
-    uint32_t get_next_queue_index()
+private:
+    std::vector<Task> m_tasks;
+    uint32 m_head = 0;
+    uint32 m_size = 0;
+    std::mutex m_mutex;
+
+    void grow(uint32 minCapacity)
     {
-        return m_nextQueue.fetch_add(1) % m_threadCount;
-    }
+        uint32 newCapacity = (uint32)m_tasks.size();
+        while (newCapacity < minCapacity)
+            newCapacity *= 2;
 
-private:
-    std::vector<std::unique_ptr<TaskQueue>> m_taskQueues;
-    std::atomic<uint64> m_nextQueue = 0;
-    uint32_t m_threadCount;
+        std::vector<Task> newTasks(newCapacity);
+        for (uint32 i = 0; i != m_size; ++i)
+            newTasks[i] = m_tasks[(m_head + i) & (m_tasks.size() - 1)];
+
+        m_tasks = std::move(newTasks);
+        m_head = 0;
+    }
 };
 
 }
\ No newline at end of file
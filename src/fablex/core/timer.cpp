@@ -1,23 +1,23 @@
 #include "timer.h"
+#include "platform/platform.h"
+
+#ifndef WIN32
+#include <time.h>
+#endif // WIN32
 
 namespace fe
 {
 
 void Timer::init()
 {
-#ifdef WIN32
-    QueryPerformanceFrequency(&s_ticksPerSecond);
-    QueryPerformanceCounter(&s_lastTickCount);
-#endif // WIN32
+    s_lastTime = get_time();
 }
 
 void Timer::update()
 {
-	QueryPerformanceCounter(&s_currentTickCount);
-	uint64_t elapsedTicks = s_currentTickCount.QuadPart - s_lastTickCount.QuadPart;
-	uint64_t elapsedTicksMicroseconds = elapsedTicks * 1000000 / s_ticksPerSecond.QuadPart;
-	s_deltaTime = (float)elapsedTicksMicroseconds / 1000000.0f;
-	s_lastTickCount = s_currentTickCount;
+    uint64 currentTime = get_time();
+    s_deltaTime = float(double(currentTime - s_lastTime) / 1000000000.0);
+    s_lastTime = currentTime;
 }
 
 float Timer::get_delta_time()
@@ -25,4 +25,27 @@ float Timer::get_delta_time()
     return s_deltaTime;
 }
 
-}
\ No newline at end of file
+uint64 Timer::get_time()
+{
+#ifdef WIN32
+    static const uint64 ticksPerSecond = []()
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return uint64(frequency.QuadPart);
+    }();
+
+    LARGE_INTEGER tickCount;
+    QueryPerformanceCounter(&tickCount);
+
+    // Split into seconds and remainder, so the multiplication doesn't overflow
+    uint64 ticks = uint64(tickCount.QuadPart);
+    return ticks / ticksPerSecond * 1000000000ull + ticks % ticksPerSecond * 1000000000ull / ticksPerSecond;
+#else
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return uint64(time.tv_sec) * 1000000000ull + uint64(time.tv_nsec);
+#endif // WIN32
+}
+
+}
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "platform/platform.h"
+#include "types.h"
 
 namespace fe
 {
@@ -13,14 +13,13 @@ public:
 
     static float get_delta_time();
 
-private:
-#ifdef WIN32
-    inline static LARGE_INTEGER s_ticksPerSecond;
-    inline static LARGE_INTEGER s_lastTickCount;
-    inline static LARGE_INTEGER s_currentTickCount;
+    // Nanoseconds from an arbitrary point, monotonic and the same for all threads.
+    // Uses QueryPerformanceCounter on Win32 and clock_gettime(CLOCK_MONOTONIC) on other platforms.
+    static uint64 get_time();
 
-    inline static float s_deltaTime; 
-#endif // WIN32
+private:
+    inline static uint64 s_lastTime = 0;
+    inline static float s_deltaTime = 0.0f;
 };
 
-}
\ No newline at end of file
+}
@@ -1,17 +1,100 @@
 #include "uuid.h"
+#include "macro.h"
+#include <atomic>
+#include <mutex>
 #include <random>
 
 namespace fe
 {
 
-static std::random_device sRandomDevice;
-static std::mt19937_64 sRandomEngine(sRandomDevice());
-static std::uniform_int_distribution<uint64_t> sUniformDistribution;
+// Expands one seed into the state of xoshiro256**
+uint64 splitmix64(uint64& state)
+{
+    uint64 result = (state += 0x9e3779b97f4a7c15ull);
+    result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9ull;
+    result = (result ^ (result >> 27)) * 0x94d049bb133111ebull;
+    return result ^ (result >> 31);
+}
+
+uint64 rotate_left(uint64 value, uint32 shift)
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+class UUIDGenerator
+{
+public:
+    uint64 seedVersion = ~0ull;
+
+    void seed(uint64 seed)
+    {
+        for (uint64& word : m_state)
+            word = splitmix64(seed);
+    }
+
+    uint64 next()
+    {
+        const uint64 result = rotate_left(m_state[1] * 5, 7) * 9;
+        const uint64 t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotate_left(m_state[3], 45);
+
+        return result;
+    }
+
+    uint64 next_valid()
+    {
+        uint64 uuid = next();
+        while (uuid == 0)
+            uuid = next();
+        return uuid;
+    }
+
+private:
+    uint64 m_state[4];
+};
+
+thread_local UUIDGenerator g_uuidGenerator;
+
+// Generators compare their version with this one before drawing, so seeds are changed without touching other threads
+std::atomic<uint64> g_uuidSeedVersion{ 0 };
+
+std::mutex g_uuidSeedMutex;
+bool g_isUUIDSeedDeterministic = false;
+uint64 g_uuidDeterministicSeed = 0;
+uint64 g_uuidSeededThreadCount = 0;
+
+UUIDGenerator& get_uuid_generator()
+{
+    UUIDGenerator& generator = g_uuidGenerator;
+    if (generator.seedVersion == g_uuidSeedVersion.load(std::memory_order_acquire))
+        return generator;
+
+    std::scoped_lock<std::mutex> lock(g_uuidSeedMutex);
+    generator.seedVersion = g_uuidSeedVersion.load(std::memory_order_relaxed);
+
+    if (g_isUUIDSeedDeterministic)
+    {
+        uint64 threadSeed = g_uuidDeterministicSeed + g_uuidSeededThreadCount++;
+        generator.seed(splitmix64(threadSeed));
+    }
+    else
+    {
+        std::random_device randomDevice;
+        generator.seed((uint64(randomDevice()) << 32) | randomDevice());
+    }
+
+    return generator;
+}
 
-UUID::UUID() : m_uuid(sUniformDistribution(sRandomEngine))
+UUID::UUID() : m_uuid(get_uuid_generator().next_valid())
 {
-    if (m_uuid == 0)
-        m_uuid = sUniformDistribution(sRandomEngine);
+
 }
 
 UUID::UUID(uint64_t uuid) : m_uuid(uuid)
@@ -19,4 +102,29 @@ UUID::UUID(uint64_t uuid) : m_uuid(uuid)
     
 }
 
-}
\ No newline at end of file
+void UUID::generate(UUID* outUUIDs, uint64 count)
+{
+    FE_CHECK(outUUIDs || count == 0);
+
+    UUIDGenerator& generator = get_uuid_generator();
+    for (uint64 i = 0; i != count; ++i)
+        outUUIDs[i].m_uuid = generator.next_valid();
+}
+
+void UUID::set_deterministic_seed(uint64 seed)
+{
+    std::scoped_lock<std::mutex> lock(g_uuidSeedMutex);
+    g_isUUIDSeedDeterministic = true;
+    g_uuidDeterministicSeed = seed;
+    g_uuidSeededThreadCount = 0;
+    g_uuidSeedVersion.fetch_add(1, std::memory_order_release);
+}
+
+void UUID::reset_seed()
+{
+    std::scoped_lock<std::mutex> lock(g_uuidSeedMutex);
+    g_isUUIDSeedDeterministic = false;
+    g_uuidSeedVersion.fetch_add(1, std::memory_order_release);
+}
+
+}
@@ -12,9 +12,19 @@ class UUID
 public:
     static const UUID INVALID;
 
+    // Never INVALID. Each thread draws from its own xoshiro256** generator, so UUIDs can be created from any thread.
     UUID();
     UUID(uint64 uuid);
 
+    // Draws all UUIDs from the generator of the calling thread, cheaper than constructing them one by one
+    static void generate(UUID* outUUIDs, uint64 count);
+
+    // Generators are seeded again from the seed and the order in which threads create their first UUID after the call,
+    // so UUIDs of scenes created by one thread are the same in every run. Used by tests and benchmarks.
+    static void set_deterministic_seed(uint64 seed);
+    // Generators are seeded again from std::random_device
+    static void reset_seed();
+
     operator uint64() const { return m_uuid; }
     
     bool operator==(const UUID& uuid) const
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "types.h"
+#include "macro.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+
+namespace fe
+{
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models").
+// Only the owner thread can call push() and pop(), any thread can call steal().
+// Elements are stored as arrays of atomic words, so a thief that reads a slot concurrently
+// with the owner overwriting it gets a torn value instead of a data race. Torn values are always
+// discarded because the thief's CAS on top fails in that case.
+template<typename T>
+class WorkStealingQueue
+{
+    FE_COMPILE_CHECK(std::is_trivially_copyable_v<T>);
+
+public:
+    WorkStealingQueue(uint64 capacity = 256)
+    {
+        FE_CHECK((capacity & (capacity - 1)) == 0);
+        m_buffer.store(new RingBuffer(capacity), std::memory_order_relaxed);
+    }
+
+    ~WorkStealingQueue()
+    {
+        delete m_buffer.load(std::memory_order_relaxed);
+    }
+
+    WorkStealingQueue(const WorkStealingQueue&) = delete;
+    WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+    void push(const T& item)
+    {
+        int64 bottom = m_bottom.load(std::memory_order_relaxed);
+        int64 top = m_top.load(std::memory_order_acquire);
+        RingBuffer* buffer = m_buffer.load(std::memory_order_relaxed);
+
+        if (bottom - top > int64(buffer->capacity) - 1)
+        {
+            buffer = grow(buffer, bottom, top);
+            m_buffer.store(buffer, std::memory_order_release);
+        }
+
+        buffer->put(bottom, item);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    bool pop(T& outItem)
+    {
+        int64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        RingBuffer* buffer = m_buffer.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        outItem = buffer->get(bottom);
+        if (top != bottom)
+            return true;
+
+        // Last item, race against thieves
+        bool result = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return result;
+    }
+
+    bool steal(T& outItem)
+    {
+        int64 top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 bottom = m_bottom.load(std::memory_order_acquire);
+
+        if (top >= bottom)
+            return false;
+
+        RingBuffer* buffer = m_buffer.load(std::memory_order_acquire);
+        T item = buffer->get(top);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return false;
+
+        outItem = item;
+        return true;
+    }
+
+    bool empty() const
+    {
+        int64 bottom = m_bottom.load(std::memory_order_relaxed);
+        int64 top = m_top.load(std::memory_order_relaxed);
+        return bottom <= top;
+    }
+
+    uint64 size() const
+    {
+        int64 bottom = m_bottom.load(std::memory_order_relaxed);
+        int64 top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? uint64(bottom - top) : 0;
+    }
+
+private:
+    static constexpr uint64 s_wordCount = (sizeof(T) + sizeof(uint64) - 1) / sizeof(uint64);
+
+    struct Slot
+    {
+        std::atomic<uint64> words[s_wordCount];
+    };
+
+    struct RingBuffer
+    {
+        uint64 capacity;
+        uint64 mask;
+        std::unique_ptr<Slot[]> slots;
+
+        RingBuffer(uint64 inCapacity) : capacity(inCapacity), mask(inCapacity - 1), slots(new Slot[inCapacity]) { }
+
+        void put(int64 index, const T& item)
+        {
+            uint64 words[s_wordCount] = {};
+            std::memcpy(words, &item, sizeof(T));
+
+            Slot& slot = slots[uint64(index) & mask];
+            for (uint64 i = 0; i != s_wordCount; ++i)
+                slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        T get(int64 index) const
+        {
+            uint64 words[s_wordCount];
+
+            const Slot& slot = slots[uint64(index) & mask];
+            for (uint64 i = 0; i != s_wordCount; ++i)
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+
+            T item;
+            std::memcpy(&item, words, sizeof(T));
+            return item;
+        }
+    };
+
+    alignas(64) std::atomic<int64> m_top{ 0 };
+    alignas(64) std::atomic<int64> m_bottom{ 0 };
+    alignas(64) std::atomic<RingBuffer*> m_buffer{ nullptr };
+
+    // Thieves may still read from old buffers, so they are kept alive until the queue is destroyed.
+    // Only the owner touches this vector.
+    std::vector<std::unique_ptr<RingBuffer>> m_retiredBuffers;
+
+    RingBuffer* grow(RingBuffer* oldBuffer, int64 bottom, int64 top)
+    {
+        RingBuffer* newBuffer = new RingBuffer(oldBuffer->capacity * 2);
+        for (int64 i = top; i != bottom; ++i)
+            newBuffer->put(i, oldBuffer->get(i));
+
+        m_retiredBuffers.emplace_back(oldBuffer);
+        return newBuffer;
+    }
+};
+
+}
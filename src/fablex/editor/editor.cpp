@@ -6,6 +6,7 @@
 #include "core/window.h"
 #include "engine/entity/world.h"
 #include "core/file_system/file_system.h"
+#include "core/task_tracer.h"
 
 #include "imgui.h"
 #include "ImGuizmo.h"
@@ -29,6 +30,8 @@ Editor::Editor()
     m_propertiesWindow = std::make_unique<PropertiesWindow>();
     m_contentBrowser = std::make_unique<ContentBrowser>();
     m_toolbar = std::make_unique<Toolbar>();
+    m_profilerWindow = std::make_unique<ProfilerWindow>();
+    m_memoryWindow = std::make_unique<MemoryWindow>();
 
     Utils::setup_dark_theme();
     subscribe_to_events();
@@ -45,6 +48,8 @@ Editor::~Editor()
 
 void Editor::draw()
 {
+    FE_PROFILE_SCOPE("Editor::draw");
+
     ImGuiIO& io = ImGui::GetIO();
     io.DisplaySize.x = static_cast<float>(m_window->get_info().width);
     io.DisplaySize.y = static_cast<float>(m_window->get_info().height);
@@ -63,6 +68,8 @@ void Editor::draw()
     m_propertiesWindow->draw(m_outlinerWindow->last_selected_entity());
     m_contentBrowser->draw();
     m_toolbar->draw(FileSystem::get_project_path());
+    m_profilerWindow->draw();
+    m_memoryWindow->draw();
 
     for (auto it = m_extraWindows.begin(); it != m_extraWindows.end(); )
     {
@@ -74,6 +81,8 @@ void Editor::draw()
 
     ImGui::PopFont();
 
+    update_task_trace_capture();
+
     ImGui::Render();
 }
 
@@ -117,4 +126,21 @@ void Editor::load_fonts()
     m_inconsolataMedium = io.Fonts->AddFontFromFileTTF(inconsolataMediumPath.c_str(), 16.0f);
 }
 
-}
\ No newline at end of file
+// F9 starts capture, second press stops it and writes the trace to the traces folder
+void Editor::update_task_trace_capture()
+{
+    if (!ImGui::IsKeyPressed(ImGuiKey_F9, false))
+        return;
+
+    if (!TaskTracer::is_capturing())
+    {
+        TaskTracer::start_capture();
+        return;
+    }
+
+    FileSystem::create_directories("traces");
+    std::string path = FileSystem::get_absolute_path("traces/task_trace_" + std::to_string(TaskTracer::get_time()) + ".json");
+    TaskTracer::export_chrome_trace(path);
+}
+
+}
@@ -6,6 +6,8 @@
 #include "properties_window.h"
 #include "toolbar.h"
 #include "content_browser.h"
+#include "profiler_window.h"
+#include "memory_window.h"
 #include "window_ui.h"
 
 #include "core/fwd.h"
@@ -41,6 +43,8 @@ private:
     std::unique_ptr<PropertiesWindow> m_propertiesWindow = nullptr;
     std::unique_ptr<ContentBrowser> m_contentBrowser = nullptr;
     std::unique_ptr<Toolbar> m_toolbar = nullptr;
+    std::unique_ptr<ProfilerWindow> m_profilerWindow = nullptr;
+    std::unique_ptr<MemoryWindow> m_memoryWindow = nullptr;
 
     ImFont* m_inconsolataMedium = nullptr;;
 
@@ -48,6 +52,7 @@ private:
 
     void subscribe_to_events();
     void load_fonts();
+    void update_task_trace_capture();
 };
 
 }
\ No newline at end of file
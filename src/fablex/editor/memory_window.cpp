@@ -0,0 +1,65 @@
+#include "memory_window.h"
+#include "core/memory_tracker.h"
+#include "core/timer.h"
+#include "core/file_system/file_system.h"
+
+#include "imgui.h"
+
+#include <string>
+
+namespace fe::editor
+{
+
+constexpr double g_bytesInMegabyte = 1024.0 * 1024.0;
+
+void MemoryWindow::draw()
+{
+    ImGui::Begin("Memory");
+
+#ifdef FE_MEMORY_TRACKING
+    if (ImGui::Button("Save Report"))
+        save_report();
+
+    ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp;
+    if (ImGui::BeginTable("MemoryTags", 5, flags))
+    {
+        ImGui::TableSetupColumn("Tag");
+        ImGui::TableSetupColumn("Live, MB");
+        ImGui::TableSetupColumn("Peak, MB");
+        ImGui::TableSetupColumn("Live Allocations");
+        ImGui::TableSetupColumn("Total Allocations");
+        ImGui::TableHeadersRow();
+
+        for (uint32 tagIndex = 0; tagIndex != MemoryTracker::s_tagCount; ++tagIndex)
+        {
+            MemoryTracker::TagStats tagStats = MemoryTracker::get_tag_stats(MemoryTag(tagIndex));
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(tagStats.tagName);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", tagStats.liveBytes / g_bytesInMegabyte);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", tagStats.peakBytes / g_bytesInMegabyte);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)tagStats.liveAllocationCount);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)tagStats.totalAllocationCount);
+        }
+
+        ImGui::EndTable();
+    }
+#else
+    ImGui::TextUnformatted("Memory tracking is disabled in shipping builds");
+#endif
+
+    ImGui::End();
+}
+
+void MemoryWindow::save_report()
+{
+    FileSystem::create_directories("traces");
+    MemoryTracker::export_report(FileSystem::get_absolute_path("traces/memory_" + std::to_string(Timer::get_time()) + ".json"));
+}
+
+}
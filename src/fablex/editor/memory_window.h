@@ -0,0 +1,15 @@
+#pragma once
+
+namespace fe::editor
+{
+
+class MemoryWindow
+{
+public:
+    void draw();
+
+private:
+    void save_report();
+};
+
+}
@@ -0,0 +1,138 @@
+#include "profiler_window.h"
+#include "core/timer.h"
+#include "core/file_system/file_system.h"
+
+#include "imgui.h"
+
+#include <algorithm>
+
+namespace fe::editor
+{
+
+constexpr float g_timelineRowHeight = 18.0f;
+
+void ProfilerWindow::draw()
+{
+    ImGui::Begin("Profiler");
+
+    bool isEnabled = Profiler::is_enabled();
+    if (ImGui::Checkbox("Enabled", &isEnabled))
+        Profiler::set_enabled(isEnabled);
+
+    ImGui::SameLine();
+    if (ImGui::Button("Save Capture"))
+        save_capture();
+
+    const Profiler::Frame* lastFrame = Profiler::get_last_frame();
+    if (!lastFrame)
+    {
+        ImGui::End();
+        return;
+    }
+
+    Profiler::get_frame_times(m_frameTimes);
+    float maxFrameTime = *std::max_element(m_frameTimes.begin(), m_frameTimes.end());
+    ImGui::PlotLines("##FrameTimes", m_frameTimes.data(), (int)m_frameTimes.size(), 0,
+        "Frame time, ms", 0.0f, maxFrameTime, ImVec2(ImGui::GetContentRegionAvail().x, 60.0f));
+
+    draw_timeline(*lastFrame);
+    draw_scope_stats();
+
+    ImGui::End();
+}
+
+// Each thread is a group of rows, nested scopes are drawn one row lower than their parents
+void ProfilerWindow::draw_timeline(const Profiler::Frame& frame)
+{
+    if (!ImGui::CollapsingHeader("Last Frame", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    double frameDuration = double(std::max<uint64>(frame.endTime - frame.beginTime, 1));
+    ImGui::Text("Frame %llu: %.3f ms", (unsigned long long)frame.frameNumber, frameDuration / 1000000.0);
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    float width = ImGui::GetContentRegionAvail().x;
+
+    for (const Profiler::ThreadFrame& threadFrame : frame.threads)
+    {
+        if (threadFrame.events.empty())
+            continue;
+
+        uint32 maxDepth = 0;
+        for (const Profiler::ScopeEvent& event : threadFrame.events)
+            maxDepth = std::max(maxDepth, event.depth);
+
+        ImGui::TextUnformatted(Profiler::get_thread_name(threadFrame.threadIndex).c_str());
+
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        float height = (maxDepth + 1) * g_timelineRowHeight;
+        ImGui::InvisibleButton(("##Thread" + std::to_string(threadFrame.threadIndex)).c_str(), ImVec2(width, height));
+        bool isHovered = ImGui::IsItemHovered();
+        ImVec2 mousePos = ImGui::GetMousePos();
+
+        for (const Profiler::ScopeEvent& event : threadFrame.events)
+        {
+            uint64 beginTime = std::max(event.beginTime, frame.beginTime);
+            float beginX = origin.x + float(double(beginTime - frame.beginTime) / frameDuration) * width;
+            float endX = origin.x + float(double(event.endTime - frame.beginTime) / frameDuration) * width;
+            endX = std::max(endX, beginX + 1.0f);
+
+            ImVec2 min(beginX, origin.y + event.depth * g_timelineRowHeight);
+            ImVec2 max(endX, min.y + g_timelineRowHeight - 1.0f);
+
+            drawList->AddRectFilled(min, max, ImGui::GetColorU32(ImGuiCol_PlotHistogram, 0.4f + 0.15f * (event.depth % 4)));
+            if (max.x - min.x > ImGui::CalcTextSize(event.name).x + 4.0f)
+                drawList->AddText(ImVec2(min.x + 2.0f, min.y + 1.0f), ImGui::GetColorU32(ImGuiCol_Text), event.name);
+
+            if (isHovered && mousePos.x >= min.x && mousePos.x < max.x && mousePos.y >= min.y && mousePos.y < max.y)
+                ImGui::SetTooltip("%s: %.3f ms", event.name, double(event.endTime - beginTime) / 1000000.0);
+        }
+    }
+}
+
+void ProfilerWindow::draw_scope_stats()
+{
+    if (!ImGui::CollapsingHeader("Scopes", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    Profiler::get_scope_stats(m_scopeStats);
+
+    ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp;
+    if (!ImGui::BeginTable("ProfilerScopes", 6, flags))
+        return;
+
+    ImGui::TableSetupColumn("Scope");
+    ImGui::TableSetupColumn("Min, ms");
+    ImGui::TableSetupColumn("Avg, ms");
+    ImGui::TableSetupColumn("P99, ms");
+    ImGui::TableSetupColumn("Max, ms");
+    ImGui::TableSetupColumn("Calls");
+    ImGui::TableHeadersRow();
+
+    for (const Profiler::ScopeStats& scopeStats : m_scopeStats)
+    {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(scopeStats.name.c_str());
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", scopeStats.minTime);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", scopeStats.avgTime);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", scopeStats.p99Time);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", scopeStats.maxTime);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f", scopeStats.callsPerFrame);
+    }
+
+    ImGui::EndTable();
+}
+
+void ProfilerWindow::save_capture()
+{
+    FileSystem::create_directories("traces");
+    Profiler::export_capture(FileSystem::get_absolute_path("traces/profile_" + std::to_string(Timer::get_time()) + ".json"));
+}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "core/profiler.h"
+
+#include <vector>
+
+namespace fe::editor
+{
+
+class ProfilerWindow
+{
+public:
+    void draw();
+
+private:
+    std::vector<float> m_frameTimes;
+    std::vector<Profiler::ScopeStats> m_scopeStats;
+
+    void draw_timeline(const Profiler::Frame& frame);
+    void draw_scope_stats();
+    void save_capture();
+};
+
+}
@@ -47,6 +47,7 @@ void PropertiesWindow::draw(engine::Entity* selectedEntity)
     }
 
     std::vector<Property*> properties;
+    bool areComponentsChanged = false;
     const TypeInfo* baseComponentTypeInfo = engine::Component::get_static_type_info();
 
     for (engine::Component* component : m_selectedEntity->get_components())
@@ -66,12 +67,16 @@ void PropertiesWindow::draw(engine::Entity* selectedEntity)
 
             std::reverse(properties.begin(), properties.end());
 
-            Utils::draw_properties_ui(properties, component);
+            areComponentsChanged |= Utils::draw_properties_ui(properties, component);
         }
 
         properties.clear();
     }
 
+    // Component properties are written directly, so bounds may change without the entity knowing
+    if (areComponentsChanged)
+        m_selectedEntity->set_world_bounds_dirty(true);
+
     ImGui::End();
 }
 
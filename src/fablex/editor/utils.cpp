@@ -21,8 +21,10 @@
 namespace fe::editor
 {
 
-void Utils::draw_properties_ui(const PropertyArray& properties, Object* object)
+bool Utils::draw_properties_ui(const PropertyArray& properties, Object* object)
 {
+    bool isChanged = false;
+
     for (Property* property : properties)
     {
         float minValue = 0.0f;
@@ -43,53 +45,71 @@ void Utils::draw_properties_ui(const PropertyArray& properties, Object* object)
             case PropertyType::BOOL:
             {
                 bool value = property->get_value<bool>(object);
-                ImGui::Checkbox(property->get_name().c_str(), &value);
-                property->set_value(object, value);
+                if (ImGui::Checkbox(property->get_name().c_str(), &value))
+                {
+                    property->set_value(object, value);
+                    isChanged = true;
+                }
                 break;
             }
             case PropertyType::INTEGER:
             {
                 int32 value = property->get_value<int32>(object);
-                ImGui::SliderInt(property->get_name().c_str(), &value, (int)minValue, (int)maxValue);
-                property->set_value(object, value);
+                if (ImGui::SliderInt(property->get_name().c_str(), &value, (int)minValue, (int)maxValue))
+                {
+                    property->set_value(object, value);
+                    isChanged = true;
+                }
                 break;
             }
             case PropertyType::UUID:
             {
-                draw_model_component(object);
+                isChanged |= draw_model_component(object);
                 break;
             }
             case PropertyType::FLOAT:
             {
                 float value = property->get_value<float>(object);
-                ImGui::DragFloat(property->get_name().c_str(), &value, speed, minValue, maxValue);
-                property->set_value(object, value);
+                if (ImGui::DragFloat(property->get_name().c_str(), &value, speed, minValue, maxValue))
+                {
+                    property->set_value(object, value);
+                    isChanged = true;
+                }
                 break;
             }
             case PropertyType::FLOAT2:
             {
                 Float2 value = property->get_value<Float2>(object);
-                ImGui::DragFloat2(property->get_name().c_str(), &value.x, speed, minValue, maxValue);
-                property->set_value(object, value);
+                if (ImGui::DragFloat2(property->get_name().c_str(), &value.x, speed, minValue, maxValue))
+                {
+                    property->set_value(object, value);
+                    isChanged = true;
+                }
                 break;
             }
             case PropertyType::FLOAT3:
             {
                 Float3 value = property->get_value<Float3>(object);
-                ImGui::DragFloat3(property->get_name().c_str(), &value.x, speed, minValue, maxValue);
-                property->set_value(object, value);
+                if (ImGui::DragFloat3(property->get_name().c_str(), &value.x, speed, minValue, maxValue))
+                {
+                    property->set_value(object, value);
+                    isChanged = true;
+                }
                 break;
             }
             case PropertyType::FLOAT4:
             {
                 Float4 value = property->get_value<Float4>(object);
 
-                if (property->get_attribute<Color>())
-                    ImGui::ColorEdit4(property->get_name().c_str(), &value.x);
-                else
-                    ImGui::DragFloat4(property->get_name().c_str(), &value.x, speed, minValue, maxValue);
+                const bool isValueChanged = property->get_attribute<Color>()
+                    ? ImGui::ColorEdit4(property->get_name().c_str(), &value.x)
+                    : ImGui::DragFloat4(property->get_name().c_str(), &value.x, speed, minValue, maxValue);
 
-                property->set_value(object, value);
+                if (isValueChanged)
+                {
+                    property->set_value(object, value);
+                    isChanged = true;
+                }
                 break;
             }
             case PropertyType::FLOAT3X4:
@@ -115,11 +135,13 @@ void Utils::draw_properties_ui(const PropertyArray& properties, Object* object)
             case PropertyType::ARRAY:
             {
                 // FE_LOG(LogDefault, INFO, "DRAW ARRAY");
-                draw_material_component(object);
+                isChanged |= draw_material_component(object);
                 break;
             }
         }
     }
+
+    return isChanged;
 }
 
 void Utils::send_save_request()
@@ -237,10 +259,10 @@ void Utils::setup_dark_theme()
 }
 
 // Must not do this, but for now have no ideas how to draw this component in another way
-void Utils::draw_material_component(Object* materialComponentObj)
+bool Utils::draw_material_component(Object* materialComponentObj)
 {
     if (!materialComponentObj->is_a<engine::MaterialComponent>())
-        return;
+        return false;
 
     auto materialComponent = reinterpret_cast<engine::MaterialComponent*>(materialComponentObj);
     FE_CHECK(materialComponent);
@@ -253,6 +275,7 @@ void Utils::draw_material_component(Object* materialComponentObj)
     FE_CHECK(model);
 
     const auto& allMaterials = asset::AssetRegistry::get_assets_data_by_type(asset::Type::MATERIAL);
+    bool isChanged = false;
 
     for (uint32 i = 0; i != model->material_slots().size(); ++i)
     {
@@ -269,6 +292,7 @@ void Utils::draw_material_component(Object* materialComponentObj)
                 if (ImGui::Selectable(matData->name.c_str(), matData == selectedMaterialData))
                 {
                     newSelectedMaterialData = matData;
+                    isChanged = true;
                     EventManager::enqueue_event(engine::MaterialUpdatedEvent(materialComponent));
                 }
 
@@ -282,12 +306,14 @@ void Utils::draw_material_component(Object* materialComponentObj)
                 FE_LOG(LogEditor, ERROR, "Material index {} is invalid.", i);
         }
     }
+
+    return isChanged;
 }
 
-void Utils::draw_model_component(Object* modelComponentObj)
+bool Utils::draw_model_component(Object* modelComponentObj)
 {
     if (!modelComponentObj->is_a<engine::ModelComponent>())
-        return;
+        return false;
 
     auto modelComponent = static_cast<engine::ModelComponent*>(modelComponentObj);
     FE_CHECK(modelComponent);
@@ -311,7 +337,7 @@ void Utils::draw_model_component(Object* modelComponentObj)
     }
 
     if (selectedAssetData == prevAssetData)
-        return;
+        return false;
 
     asset::Model* oldModel = asset::AssetManager::get_model(prevAssetData->uuid);
     asset::Model* currModel = asset::AssetManager::get_model(selectedAssetData->uuid);
@@ -330,6 +356,8 @@ void Utils::draw_model_component(Object* modelComponentObj)
 
         EventManager::enqueue_event(engine::ModelComponentUpdatedEvent(modelComponent->get_entity(), oldModel, currModel));
     }
+
+    return true;
 }
 
 bool Utils::is_model_file(const std::string& name)
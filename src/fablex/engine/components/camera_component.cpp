@@ -17,22 +17,13 @@ FE_BEGIN_PROPERTY_REGISTER(CameraComponent)
 }
 FE_END_PROPERTY_REGISTER(CameraComponent)
 
-void CameraComponent::serialize(Archive& archive) const
-{
-    Component::serialize(archive);
-
-    archive << zNear;
-    archive << zFar;
-    archive << fov;
-    archive << isActive;
-    archive << movementSpeed;
-    archive << mouseSensitivity;
-}
-
 void CameraComponent::deserialize(Archive& archive)
 {
     Component::deserialize(archive);
 
+    if (archive.get_version() >= Archive::s_propertyLayoutVersion)
+        return;
+
     archive >> zNear;
     archive >> zFar;
     archive >> fov;
@@ -31,7 +31,7 @@ public:
     Float4x4 inverseProjection;
     Float4x4 inverseViewProjection;
 
-    virtual void serialize(Archive& archive) const override;
+    // Reads archives written before the property layout in the old field order
     virtual void deserialize(Archive& archive) override;
 };
 
@@ -35,18 +35,13 @@ void LightComponent::fill_shader_data(ShaderEntity& outShaderEntity) const
     outShaderEntity.position = m_entity->get_position();
 }
 
-void LightComponent::serialize(Archive& archive) const
-{
-    ShaderEntityComponent::serialize(archive);
-
-    archive << color;
-    archive << intensity;
-}
-
 void LightComponent::deserialize(Archive& archive)
 {
     ShaderEntityComponent::deserialize(archive);
 
+    if (archive.get_version() >= Archive::s_propertyLayoutVersion)
+        return;
+
     archive >> color;
     archive >> intensity;
 }
@@ -70,16 +65,22 @@ void PointLightComponent::fill_shader_data(ShaderEntity& outShaderEntity) const
     outShaderEntity.set_type(SHADER_ENTITY_TYPE_POINT_LIGHT);
 }
 
-void PointLightComponent::serialize(Archive& archive) const
+bool PointLightComponent::get_world_bounds(AABB& outAABB) const
 {
-    LightComponent::serialize(archive);
-    archive << attenuationRadius;
+    if (!m_entity)
+        return false;
+
+    const Float4x4& worldTransform = m_entity->get_world_transform();
+    outAABB.create(Float3(worldTransform._41, worldTransform._42, worldTransform._43), Float3(attenuationRadius, attenuationRadius, attenuationRadius));
+    return true;
 }
 
 void PointLightComponent::deserialize(Archive& archive)
 {
     LightComponent::deserialize(archive);
-    archive >> attenuationRadius;
+
+    if (archive.get_version() < Archive::s_propertyLayoutVersion)
+        archive >> attenuationRadius;
 }
 
 }
\ No newline at end of file
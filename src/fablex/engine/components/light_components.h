@@ -19,7 +19,7 @@ public:
     
     virtual bool is_light_source() const override { return true; }
 
-    virtual void serialize(Archive& archive) const override;
+    // Reads archives written before the property layout in the old field order
     virtual void deserialize(Archive& archive) override;
 };
 
@@ -41,8 +41,9 @@ public:
     float attenuationRadius = 32.0f;
 
     virtual void fill_shader_data(ShaderEntity& outShaderEntity) const override;
+    // Box around the attenuation radius, which doesn't depend on the entity scale
+    virtual bool get_world_bounds(AABB& outAABB) const override;
 
-    virtual void serialize(Archive& archive) const override;
     virtual void deserialize(Archive& archive) override;
 };
 
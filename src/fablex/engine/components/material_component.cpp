@@ -1,5 +1,6 @@
 #include "material_component.h"
 #include "asset_manager/asset_manager.h"
+#include "core/file_system/archive.h"
 
 namespace fe::engine
 {
@@ -51,18 +52,12 @@ bool MaterialComponent::set_material(UUID materialUUID, uint32 index)
     return true;
 }
 
-void MaterialComponent::serialize(Archive& archive) const
-{
-    Component::serialize(archive);
-
-    archive << m_materialUUIDs;
-}
-
 void MaterialComponent::deserialize(Archive& archive)
 {
     Component::deserialize(archive);
 
-    archive >> m_materialUUIDs;
+    if (archive.get_version() < Archive::s_propertyLayoutVersion)
+        archive >> m_materialUUIDs;
 }
 
 }
\ No newline at end of file
@@ -23,9 +23,9 @@ public:
 
     const std::vector<UUID>& material_uuids() const { return m_materialUUIDs; }
 
-    virtual void serialize(Archive& archive) const override;
+    // Reads archives written before the property layout in the old field order
     virtual void deserialize(Archive& archive) override;
-    
+
 protected:
     std::vector<UUID> m_materialUUIDs;
 };
@@ -17,12 +17,15 @@ FE_END_PROPERTY_REGISTER(ModelComponent)
 
 void ModelComponent::set_model(asset::Model* model)
 {
-    m_modelUUID = model->get_uuid();
+    set_model_uuid(model->get_uuid());
 }
 
 void ModelComponent::set_model_uuid(UUID uuid)
 {
     m_modelUUID = uuid;
+
+    if (m_entity)
+        m_entity->set_world_bounds_dirty(true);
 }
 
 UUID ModelComponent::get_model_uuid() const
@@ -40,6 +43,20 @@ bool ModelComponent::is_model_loaded() const
     return asset::AssetManager::is_asset_loaded(m_modelUUID);
 }
 
+bool ModelComponent::get_world_bounds(AABB& outAABB) const
+{
+    if (!m_entity || !is_model_loaded())
+        return false;
+
+    outAABB = get_model()->aabb().transform(m_entity->get_world_transform());
+    return true;
+}
+
+bool ModelComponent::are_world_bounds_pending() const
+{
+    return m_modelUUID != UUID::INVALID && !is_model_loaded();
+}
+
 void ModelComponent::fill_shader_instance_data(ShaderModelInstance& outModelInstance) const
 {
     const AABB& aabb = get_model()->aabb(); 
@@ -57,18 +74,12 @@ void ModelComponent::fill_shader_instance_data(ShaderModelInstance& outModelInst
     outModelInstance.transformInverseTranspose.set_transfrom(transformMat.transpose().inverse());
 }
 
-void ModelComponent::serialize(Archive& archive) const
-{
-    Component::serialize(archive);
-
-    archive << m_modelUUID;
-}
-
 void ModelComponent::deserialize(Archive& archive)
 {
     Component::deserialize(archive);
 
-    archive >> m_modelUUID;
+    if (archive.get_version() < Archive::s_propertyLayoutVersion)
+        archive >> m_modelUUID;
 }
 
 }
\ No newline at end of file
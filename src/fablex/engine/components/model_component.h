@@ -23,7 +23,10 @@ public:
 
     void fill_shader_instance_data(ShaderModelInstance& outModelInstance) const;
 
-    virtual void serialize(Archive& archive) const override;
+    virtual bool get_world_bounds(AABB& outAABB) const override;
+    virtual bool are_world_bounds_pending() const override;
+
+    // Reads archives written before the property layout in the old field order
     virtual void deserialize(Archive& archive) override;
 
 protected:
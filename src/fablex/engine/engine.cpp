@@ -10,6 +10,7 @@
 #include "asset_manager/material/opaque_material_settings.h"
 #include "core/file_system/file_system.h"
 #include "core/task_composer.h"
+#include "core/profiler.h"
 
 namespace fe::engine
 {
@@ -24,8 +25,15 @@ Engine::Engine()
     subscribe_to_events();
 }
 
+Engine::~Engine()
+{
+    close_project();
+}
+
 void Engine::update()
 {
+    FE_PROFILE_SCOPE("Engine::update");
+
     m_world->update_pre_entities_update();
     m_world->update_camera_entities();
 }
@@ -263,6 +271,8 @@ void Engine::configure_sponza()
 
 void Engine::create_project(const std::string& projectName)
 {
+    close_project();
+
     FileSystem::create_project(projectName);
 
     create_default_material();
@@ -278,6 +288,8 @@ bool Engine::load_project(const std::string& projectPath)
     if (!FileSystem::is_project_existed(projectPath))
         return false;
 
+    close_project();
+
     FileSystem::set_project_path(projectPath);
     asset::AssetRegistry::init();
 
@@ -333,6 +345,12 @@ void Engine::subscribe_to_events()
     });
 }
 
+// Imports and loading of the previous project that are still running on other threads are not needed anymore
+void Engine::close_project()
+{
+    asset::AssetManager::cancel_pending_tasks();
+}
+
 void Engine::create_default_model()
 {
     asset::ModelImportContext importContext;
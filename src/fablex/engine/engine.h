@@ -11,6 +11,7 @@ class Engine
 {
 public:
     Engine();
+    ~Engine();
 
     void update();
 
@@ -31,6 +32,7 @@ private:
     Entity* m_cameraEntity = nullptr;
 
     void subscribe_to_events();
+    void close_project();
 
     void create_default_model();
     void create_default_material();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/object.h"
+#include "core/primitives/aabb.h"
 #include "shaders/shader_interop_renderer.h"
 
 namespace fe::engine
@@ -30,6 +31,11 @@ public:
 
     virtual void fill_shader_data(ShaderEntity& outShaderEntity) const { }
 
+    // Returns false if the component has no bounds, used by World to index entities
+    virtual bool get_world_bounds(AABB& outAABB) const { return false; }
+    // True while bounds can't be computed yet, for example if a model isn't loaded. World recomputes them next frame.
+    virtual bool are_world_bounds_pending() const { return false; }
+
     Entity* get_entity() const { return m_entity; }
     World* get_world() const { return m_world; }
 
@@ -2,6 +2,7 @@
 #include "world.h"
 #include "component.h"
 #include "core/file_system/archive.h"
+#include <cstring>
 
 namespace fe::engine
 {
@@ -64,21 +65,40 @@ Component* Entity::create_component(const TypeInfo* typeInfo)
     // TODO: Think how to allocate component from pool
     FE_CHECK(typeInfo);
 
+    const TypeInfo* componentTypeInfo = Component::get_static_type_info();
+    FE_CHECK(typeInfo->is_a(componentTypeInfo));
+
     Component* component = static_cast<Component*>(TypeManager::create_object(typeInfo));
     m_components.push_back(component);
+
+    if (m_componentsByTypeIndex.empty())
+        m_componentsByTypeIndex.resize(componentTypeInfo->get_descendant_count() + 1);
+
+    for (const TypeInfo* it = typeInfo; it != componentTypeInfo->get_base_type_info(); it = it->get_base_type_info())
+    {
+        Component*& slot = m_componentsByTypeIndex[it->get_type_index() - componentTypeInfo->get_type_index()];
+        if (!slot)
+            slot = component;
+    }
+
     if (m_world) component->on_world_set(m_world);
     component->on_entity_set(this);
 
+    m_areWorldBoundsDirty = true;
+
     return component;
 }
 
 Component* Entity::get_component(const TypeInfo* typeInfo) const
 {
-    for (Component* component : m_components)
-        if (component->is_a(typeInfo))
-            return component;
+    FE_CHECK(typeInfo);
+
+    // Unsigned subtraction wraps around for types that are not components
+    uint32 slotIndex = typeInfo->get_type_index() - Component::get_static_type_info()->get_type_index();
+    if (slotIndex >= m_componentsByTypeIndex.size())
+        return nullptr;
 
-    return nullptr;
+    return m_componentsByTypeIndex[slotIndex];
 }
 
 void Entity::update_world_transform()
@@ -91,6 +111,37 @@ void Entity::update_world_transform()
         worldTransformMat *= m_rootEntity->get_world_transform().to_matrix();
 
     m_worldTransform = worldTransformMat;
+
+    if (memcmp(&m_worldTransform, &m_prevWorldTransform, sizeof(Float4x4)) != 0)
+        m_areWorldBoundsDirty = true;
+}
+
+AABB Entity::get_world_bounds() const
+{
+    AABB bounds;
+    for (Component* component : m_components)
+    {
+        AABB componentBounds;
+        if (component->get_world_bounds(componentBounds))
+            bounds = AABB::merge(bounds, componentBounds);
+    }
+
+    if (!bounds.is_valid())
+    {
+        bounds.minPoint = Float3(m_worldTransform._41, m_worldTransform._42, m_worldTransform._43);
+        bounds.maxPoint = bounds.minPoint;
+    }
+
+    return bounds;
+}
+
+bool Entity::are_world_bounds_pending() const
+{
+    for (Component* component : m_components)
+        if (component->are_world_bounds_pending())
+            return true;
+
+    return false;
 }
 
 Float3 Entity::get_world_position() const
@@ -145,12 +196,10 @@ void Entity::set_rotation(const Float3& axis, float angle, AngleUnit angleUnit)
 
 void Entity::serialize(Archive& archive) const
 {
-    Object::serialize(archive); 
+    // Transform is written by Object::serialize() because it is stored in properties
+    Object::serialize(archive);
 
     archive << m_name;
-    archive << m_position;
-    archive << Float4(m_rotation);
-    archive << m_scale;
 
     archive << m_tags.size();
     for (uint64 tag : m_tags)
@@ -178,14 +227,17 @@ void Entity::deserialize(Archive& archive)
     FE_CHECK(m_world);
 
     archive >> m_name;
-    archive >> m_position;
 
-    // Must add quat to archive
-    Float4 rotation;
-    archive >> rotation;
-    m_rotation = Vector(rotation);
+    if (archive.get_version() < Archive::s_propertyLayoutVersion)
+    {
+        archive >> m_position;
+
+        Float4 rotation;
+        archive >> rotation;
+        m_rotation = Vector(rotation);
 
-    archive >> m_scale;
+        archive >> m_scale;
+    }
 
     uint32 tagCount;
     archive >> tagCount;
@@ -205,7 +257,7 @@ void Entity::deserialize(Archive& archive)
         std::string componentTypeName;
         archive >> componentTypeName;
 
-        const TypeInfo* typeInfo = TypeManager::get_type_info(componentTypeName);
+        const TypeInfo* typeInfo = TypeManager::get_type_info(componentTypeName.c_str());
         FE_CHECK(typeInfo);
 
         Component* component = create_component(typeInfo);
@@ -219,7 +271,7 @@ void Entity::deserialize(Archive& archive)
     {
         std::string entityTypeName;
         archive >> entityTypeName;
-        const TypeInfo* typeInfo = TypeManager::get_type_info(entityTypeName);
+        const TypeInfo* typeInfo = TypeManager::get_type_info(entityTypeName.c_str());
         FE_CHECK(typeInfo);
 
         Entity* entity = create_child(typeInfo);
@@ -2,6 +2,7 @@
 
 #include "core/object.h"
 #include "tags.h"
+#include "core/spatial/spatial_hash.h"
 #include <unordered_set>
 
 namespace fe::engine
@@ -48,6 +49,7 @@ public:
     }
 
     const std::vector<Component*>& get_components() const { return m_components; }
+    // Returns the first created component that is a type, doesn't iterate components
     Component* get_component(const TypeInfo* typeInfo) const;
 
     template<typename T>
@@ -72,6 +74,18 @@ public:
     const Float4x4& get_world_transform() const { return m_worldTransform; }
     const Float4x4& get_prev_world_transform() const { return m_prevWorldTransform; }
 
+    // Union of world bounds of components, a point at the world position if no component has bounds
+    AABB get_world_bounds() const;
+    bool are_world_bounds_pending() const;
+
+    // Set if the world transform or components changed, World updates the spatial index only for dirty entities
+    void set_world_bounds_dirty(bool isDirty) { m_areWorldBoundsDirty = isDirty; }
+    bool are_world_bounds_dirty() const { return m_areWorldBoundsDirty; }
+
+    // Proxy of the entity in the spatial index of World, set by World
+    void set_spatial_proxy(uint32 proxy) { m_spatialProxy = proxy; }
+    uint32 get_spatial_proxy() const { return m_spatialProxy; }
+
     void translate(const Float3& deltaPosition);
     void set_position(const Float3& position) { m_position = position; }
     void set_scale(const Float3& scale) { m_scale = scale; }
@@ -104,11 +118,15 @@ private:
     std::string m_name = "undefined";
 
     std::vector<Component*> m_components;
+    // Indexed by type index relative to Component, filled for a created component type and all its base types
+    std::vector<Component*> m_componentsByTypeIndex;
     std::vector<Entity*> m_children;
     std::unordered_set<uint64> m_tags;
 
     World* m_world = nullptr;
     Entity* m_rootEntity = nullptr;
+    uint32 m_spatialProxy = SpatialHash::s_invalidProxy;
+    bool m_areWorldBoundsDirty = true;
     
     Float4x4 m_worldTransform;
     Float4x4 m_prevWorldTransform;
@@ -14,7 +14,12 @@ void EntityManager::update()
             EventManager::trigger_event(EntityRemovedEvent(entity));
             
             m_entities.erase(it);
-            m_allocator.free(entity);
+
+            // Entities of derived types are created by TypeManager, not by the pool
+            if (entity->is_exactly<Entity>())
+                m_allocator.free(entity);
+            else
+                memory_delete(entity);
         }
     }
 
@@ -27,7 +27,7 @@ public:
     const std::vector<Entity*>& get_entities() const { return m_entities; }
 
 private:
-    ThreadSafePoolAllocator<Entity, ENTITY_POOL_SIZE> m_allocator;
+    ThreadSafePoolAllocator<Entity, ENTITY_POOL_SIZE, MemoryTag::ECS> m_allocator;
     
     std::vector<Entity*> m_entities;
     std::vector<Entity*> m_entitiesToCreate;
@@ -120,7 +120,7 @@ private:
     std::vector<uint32> m_sparse;
     std::vector<uint32> m_dense;
     std::vector<Component*> m_components;
-    PoolAllocator<Component, PoolSize> m_allocator;
+    PoolAllocator<Component, PoolSize, MemoryTag::ECS> m_allocator;
 };
 
 }
\ No newline at end of file
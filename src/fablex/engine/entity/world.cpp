@@ -2,8 +2,11 @@
 #include "engine/components/camera_component.h"
 
 #include "core/timer.h"
+#include "core/parallel.h"
 #include "core/file_system/archive.h"
 
+#include <algorithm>
+
 namespace fe::engine
 {
 
@@ -12,6 +15,7 @@ FE_DEFINE_OBJECT(World, Object);
 Entity* World::create_entity()
 {
     engine::Entity* entity = m_entityManager.create_entity();
+    entity->set_spatial_proxy(m_spatialIndex.insert(entity->get_world_bounds(), uint64(entity)));
     entity->on_world_set(this);
     entity->init();
     return entity;
@@ -20,6 +24,7 @@ Entity* World::create_entity()
 Entity* World::create_entity(const TypeInfo* typeInfo)
 {
     engine::Entity* entity = m_entityManager.create_entity(typeInfo);
+    entity->set_spatial_proxy(m_spatialIndex.insert(entity->get_world_bounds(), uint64(entity)));
     entity->on_world_set(this);
     entity->init();
     return entity;
@@ -27,18 +32,40 @@ Entity* World::create_entity(const TypeInfo* typeInfo)
 
 void World::remove_entity(Entity* entity)
 {
+    // The entity stays in the entity list until the next update, but queries must not return it anymore
+    if (entity->get_spatial_proxy() != SpatialHash::s_invalidProxy)
+    {
+        m_spatialIndex.remove(entity->get_spatial_proxy());
+        entity->set_spatial_proxy(SpatialHash::s_invalidProxy);
+    }
+
     m_entityManager.remove_entity(entity);
 }
 
+void update_world_transform_recursive(Entity* entity)
+{
+    entity->update_world_transform();
+
+    for (Entity* child : entity->get_children())
+        update_world_transform_recursive(child);
+}
+
 void World::update_pre_entities_update()
 {
     m_entityManager.update();
 
+    // Each hierarchy is updated by one task, so a child is never updated before or concurrently with its parent
     const std::vector<Entity*>& entities = m_entityManager.get_entities();
-    for (Entity* entity : entities)
+    parallel_for(0, entities.size(), [&](uint64 begin, uint64 end)
     {
-        entity->update_world_transform();
-    }
+        for (uint64 i = begin; i != end; ++i)
+        {
+            if (!entities[i]->get_root())
+                update_world_transform_recursive(entities[i]);
+        }
+    }, 256);
+
+    update_spatial_index();
 }
 
 void World::update_camera_entities()
@@ -49,11 +76,70 @@ void World::update_camera_entities()
             cameraComponent->update(Timer::get_delta_time());
 }
 
+void World::query_entities(const AABB& aabb, std::vector<Entity*>& outEntities) const
+{
+    std::vector<uint32> proxies;
+    m_spatialIndex.query_overlaps(aabb, proxies);
+    append_entities(proxies, outEntities);
+}
+
+void World::query_entities(const Float3& center, float radius, std::vector<Entity*>& outEntities) const
+{
+    std::vector<uint32> proxies;
+    m_spatialIndex.query_sphere(center, radius, proxies);
+    append_entities(proxies, outEntities);
+}
+
+void World::query_entities(const Frustum& frustum, std::vector<Entity*>& outEntities) const
+{
+    std::vector<uint32> proxies;
+    m_spatialIndex.query_frustum(frustum, proxies);
+    append_entities(proxies, outEntities);
+}
+
+void World::update_spatial_index()
+{
+    const std::vector<Entity*>& entities = m_entityManager.get_entities();
+    m_entityProxies.resize(entities.size());
+    m_entityBounds.resize(entities.size());
+
+    // Bounds are computed only for entities that moved or changed, others keep their proxies as they are
+    parallel_for(0, entities.size(), [&](uint64 begin, uint64 end)
+    {
+        for (uint64 i = begin; i != end; ++i)
+        {
+            Entity* entity = entities[i];
+            if (!entity->are_world_bounds_dirty())
+            {
+                m_entityProxies[i] = SpatialHash::s_invalidProxy;
+                continue;
+            }
+
+            m_entityProxies[i] = entity->get_spatial_proxy();
+            m_entityBounds[i] = entity->get_world_bounds();
+            entity->set_world_bounds_dirty(entity->are_world_bounds_pending());
+        }
+    }, 256);
+
+    // Clean entities and removed entities that are still in the list have invalid proxies and are skipped
+    m_spatialIndex.update(m_entityProxies.data(), m_entityBounds.data(), uint32(entities.size()));
+}
+
+void World::append_entities(const std::vector<uint32>& proxies, std::vector<Entity*>& outEntities) const
+{
+    for (uint32 proxy : proxies)
+        outEntities.push_back(reinterpret_cast<Entity*>(m_spatialIndex.get_user_data(proxy)));
+}
+
 void World::serialize(Archive& archive) const
 {
     Object::serialize(archive);
 
-    archive << m_entityManager.get_entities().size();
+    // Children are written by their roots
+    uint64 rootEntityCount = std::count_if(m_entityManager.get_entities().begin(), m_entityManager.get_entities().end(),
+        [](const Entity* entity) { return !entity->get_root(); });
+
+    archive << rootEntityCount;
     for (Entity* entity : m_entityManager.get_entities())
     {
         if (entity->get_root())
@@ -71,12 +157,22 @@ void World::deserialize(Archive& archive)
     uint32 entityCount = 0;
     archive >> entityCount;
 
+    // Older archives count children as well, but children are written by their roots.
+    // Their entities end with the data or with the zero padding saved after it.
+    const bool isLegacyArchive = archive.get_version() < Archive::s_propertyLayoutVersion;
+
     for (uint32 i = 0; i != entityCount; ++i)
     {
+        if (isLegacyArchive && !archive.has_unread_data())
+            break;
+
         std::string entityTypeName;
         archive >> entityTypeName;
 
-        const TypeInfo* typeInfo = TypeManager::get_type_info(entityTypeName);
+        if (isLegacyArchive && entityTypeName.empty())
+            break;
+
+        const TypeInfo* typeInfo = TypeManager::get_type_info(entityTypeName.c_str());
         FE_CHECK(typeInfo);
 
         Entity* entity = create_entity(typeInfo);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "entity_manager.h"
+#include "core/spatial/spatial_hash.h"
 
 namespace fe::engine
 {
@@ -31,11 +32,28 @@ public:
 
     const std::vector<Entity*>& get_entities() const { return m_entityManager.get_entities(); }
 
+    // Entities are indexed by Entity::get_world_bounds, bounds of dirty entities are updated in update_pre_entities_update.
+    // Proxy user data is the entity pointer.
+    const SpatialHash& get_spatial_index() const { return m_spatialIndex; }
+
+    // Append entities whose world bounds overlap the box, intersect the sphere or pass Frustum::intersects
+    void query_entities(const AABB& aabb, std::vector<Entity*>& outEntities) const;
+    void query_entities(const Float3& center, float radius, std::vector<Entity*>& outEntities) const;
+    void query_entities(const Frustum& frustum, std::vector<Entity*>& outEntities) const;
+
     virtual void serialize(Archive& archive) const override;
     virtual void deserialize(Archive& archive) override;
 
 private:
     EntityManager m_entityManager;
+    SpatialHash m_spatialIndex;
+
+    // Used only while updating the spatial index
+    std::vector<uint32> m_entityProxies;
+    std::vector<AABB> m_entityBounds;
+
+    void update_spatial_index();
+    void append_entities(const std::vector<uint32>& proxies, std::vector<Entity*>& outEntities) const;
 };
 
 }
\ No newline at end of file
@@ -1,10 +1,73 @@
 #include "entity/sparse_set.h"
+#include "core/task_composer.h"
+#include "core/parallel.h"
+#include "core/concurrent_pool_allocator.h"
+#include "core/frame_allocator.h"
+#include "core/name.h"
+#include "core/events/event_manager.h"
+#include "core/profiler.h"
+#include "core/memory_tracker.h"
+#include "core/object.h"
+#include "core/object/property_layout.h"
+#include "core/file_system/archive.h"
+#include "core/uuid.h"
+#include "core/bulk_math.h"
+#include "core/primitives/aabb.h"
+#include "core/primitives/frustum.h"
+#include "core/primitives/ray.h"
+#include "core/spatial/bvh.h"
+#include "core/spatial/triangle_bvh.h"
+#include "core/spatial/spatial_hash.h"
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <numeric>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
 using namespace fe::engine;
 
+static std::atomic<uint64> g_allocationCount = 0;
+static std::atomic_bool g_countAllocations = false;
+
+void* operator new(size_t size)
+{
+    if (g_countAllocations.load(std::memory_order_relaxed))
+        g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    if (g_countAllocations.load(std::memory_order_relaxed))
+        g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
 struct TestComponent
 {
     uint32 value = 0;
@@ -48,3 +111,1843 @@ TEST_CASE("Tesing sparse set")
         CHECK(component->value < entries.size());
     });
 }
+
+
+TEST_CASE("Work-stealing queue gives each item to exactly one thread")
+{
+    constexpr uint32 itemCount = 200000;
+    constexpr uint32 thiefCount = 3;
+
+    // Small capacity, so the owner grows the buffer while thieves read from it
+    fe::WorkStealingQueue<uint32> queue(16);
+    std::vector<std::atomic<uint32>> takeCounts(itemCount);
+    std::atomic_bool isOwnerDone = false;
+    std::atomic<uint32> stolenItemCount = 0;
+
+    std::vector<std::thread> thieves;
+    for (uint32 i = 0; i != thiefCount; ++i)
+    {
+        thieves.emplace_back([&]()
+        {
+            uint32 item;
+            while (!isOwnerDone.load() || !queue.empty())
+            {
+                if (queue.steal(item))
+                {
+                    takeCounts[item].fetch_add(1);
+                    stolenItemCount.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    // Owner pushes in bursts and pops some of them back, racing with thieves for the last items
+    uint32 poppedItemCount = 0;
+    for (uint32 item = 0; item != itemCount;)
+    {
+        uint32 burstEnd = std::min(item + 1 + item % 37, itemCount);
+        for (; item != burstEnd; ++item)
+            queue.push(item);
+
+        uint32 poppedItem;
+        for (uint32 i = 0; i != item % 5 && queue.pop(poppedItem); ++i)
+        {
+            takeCounts[poppedItem].fetch_add(1);
+            ++poppedItemCount;
+        }
+    }
+
+    uint32 poppedItem;
+    while (queue.pop(poppedItem))
+    {
+        takeCounts[poppedItem].fetch_add(1);
+        ++poppedItemCount;
+    }
+
+    isOwnerDone.store(true);
+    for (std::thread& thief : thieves)
+        thief.join();
+
+    CHECK(poppedItemCount + stolenItemCount.load() == itemCount);
+    CHECK(std::all_of(takeCounts.begin(), takeCounts.end(), [](const std::atomic<uint32>& takeCount) { return takeCount.load() == 1; }));
+    CHECK(queue.empty());
+}
+
+TEST_CASE("Tasks submitted from workers and other threads run exactly once")
+{
+    fe::TaskComposer::init(4);
+
+    constexpr uint32 outerTaskCount = 64;
+    constexpr uint32 innerTaskCount = 256;
+
+    std::vector<std::atomic<uint32>> runCounts(outerTaskCount * innerTaskCount);
+    fe::TaskGroup taskGroup;
+
+    // Outer tasks are injected, inner tasks are pushed to worker queues and stolen by idle workers
+    fe::TaskComposer::dispatch(taskGroup, outerTaskCount, 1, [&](fe::TaskExecutionInfo outerInfo)
+    {
+        uint32 firstRunIndex = outerInfo.globalTaskIndex * innerTaskCount;
+        fe::TaskComposer::dispatch(taskGroup, innerTaskCount, 4, [&runCounts, firstRunIndex](fe::TaskExecutionInfo innerInfo)
+        {
+            runCounts[firstRunIndex + innerInfo.globalTaskIndex].fetch_add(1);
+        });
+    });
+
+    fe::TaskComposer::wait(taskGroup);
+
+    CHECK(std::all_of(runCounts.begin(), runCounts.end(), [](const std::atomic<uint32>& runCount) { return runCount.load() == 1; }));
+
+    fe::TaskComposer::cleanup();
+}
+
+TEST_CASE("Task graph releases nodes after their predecessors")
+{
+    fe::TaskComposer::init(4);
+
+    constexpr uint32 dispatchTaskCount = 100;
+
+    // root -> dispatch -> join, root -> empty dispatch -> join
+    std::atomic<uint32> rootRunCount = 0;
+    std::atomic<uint32> dispatchRunCount = 0;
+    std::atomic<uint32> joinRunCount = 0;
+    std::atomic<uint32> orderErrorCount = 0;
+
+    fe::TaskGraph taskGraph;
+    fe::TaskGraph::NodeHandle joinNode = taskGraph.add_task([&](fe::TaskExecutionInfo)
+    {
+        if (dispatchRunCount.load() % dispatchTaskCount != 0 || dispatchRunCount.load() / dispatchTaskCount != joinRunCount.load() + 1)
+            orderErrorCount.fetch_add(1);
+
+        joinRunCount.fetch_add(1);
+    });
+
+    fe::TaskGraph::NodeHandle dispatchNode = taskGraph.add_dispatch(dispatchTaskCount, 8, [&](fe::TaskExecutionInfo)
+    {
+        if (rootRunCount.load() != joinRunCount.load() + 1)
+            orderErrorCount.fetch_add(1);
+
+        dispatchRunCount.fetch_add(1);
+    });
+
+    fe::TaskGraph::NodeHandle emptyNode = taskGraph.add_dispatch(0, 8, [&](fe::TaskExecutionInfo)
+    {
+        orderErrorCount.fetch_add(1);
+    });
+
+    fe::TaskGraph::NodeHandle rootNode = taskGraph.add_task([&](fe::TaskExecutionInfo)
+    {
+        rootRunCount.fetch_add(1);
+    });
+
+    taskGraph.add_dependency(rootNode, dispatchNode);
+    taskGraph.add_dependency(rootNode, emptyNode);
+    taskGraph.add_dependencies({ dispatchNode, emptyNode }, joinNode);
+
+    // Graphs can be executed again once the previous execution is completed
+    fe::TaskGroup taskGroup;
+    for (uint32 i = 0; i != 3; ++i)
+    {
+        fe::TaskComposer::execute(taskGroup, taskGraph);
+        fe::TaskComposer::wait(taskGroup);
+    }
+
+    CHECK(rootRunCount.load() == 3);
+    CHECK(dispatchRunCount.load() == 3 * dispatchTaskCount);
+    CHECK(joinRunCount.load() == 3);
+    CHECK(orderErrorCount.load() == 0);
+
+    // A graph of zero-task nodes completes without running anything
+    fe::TaskGraph emptyGraph;
+    fe::TaskGraph::NodeHandle firstEmptyNode = emptyGraph.add_dispatch(0, 1, [](fe::TaskExecutionInfo) { });
+    emptyGraph.add_dependency(firstEmptyNode, emptyGraph.add_dispatch(0, 1, [](fe::TaskExecutionInfo) { }));
+    fe::TaskComposer::execute(taskGroup, emptyGraph);
+    fe::TaskComposer::wait(taskGroup);
+    CHECK(!fe::TaskComposer::is_busy(taskGroup));
+
+    fe::TaskComposer::cleanup();
+}
+
+TEST_CASE("Task graph rebuilt after clear doesn't allocate")
+{
+    fe::TaskComposer::init(2);
+
+    std::atomic<uint32> runCount = 0;
+    fe::TaskGraph taskGraph;
+    fe::TaskGroup taskGroup;
+
+    auto buildGraph = [&]()
+    {
+        taskGraph.clear();
+
+        fe::TaskGraph::NodeHandle rootNode = taskGraph.add_task([&](fe::TaskExecutionInfo) { runCount.fetch_add(1); });
+        fe::TaskGraph::NodeHandle dispatchNode = taskGraph.add_dispatch(32, 4, [&](fe::TaskExecutionInfo) { runCount.fetch_add(1); });
+        fe::TaskGraph::NodeHandle joinNode = taskGraph.add_task([&](fe::TaskExecutionInfo) { runCount.fetch_add(1); });
+
+        taskGraph.add_dependency(rootNode, dispatchNode);
+        taskGraph.add_dependency(dispatchNode, joinNode);
+        taskGraph.add_dependency(rootNode, joinNode);
+    };
+
+    // The first build allocates nodes and successor arrays, later builds reuse them
+    buildGraph();
+    fe::TaskComposer::execute(taskGroup, taskGraph);
+    fe::TaskComposer::wait(taskGroup);
+
+    g_allocationCount.store(0);
+    g_countAllocations.store(true);
+
+    buildGraph();
+
+    g_countAllocations.store(false);
+
+    CHECK(g_allocationCount.load() == 0);
+    CHECK(taskGraph.get_node_count() == 3);
+
+    fe::TaskComposer::execute(taskGroup, taskGraph);
+    fe::TaskComposer::wait(taskGroup);
+    CHECK(runCount.load() == 2 * 34);
+
+    fe::TaskComposer::cleanup();
+}
+
+TEST_CASE("Cancelling a task group stops a graph before its successors")
+{
+    fe::TaskComposer::init(4);
+
+    std::atomic_bool shouldCancel = true;
+    std::atomic<uint32> secondStageRunCount = 0;
+    std::atomic<uint32> thirdStageRunCount = 0;
+
+    fe::TaskGroup taskGroup;
+    fe::TaskGraph taskGraph;
+    fe::TaskGraph::NodeHandle firstStage = taskGraph.add_task([&](fe::TaskExecutionInfo)
+    {
+        if (shouldCancel.load())
+            taskGroup.cancel();
+    });
+    fe::TaskGraph::NodeHandle secondStage = taskGraph.add_dispatch(64, 1, [&](fe::TaskExecutionInfo)
+    {
+        secondStageRunCount.fetch_add(1);
+    });
+    fe::TaskGraph::NodeHandle thirdStage = taskGraph.add_task([&](fe::TaskExecutionInfo)
+    {
+        thirdStageRunCount.fetch_add(1);
+    });
+    taskGraph.add_dependency(firstStage, secondStage);
+    taskGraph.add_dependency(secondStage, thirdStage);
+
+    fe::TaskComposer::execute(taskGroup, taskGraph);
+    fe::TaskComposer::wait(taskGroup);
+
+    CHECK(secondStageRunCount.load() == 0);
+    CHECK(thirdStageRunCount.load() == 0);
+    CHECK(!fe::TaskComposer::is_busy(taskGroup));
+
+    // Predecessor counters left by the cancelled execution are reset, so the whole graph runs again
+    shouldCancel.store(false);
+    taskGroup.reset_cancellation();
+    fe::TaskComposer::execute(taskGroup, taskGraph);
+    fe::TaskComposer::wait(taskGroup);
+
+    CHECK(secondStageRunCount.load() == 64);
+    CHECK(thirdStageRunCount.load() == 1);
+
+    fe::TaskComposer::cleanup();
+}
+
+TEST_CASE("Parked waiters return when other workers complete their tasks")
+{
+    fe::TaskComposer::init(4);
+
+    // Workers take the blocking tasks first, so waiters find nothing to help with and park
+    constexpr uint32 groupCount = 3;
+    std::array<fe::TaskGroup, groupCount> taskGroups;
+    std::atomic<uint32> startedTaskCount = 0;
+    std::atomic<uint32> completedTaskCount = 0;
+    std::atomic_bool isReleased = false;
+
+    for (fe::TaskGroup& taskGroup : taskGroups)
+    {
+        fe::TaskComposer::execute(taskGroup, [&](fe::TaskExecutionInfo)
+        {
+            startedTaskCount.fetch_add(1);
+            while (!isReleased.load())
+                std::this_thread::yield();
+
+            completedTaskCount.fetch_add(1);
+        });
+    }
+
+    uint32 highPriorityThreadCount = fe::TaskComposer::get_thread_count(fe::TaskGroup::Priority::HIGH);
+    while (startedTaskCount.load() != std::min(groupCount, highPriorityThreadCount))
+        std::this_thread::yield();
+
+    // One waiter per group, the last group is waited on by this thread
+    std::atomic<uint32> returnedWaiterCount = 0;
+    std::vector<std::thread> waiters;
+    for (uint32 i = 0; i + 1 != groupCount; ++i)
+    {
+        waiters.emplace_back([&, i]()
+        {
+            fe::TaskComposer::wait(taskGroups[i]);
+            returnedWaiterCount.fetch_add(1);
+        });
+    }
+
+    std::thread releaser([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        isReleased.store(true);
+    });
+
+    fe::TaskComposer::wait(taskGroups[groupCount - 1]);
+    CHECK(!fe::TaskComposer::is_busy(taskGroups[groupCount - 1]));
+
+    releaser.join();
+    for (std::thread& waiter : waiters)
+        waiter.join();
+
+    CHECK(returnedWaiterCount.load() == groupCount - 1);
+    CHECK(completedTaskCount.load() == groupCount);
+
+    fe::TaskComposer::cleanup();
+}
+
+TEST_CASE("Task submission does not allocate")
+{
+    fe::TaskComposer::init(2);
+
+    fe::TaskGroup taskGroup;
+    std::atomic<uint64> sum = 0;
+    std::array<uint64, 12> largeCapture;
+    largeCapture.fill(1);
+
+    auto submitTasks = [&]()
+    {
+        for (uint32 i = 0; i != 32; ++i)
+        {
+            fe::TaskComposer::execute(taskGroup, [&sum, largeCapture](fe::TaskExecutionInfo)
+            {
+                sum.fetch_add(largeCapture[0]);
+            });
+        }
+
+        for (uint32 i = 0; i != 4; ++i)
+        {
+            fe::TaskComposer::dispatch(taskGroup, 256, 16, [&sum, largeCapture](fe::TaskExecutionInfo)
+            {
+                sum.fetch_add(largeCapture[1]);
+            });
+        }
+
+        fe::TaskComposer::wait(taskGroup);
+    };
+
+    // Warms up task pools
+    submitTasks();
+    REQUIRE(sum.load() == 32 + 4 * 256);
+
+    g_allocationCount.store(0);
+    g_countAllocations.store(true);
+    
+    submitTasks();
+
+    g_countAllocations.store(false);
+    
+    CHECK(sum.load() == 2 * (32 + 4 * 256));
+    CHECK(g_allocationCount.load() == 0);
+
+    fe::TaskComposer::cleanup();
+}
+
+TEST_CASE("Parallel algorithms match serial results")
+{
+    fe::TaskComposer::init(4);
+
+    constexpr uint64 count = 100000;
+
+    std::vector<uint32> visitCounts(count, 0);
+    fe::parallel_for(0, count, [&](uint64 begin, uint64 end)
+    {
+        for (uint64 i = begin; i != end; ++i)
+            ++visitCounts[i];
+    }, 64);
+    CHECK(std::all_of(visitCounts.begin(), visitCounts.end(), [](uint32 visitCount) { return visitCount == 1; }));
+
+    std::vector<uint64> values(count);
+    for (uint64 i = 0; i != count; ++i)
+        values[i] = (i * 2654435761ull) % 1000;
+
+    uint64 sum = fe::parallel_reduce(0, count, uint64(0), [&](uint64 begin, uint64 end, uint64 result)
+    {
+        for (uint64 i = begin; i != end; ++i)
+            result += values[i];
+        return result;
+    },
+    std::plus<uint64>(), 1000);
+    CHECK(sum == std::accumulate(values.begin(), values.end(), uint64(0)));
+
+    std::vector<uint64> scanResult(count);
+    std::vector<uint64> expectedScanResult(count);
+    fe::parallel_inclusive_scan(values.data(), scanResult.data(), count, std::plus<uint64>(), uint64(0), 1000);
+    std::inclusive_scan(values.begin(), values.end(), expectedScanResult.begin());
+    CHECK(scanResult == expectedScanResult);
+
+    std::vector<uint64> sortResult = values;
+    fe::parallel_sort(sortResult.begin(), sortResult.end(), std::less<uint64>(), 1000);
+    std::sort(values.begin(), values.end());
+    CHECK(sortResult == values);
+
+    fe::TaskComposer::cleanup();
+}
+
+TEST_CASE("Cancelled task group drops queued tasks")
+{
+    fe::TaskComposer::init(4);
+
+    fe::TaskGroup taskGroup;
+    std::atomic_bool isReleased = false;
+    std::atomic<uint32> executedTaskCount = 0;
+
+    // Workers block on the first tasks they take, so the rest stays queued until the group is cancelled
+    fe::TaskComposer::dispatch(taskGroup, 1000, 1, [&](fe::TaskExecutionInfo)
+    {
+        while (!isReleased.load())
+            std::this_thread::yield();
+
+        executedTaskCount.fetch_add(1);
+    });
+
+    taskGroup.cancel();
+    isReleased.store(true);
+    fe::TaskComposer::wait(taskGroup);
+
+    CHECK(executedTaskCount.load() <= fe::TaskComposer::get_thread_count(fe::TaskGroup::Priority::HIGH));
+    CHECK(!fe::TaskComposer::is_busy(taskGroup));
+
+    fe::TaskComposer::execute(taskGroup, [&](fe::TaskExecutionInfo) { executedTaskCount.fetch_add(1000); });
+    CHECK(!fe::TaskComposer::is_busy(taskGroup));
+
+    taskGroup.reset_cancellation();
+    uint32 executedTaskCountBeforeReset = executedTaskCount.load();
+    fe::TaskComposer::execute(taskGroup, [&](fe::TaskExecutionInfo) { executedTaskCount.fetch_add(1); });
+    fe::TaskComposer::wait(taskGroup);
+    CHECK(executedTaskCount.load() == executedTaskCountBeforeReset + 1);
+
+    fe::TaskComposer::cleanup();
+}
+
+TEST_CASE("Task tracer exports labelled tasks")
+{
+    fe::TaskComposer::init(4);
+
+    fe::TaskTracer::start_capture();
+
+    fe::TaskGroup taskGroup;
+    fe::TaskComposer::dispatch(taskGroup, 64, 4, [](fe::TaskExecutionInfo) { }, "TracedDispatch");
+    fe::TaskComposer::wait(taskGroup);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "fe_task_trace_test.json").string();
+    CHECK(fe::TaskTracer::export_chrome_trace(path));
+    CHECK(!fe::TaskTracer::is_capturing());
+
+    std::ifstream file(path);
+    std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CHECK(trace.find("\"name\":\"TracedDispatch\"") != std::string::npos);
+
+    file.close();
+    std::filesystem::remove(path);
+
+    fe::TaskComposer::cleanup();
+}
+
+TEST_CASE("Task tracer reuses buffers of exited threads")
+{
+    auto traceTasks = []()
+    {
+        fe::TaskComposer::init(4);
+        fe::TaskTracer::start_capture();
+
+        fe::TaskGroup taskGroup;
+        fe::TaskComposer::dispatch(taskGroup, 64, 1, [](fe::TaskExecutionInfo) { }, "TracedDispatch");
+        fe::TaskComposer::wait(taskGroup);
+
+        fe::TaskTracer::stop_capture();
+        fe::TaskComposer::cleanup();
+    };
+
+    traceTasks();
+    uint32 threadBufferCount = fe::TaskTracer::get_thread_buffer_count();
+
+    // Workers are recreated, their buffers are taken from the previous workers
+    traceTasks();
+    traceTasks();
+    CHECK(fe::TaskTracer::get_thread_buffer_count() == threadBufferCount);
+}
+
+TEST_CASE("Concurrent pool allocator keeps objects unique across threads")
+{
+    struct PoolObject
+    {
+        std::atomic<uint32> owner;
+        PoolObject(uint32 inOwner) : owner(inOwner) { }
+    };
+
+    constexpr uint32 threadCount = 4;
+    constexpr uint32 iterationCount = 2000;
+    constexpr uint32 objectsPerIteration = 48;
+
+    fe::ConcurrentPoolAllocator<PoolObject, 64> pool;
+    std::atomic<uint32> corruptedObjectCount = 0;
+    std::vector<std::thread> threads;
+
+    for (uint32 threadIndex = 0; threadIndex != threadCount; ++threadIndex)
+    {
+        threads.emplace_back([&, threadIndex]
+        {
+            std::vector<PoolObject*> objects;
+
+            for (uint32 iteration = 0; iteration != iterationCount; ++iteration)
+            {
+                for (uint32 i = 0; i != objectsPerIteration; ++i)
+                    objects.push_back(pool.allocate(threadIndex));
+
+                std::this_thread::yield();
+
+                for (PoolObject* object : objects)
+                {
+                    if (object->owner.load() != threadIndex)
+                        corruptedObjectCount.fetch_add(1);
+                }
+
+                // Alternates single and bulk frees
+                if (iteration % 2)
+                {
+                    for (PoolObject* object : objects)
+                        pool.free(object);
+                }
+                else
+                {
+                    pool.free(objects);
+                }
+
+                objects.clear();
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    CHECK(corruptedObjectCount.load() == 0);
+    CHECK(pool.get_live_count() == 0);
+    CHECK(pool.get_peak_count() <= threadCount * objectsPerIteration);
+
+    std::vector<PoolObject*> objects;
+    for (uint32 i = 0; i != 100; ++i)
+        objects.push_back(pool.allocate(0u));
+
+    CHECK(pool.get_live_count() == 100);
+    CHECK(pool.get_peak_count() >= 100);
+
+    pool.free(objects);
+    CHECK(pool.get_live_count() == 0);
+}
+
+TEST_CASE("Frame allocator stops allocating blocks in the steady state")
+{
+    auto simulateFrame = []()
+    {
+        fe::FrameVector<uint64> values;
+        for (uint64 i = 0; i != 50000; ++i)
+            values.push_back(i);
+
+        fe::FrameUnorderedMap<uint64, uint64> valueByKey;
+        for (uint64 i = 0; i != 1000; ++i)
+            valueByKey[i] = values[i];
+
+        return uint64(values.data()) % alignof(uint64) == 0 && valueByKey.at(999) == 999;
+    };
+
+    CHECK(simulateFrame());
+    fe::FrameAllocator::reset();
+
+    // Blocks are merged on reset, so the second frame fits into one block
+    uint64 blockCount = fe::FrameAllocator::get_block_count();
+    CHECK(simulateFrame());
+    fe::FrameAllocator::reset();
+    CHECK(fe::FrameAllocator::get_block_count() == blockCount);
+
+    g_allocationCount.store(0);
+    g_countAllocations.store(true);
+
+    bool isFrameValid = simulateFrame();
+
+    g_countAllocations.store(false);
+    fe::FrameAllocator::reset();
+
+    CHECK(isFrameValid);
+    CHECK(g_allocationCount.load() == 0);
+}
+
+TEST_CASE("Names interned from many threads get one id per string")
+{
+    constexpr uint32 threadCount = 4;
+    constexpr uint32 nameCount = 5000;
+
+    const std::string& firstName = fe::Name("StressName_0").to_string();
+
+    std::vector<std::vector<fe::Name::ID>> idsPerThread(threadCount);
+    std::vector<std::thread> threads;
+
+    for (uint32 threadIndex = 0; threadIndex != threadCount; ++threadIndex)
+    {
+        threads.emplace_back([&, threadIndex]
+        {
+            std::vector<fe::Name::ID>& ids = idsPerThread[threadIndex];
+            ids.resize(nameCount);
+
+            // Threads walk names in different orders, so the same name is often inserted concurrently
+            for (uint32 i = 0; i != nameCount; ++i)
+            {
+                uint32 nameIndex = threadIndex % 2 ? nameCount - 1 - i : i;
+                ids[nameIndex] = fe::Name("StressName_" + std::to_string(nameIndex)).to_id();
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    bool areIDsEqual = true;
+    bool areStringsValid = true;
+
+    for (uint32 i = 0; i != nameCount; ++i)
+    {
+        for (uint32 threadIndex = 1; threadIndex != threadCount; ++threadIndex)
+            areIDsEqual &= idsPerThread[threadIndex][i] == idsPerThread[0][i];
+
+        areStringsValid &= fe::Name(idsPerThread[0][i]).to_string_view() == "StressName_" + std::to_string(i);
+    }
+
+    CHECK(areIDsEqual);
+    CHECK(areStringsValid);
+
+    // References stay valid while the registry grows
+    CHECK(firstName == "StressName_0");
+}
+
+TEST_CASE("Name literals are hashed at compile time")
+{
+    using fe::operator""_name;
+
+    constexpr fe::Name literalName = "LiteralName"_name;
+    static_assert(literalName == fe::Name(fe::fnv1a_64("LiteralName")));
+
+    CHECK(literalName == fe::Name("LiteralName"));
+    CHECK(literalName.to_string() == "LiteralName");
+
+    fe::Name suffixedName = literalName.with_suffix("1");
+    CHECK(suffixedName == fe::Name("LiteralName1"));
+    CHECK(suffixedName.to_string() == "LiteralName1");
+    CHECK(suffixedName.with_suffix("2") == fe::Name("LiteralName12"));
+    CHECK(literalName.with_suffix(uint64(0)) == fe::Name("LiteralName0"));
+    CHECK(literalName.with_suffix(~0ull).to_string() == "LiteralName18446744073709551615");
+}
+
+namespace fe::test
+{
+
+// FE_DECLARE_EVENT expects to be used inside the fe namespace
+class TestSequenceEvent : public IEvent
+{
+public:
+    FE_DECLARE_EVENT(TestSequenceEvent);
+
+    TestSequenceEvent(uint32 producerIndex, uint32 sequenceIndex)
+        : m_producerIndex(producerIndex), m_sequenceIndex(sequenceIndex) { }
+
+    uint32 get_producer_index() const { return m_producerIndex; }
+    uint32 get_sequence_index() const { return m_sequenceIndex; }
+
+private:
+    uint32 m_producerIndex = 0;
+    uint32 m_sequenceIndex = 0;
+};
+
+class TestBatchEvent : public IEvent
+{
+public:
+    FE_DECLARE_EVENT(TestBatchEvent);
+
+    TestBatchEvent(uint32 value) : m_value(value) { }
+
+    uint32 get_value() const { return m_value; }
+
+private:
+    uint32 m_value = 0;
+};
+
+}
+
+TEST_CASE("Event queue keeps producer order without allocating per event")
+{
+    constexpr uint32 threadCount = 4;
+    constexpr uint32 eventCount = 20000;
+
+    fe::EventQueue queue;
+    std::vector<uint32> nextSequenceIndices(threadCount, 0);
+    bool isOrderValid = true;
+
+    auto drainEvents = [&]()
+    {
+        return queue.drain([&](const fe::IEvent& event)
+        {
+            const fe::test::TestSequenceEvent& sequenceEvent = static_cast<const fe::test::TestSequenceEvent&>(event);
+            uint32& nextSequenceIndex = nextSequenceIndices[sequenceEvent.get_producer_index()];
+            isOrderValid &= sequenceEvent.get_sequence_index() == nextSequenceIndex++;
+        });
+    };
+
+    std::vector<std::thread> threads;
+    uint64 drainedEventCount = 0;
+
+    for (uint32 threadIndex = 0; threadIndex != threadCount; ++threadIndex)
+    {
+        threads.emplace_back([&queue, threadIndex]
+        {
+            for (uint32 i = 0; i != eventCount; ++i)
+                queue.enqueue(fe::test::TestSequenceEvent(threadIndex, i));
+        });
+    }
+
+    // Draining concurrently with producers must not break the order
+    for (uint32 i = 0; i != 100; ++i)
+        drainedEventCount += drainEvents();
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    drainedEventCount += drainEvents();
+
+    CHECK(isOrderValid);
+    CHECK(drainedEventCount == threadCount * eventCount);
+
+    // Drained blocks are reused, so a frame that fits into them doesn't touch the heap
+    for (uint32 i = 0; i != eventCount; ++i)
+        queue.enqueue(fe::test::TestSequenceEvent(0, nextSequenceIndices[0] + i));
+    drainEvents();
+
+    uint64 blockCount = queue.get_block_count();
+
+    g_allocationCount.store(0);
+    g_countAllocations.store(true);
+
+    for (uint32 i = 0; i != eventCount; ++i)
+        queue.enqueue(fe::test::TestSequenceEvent(0, nextSequenceIndices[0] + i));
+    uint64 frameEventCount = drainEvents();
+
+    g_countAllocations.store(false);
+
+    CHECK(isOrderValid);
+    CHECK(frameEventCount == eventCount);
+    CHECK(g_allocationCount.load() == 0);
+    CHECK(queue.get_block_count() == blockCount);
+}
+
+TEST_CASE("Event channel passes all drained events of one type in one call")
+{
+    constexpr uint32 eventCount = 1000;
+
+    uint32 batchCount = 0;
+    std::vector<uint32> values;
+    uint32 handledEventCount = 0;
+
+    fe::EventManager::subscribe_batch<fe::test::TestBatchEvent>([&](std::span<const fe::test::TestBatchEvent> events)
+    {
+        ++batchCount;
+        for (const fe::test::TestBatchEvent& event : events)
+            values.push_back(event.get_value());
+    });
+
+    // Per-event handlers of the same type still receive every event
+    fe::EventManager::subscribe<fe::test::TestBatchEvent>([&](const fe::test::TestBatchEvent&)
+    {
+        ++handledEventCount;
+    });
+
+    for (uint32 i = 0; i != eventCount; ++i)
+        fe::EventManager::enqueue_event(fe::test::TestBatchEvent(i));
+
+    fe::EventManager::dispatch_events();
+
+    std::vector<uint32> expectedValues(eventCount);
+    std::iota(expectedValues.begin(), expectedValues.end(), 0);
+
+    CHECK(batchCount == 1);
+    CHECK(values == expectedValues);
+    CHECK(handledEventCount == eventCount);
+
+    fe::EventManager::trigger_event(fe::test::TestBatchEvent(eventCount));
+
+    CHECK(batchCount == 2);
+    CHECK(values.back() == eventCount);
+
+    // Triggered events are passed as batches of one from any thread, handlers are never executed concurrently
+    constexpr uint32 threadCount = 4;
+    constexpr uint32 triggeredEventCount = 100;
+
+    std::vector<std::thread> threads;
+    for (uint32 threadIndex = 0; threadIndex != threadCount; ++threadIndex)
+    {
+        threads.emplace_back([]
+        {
+            for (uint32 i = 0; i != triggeredEventCount; ++i)
+                fe::EventManager::trigger_event(fe::test::TestBatchEvent(i));
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    CHECK(batchCount == 2 + threadCount * triggeredEventCount);
+    CHECK(handledEventCount == eventCount + 1 + threadCount * triggeredEventCount);
+    CHECK(values.size() == eventCount + 1 + threadCount * triggeredEventCount);
+}
+
+FE_DEFINE_LOG_CATEGORY(LogTest)
+
+TEST_CASE("Logger writes messages of all threads before flush returns")
+{
+    constexpr uint32 threadCount = 4;
+    constexpr uint32 messageCount = 500;
+
+    const std::string logPath = (std::filesystem::temp_directory_path() / "fe_logger_test.log").string();
+    REQUIRE(FELogger::open_log_file(logPath));
+
+    FELogger::set_min_log_type<LogTest>(WARNING);
+    FE_LOG(LogTest, SUCCESS, "Filtered message");
+    FELogger::set_min_log_type<LogTest>(INFO);
+
+    std::vector<std::thread> threads;
+    for (uint32 threadIndex = 0; threadIndex != threadCount; ++threadIndex)
+    {
+        threads.emplace_back([threadIndex]
+        {
+            for (uint32 i = 0; i != messageCount; ++i)
+                FE_LOG(LogTest, WARNING, "Thread {} message {}", threadIndex, i);
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // Long messages don't fit into a ring record and take a separate path
+    FE_LOG(LogTest, WARNING, "{}", std::string(1000, 'x'));
+
+    FELogger::close_log_file();
+
+    std::ifstream logFile(logPath);
+    std::string line;
+    uint32 lineCount = 0;
+    bool hasFilteredMessage = false;
+    bool hasLongMessage = false;
+
+    while (std::getline(logFile, line))
+    {
+        ++lineCount;
+        hasFilteredMessage |= line.find("Filtered message") != std::string::npos;
+        hasLongMessage |= line == "[LogTest][WARNING]: " + std::string(1000, 'x');
+    }
+
+    CHECK(lineCount == threadCount * messageCount + 1);
+    CHECK(!hasFilteredMessage);
+    CHECK(hasLongMessage);
+}
+
+TEST_CASE("Profiler aggregates nested scopes per frame")
+{
+    constexpr uint32 frameCount = 10;
+
+    fe::Profiler::set_enabled(true);
+
+    for (uint32 frameIndex = 0; frameIndex != frameCount; ++frameIndex)
+    {
+        std::thread worker([]
+        {
+            FE_PROFILE_SCOPE("WorkerScope");
+        });
+
+        {
+            FE_PROFILE_SCOPE("OuterScope");
+            for (uint32 i = 0; i != 3; ++i)
+            {
+                FE_PROFILE_SCOPE("InnerScope");
+            }
+        }
+
+        worker.join();
+        fe::Profiler::begin_frame();
+    }
+
+    const fe::Profiler::Frame* lastFrame = fe::Profiler::get_last_frame();
+    REQUIRE(lastFrame);
+    CHECK(lastFrame->frameNumber == frameCount - 1);
+
+    uint32 innerScopeCount = 0;
+    for (const fe::Profiler::ThreadFrame& threadFrame : lastFrame->threads)
+    {
+        for (const fe::Profiler::ScopeEvent& event : threadFrame.events)
+        {
+            if (std::string_view(event.name) == "InnerScope")
+            {
+                CHECK(event.depth == 1);
+                ++innerScopeCount;
+            }
+        }
+    }
+    CHECK(innerScopeCount == 3);
+
+    std::vector<fe::Profiler::ScopeStats> scopeStats;
+    fe::Profiler::get_scope_stats(scopeStats);
+    CHECK(scopeStats.size() == 3);
+
+    for (const fe::Profiler::ScopeStats& stats : scopeStats)
+    {
+        CHECK(stats.frameCount == frameCount);
+        CHECK(stats.minTime <= stats.avgTime);
+        CHECK(stats.avgTime <= stats.p99Time);
+        CHECK(stats.p99Time <= stats.maxTime);
+        CHECK(stats.callsPerFrame == doctest::Approx(stats.name == "InnerScope" ? 3.0 : 1.0));
+    }
+
+    const std::string capturePath = (std::filesystem::temp_directory_path() / "fe_profile_test.json").string();
+    CHECK(fe::Profiler::export_capture(capturePath));
+
+    fe::Profiler::set_enabled(false);
+}
+
+TEST_CASE("Memory tracker counts tagged pool objects and aligned allocations")
+{
+    struct alignas(64) TrackedObject
+    {
+        uint64 value = 0;
+    };
+
+    constexpr uint32 threadCount = 4;
+    constexpr uint32 objectsPerThread = 100;
+
+    const fe::MemoryTracker::TagStats ecsStatsBefore = fe::MemoryTracker::get_tag_stats(fe::MemoryTag::ECS);
+
+    {
+        fe::ConcurrentPoolAllocator<TrackedObject, 64, fe::MemoryTag::ECS> pool;
+        std::array<std::vector<TrackedObject*>, threadCount> objectsByThread;
+        std::vector<std::thread> threads;
+
+        for (uint32 threadIndex = 0; threadIndex != threadCount; ++threadIndex)
+        {
+            threads.emplace_back([&, threadIndex]
+            {
+                for (uint32 i = 0; i != objectsPerThread; ++i)
+                    objectsByThread[threadIndex].push_back(pool.allocate());
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        fe::MemoryTracker::TagStats ecsStats = fe::MemoryTracker::get_tag_stats(fe::MemoryTag::ECS);
+        CHECK(ecsStats.liveBytes - ecsStatsBefore.liveBytes == threadCount * objectsPerThread * sizeof(TrackedObject));
+        CHECK(ecsStats.liveAllocationCount - ecsStatsBefore.liveAllocationCount == threadCount * objectsPerThread);
+        CHECK(ecsStats.peakBytes >= ecsStats.liveBytes);
+        CHECK(fe::MemoryTracker::report_leaks() >= 1);
+
+        for (std::vector<TrackedObject*>& objects : objectsByThread)
+            pool.free(objects);
+    }
+
+    fe::MemoryTracker::TagStats ecsStats = fe::MemoryTracker::get_tag_stats(fe::MemoryTag::ECS);
+    CHECK(ecsStats.liveBytes == ecsStatsBefore.liveBytes);
+    CHECK(ecsStats.liveAllocationCount == ecsStatsBefore.liveAllocationCount);
+    CHECK(ecsStats.totalAllocationCount - ecsStatsBefore.totalAllocationCount == threadCount * objectsPerThread);
+
+    const fe::MemoryTracker::TagStats modelStatsBefore = fe::MemoryTracker::get_tag_stats(fe::MemoryTag::ASSETS_MODELS);
+
+    void* memory = fe::MemoryUtils::allocate_aligned_memory(1000, 256, fe::MemoryTag::ASSETS_MODELS);
+    CHECK(uint64(memory) % 256 == 0);
+    CHECK(fe::MemoryTracker::get_tag_stats(fe::MemoryTag::ASSETS_MODELS).liveBytes - modelStatsBefore.liveBytes == 1000);
+
+    fe::MemoryUtils::free_aligned_memory(memory);
+    CHECK(fe::MemoryTracker::get_tag_stats(fe::MemoryTag::ASSETS_MODELS).liveBytes == modelStatsBefore.liveBytes);
+
+    const std::string reportPath = (std::filesystem::temp_directory_path() / "fe_memory_report.json").string();
+    CHECK(fe::MemoryTracker::export_report(reportPath));
+}
+
+namespace fe
+{
+
+class SerializedObject : public Object
+{
+    FE_DECLARE_OBJECT(SerializedObject);
+    FE_DECLARE_PROPERTY_REGISTER(SerializedObject);
+
+public:
+    float intensity = 0.0f;
+    int32 count = 0;
+    bool isActive = false;
+    Float3 position = Float3(0.0f, 0.0f, 0.0f);
+    Quat rotation;
+    UUID modelUUID = UUID::INVALID;
+    std::string label;
+    std::vector<UUID> materialUUIDs;
+    std::vector<std::string> tags;
+};
+
+FE_DEFINE_OBJECT(SerializedObject, Object);
+FE_BEGIN_PROPERTY_REGISTER(SerializedObject)
+{
+    FE_REGISTER_PROPERTY(SerializedObject, intensity);
+    FE_REGISTER_PROPERTY(SerializedObject, count);
+    FE_REGISTER_PROPERTY(SerializedObject, isActive);
+    FE_REGISTER_PROPERTY(SerializedObject, position);
+    FE_REGISTER_PROPERTY(SerializedObject, rotation);
+    FE_REGISTER_PROPERTY(SerializedObject, modelUUID);
+    FE_REGISTER_PROPERTY(SerializedObject, label);
+    FE_REGISTER_ARRAY_PROPERTY(SerializedObject, materialUUIDs);
+    FE_REGISTER_ARRAY_PROPERTY(SerializedObject, tags);
+}
+FE_END_PROPERTY_REGISTER(SerializedObject)
+
+// SerializedObject after count was removed, position was changed to Float4 and a property was added
+class ChangedSerializedObject : public Object
+{
+    FE_DECLARE_OBJECT(ChangedSerializedObject);
+    FE_DECLARE_PROPERTY_REGISTER(ChangedSerializedObject);
+
+public:
+    float attenuationRadius = 32.0f;
+    float intensity = 0.0f;
+    Float4 position = Float4(0.0f, 0.0f, 0.0f, 0.0f);
+    UUID modelUUID = UUID::INVALID;
+    std::string label;
+    std::vector<UUID> materialUUIDs;
+};
+
+FE_DEFINE_OBJECT(ChangedSerializedObject, Object);
+FE_BEGIN_PROPERTY_REGISTER(ChangedSerializedObject)
+{
+    FE_REGISTER_PROPERTY(ChangedSerializedObject, attenuationRadius);
+    FE_REGISTER_PROPERTY(ChangedSerializedObject, intensity);
+    FE_REGISTER_PROPERTY(ChangedSerializedObject, position);
+    FE_REGISTER_PROPERTY(ChangedSerializedObject, modelUUID);
+    FE_REGISTER_PROPERTY(ChangedSerializedObject, label);
+    FE_REGISTER_ARRAY_PROPERTY(ChangedSerializedObject, materialUUIDs);
+}
+FE_END_PROPERTY_REGISTER(ChangedSerializedObject)
+
+class DerivedSerializedObject : public SerializedObject
+{
+    FE_DECLARE_OBJECT(DerivedSerializedObject);
+};
+
+FE_DEFINE_OBJECT(DerivedSerializedObject, SerializedObject);
+
+// Reads back written data without saving it to a file
+class MemoryArchive : public Archive
+{
+public:
+    void begin_reading()
+    {
+        m_mode = Mode::READ;
+        m_position = 0;
+        m_fieldLayouts.clear();
+    }
+};
+
+}
+
+TEST_CASE("Property layout round-trips objects and reads changed layouts by field")
+{
+    constexpr uint32 objectCount = 3;
+
+    std::vector<fe::SerializedObject> objects(objectCount);
+    for (uint32 i = 0; i != objectCount; ++i)
+    {
+        fe::SerializedObject& object = objects[i];
+        object.intensity = 1.5f * i;
+        object.count = -int32(i);
+        object.isActive = i % 2;
+        object.position = fe::Float3(1.0f, 2.0f, float(i));
+        object.rotation = fe::Quat::rotation_axis(fe::Float3(0.0f, 1.0f, 0.0f), 30.0f * i);
+        object.modelUUID = fe::UUID(100 + i);
+        object.label = "Object " + std::to_string(i);
+        object.materialUUIDs.assign(i + 1, fe::UUID(200 + i));
+        object.tags.assign(i, "Tag");
+    }
+
+    fe::MemoryArchive archive;
+    for (const fe::SerializedObject& object : objects)
+        object.serialize(archive);
+
+    const fe::PropertyLayout& layout = fe::SerializedObject::get_static_type_info()->get_property_layout();
+    CHECK(!layout.is_empty());
+    CHECK(archive.get_field_layout(layout.get_hash()) != nullptr);
+
+    archive.begin_reading();
+    for (const fe::SerializedObject& object : objects)
+    {
+        fe::SerializedObject readObject;
+        readObject.deserialize(archive);
+
+        CHECK(readObject.intensity == object.intensity);
+        CHECK(readObject.count == object.count);
+        CHECK(readObject.isActive == object.isActive);
+        CHECK(readObject.position.x == object.position.x);
+        CHECK(readObject.position.z == object.position.z);
+        CHECK(readObject.rotation == object.rotation);
+        CHECK(readObject.modelUUID == object.modelUUID);
+        CHECK(readObject.label == object.label);
+        CHECK(readObject.materialUUIDs == object.materialUUIDs);
+        CHECK(readObject.tags == object.tags);
+    }
+
+    // The archive keeps descriptors of the written layout, so matching properties are found by name, type and size
+    archive.begin_reading();
+    for (const fe::SerializedObject& object : objects)
+    {
+        fe::ChangedSerializedObject readObject;
+        readObject.deserialize(archive);
+
+        CHECK(readObject.attenuationRadius == 32.0f);
+        CHECK(readObject.intensity == object.intensity);
+        CHECK(readObject.position.z == 0.0f);
+        CHECK(readObject.modelUUID == object.modelUUID);
+        CHECK(readObject.label == object.label);
+        CHECK(readObject.materialUUIDs == object.materialUUIDs);
+    }
+}
+
+TEST_CASE("Type indices give the same is_a results as base type chains")
+{
+    const fe::TypeInfo* objectTypeInfo = fe::Object::get_static_type_info();
+    const fe::TypeInfo* serializedTypeInfo = fe::SerializedObject::get_static_type_info();
+    const fe::TypeInfo* derivedTypeInfo = fe::DerivedSerializedObject::get_static_type_info();
+    const fe::TypeInfo* changedTypeInfo = fe::ChangedSerializedObject::get_static_type_info();
+
+    CHECK(fe::TypeManager::get_type_info("SerializedObject") == serializedTypeInfo);
+    CHECK(fe::TypeManager::get_type_info(fe::Name("DerivedSerializedObject")) == derivedTypeInfo);
+    CHECK(fe::TypeManager::get_type_info(fe::Name(derivedTypeInfo->get_name_hash())) == derivedTypeInfo);
+    CHECK(fe::TypeManager::get_type_info("MissingObject") == nullptr);
+
+    CHECK(derivedTypeInfo->is_a(serializedTypeInfo));
+    CHECK(derivedTypeInfo->is_a(objectTypeInfo));
+    CHECK(!serializedTypeInfo->is_a(derivedTypeInfo));
+    CHECK(!changedTypeInfo->is_a(serializedTypeInfo));
+    CHECK(derivedTypeInfo->get_type_index() == serializedTypeInfo->get_type_index() + 1);
+
+    // Object isn't registered, but it gets an index as the base type of registered types
+    const uint32 typeCount = fe::TypeManager::get_type_count();
+    CHECK(fe::TypeManager::get_type_info_by_index(objectTypeInfo->get_type_index()) == objectTypeInfo);
+    CHECK(objectTypeInfo->get_descendant_count() == typeCount - 1);
+
+    for (uint32 i = 0; i != typeCount; ++i)
+    {
+        const fe::TypeInfo* typeInfo = fe::TypeManager::get_type_info_by_index(i);
+        CHECK(typeInfo->get_type_index() == i);
+
+        for (uint32 j = 0; j != typeCount; ++j)
+        {
+            const fe::TypeInfo* baseTypeInfo = fe::TypeManager::get_type_info_by_index(j);
+
+            bool isBaseInChain = false;
+            for (const fe::TypeInfo* it = typeInfo; it != nullptr; it = it->get_base_type_info())
+                isBaseInChain |= it == baseTypeInfo;
+
+            CHECK(typeInfo->is_a(baseTypeInfo) == isBaseInChain);
+        }
+    }
+}
+
+TEST_CASE("UUIDs are unique across threads and reproducible with a deterministic seed")
+{
+    constexpr uint32 threadCount = 4;
+    constexpr uint32 uuidsPerThread = 20000;
+
+    std::vector<std::vector<fe::UUID>> uuidsByThread(threadCount);
+    std::vector<std::thread> threads;
+    for (uint32 threadIndex = 0; threadIndex != threadCount; ++threadIndex)
+    {
+        threads.emplace_back([&, threadIndex]
+        {
+            std::vector<fe::UUID>& uuids = uuidsByThread[threadIndex];
+            for (uint32 i = 0; i != uuidsPerThread / 2; ++i)
+                uuids.push_back(fe::UUID());
+
+            uuids.resize(uuidsPerThread, fe::UUID::INVALID);
+            fe::UUID::generate(uuids.data() + uuidsPerThread / 2, uuidsPerThread / 2);
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::unordered_set<fe::UUID> uniqueUUIDs;
+    for (const std::vector<fe::UUID>& uuids : uuidsByThread)
+        for (fe::UUID uuid : uuids)
+            CHECK((uuid != fe::UUID::INVALID && uniqueUUIDs.insert(uuid).second));
+
+    // A batch continues the sequence of the thread generator
+    fe::UUID::set_deterministic_seed(42);
+    std::vector<fe::UUID> firstUUIDs;
+    for (uint32 i = 0; i != 8; ++i)
+        firstUUIDs.push_back(fe::UUID());
+
+    fe::UUID::set_deterministic_seed(42);
+    std::vector<fe::UUID> secondUUIDs(8, fe::UUID::INVALID);
+    secondUUIDs[0] = fe::UUID();
+    fe::UUID::generate(secondUUIDs.data() + 1, secondUUIDs.size() - 1);
+
+    fe::UUID::reset_seed();
+    CHECK(firstUUIDs == secondUUIDs);
+    CHECK(fe::UUID() != firstUUIDs.front());
+}
+
+TEST_CASE("SIMD frustum culling matches per-box tests")
+{
+    // Same reversed depth range as EditorCameraComponent
+    fe::Matrix view = fe::Matrix::look_at_lh(
+        fe::Vector4::create(0.0f, 0.0f, -10.0f, 1.0f),
+        fe::Vector4::create(0.0f, 0.0f, 0.0f, 1.0f),
+        fe::Vector4::create(0.0f, 1.0f, 0.0f, 0.0f));
+    fe::Matrix projection = fe::Matrix::perspective_for_lh(fe::to_radians(60.0f), 16.0f / 9.0f, 100.0f, 0.1f);
+    fe::Float4x4 viewProjection = view * projection;
+    fe::Frustum frustum(viewProjection);
+
+    // Not a multiple of 8, so the scalar tail is tested too
+    constexpr uint32 boxCount = 10003;
+    std::vector<fe::AABB> aabbs;
+    fe::AABBArray aabbArray;
+    uint32 state = 12345;
+    auto nextFloat = [&state](float min, float max)
+    {
+        state = state * 1664525u + 1013904223u;
+        return min + (max - min) * float(state >> 8) / float(1u << 24);
+    };
+
+    for (uint32 i = 0; i != boxCount; ++i)
+    {
+        fe::Float3 center(nextFloat(-120.0f, 120.0f), nextFloat(-120.0f, 120.0f), nextFloat(-120.0f, 120.0f));
+        float halfWidth = nextFloat(0.1f, 5.0f);
+        aabbs.push_back(fe::AABB(center, fe::Float3(halfWidth, halfWidth, halfWidth)));
+        aabbArray.push_back(aabbs.back());
+    }
+
+    std::vector<uint32> expectedIndices;
+    for (uint32 i = 0; i != boxCount; ++i)
+        if (frustum.intersects(aabbs[i]))
+            expectedIndices.push_back(i);
+
+    CHECK(!expectedIndices.empty());
+    CHECK(expectedIndices.size() < boxCount);
+
+    std::vector<uint32> visibleIndices(boxCount);
+    uint32 visibleCount = fe::cull_aabbs(frustum, aabbArray, 0, boxCount, visibleIndices.data());
+    visibleIndices.resize(visibleCount);
+    CHECK(visibleIndices == expectedIndices);
+
+    fe::TaskComposer::init(4);
+
+    std::vector<uint32> parallelVisibleIndices(boxCount);
+    uint32 parallelVisibleCount = fe::parallel_cull_aabbs(frustum, aabbArray, parallelVisibleIndices.data(), 1000);
+    parallelVisibleIndices.resize(parallelVisibleCount);
+    CHECK(parallelVisibleIndices == expectedIndices);
+
+    fe::TaskComposer::cleanup();
+}
+
+TEST_CASE("BVH queries match brute force before and after refit")
+{
+    // More than two parallel build chunks, so subtrees are built by workers
+    constexpr uint32 boxCount = 20000;
+    constexpr uint32 rayCount = 300;
+
+    uint32 state = 777;
+    auto nextFloat = [&state](float min, float max)
+    {
+        state = state * 1664525u + 1013904223u;
+        return min + (max - min) * float(state >> 8) / float(1u << 24);
+    };
+
+    std::vector<fe::AABB> aabbs;
+    for (uint32 i = 0; i != boxCount; ++i)
+    {
+        fe::Float3 center(nextFloat(-200.0f, 200.0f), nextFloat(-200.0f, 200.0f), nextFloat(-200.0f, 200.0f));
+        aabbs.push_back(fe::AABB(center, fe::Float3(nextFloat(0.1f, 2.0f), nextFloat(0.1f, 2.0f), nextFloat(0.1f, 2.0f))));
+    }
+
+    std::vector<fe::Ray> rays;
+    for (uint32 i = 0; i != rayCount; ++i)
+    {
+        fe::Float3 origin(nextFloat(-250.0f, 250.0f), nextFloat(-250.0f, 250.0f), nextFloat(-250.0f, 250.0f));
+        fe::Float3 direction(nextFloat(-1.0f, 1.0f), nextFloat(-1.0f, 1.0f), nextFloat(-1.0f, 1.0f));
+        rays.emplace_back(origin, direction, 0.0f, i % 2 ? 100.0f : fe::FLOAT_MAX);
+    }
+
+    fe::Matrix view = fe::Matrix::look_at_lh(
+        fe::Vector4::create(0.0f, 0.0f, -250.0f, 1.0f),
+        fe::Vector4::create(0.0f, 0.0f, 0.0f, 1.0f),
+        fe::Vector4::create(0.0f, 1.0f, 0.0f, 0.0f));
+    fe::Frustum frustum(fe::Float4x4(view * fe::Matrix::perspective_for_lh(fe::to_radians(40.0f), 1.0f, 300.0f, 1.0f)));
+
+    auto checkQueries = [&](const fe::BVH& bvh)
+    {
+        CHECK(bvh.get_depth() < fe::BVH::s_maxDepth);
+
+        for (const fe::Ray& ray : rays)
+        {
+            uint32 closestIndex = ~0u;
+            float closestDistance = fe::FLOAT_MAX;
+            for (uint32 i = 0; i != boxCount; ++i)
+            {
+                if (!aabbs[i].intersects(ray))
+                    continue;
+
+                float distance = ray.tmin;
+                for (uint32 axis = 0; axis != 3; ++axis)
+                {
+                    float t1 = ((&aabbs[i].minPoint.x)[axis] - (&ray.origin.x)[axis]) * (&ray.directionInverse.x)[axis];
+                    float t2 = ((&aabbs[i].maxPoint.x)[axis] - (&ray.origin.x)[axis]) * (&ray.directionInverse.x)[axis];
+                    distance = std::max(distance, std::min(t1, t2));
+                }
+
+                if (distance < closestDistance)
+                {
+                    closestDistance = distance;
+                    closestIndex = i;
+                }
+            }
+
+            fe::BVH::Hit hit;
+            bool isHit = bvh.closest_hit(ray, hit);
+            CHECK(isHit == (closestIndex != ~0u));
+            CHECK(bvh.any_hit(ray) == isHit);
+            if (isHit)
+                CHECK(hit.distance == doctest::Approx(closestDistance));
+        }
+
+        fe::AABB queryAABB(fe::Float3(10.0f, -20.0f, 5.0f), fe::Float3(30.0f, 15.0f, 40.0f));
+        std::vector<uint32> expectedOverlaps;
+        std::vector<uint32> expectedVisible;
+        for (uint32 i = 0; i != boxCount; ++i)
+        {
+            if (aabbs[i].intersects(queryAABB) != fe::AABB::IntersectionType::OUTSIDE)
+                expectedOverlaps.push_back(i);
+            if (frustum.intersects(aabbs[i]))
+                expectedVisible.push_back(i);
+        }
+
+        std::vector<uint32> overlaps;
+        bvh.query_overlaps(queryAABB, overlaps);
+        std::sort(overlaps.begin(), overlaps.end());
+        CHECK(!expectedOverlaps.empty());
+        CHECK(overlaps == expectedOverlaps);
+
+        std::vector<uint32> visible;
+        bvh.query_frustum(frustum, visible);
+        std::sort(visible.begin(), visible.end());
+        CHECK(!expectedVisible.empty());
+        CHECK(visible == expectedVisible);
+    };
+
+    fe::TaskComposer::init(4);
+
+    fe::BVH bvh;
+    bvh.build(aabbs);
+    checkQueries(bvh);
+
+    for (uint32 i = 0; i < boxCount; i += 3)
+    {
+        fe::Float3 offset(nextFloat(-20.0f, 20.0f), nextFloat(-20.0f, 20.0f), nextFloat(-20.0f, 20.0f));
+        aabbs[i].minPoint = fe::Float3(aabbs[i].minPoint.x + offset.x, aabbs[i].minPoint.y + offset.y, aabbs[i].minPoint.z + offset.z);
+        aabbs[i].maxPoint = fe::Float3(aabbs[i].maxPoint.x + offset.x, aabbs[i].maxPoint.y + offset.y, aabbs[i].maxPoint.z + offset.z);
+        bvh.set_primitive_aabb(i, aabbs[i]);
+    }
+
+    bvh.refit();
+    checkQueries(bvh);
+
+    fe::TaskComposer::cleanup();
+}
+
+TEST_CASE("Triangle BVH hits match brute force for models and transformed instances")
+{
+    constexpr uint32 gridSize = 40;
+    constexpr uint32 rayCount = 500;
+
+    // Two bumpy grids that share the vertex and index buffers, the second one is the second mesh
+    std::vector<fe::Float3> positions;
+    std::vector<uint32> indices;
+    std::vector<uint32> meshFirstTriangles;
+    for (uint32 meshIndex = 0; meshIndex != 2; ++meshIndex)
+    {
+        meshFirstTriangles.push_back(uint32(indices.size() / 3));
+        uint32 firstVertex = (uint32)positions.size();
+        for (uint32 z = 0; z <= gridSize; ++z)
+        {
+            for (uint32 x = 0; x <= gridSize; ++x)
+            {
+                float posX = x * 0.5f - 10.0f;
+                float posZ = z * 0.5f - 10.0f;
+                positions.emplace_back(posX, std::sin(posX) * std::cos(posZ) + meshIndex * 4.0f, posZ);
+            }
+        }
+
+        for (uint32 z = 0; z != gridSize; ++z)
+        {
+            for (uint32 x = 0; x != gridSize; ++x)
+            {
+                uint32 vertex = firstVertex + z * (gridSize + 1) + x;
+                indices.insert(indices.end(), { vertex, vertex + gridSize + 1, vertex + 1 });
+                indices.insert(indices.end(), { vertex + 1, vertex + gridSize + 1, vertex + gridSize + 2 });
+            }
+        }
+    }
+    const uint32 triangleCount = uint32(indices.size() / 3);
+
+    uint32 state = 4242;
+    auto nextFloat = [&state](float min, float max)
+    {
+        state = state * 1664525u + 1013904223u;
+        return min + (max - min) * float(state >> 8) / float(1u << 24);
+    };
+
+    std::vector<fe::Ray> rays;
+    for (uint32 i = 0; i != rayCount; ++i)
+    {
+        fe::Float3 origin(nextFloat(-12.0f, 12.0f), nextFloat(-5.0f, 10.0f), nextFloat(-12.0f, 12.0f));
+        fe::Float3 direction(nextFloat(-1.0f, 1.0f), nextFloat(-1.0f, 1.0f), nextFloat(-1.0f, 1.0f));
+        rays.emplace_back(origin, direction, 0.0f, i % 2 ? 8.0f : fe::FLOAT_MAX);
+    }
+
+    // Independent Moller-Trumbore over all triangles, vertices are transformed by the instance transform
+    auto findClosestTriangle = [&](const fe::Ray& ray, const fe::Matrix& transform, float& outDistance)
+    {
+        uint32 closestTriangle = ~0u;
+        outDistance = ray.tmax;
+        for (uint32 i = 0; i != triangleCount; ++i)
+        {
+            fe::Vector vertex0 = fe::Vector3::transform_coord(positions[indices[i * 3]], transform);
+            fe::Vector edge1 = fe::Vector3::transform_coord(positions[indices[i * 3 + 1]], transform) - vertex0;
+            fe::Vector edge2 = fe::Vector3::transform_coord(positions[indices[i * 3 + 2]], transform) - vertex0;
+            fe::Vector p = fe::Vector3::cross(ray.direction, edge2);
+            float determinant = fe::Vector3::dot(edge1, p);
+            if (std::abs(determinant) < 1e-9f)
+                continue;
+
+            fe::Vector t = fe::Vector(ray.origin) - vertex0;
+            float u = fe::Vector3::dot(t, p) / determinant;
+            fe::Vector q = fe::Vector3::cross(t, edge1);
+            float v = fe::Vector3::dot(ray.direction, q) / determinant;
+            float distance = fe::Vector3::dot(edge2, q) / determinant;
+            if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && distance >= ray.tmin && distance < outDistance)
+            {
+                outDistance = distance;
+                closestTriangle = i;
+            }
+        }
+        return closestTriangle;
+    };
+
+    // The hit point from barycentrics of the reported triangle must be where the ray is at the hit distance
+    auto checkHitPoint = [&](const fe::Ray& ray, const fe::TriangleBVH::Hit& hit, const fe::Matrix& transform)
+    {
+        fe::Vector vertex0 = fe::Vector3::transform_coord(positions[indices[hit.triangleIndex * 3]], transform);
+        fe::Vector vertex1 = fe::Vector3::transform_coord(positions[indices[hit.triangleIndex * 3 + 1]], transform);
+        fe::Vector vertex2 = fe::Vector3::transform_coord(positions[indices[hit.triangleIndex * 3 + 2]], transform);
+        fe::Float3 trianglePoint = vertex0 * (1.0f - hit.barycentrics.x - hit.barycentrics.y) + vertex1 * hit.barycentrics.x + vertex2 * hit.barycentrics.y;
+        fe::Float3 rayPoint = ray.origin + ray.direction * hit.distance;
+        CHECK(fe::distance(trianglePoint, rayPoint) < 1e-3f);
+
+        fe::Float3 edge1 = vertex1 - vertex0;
+        CHECK(std::abs(fe::dot(hit.normal, edge1)) < 1e-3f * edge1.length());
+        CHECK(fe::dot(hit.normal, ray.direction) <= 0.0f);
+        CHECK(hit.normal.length() == doctest::Approx(1.0f));
+        CHECK(hit.meshIndex == (hit.triangleIndex >= meshFirstTriangles[1] ? 1u : 0u));
+    };
+
+    fe::TriangleBVH triangleBVH;
+    triangleBVH.build(positions, indices, meshFirstTriangles);
+    CHECK(triangleBVH.get_triangle_count() == triangleCount);
+    CHECK(triangleBVH.get_memory_size() >= triangleCount * sizeof(fe::TriangleBVH::Triangle));
+
+    uint32 hitCount = 0;
+    for (const fe::Ray& ray : rays)
+    {
+        float expectedDistance;
+        uint32 expectedTriangle = findClosestTriangle(ray, fe::Matrix::identity(), expectedDistance);
+
+        fe::TriangleBVH::Hit hit;
+        bool isHit = triangleBVH.closest_hit(ray, hit);
+        CHECK(isHit == (expectedTriangle != ~0u));
+        CHECK(triangleBVH.any_hit(ray) == isHit);
+        if (!isHit)
+            continue;
+
+        ++hitCount;
+        CHECK(hit.distance == doctest::Approx(expectedDistance).epsilon(1e-4));
+        checkHitPoint(ray, hit, fe::Matrix::identity());
+    }
+    CHECK(hitCount > rayCount / 4);
+
+    // Instances with rotation and non-uniform scale are placed next to each other
+    std::vector<fe::Matrix> transforms;
+    std::vector<fe::TriangleBVHInstance> instances;
+    std::vector<fe::AABB> instanceAABBs;
+    for (uint32 i = 0; i != 3; ++i)
+    {
+        fe::Matrix transform = fe::Matrix::scaling(1.0f + i * 0.5f, 1.0f, 2.0f - i * 0.5f)
+            * fe::Matrix::rotation(10.0f * i, 30.0f * i, 0.0f)
+            * fe::Matrix::translation(i * 30.0f - 30.0f, i * 2.0f, 0.0f);
+        transforms.push_back(transform);
+
+        fe::TriangleBVHInstance& instance = instances.emplace_back();
+        instance.triangleBVH = &triangleBVH;
+        instance.transform = transform;
+        instance.inverseTransform = transform.inverse();
+
+        fe::AABB aabb(fe::Float3(fe::FLOAT_MAX, fe::FLOAT_MAX, fe::FLOAT_MAX), fe::Float3(-fe::FLOAT_MAX, -fe::FLOAT_MAX, -fe::FLOAT_MAX));
+        for (const fe::Float3& position : positions)
+        {
+            fe::Float3 worldPosition = fe::Vector3::transform_coord(position, transform);
+            aabb.minPoint = fe::min(aabb.minPoint, worldPosition);
+            aabb.maxPoint = fe::max(aabb.maxPoint, worldPosition);
+        }
+        instanceAABBs.push_back(aabb);
+    }
+
+    fe::BVH instanceBVH;
+    instanceBVH.build(instanceAABBs);
+
+    uint32 instanceHitCount = 0;
+    for (uint32 rayIndex = 0; rayIndex != rayCount; ++rayIndex)
+    {
+        fe::Float3 origin(nextFloat(-60.0f, 40.0f), nextFloat(-5.0f, 15.0f), nextFloat(-30.0f, 30.0f));
+        fe::Float3 direction(nextFloat(-1.0f, 1.0f), nextFloat(-1.0f, 1.0f), nextFloat(-1.0f, 1.0f));
+        fe::Ray ray(origin, direction);
+
+        uint32 expectedInstance = ~0u;
+        float expectedDistance = fe::FLOAT_MAX;
+        for (uint32 i = 0; i != instances.size(); ++i)
+        {
+            float distance;
+            if (findClosestTriangle(ray, transforms[i], distance) != ~0u && distance < expectedDistance)
+            {
+                expectedDistance = distance;
+                expectedInstance = i;
+            }
+        }
+
+        fe::TriangleBVH::Hit hit;
+        uint32 instanceIndex = ~0u;
+        bool isHit = fe::closest_instance_hit(instanceBVH, instances.data(), ray, hit, instanceIndex);
+        CHECK(isHit == (expectedInstance != ~0u));
+        if (!isHit)
+            continue;
+
+        ++instanceHitCount;
+        CHECK(instanceIndex == expectedInstance);
+        CHECK(hit.distance == doctest::Approx(expectedDistance).epsilon(1e-4));
+        checkHitPoint(ray, hit, transforms[instanceIndex]);
+    }
+    CHECK(instanceHitCount > rayCount / 4);
+}
+
+TEST_CASE("Bulk math kernels match scalar and per-element results")
+{
+    // Not a multiple of 8, so the scalar tails are tested too
+    constexpr uint32 count = 1003;
+
+    uint32 state = 4242;
+    auto nextFloat = [&state](float min, float max)
+    {
+        state = state * 1664525u + 1013904223u;
+        return min + (max - min) * float(state >> 8) / float(1u << 24);
+    };
+    auto isNear = [](float a, float b)
+    {
+        return std::abs(a - b) <= 1e-5f * std::max(1.0f, std::abs(b));
+    };
+    auto isNear3 = [&isNear](const fe::Float3& a, const fe::Float3& b)
+    {
+        return isNear(a.x, b.x) && isNear(a.y, b.y) && isNear(a.z, b.z);
+    };
+
+    std::vector<fe::Float3> points(count);
+    std::vector<fe::Float2> uvs(count);
+    std::vector<fe::Float4> quats(count);
+    std::vector<fe::Float4x4> matrices1(count);
+    std::vector<fe::Float4x4> matrices2(count);
+    for (uint32 i = 0; i != count; ++i)
+    {
+        points[i] = fe::Float3(nextFloat(-100.0f, 100.0f), nextFloat(-100.0f, 100.0f), nextFloat(-100.0f, 100.0f));
+        uvs[i] = fe::Float2(nextFloat(-2.0f, 3.0f), nextFloat(-4.0f, 5.0f));
+        quats[i] = fe::Float4(nextFloat(-1.0f, 1.0f), nextFloat(-1.0f, 1.0f), nextFloat(-1.0f, 1.0f), nextFloat(-1.0f, 1.0f));
+        for (uint32 j = 0; j != 16; ++j)
+        {
+            matrices1[i].m[j / 4][j % 4] = nextFloat(-2.0f, 2.0f);
+            matrices2[i].m[j / 4][j % 4] = nextFloat(-2.0f, 2.0f);
+        }
+    }
+    quats[5] = fe::Float4(0.0f, 0.0f, 0.0f, 0.0f);
+
+    fe::Float4x4 transform = fe::Matrix::scaling(1.5f, 2.0f, 0.5f)
+        * fe::Matrix::rotation(17.0f, 63.0f, -40.0f)
+        * fe::Matrix::translation(10.0f, -3.0f, 7.0f);
+    fe::Float4x4 projection = fe::Matrix::perspective_for_lh(fe::to_radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+
+    for (const fe::Float4x4& matrix : { transform, projection })
+    {
+        std::vector<fe::Float3> result(count), scalarResult(count);
+        fe::transform_points(points.data(), count, matrix, result.data());
+        fe::transform_points_scalar(points.data(), count, matrix, scalarResult.data());
+        for (uint32 i = 0; i != count; ++i)
+        {
+            CHECK(isNear3(result[i], scalarResult[i]));
+            CHECK(isNear3(result[i], fe::Float3(fe::Vector3::transform_coord(points[i], matrix))));
+        }
+
+        fe::transform_normals(points.data(), count, matrix, result.data());
+        fe::transform_normals_scalar(points.data(), count, matrix, scalarResult.data());
+        for (uint32 i = 0; i != count; ++i)
+        {
+            CHECK(isNear3(result[i], scalarResult[i]));
+            CHECK(isNear3(result[i], fe::Float3(fe::Vector3::transform_normal(points[i], matrix))));
+        }
+    }
+
+    // Output can be the input
+    std::vector<fe::Float3> inPlacePoints = points;
+    std::vector<fe::Float3> expectedPoints(count);
+    fe::transform_points(points.data(), count, transform, expectedPoints.data());
+    fe::transform_points(inPlacePoints.data(), count, transform, inPlacePoints.data());
+    CHECK(std::memcmp(inPlacePoints.data(), expectedPoints.data(), count * sizeof(fe::Float3)) == 0);
+
+    fe::AABB expectedAABB;
+    for (const fe::Float3& point : points)
+    {
+        expectedAABB.minPoint = fe::min(expectedAABB.minPoint, point);
+        expectedAABB.maxPoint = fe::max(expectedAABB.maxPoint, point);
+    }
+    for (uint32 boundsCount : { 0u, 1u, 7u, 8u, 9u, count })
+    {
+        fe::Float3 minPoint, maxPoint, scalarMinPoint, scalarMaxPoint;
+        fe::compute_bounds(points.data(), boundsCount, minPoint, maxPoint);
+        fe::compute_bounds_scalar(points.data(), boundsCount, scalarMinPoint, scalarMaxPoint);
+        CHECK(std::memcmp(&minPoint, &scalarMinPoint, sizeof(fe::Float3)) == 0);
+        CHECK(std::memcmp(&maxPoint, &scalarMaxPoint, sizeof(fe::Float3)) == 0);
+
+        fe::Float2 minUV, maxUV, scalarMinUV, scalarMaxUV;
+        fe::compute_bounds(uvs.data(), boundsCount, minUV, maxUV);
+        fe::compute_bounds_scalar(uvs.data(), boundsCount, scalarMinUV, scalarMaxUV);
+        CHECK(std::memcmp(&minUV, &scalarMinUV, sizeof(fe::Float2)) == 0);
+        CHECK(std::memcmp(&maxUV, &scalarMaxUV, sizeof(fe::Float2)) == 0);
+    }
+
+    fe::AABB aabb(points);
+    CHECK(std::memcmp(&aabb.minPoint, &expectedAABB.minPoint, sizeof(fe::Float3)) == 0);
+    CHECK(std::memcmp(&aabb.maxPoint, &expectedAABB.maxPoint, sizeof(fe::Float3)) == 0);
+
+    std::vector<fe::Float4x4> products(count), scalarProducts(count);
+    fe::multiply_matrices(matrices1.data(), matrices2.data(), count, products.data());
+    fe::multiply_matrices_scalar(matrices1.data(), matrices2.data(), count, scalarProducts.data());
+    for (uint32 i = 0; i != count; ++i)
+    {
+        fe::Float4x4 expected = matrices1[i].to_matrix() * matrices2[i].to_matrix();
+        for (uint32 j = 0; j != 16; ++j)
+        {
+            CHECK(isNear(products[i].m[j / 4][j % 4], scalarProducts[i].m[j / 4][j % 4]));
+            CHECK(isNear(products[i].m[j / 4][j % 4], expected.m[j / 4][j % 4]));
+        }
+    }
+
+    std::vector<fe::Float4> normalizedQuats(count), scalarNormalizedQuats(count);
+    fe::normalize_quaternions(quats.data(), count, normalizedQuats.data());
+    fe::normalize_quaternions_scalar(quats.data(), count, scalarNormalizedQuats.data());
+    for (uint32 i = 0; i != count; ++i)
+    {
+        const fe::Float4& quat = normalizedQuats[i];
+        const fe::Float4& scalarQuat = scalarNormalizedQuats[i];
+        CHECK((isNear(quat.x, scalarQuat.x) && isNear(quat.y, scalarQuat.y) && isNear(quat.z, scalarQuat.z) && isNear(quat.w, scalarQuat.w)));
+        if (i == 5)
+        {
+            CHECK((quat.x == 0.0f && quat.y == 0.0f && quat.z == 0.0f && quat.w == 0.0f));
+            continue;
+        }
+        CHECK(isNear(quat.x * quat.x + quat.y * quat.y + quat.z * quat.z + quat.w * quat.w, 1.0f));
+    }
+}
+
+TEST_CASE("Spatial hash queries match brute force after moves and removals")
+{
+    // More than one parallel chunk, so bulk insert and update are split between workers
+    constexpr uint32 boxCount = 20000;
+    constexpr uint32 queryCount = 100;
+
+    uint32 state = 2024;
+    auto nextFloat = [&state](float min, float max)
+    {
+        state = state * 1664525u + 1013904223u;
+        return min + (max - min) * float(state >> 8) / float(1u << 24);
+    };
+    // Mostly small boxes, some big ones for higher levels, a few too big or too far for the grid
+    auto nextAABB = [&](uint32 index)
+    {
+        float halfWidth = index % 100 == 0 ? nextFloat(20.0f, 200.0f) : nextFloat(0.0f, 3.0f);
+        fe::Float3 center(nextFloat(-500.0f, 500.0f), nextFloat(-500.0f, 500.0f), nextFloat(-500.0f, 500.0f));
+        if (index % 5000 == 1)
+            halfWidth = 1e6f;
+        if (index % 5000 == 2)
+            center.x = 1e9f;
+        return fe::AABB(center, fe::Float3(halfWidth, halfWidth * 0.5f, halfWidth));
+    };
+
+    std::vector<fe::AABB> aabbs;
+    std::vector<uint64> userData;
+    for (uint32 i = 0; i != boxCount; ++i)
+    {
+        aabbs.push_back(nextAABB(i));
+        userData.push_back(i);
+    }
+
+    fe::TaskComposer::init(4);
+
+    fe::SpatialHash spatialHash(2.0f);
+    std::vector<uint32> proxies(boxCount);
+    spatialHash.insert(aabbs.data(), userData.data(), boxCount / 2, proxies.data());
+    for (uint32 i = boxCount / 2; i != boxCount; ++i)
+        proxies[i] = spatialHash.insert(aabbs[i], i);
+    CHECK(spatialHash.get_proxy_count() == boxCount);
+
+    std::vector<bool> isRemoved(boxCount, false);
+    auto checkQueries = [&]()
+    {
+        fe::Matrix view = fe::Matrix::look_at_lh(
+            fe::Vector4::create(nextFloat(-300.0f, 300.0f), 0.0f, -600.0f, 1.0f),
+            fe::Vector4::create(0.0f, 0.0f, 0.0f, 1.0f),
+            fe::Vector4::create(0.0f, 1.0f, 0.0f, 0.0f));
+        fe::Frustum frustum(fe::Float4x4(view * fe::Matrix::perspective_for_lh(fe::to_radians(40.0f), 1.0f, 700.0f, 0.1f)));
+
+        for (uint32 queryIndex = 0; queryIndex != queryCount; ++queryIndex)
+        {
+            fe::Float3 center(nextFloat(-500.0f, 500.0f), nextFloat(-500.0f, 500.0f), nextFloat(-500.0f, 500.0f));
+            // Some queries cover more cells than exist on small levels
+            float size = queryIndex % 10 == 0 ? nextFloat(200.0f, 600.0f) : nextFloat(1.0f, 40.0f);
+            fe::AABB queryAABB(center, fe::Float3(size, size * 0.7f, size));
+
+            std::vector<uint32> expectedOverlaps, expectedSphereHits, expectedFrustumHits;
+            for (uint32 i = 0; i != boxCount; ++i)
+            {
+                if (isRemoved[i])
+                    continue;
+
+                const fe::AABB& aabb = aabbs[i];
+                if (aabb.minPoint.x <= queryAABB.maxPoint.x && aabb.maxPoint.x >= queryAABB.minPoint.x
+                    && aabb.minPoint.y <= queryAABB.maxPoint.y && aabb.maxPoint.y >= queryAABB.minPoint.y
+                    && aabb.minPoint.z <= queryAABB.maxPoint.z && aabb.maxPoint.z >= queryAABB.minPoint.z)
+                    expectedOverlaps.push_back(i);
+
+                fe::Float3 closestPoint = fe::min(fe::max(center, aabb.minPoint), aabb.maxPoint);
+                if (fe::distance_squared(closestPoint, center) <= size * size)
+                    expectedSphereHits.push_back(i);
+
+                if (queryIndex == 0 && frustum.intersects(aabb))
+                    expectedFrustumHits.push_back(i);
+            }
+
+            auto toIndices = [&](const std::vector<uint32>& hitProxies)
+            {
+                std::vector<uint32> indices;
+                for (uint32 proxy : hitProxies)
+                    indices.push_back(uint32(spatialHash.get_user_data(proxy)));
+                std::sort(indices.begin(), indices.end());
+                return indices;
+            };
+
+            std::vector<uint32> hitProxies;
+            spatialHash.query_overlaps(queryAABB, hitProxies);
+            CHECK(toIndices(hitProxies) == expectedOverlaps);
+
+            hitProxies.clear();
+            spatialHash.query_sphere(center, size, hitProxies);
+            CHECK(toIndices(hitProxies) == expectedSphereHits);
+
+            if (queryIndex == 0)
+            {
+                hitProxies.clear();
+                spatialHash.query_frustum(frustum, hitProxies);
+                CHECK(!expectedFrustumHits.empty());
+                CHECK(toIndices(hitProxies) == expectedFrustumHits);
+            }
+        }
+    };
+
+    checkQueries();
+
+    // Every third box moves a bit, usually inside of its cell, every tenth one jumps somewhere else
+    std::vector<uint32> movedProxies;
+    std::vector<fe::AABB> movedAABBs;
+    for (uint32 i = 0; i != boxCount; ++i)
+    {
+        if (i % 10 == 0)
+        {
+            aabbs[i] = nextAABB(i + 3);
+        }
+        else if (i % 3 == 0)
+        {
+            fe::Float3 offset(nextFloat(-0.5f, 0.5f), nextFloat(-0.5f, 0.5f), nextFloat(-0.5f, 0.5f));
+            aabbs[i] = fe::AABB(aabbs[i].get_center() + offset, aabbs[i].get_half_width());
+        }
+        else
+        {
+            continue;
+        }
+
+        if (i % 20 == 0)
+        {
+            spatialHash.update(proxies[i], aabbs[i]);
+            continue;
+        }
+        movedProxies.push_back(proxies[i]);
+        movedAABBs.push_back(aabbs[i]);
+    }
+    movedProxies.push_back(fe::SpatialHash::s_invalidProxy);
+    movedAABBs.push_back(fe::AABB());
+    spatialHash.update(movedProxies.data(), movedAABBs.data(), uint32(movedProxies.size()));
+
+    for (uint32 i = 0; i < boxCount; i += 7)
+    {
+        spatialHash.remove(proxies[i]);
+        isRemoved[i] = true;
+    }
+
+    checkQueries();
+    for (uint32 i = 0; i != boxCount; ++i)
+    {
+        if (isRemoved[i])
+            continue;
+
+        const fe::AABB& aabb = spatialHash.get_aabb(proxies[i]);
+        CHECK(std::memcmp(&aabb, &aabbs[i], sizeof(fe::AABB)) == 0);
+    }
+
+    // Removed proxies are reused, the last removed one first
+    uint32 lastRemovedIndex = (boxCount - 1) / 7 * 7;
+    CHECK(spatialHash.insert(aabbs[0], 0) == proxies[lastRemovedIndex]);
+
+    spatialHash.clear();
+    CHECK(spatialHash.get_proxy_count() == 0);
+    CHECK(spatialHash.get_cell_count() == 0);
+
+    fe::TaskComposer::cleanup();
+}
@@ -56,7 +56,10 @@ Application::Application()
 
 Application::~Application()
 {
+    // Subsystems are destroyed before Core::cleanup(), so it reports only memory that was really leaked
     m_renderer.reset();
+    m_editor.reset();
+    m_engine.reset();
     TypeManager::cleanup();
     Core::cleanup();
 }
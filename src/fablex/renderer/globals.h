@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/types.h"
+#include "core/name.h"
 
 namespace fe::renderer
 {
@@ -8,14 +9,14 @@ namespace fe::renderer
 inline uint64 g_frameIndex = 0;
 inline uint64 g_frameNumber = 0;
 
-constexpr const char* BACK_BUFFER_NAME = "BackBuffer_0451";
-constexpr const char* SAMPLER_LINEAR_REPEAT = "SamplerLinearRepeat";
-constexpr const char* SAMPLER_LINEAR_CLAMP = "SamplerLinearClamp";
-constexpr const char* SAMPLER_LINEAR_MIRROR = "SamplerLinearMirror";
-constexpr const char* SAMPLER_NEAREST_REPEAT = "SamplerNearestRepeat";
-constexpr const char* SAMPLER_NEAREST_CLAMP = "SamplerNearesClamp";
-constexpr const char* SAMPLER_NEAREST_MIRROR = "SamplerNearestMirror";
-constexpr const char* SAMPLER_MINIMUM_NEAREST_CLAMP = "SamplerMinimumNearestClamp";
+constexpr Name BACK_BUFFER_NAME = "BackBuffer_0451"_name;
+constexpr Name SAMPLER_LINEAR_REPEAT = "SamplerLinearRepeat"_name;
+constexpr Name SAMPLER_LINEAR_CLAMP = "SamplerLinearClamp"_name;
+constexpr Name SAMPLER_LINEAR_MIRROR = "SamplerLinearMirror"_name;
+constexpr Name SAMPLER_NEAREST_REPEAT = "SamplerNearestRepeat"_name;
+constexpr Name SAMPLER_NEAREST_CLAMP = "SamplerNearesClamp"_name;
+constexpr Name SAMPLER_NEAREST_MIRROR = "SamplerNearestMirror"_name;
+constexpr Name SAMPLER_MINIMUM_NEAREST_CLAMP = "SamplerMinimumNearestClamp"_name;
 
 // Must only be used for render graph cross frame resources 
 inline uint64 get_curr_frame_index()
@@ -69,15 +69,12 @@ RenderGraph::Node* RenderGraph::get_node(RenderPassName renderPassName) const
 
 RenderGraph::ViewName RenderGraph::encode_view_name(ResourceName resourceName, uint32 viewIndex)
 {
-    ViewName viewName = resourceName.to_id();
-    viewName <<= 32;
-    viewName |= viewIndex;
-    return viewName;
+    return ViewName{ resourceName, viewIndex };
 }
 
 std::pair<ResourceName, uint32> RenderGraph::decode_view_name(ViewName viewName)
 {
-    return {ResourceName{uint32(viewName >> 32)}, uint32(viewName & 0x0000FFFF)};
+    return { viewName.resourceName, viewName.viewIndex };
 }
 
 void RenderGraph::build_adjacency_lists()
@@ -220,7 +217,7 @@ void RenderGraph::finalize_dependency_levels()
     {
         uint64 localExecIdx = 0;
 
-        std::unordered_map<ViewName, std::unordered_set<QueueIndex>> resourceReadingQueueTracker;
+        std::unordered_map<ViewName, std::unordered_set<QueueIndex>, RenderGraphViewNameHash> resourceReadingQueueTracker;
         dependencyLevel.m_nodesPerQueue.resize(m_detectedQueueCount);
 
         for (Node* node : dependencyLevel.m_nodes)
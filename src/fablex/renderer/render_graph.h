@@ -10,13 +10,33 @@ namespace fe::renderer
 
 class RenderPassContainer;
 
+// Resource name is a 64-bit hash, so it can't be packed into one integer with the view index
+struct RenderGraphViewName
+{
+    ResourceName resourceName;
+    uint32 viewIndex = 0;
+
+    bool operator==(const RenderGraphViewName& other) const
+    {
+        return resourceName == other.resourceName && viewIndex == other.viewIndex;
+    }
+};
+
+struct RenderGraphViewNameHash
+{
+    size_t operator()(const RenderGraphViewName& viewName) const
+    {
+        return std::hash<ResourceName>()(viewName.resourceName) ^ (uint64(viewName.viewIndex) * 0x9e3779b97f4a7c15ull);
+    }
+};
+
 class RenderGraph
 {
 public:
-    using ViewName = uint64;
+    using ViewName = RenderGraphViewName;
     using QueueIndex = uint64;
-    using WriteDependencyRegistry = std::unordered_map<ViewName, RenderPassName>;
-    using ViewNameSet = std::unordered_set<ViewName>;
+    using WriteDependencyRegistry = std::unordered_map<ViewName, RenderPassName, RenderGraphViewNameHash>;
+    using ViewNameSet = std::unordered_set<ViewName, RenderGraphViewNameHash>;
     using QueueIndexSet = std::unordered_set<QueueIndex>;
 
     class Node
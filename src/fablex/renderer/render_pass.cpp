@@ -67,7 +67,7 @@ void RenderPass::schedule_resources()
         }
         else if (textureMetadata.has_flag(ResourceMetadataFlag::PING_PONG))
         {
-            ResourceName pingPong0 = textureName.to_string() + "0";
+            ResourceName pingPong0 = textureName.with_suffix("0");
             ResourceScheduler::read_texture(get_name(), pingPong0);
         }
         else
@@ -134,8 +134,8 @@ void RenderPass::schedule_resources()
         }
         else if (textureMetadata.has_flag(ResourceMetadataFlag::PING_PONG))
         {
-            ResourceName pingPong0 = textureName.to_string() + "0";
-            ResourceName pingPong1 = textureName.to_string() + "1";
+            ResourceName pingPong0 = textureName.with_suffix("0");
+            ResourceName pingPong1 = textureName.with_suffix("1");
             ResourceScheduler::create_storage_texture(get_name(), pingPong0, &info);
             ResourceScheduler::create_storage_texture(get_name(), pingPong1, &info);
 
@@ -343,12 +343,12 @@ RenderPass::ResourceNamesXFR RenderPass::get_resource_names_xfr(ResourceName bas
 
 ResourceName RenderPass::get_prev_frame_resource_name(ResourceName baseName) const
 {
-    return ResourceName(baseName.to_string() + std::to_string(get_prev_frame_index()));
+    return baseName.with_suffix(get_prev_frame_index());
 }
 
 ResourceName RenderPass::get_curr_frame_resource_name(ResourceName baseName) const
 {
-    return ResourceName(baseName.to_string() + std::to_string(get_curr_frame_index()));
+    return baseName.with_suffix(get_curr_frame_index());
 }
 
 std::string RenderPass::get_name_at_index(Name name, uint32 index) const
@@ -425,7 +425,7 @@ void RenderPass::fill_push_constants(PushConstantsName pushConstantsName, void*
             else
             {
                 isWritePingPong = false;
-                resourceName = resourceName.to_string() + "0";
+                resourceName = resourceName.with_suffix("0");
             }
         }
 
@@ -38,7 +38,7 @@ void PathTracingPass::schedule_resources()
 void PathTracingPass::execute(rhi::CommandBuffer* cmd)
 {
     RenderGraphResourceManager* resourceManager = m_renderContext->render_graph_resource_manager();
-    Resource* finalIllumination = resourceManager->get_resource("FilteredIllumination0");
+    Resource* finalIllumination = resourceManager->get_resource("FilteredIllumination0"_name);
     FE_CHECK(finalIllumination);
 
     ++m_accumulationFactor;
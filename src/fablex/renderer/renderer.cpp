@@ -4,6 +4,7 @@
 #include "resource_scheduler.h"
 #include "rhi/utils.h"
 #include "core/task_composer.h"
+#include "core/profiler.h"
 
 namespace fe::renderer
 {
@@ -44,6 +45,8 @@ Renderer::~Renderer()
 
 void Renderer::predraw()
 {
+    FE_PROFILE_SCOPE("Renderer::predraw");
+
     bool beginFrameCalled = false;
 
     rhi::CommandBuffer* cmd = nullptr;
@@ -86,6 +89,8 @@ void Renderer::predraw()
 
 void Renderer::draw()
 {
+    FE_PROFILE_SCOPE("Renderer::draw");
+
     if (m_renderGraph->get_nodes().empty())
         return;
 
@@ -203,8 +208,6 @@ void Renderer::begin_frame()
 
     m_bvhBuildSemaphore = nullptr;
     m_uploadSemaphore = nullptr;
-    m_submitContexts.clear();
-    m_pipelineBarriersByPassName.clear();
 
     if (g_frameNumber > 3)
         m_deletionQueue->destroy_objects();
@@ -214,6 +217,11 @@ void Renderer::begin_frame()
 
 void Renderer::end_frame()
 {
+    // Frame containers must not keep pointers into arenas after reset
+    SubmitContextArray().swap(m_submitContexts);
+    PipelineBarrierMap().swap(m_pipelineBarriersByPassName);
+    FrameAllocator::reset();
+
     m_commandManager->end_frame();
     m_resourceManager->end_frame();
     m_syncManager->end_frame();
@@ -254,17 +262,20 @@ void Renderer::execute_render_graph()
 
 void Renderer::present()
 {
-    rhi::PresentInfo presentInfo;
-    presentInfo.swapChains.push_back(m_mainSwapChain);
-    presentInfo.waitSemaphores.push_back(m_backBufferSemaphore);
+    FE_PROFILE_SCOPE("Renderer::present");
+
+    m_presentInfo.swapChains.clear();
+    m_presentInfo.waitSemaphores.clear();
+    m_presentInfo.swapChains.push_back(m_mainSwapChain);
+    m_presentInfo.waitSemaphores.push_back(m_backBufferSemaphore);
 
-    rhi::present(&presentInfo);
+    rhi::present(&m_presentInfo);
 }
 
 void Renderer::configure_submit_contexts()
 {
-    std::vector<SubmitContext*> lastSubmitContextPerQueue(m_renderGraph->get_detected_queue_count(), nullptr);
-    std::unordered_map<const RenderGraph::Node*, rhi::Semaphore*> signalSemaphoreByNode;
+    FrameVector<SubmitContext*> lastSubmitContextPerQueue(m_renderGraph->get_detected_queue_count(), nullptr);
+    FrameUnorderedMap<const RenderGraph::Node*, rhi::Semaphore*> signalSemaphoreByNode;
     bool requiresWaitingBVH = true;
 
     for (const RenderGraph::Node* node : m_renderGraph->get_nodes_in_global_exec_order())
@@ -421,11 +432,13 @@ void Renderer::record_predraw_cmds()
     {
         record_upload_cmd();
         record_bvh_build_cmd();
-    });
+    }, "RecordPredrawCommands");
 }
 
 void Renderer::record_worker_cmds()
 {
+    FE_PROFILE_SCOPE("Renderer::record_worker_cmds");
+
     TaskComposer::wait(m_commandRecordingTaskGroup);
 
     for (SubmitContext& submitContext : m_submitContexts)
@@ -487,13 +500,15 @@ void Renderer::record_worker_cmds()
                 }
 
                 rhi::end_command_buffer(cmd);
-            });
+            }, "RecordWorkerCommands");
         }
     }
 }
 
 void Renderer::submit()
 {
+    FE_PROFILE_SCOPE("Renderer::submit");
+
     TaskComposer::wait(m_commandRecordingTaskGroup);
 
     if (is_upload_cmd_submit_required())
@@ -504,18 +519,18 @@ void Renderer::submit()
 
     for (const SubmitContext& submitContext : m_submitContexts)
     {
-        rhi::SubmitInfo submitInfo;
-        submitInfo.queueType = submitContext.queueType;
+        m_workerSubmitInfo.clear();
+        m_workerSubmitInfo.queueType = submitContext.queueType;
 
         for (const DependencyLevelCommandContext& dependencyLevelContext : submitContext.depencyLevelCommandContexts)
-            submitInfo.cmdBuffers.push_back(dependencyLevelContext.workerCmd);
+            m_workerSubmitInfo.cmdBuffers.push_back(dependencyLevelContext.workerCmd);
 
         if (submitContext.signalSemaphore)
-            submitInfo.signalSemaphores.push_back(submitContext.signalSemaphore);
+            m_workerSubmitInfo.signalSemaphores.push_back(submitContext.signalSemaphore);
         
-        submitInfo.waitSemaphores = submitContext.waitSemaphores;
+        m_workerSubmitInfo.waitSemaphores.assign(submitContext.waitSemaphores.begin(), submitContext.waitSemaphores.end());
 
-        rhi::submit(&submitInfo, m_syncManager->get_fence());
+        rhi::submit(&m_workerSubmitInfo, m_syncManager->get_fence());
     }
 }
 
@@ -14,6 +14,7 @@
 #include "imgui_renderer.h"
 #include "render_context.h"
 #include "core/window.h"
+#include "core/frame_allocator.h"
 
 namespace fe::renderer
 {
@@ -43,20 +44,22 @@ private:
 
         rhi::CommandBuffer* workerCmd = nullptr;
         uint32 dependencyLevelIndex = s_undefinedDependencyLevel;
-        std::vector<const RenderGraph::Node*> nodesToRecord;
+        FrameVector<const RenderGraph::Node*> nodesToRecord;
     };
 
     struct SubmitContext
     {
         rhi::Semaphore* signalSemaphore;
-        std::vector<rhi::Semaphore*> waitSemaphores; 
-        std::vector<DependencyLevelCommandContext> depencyLevelCommandContexts;
+        FrameVector<rhi::Semaphore*> waitSemaphores; 
+        FrameVector<DependencyLevelCommandContext> depencyLevelCommandContexts;
         rhi::QueueType queueType = rhi::QueueType::GRAPHICS;
     };
 
-    using SubmitContextArray = std::vector<SubmitContext>;
+    // Frame containers are allocated from FrameAllocator and released in end_frame()
+    using SubmitContextArray = FrameVector<SubmitContext>;
     using SubmitInfoArray = std::vector<rhi::SubmitInfo>;
-    using PipelineBarrierArray = std::vector<rhi::PipelineBarrier>;
+    using PipelineBarrierArray = FrameVector<rhi::PipelineBarrier>;
+    using PipelineBarrierMap = FrameUnorderedMap<RenderPassName, PipelineBarrierArray>;
 
     std::unique_ptr<RenderGraph> m_renderGraph = nullptr;
     std::unique_ptr<RenderPassContainer> m_renderPassContainer = nullptr;
@@ -82,11 +85,13 @@ private:
     
     rhi::SubmitInfo m_uploadSubmitInfo;
     rhi::SubmitInfo m_bvhBuildSubmitInfo;
+    rhi::SubmitInfo m_workerSubmitInfo;
+    rhi::PresentInfo m_presentInfo;
 
     const RenderGraph::Node* m_backBufferNode = nullptr;
 
     SubmitContextArray m_submitContexts;
-    std::unordered_map<RenderPassName, PipelineBarrierArray> m_pipelineBarriersByPassName;
+    PipelineBarrierMap m_pipelineBarriersByPassName;
 
     TaskGroup m_commandRecordingTaskGroup;
 
@@ -6,6 +6,8 @@
 #include "asset_manager/model/model.h"
 #include "engine/components/model_component.h"
 #include "core/primitives/aabb.h"
+#include "core/parallel.h"
+#include "core/bulk_math.h"
 #include "shaders/shader_interop_renderer.h"
 #include "meshoptimizer.h"
 
@@ -38,27 +40,37 @@ void GPUModel::build(SceneManager* sceneManager, const CommandRecorder& cmdRecor
 
     const AABB& aabb = this->aabb();
 
-    for (uint32 i = 0; i != m_model->vertex_positions().size(); ++i)
-    {
-        const Float3& position = m_model->vertex_positions()[i];
-        const uint8 wind = m_model->vertex_wind_weights().empty() ? 0xFF : m_model->vertex_wind_weights()[i];
-
-        VertexPositionWind16Bit vertex;
-        vertex.from_full(aabb, position, wind);
-        const Float3 posAfterCompression = vertex.get_position(aabb);
-
-        if (
-            std::abs(posAfterCompression.x - position.x) <= targetPrecision &&
-            std::abs(posAfterCompression.y - position.y) <= targetPrecision &&
-            std::abs(posAfterCompression.z - position.z) <= targetPrecision &&
-            wind == vertex.get_wind()
-        )
+    const bool isFullPrecisionRequired = parallel_reduce(0, m_model->vertex_positions().size(), false,
+        [&](uint64 begin, uint64 end, bool isRequired)
         {
-            continue;
-        }
+            for (uint64 i = begin; i != end && !isRequired; ++i)
+            {
+                const Float3& position = m_model->vertex_positions()[i];
+                const uint8 wind = m_model->vertex_wind_weights().empty() ? 0xFF : m_model->vertex_wind_weights()[i];
+
+                VertexPositionWind16Bit vertex;
+                vertex.from_full(aabb, position, wind);
+                const Float3 posAfterCompression = vertex.get_position(aabb);
+
+                if (
+                    std::abs(posAfterCompression.x - position.x) <= targetPrecision &&
+                    std::abs(posAfterCompression.y - position.y) <= targetPrecision &&
+                    std::abs(posAfterCompression.z - position.z) <= targetPrecision &&
+                    wind == vertex.get_wind()
+                )
+                {
+                    continue;
+                }
+
+                isRequired = true;
+            }
+            return isRequired;
+        },
+        [](bool a, bool b) { return a || b; }
+    );
 
+    if (isFullPrecisionRequired)
         m_positionFormat = VertexPositionWind32Bit::FORMAT;
-    }
 
     const uint32 positionFormatStride = rhi::get_format_stride(m_positionFormat);
 
@@ -71,16 +83,32 @@ void GPUModel::build(SceneManager* sceneManager, const CommandRecorder& cmdRecor
         const std::vector<Float2>& uv0 = m_model->vertex_uv_set0().empty() ? m_model->vertex_uv_set1() : m_model->vertex_uv_set0();
         const std::vector<Float2>& uv1 = m_model->vertex_uv_set1().empty() ? m_model->vertex_uv_set0() : m_model->vertex_uv_set1();
 
-        m_uvRangeMin = Float2(FLOAT_MAX, FLOAT_MAX);
-        m_uvRangeMax = Float2(FLOAT_MIN, FLOAT_MIN);
+        using UVRange = std::pair<Float2, Float2>;
+        const UVRange initialUVRange(Float2(FLOAT_MAX, FLOAT_MAX), Float2(-FLOAT_MAX, -FLOAT_MAX));
 
-        for (uint64 i = 0; i != uvCount; ++i)
-        {
-            m_uvRangeMin = min(m_uvRangeMin, uv0.at(i));
-            m_uvRangeMin = min(m_uvRangeMin, uv1.at(i));
-            m_uvRangeMax = max(m_uvRangeMax, uv0.at(0));
-            m_uvRangeMax = max(m_uvRangeMax, uv1.at(i));
-        }
+        const UVRange uvRange = parallel_reduce(0, uvCount, initialUVRange,
+            [&](uint64 begin, uint64 end, UVRange uvRange)
+            {
+                for (const std::vector<Float2>* uvs : { &uv0, &uv1 })
+                {
+                    if (begin >= uvs->size())
+                        continue;
+
+                    Float2 chunkMin, chunkMax;
+                    compute_bounds(uvs->data() + begin, std::min<uint64>(end, uvs->size()) - begin, chunkMin, chunkMax);
+                    uvRange.first = min(uvRange.first, chunkMin);
+                    uvRange.second = max(uvRange.second, chunkMax);
+                }
+                return uvRange;
+            },
+            [](const UVRange& a, const UVRange& b)
+            {
+                return UVRange(min(a.first, b.first), max(a.second, b.second));
+            }
+        );
+
+        m_uvRangeMin = uvRange.first;
+        m_uvRangeMax = uvRange.second;
 
         if (
             std::abs(m_uvRangeMax.x - m_uvRangeMin.x) > 65536 || 
@@ -185,6 +213,7 @@ void GPUModel::build(SceneManager* sceneManager, const CommandRecorder& cmdRecor
 
     bufferInfo.memoryUsage = rhi::MemoryUsage::GPU;
     bufferInfo.flags = rhi::ResourceFlags::RAY_TRACING;
+    bufferInfo.memoryTag = MemoryTag::ASSETS_MODELS;
     
     // TODO: Add bone indices to size when animations will be implemented
     const uint64 alignment = rhi::get_min_offset_alignment(&bufferInfo);
@@ -232,14 +261,17 @@ void GPUModel::build(SceneManager* sceneManager, const CommandRecorder& cmdRecor
         VertexPositionWind16Bit* vertices = reinterpret_cast<VertexPositionWind16Bit*>(bufferData + bufferOffset);
         bufferOffset += rhi::align_to(m_vertexPositionsWinds.size, alignment);
 
-        for (uint64 i = 0; i != m_model->vertex_positions().size(); ++i)
+        parallel_for(0, m_model->vertex_positions().size(), [&](uint64 begin, uint64 end)
         {
-            const Float3& position = m_model->vertex_positions()[i];
-            uint8 wind = m_model->vertex_wind_weights().empty() ? 0 : m_model->vertex_wind_weights()[i];
-            VertexPositionWind16Bit vertex;
-            vertex.from_full(aabb, position, wind);
-            memcpy(vertices + i, &vertex, sizeof(VertexPositionWind16Bit));
-        }
+            for (uint64 i = begin; i != end; ++i)
+            {
+                const Float3& position = m_model->vertex_positions()[i];
+                uint8 wind = m_model->vertex_wind_weights().empty() ? 0 : m_model->vertex_wind_weights()[i];
+                VertexPositionWind16Bit vertex;
+                vertex.from_full(aabb, position, wind);
+                memcpy(vertices + i, &vertex, sizeof(VertexPositionWind16Bit));
+            }
+        });
 
         break;
     }
@@ -251,14 +283,17 @@ void GPUModel::build(SceneManager* sceneManager, const CommandRecorder& cmdRecor
         VertexPositionWind32Bit* vertices = reinterpret_cast<VertexPositionWind32Bit*>(bufferData + bufferOffset);
         bufferOffset += rhi::align_to(m_vertexPositionsWinds.size, alignment);
 
-        for (uint64 i = 0; i != m_model->vertex_positions().size(); ++i)
+        parallel_for(0, m_model->vertex_positions().size(), [&](uint64 begin, uint64 end)
         {
-            const Float3& position = m_model->vertex_positions()[i];
-            uint8 wind = m_model->vertex_wind_weights().empty() ? 0 : m_model->vertex_wind_weights()[i];
-            VertexPositionWind32Bit vertex;
-            vertex.from_full(position, wind);
-            memcpy(vertices + i, &vertex, sizeof(VertexPositionWind32Bit));
-        }
+            for (uint64 i = begin; i != end; ++i)
+            {
+                const Float3& position = m_model->vertex_positions()[i];
+                uint8 wind = m_model->vertex_wind_weights().empty() ? 0 : m_model->vertex_wind_weights()[i];
+                VertexPositionWind32Bit vertex;
+                vertex.from_full(position, wind);
+                memcpy(vertices + i, &vertex, sizeof(VertexPositionWind32Bit));
+            }
+        });
 
         break;
     }
@@ -281,12 +316,15 @@ void GPUModel::build(SceneManager* sceneManager, const CommandRecorder& cmdRecor
         VertexNormal* vertices = reinterpret_cast<VertexNormal*>(bufferData + bufferOffset);
         bufferOffset += rhi::align_to(m_vertexNormals.size, alignment);
 
-        for (uint64 i = 0; i != m_model->vertex_normals().size(); ++i)
+        parallel_for(0, m_model->vertex_normals().size(), [&](uint64 begin, uint64 end)
         {
-            VertexNormal vertex;
-            vertex.from_full(m_model->vertex_normals()[i]);
-            memcpy(vertices + i, &vertex, sizeof(VertexNormal));
-        }
+            for (uint64 i = begin; i != end; ++i)
+            {
+                VertexNormal vertex;
+                vertex.from_full(m_model->vertex_normals()[i]);
+                memcpy(vertices + i, &vertex, sizeof(VertexNormal));
+            }
+        });
     }
 
     if (!m_model->vertex_tangents().empty())
@@ -297,12 +335,15 @@ void GPUModel::build(SceneManager* sceneManager, const CommandRecorder& cmdRecor
         VertexTangent* vertices = reinterpret_cast<VertexTangent*>(bufferData + bufferOffset);
         bufferOffset += rhi::align_to(m_vertexTangents.size, alignment);
 
-        for (uint64 i = 0; i != m_model->vertex_tangents().size(); ++i)
+        parallel_for(0, m_model->vertex_tangents().size(), [&](uint64 begin, uint64 end)
         {
-            VertexTangent vertex;
-            vertex.from_full(m_model->vertex_tangents()[i]);
-            memcpy(vertices + i, &vertex, sizeof(VertexTangent));
-        }
+            for (uint64 i = begin; i != end; ++i)
+            {
+                VertexTangent vertex;
+                vertex.from_full(m_model->vertex_tangents()[i]);
+                memcpy(vertices + i, &vertex, sizeof(VertexTangent));
+            }
+        });
     }
 
     if (!m_model->vertex_uv_set0().empty() || m_model->vertex_uv_set1().empty())
@@ -320,13 +361,16 @@ void GPUModel::build(SceneManager* sceneManager, const CommandRecorder& cmdRecor
             VertexUVs16Bit* vertices = reinterpret_cast<VertexUVs16Bit*>(bufferData + bufferOffset);
             bufferOffset += rhi::align_to(m_vertexUVs.size, alignment);
 
-            for (uint64 i = 0; i != uvCount; ++i)
+            parallel_for(0, uvCount, [&](uint64 begin, uint64 end)
             {
-                VertexUVs16Bit vertex;
-                vertex.uv0.from_full(uv0.at(i), m_uvRangeMin, m_uvRangeMax);
-                vertex.uv1.from_full(uv1.at(i), m_uvRangeMin, m_uvRangeMax);
-                memcpy(vertices + i, &vertex, sizeof(VertexUVs16Bit));
-            }
+                for (uint64 i = begin; i != end; ++i)
+                {
+                    VertexUVs16Bit vertex;
+                    vertex.uv0.from_full(uv0.at(i), m_uvRangeMin, m_uvRangeMax);
+                    vertex.uv1.from_full(uv1.at(i), m_uvRangeMin, m_uvRangeMax);
+                    memcpy(vertices + i, &vertex, sizeof(VertexUVs16Bit));
+                }
+            });
 
             break;
         }
@@ -335,13 +379,16 @@ void GPUModel::build(SceneManager* sceneManager, const CommandRecorder& cmdRecor
             VertexUVs32Bit* vertices = reinterpret_cast<VertexUVs32Bit*>(bufferData + bufferOffset);
             bufferOffset += rhi::align_to(m_vertexUVs.size, alignment);
 
-            for (uint64 i = 0; i != uvCount; ++i)
+            parallel_for(0, uvCount, [&](uint64 begin, uint64 end)
             {
-                VertexUVs32Bit vertex;
-                vertex.uv0.from_full(uv0.at(i), m_uvRangeMin, m_uvRangeMax);
-                vertex.uv1.from_full(uv1.at(i),m_uvRangeMin, m_uvRangeMax);
-                memcpy(vertices + i, &vertex, sizeof(VertexUVs32Bit));
-            }
+                for (uint64 i = begin; i != end; ++i)
+                {
+                    VertexUVs32Bit vertex;
+                    vertex.uv0.from_full(uv0.at(i), m_uvRangeMin, m_uvRangeMax);
+                    vertex.uv1.from_full(uv1.at(i),m_uvRangeMin, m_uvRangeMax);
+                    memcpy(vertices + i, &vertex, sizeof(VertexUVs32Bit));
+                }
+            });
 
             break;
         }
@@ -11,6 +11,7 @@
 
 #include "core/primitives/sphere.h"
 #include "core/task_composer.h"
+#include "core/profiler.h"
 #include "asset_manager/asset_manager.h"
 #include "asset_manager/events.h"
 #include "shaders/shader_interop_renderer.h"
@@ -87,6 +88,8 @@ SceneManager::~SceneManager()
 
 void SceneManager::upload(rhi::CommandBuffer* cmd)
 {
+    FE_PROFILE_SCOPE("SceneManager::upload");
+
     set_cmd(cmd);
 
     if (m_deleteHandlersPerFrame.size() < g_frameIndex + 1)
@@ -97,13 +100,16 @@ void SceneManager::upload(rhi::CommandBuffer* cmd)
         deleteHandler();
     deleteHandlers.clear();
 
-    TaskGroup taskGroup;
+    // GPU resources are built first, storage buffers are allocated after that and filled at the end.
+    // All stages are one graph, so this thread waits only once. The graph is kept between frames to reuse its nodes.
+    TaskGraph& taskGraph = m_uploadGraph;
+    taskGraph.clear();
 
     for (asset::Model* model : m_pendingModels)
-        add_gpu_model(model, taskGroup);
+        add_gpu_model(model, taskGraph);
 
     for (asset::Material* material : m_pendingMaterials)
-        add_gpu_material(material->get_uuid(), taskGroup);
+        add_gpu_material(material->get_uuid(), taskGraph);
 
     for (engine::Entity* entity : m_pendingEntities)
     {
@@ -111,7 +117,7 @@ void SceneManager::upload(rhi::CommandBuffer* cmd)
         {
             UUID modelUUID = modelComponent->get_model_uuid();
 
-            add_gpu_model(modelComponent->get_model(), taskGroup);
+            add_gpu_model(modelComponent->get_model(), taskGraph);
             if (GPUModel* gpuModel = get_gpu_model(modelUUID))
                 gpuModel->add_instance(entity);
 
@@ -122,7 +128,7 @@ void SceneManager::upload(rhi::CommandBuffer* cmd)
         }
 
         if (engine::MaterialComponent* materialComponent = entity->get_component<engine::MaterialComponent>())
-            add_gpu_materials(materialComponent->material_uuids(), taskGroup);
+            add_gpu_materials(materialComponent->material_uuids(), taskGraph);
 
         if (engine::EditorCameraComponent* cameraComponent = entity->get_component<engine::EditorCameraComponent>())
         {
@@ -137,29 +143,38 @@ void SceneManager::upload(rhi::CommandBuffer* cmd)
     }
 
     for (engine::MaterialComponent* materialComponent : m_pendingMaterialComponents)
-        add_gpu_materials(materialComponent->material_uuids(), taskGroup);
+        add_gpu_materials(materialComponent->material_uuids(), taskGraph);
 
     m_pendingEntities.clear();
     m_pendingMaterialComponents.clear();
     m_pendingModels.clear();
     m_pendingMaterials.clear();
 
-    TaskComposer::wait(taskGroup);
+    // RHI buffer creation can run on any thread: buffers come from a thread safe pool, VMA is internally synchronized
+    // and bindless descriptors are allocated and written under the mutex of their pool
+    const uint32 buildNodeCount = taskGraph.get_node_count();
+    TaskGraph::NodeHandle allocateNode = taskGraph.add_task([this](TaskExecutionInfo execInfo)
+    {
+        allocate_storage_buffers();
 
-    allocate_storage_buffers();
+        // More offsets will be added further when new ShaderEntities will be created
+        m_lightEntityBufferOffset = 0;
+    }, "AllocateStorageBuffers");
 
-    // More offsets will be added further when new ShaderEntities will be created
-    m_lightEntityBufferOffset = 0;
+    for (TaskGraph::NodeHandle buildNode = 0; buildNode != buildNodeCount; ++buildNode)
+        taskGraph.add_dependency(buildNode, allocateNode);
 
-    TaskComposer::execute(taskGroup, [this](TaskExecutionInfo execInfo)
+    // Buffers are filled independently of each other
+    TaskGraph::NodeHandle fillNode = taskGraph.add_task([this](TaskExecutionInfo execInfo)
     {
         for (auto& [texture] : m_pendingTextures)
         {
             texture->build(cmd_recorder(rhi::QueueType::GRAPHICS));
         }
-    });
+    }, "BuildTextures");
+    taskGraph.add_dependency(allocateNode, fillNode);
 
-    TaskComposer::execute(taskGroup, [this](TaskExecutionInfo execInfo)
+    fillNode = taskGraph.add_task([this](TaskExecutionInfo execInfo)
     {
         rhi::Buffer* buffer = get_model_buffer();
         ShaderModel* shaderModels = static_cast<ShaderModel*>(buffer->mappedData);
@@ -167,9 +182,10 @@ void SceneManager::upload(rhi::CommandBuffer* cmd)
 
         for (const GPUModelHandle& gpuModel : m_gpuModels)
             gpuModel->fill_shader_model(shaderModels[index++]);
-    });
+    }, "FillModels");
+    taskGraph.add_dependency(allocateNode, fillNode);
 
-    TaskComposer::execute(taskGroup, [this](TaskExecutionInfo execInfo)
+    fillNode = taskGraph.add_task([this](TaskExecutionInfo execInfo)
     {
         rhi::Buffer* modelInstanceBuffer = get_model_instance_buffer();
         rhi::Buffer* meshInstanceBuffer = get_mesh_instance_buffer();
@@ -190,9 +206,10 @@ void SceneManager::upload(rhi::CommandBuffer* cmd)
                 meshInstanceOffset
             );
         }
-    });
+    }, "FillModelInstances");
+    taskGraph.add_dependency(allocateNode, fillNode);
 
-    TaskComposer::execute(taskGroup, [this](TaskExecutionInfo execInfo)
+    fillNode = taskGraph.add_task([this](TaskExecutionInfo execInfo)
     {
         rhi::Buffer* buffer = get_shader_entity_buffer();
         ShaderEntity* shaderEntities = static_cast<ShaderEntity*>(buffer->mappedData);
@@ -206,9 +223,10 @@ void SceneManager::upload(rhi::CommandBuffer* cmd)
                 shaderEntityComponent->fill_shader_data(shaderEntity);
             }
         }
-    });
+    }, "FillShaderEntities");
+    taskGraph.add_dependency(allocateNode, fillNode);
 
-    TaskComposer::execute(taskGroup, [this](TaskExecutionInfo execInfo)
+    fillNode = taskGraph.add_task([this](TaskExecutionInfo execInfo)
     {
         rhi::Buffer* buffer = get_material_buffer();
         ShaderMaterial* shaderMaterials = static_cast<ShaderMaterial*>(buffer->mappedData);
@@ -220,14 +238,18 @@ void SceneManager::upload(rhi::CommandBuffer* cmd)
             shaderMaterial.init();
             material->fill_shader_material(this, shaderMaterial);
         }
-    });
+    }, "FillMaterials");
+    taskGraph.add_dependency(allocateNode, fillNode);
 
-    TaskComposer::execute(taskGroup, [this](TaskExecutionInfo execInfo)
+    fillNode = taskGraph.add_task([this](TaskExecutionInfo execInfo)
     {
         fill_frame_data();
         fill_camera_buffers();
-    });
+    }, "FillFrameData");
+    taskGraph.add_dependency(allocateNode, fillNode);
 
+    TaskGroup taskGroup;
+    TaskComposer::execute(taskGroup, taskGraph);
     TaskComposer::wait(taskGroup);
 
     for (auto& [texture] : m_pendingTextures)
@@ -244,6 +266,8 @@ void SceneManager::upload(rhi::CommandBuffer* cmd)
 
 void SceneManager::build_bvh(rhi::CommandBuffer* cmd)
 {
+    FE_PROFILE_SCOPE("SceneManager::build_bvh");
+
     FE_CHECK(cmd->cmdPool->queueType == rhi::QueueType::COMPUTE);
 
     set_cmd(cmd);
@@ -338,9 +362,11 @@ void SceneManager::allocate_arrays()
 
 void SceneManager::subscribe_to_events()
 {
-    EventManager::subscribe<engine::EntityCreatedEvent>([this](const auto& event)
+    EventManager::subscribe_batch<engine::EntityCreatedEvent>([this](std::span<const engine::EntityCreatedEvent> events)
     {
-        m_pendingEntities.insert(event.get_entity());
+        m_pendingEntities.reserve(m_pendingEntities.size() + events.size());
+        for (const engine::EntityCreatedEvent& event : events)
+            m_pendingEntities.insert(event.get_entity());
     });
 
     EventManager::subscribe<engine::EntityRemovedEvent>([this](const auto& event)
@@ -490,7 +516,7 @@ void SceneManager::create_samplers()
     createSampler(SAMPLER_MINIMUM_NEAREST_CLAMP, samplerInfo);
 }
 
-void SceneManager::add_gpu_model(asset::Model* model, TaskGroup& taskGroup)
+void SceneManager::add_gpu_model(asset::Model* model, TaskGraph& taskGraph)
 {
     if (m_gpuResourcesLookup.contains(model->get_uuid()))
         return;
@@ -501,13 +527,13 @@ void SceneManager::add_gpu_model(asset::Model* model, TaskGroup& taskGroup)
 
     m_gpuResourcesLookup[model->get_uuid()] = index;
 
-    TaskComposer::execute(taskGroup, [this, gpuModel](TaskExecutionInfo execInfo)
+    taskGraph.add_task([this, gpuModel](TaskExecutionInfo execInfo)
     {
         gpuModel->build(this, cmd_recorder(rhi::QueueType::GRAPHICS));
-    });
+    }, "BuildGPUModel");
 }
 
-void SceneManager::add_gpu_material(UUID materialUUID, TaskGroup& taskGroup)
+void SceneManager::add_gpu_material(UUID materialUUID, TaskGraph& taskGraph)
 {
     if (m_gpuResourcesLookup.contains(materialUUID))
         return;
@@ -518,16 +544,16 @@ void SceneManager::add_gpu_material(UUID materialUUID, TaskGroup& taskGroup)
 
     m_gpuResourcesLookup[materialUUID] = index;
 
-    TaskComposer::execute(taskGroup, [this, gpuMaterial](TaskExecutionInfo execInfo)
+    taskGraph.add_task([this, gpuMaterial](TaskExecutionInfo execInfo)
     {
         gpuMaterial->build(this, cmd_recorder(rhi::QueueType::GRAPHICS));
-    });
+    }, "BuildGPUMaterial");
 }
 
-void SceneManager::add_gpu_materials(const std::vector<UUID>& materialUUIDs, TaskGroup& taskGroup)
+void SceneManager::add_gpu_materials(const std::vector<UUID>& materialUUIDs, TaskGraph& taskGraph)
 {
     for (UUID materialUUID : materialUUIDs)
-        add_gpu_material(materialUUID, taskGroup);
+        add_gpu_material(materialUUID, taskGraph);
 }
 
 GPUModel* SceneManager::get_gpu_model(UUID modelUUID) const
@@ -649,6 +675,8 @@ uint64 SceneManager::calc_buffer_size(uint64 currentSize, uint64 cpuEntrieSize)
 
 void SceneManager::fill_frame_data()
 {
+    FE_PROFILE_SCOPE("SceneManager::fill_frame_data");
+
     if (m_frameBuffers.size() < g_frameIndex + 1)
     {
         m_frameBuffers.push_back(create_uma_uniform_buffer(sizeof(FrameUB)));
@@ -712,6 +740,7 @@ rhi::Buffer* SceneManager::create_uma_storage_buffer(uint64 size) const
     rhi::BufferInfo bufferInfo;
     bufferInfo.bufferUsage = rhi::ResourceUsage::STORAGE_BUFFER;
     bufferInfo.memoryUsage = rhi::MemoryUsage::CPU_TO_GPU;
+    bufferInfo.memoryTag = MemoryTag::RENDERER_SCENE_BUFFERS;
     bufferInfo.size = size;
 
     rhi::Buffer* buffer;
@@ -724,6 +753,7 @@ rhi::Buffer* SceneManager::create_uma_uniform_buffer(uint64 size) const
     rhi::BufferInfo bufferInfo;
     bufferInfo.bufferUsage = rhi::ResourceUsage::UNIFORM_BUFFER;
     bufferInfo.memoryUsage = rhi::MemoryUsage::CPU_TO_GPU;
+    bufferInfo.memoryTag = MemoryTag::RENDERER_SCENE_BUFFERS;
     bufferInfo.size = size;
 
     rhi::Buffer* buffer;
@@ -761,6 +791,7 @@ void SceneManager::fill_tlas(rhi::CommandBuffer* cmd)
         bufferInfo.memoryUsage = rhi::MemoryUsage::GPU;
         bufferInfo.size = info.tlas.count * instanceSize;
         bufferInfo.flags = rhi::ResourceFlags::RAY_TRACING;
+        bufferInfo.memoryTag = MemoryTag::RENDERER_SCENE_BUFFERS;
     
         rhi::create_buffer(&info.tlas.instanceBuffer, &bufferInfo);
         rhi::create_acceleration_structure(&m_TLAS, &info);
@@ -783,6 +814,7 @@ void SceneManager::fill_tlas(rhi::CommandBuffer* cmd)
         bufferInfo.bufferUsage = rhi::ResourceUsage::TRANSFER_SRC;
         bufferInfo.memoryUsage = rhi::MemoryUsage::CPU;
         bufferInfo.size = m_TLAS->info.tlas.count * instanceSize;
+        bufferInfo.memoryTag = MemoryTag::RENDERER_SCENE_BUFFERS;
         rhi::create_buffer(&m_uploadBuffersForTLAS.at(g_frameIndex), &bufferInfo);
     }
 
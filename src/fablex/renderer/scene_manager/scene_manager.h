@@ -7,6 +7,7 @@
 #include "common.h"
 
 #include "core/fwd.h"
+#include "core/task_graph.h"
 #include "engine/entity/entity.h"
 #include "engine/components/fwd.h"
 #include "shaders/shader_interop_renderer.h"
@@ -78,6 +79,9 @@ private:
     std::vector<asset::Model*> m_pendingModels; 
     std::vector<asset::Material*> m_pendingMaterials;
 
+    // Rebuilt by upload() every frame, nodes of previous frames are reused
+    TaskGraph m_uploadGraph;
+
     std::vector<engine::ModelComponent*> m_modelComponents;
     std::vector<engine::ShaderEntityComponent*> m_shaderEntityComponents;
 
@@ -119,9 +123,9 @@ private:
     void load_resources();
     void create_samplers();
 
-    void add_gpu_model(asset::Model* model, TaskGroup& taskGroup);
-    void add_gpu_material(UUID materialUUID, TaskGroup& taskGroup);
-    void add_gpu_materials(const std::vector<UUID>& materialUUIDs, TaskGroup& taskGroup);
+    void add_gpu_model(asset::Model* model, TaskGraph& taskGraph);
+    void add_gpu_material(UUID materialUUID, TaskGraph& taskGraph);
+    void add_gpu_materials(const std::vector<UUID>& materialUUIDs, TaskGraph& taskGraph);
 
     GPUModel* get_gpu_model(UUID modelUUID) const;
     GPUTexture* get_gpu_texture(UUID textureUUID) const;
@@ -54,7 +54,7 @@ int32 Utils::get_sampler_minimum_nearest_clamp()
     return get_sampler_descriptor(SAMPLER_MINIMUM_NEAREST_CLAMP);
 }
 
-int32 Utils::get_sampler_descriptor(const char* samplerName)
+int32 Utils::get_sampler_descriptor(Name samplerName)
 {
     FE_CHECK(s_renderContext);
     return s_renderContext->scene_manager()->sampler_descriptor(samplerName);
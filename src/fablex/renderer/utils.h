@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/types.h"
+#include "core/name.h"
 #include "asset_manager/fwd.h"
 
 namespace fe::renderer
@@ -25,7 +26,7 @@ public:
 private:
     inline static RenderContext* s_renderContext = nullptr;
 
-    static int32 get_sampler_descriptor(const char* samplerName);
+    static int32 get_sampler_descriptor(Name samplerName);
 };
 
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "core/macro.h"
 #include "core/window.h"
 #include "core/flags_operations.h"
+#include "core/memory_tracker.h"
 
 #ifdef WIN32
 #define FE_VULKAN
@@ -43,6 +44,9 @@ struct BufferInfo
     // Init data can be used only with memory usage CPU_ONLY and GPU_TO_CPU
     void* initData = nullptr;
     uint64 initDataSize;
+
+    // Buffer size is counted under the tag until the buffer is destroyed
+    MemoryTag memoryTag = MemoryTag::UNTAGGED;
 };
 
 struct alignas(64) Buffer
@@ -67,6 +71,7 @@ struct alignas(64) Buffer
     Format format : 8;
 
     void* mappedData = nullptr;
+    MemoryTag memoryTag = MemoryTag::UNTAGGED;
 };
 
 FE_COMPILE_CHECK(sizeof(Buffer) == sizeof(uint64) * 8);
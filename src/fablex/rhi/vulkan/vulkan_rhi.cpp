@@ -1824,7 +1824,7 @@ public:
         writeDescriptorSet.dstArrayElement = buffer->descriptorIndex;
         writeDescriptorSet.descriptorCount = 1;
         writeDescriptorSet.pBufferInfo = &bufferDescriptorInfo;
-        vkUpdateDescriptorSets(g_device.device, 1, &writeDescriptorSet, 0, nullptr);
+        m_storageBufferBindlessPool.write(writeDescriptorSet);
     }
 
     void allocate_descriptor(BufferView* bufferView)
@@ -1836,28 +1836,30 @@ public:
 
         if (bufferView->format != rhi::Format::UNDEFINED)
         {
+            BindlessDescriptorPool* texelBufferPool = nullptr;
+
             switch (bufferView->type)
             {
             case rhi::ViewType::SRV:
                 writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-                writeDescriptorSet.dstSet = m_uniformTexelBufferBindlessPool.set;
-                bufferView->descriptorIndex = m_uniformTexelBufferBindlessPool.allocate();
+                texelBufferPool = &m_uniformTexelBufferBindlessPool;
                 break;
             case rhi::ViewType::UAV:
                 writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
-                writeDescriptorSet.dstSet = m_storageTexelBufferBindlessPool.set;
-                bufferView->descriptorIndex = m_storageTexelBufferBindlessPool.allocate();
+                texelBufferPool = &m_storageTexelBufferBindlessPool;
                 break;
             default:
                 FE_LOG(LogVulkanRHI, FATAL, "Failed to allocate descriptor for buffer view");
             }
 
+            writeDescriptorSet.dstSet = texelBufferPool->set;
+            bufferView->descriptorIndex = texelBufferPool->allocate();
             writeDescriptorSet.dstBinding = 0;
             writeDescriptorSet.dstArrayElement = bufferView->descriptorIndex;
             writeDescriptorSet.descriptorCount = 1;
             VkBufferView vkBufferViewHandle = bufferView->vk().bufferView;
             writeDescriptorSet.pTexelBufferView = &vkBufferViewHandle;
-            vkUpdateDescriptorSets(g_device.device, 1, &writeDescriptorSet, 0, nullptr);
+            texelBufferPool->write(writeDescriptorSet);
         }
         else
         {
@@ -1877,7 +1879,7 @@ public:
             writeDescriptorSet.dstArrayElement = bufferView->descriptorIndex;
             writeDescriptorSet.descriptorCount = 1;
             writeDescriptorSet.pBufferInfo = &bufferDescriptorInfo;
-            vkUpdateDescriptorSets(g_device.device, 1, &writeDescriptorSet, 0, nullptr);
+            m_storageBufferBindlessPool.write(writeDescriptorSet);
         }
     }
 
@@ -1904,7 +1906,7 @@ public:
             writeDescriptorSet.dstArrayElement = textureView->descriptorIndex;
             writeDescriptorSet.descriptorCount = 1;
             writeDescriptorSet.pImageInfo = &imageInfo;
-            vkUpdateDescriptorSets(g_device.device, 1, &writeDescriptorSet, 0, nullptr);
+            m_imageBindlessPool.write(writeDescriptorSet);
         };
 
         auto setStorageImageDescriptor = [&]()
@@ -1926,7 +1928,7 @@ public:
             writeDescriptorSet.dstArrayElement = textureView->descriptorIndex;
             writeDescriptorSet.descriptorCount = 1;
             writeDescriptorSet.pImageInfo = &imageInfo;
-            vkUpdateDescriptorSets(g_device.device, 1, &writeDescriptorSet, 0, nullptr);
+            m_storageImageBindlessPool.write(writeDescriptorSet);
         };
 
         switch (textureView->type)
@@ -1967,7 +1969,7 @@ public:
         writeDescriptorSet.dstArrayElement = sampler->descriptorIndex;
         writeDescriptorSet.descriptorCount = 1;
         writeDescriptorSet.pImageInfo = &imageInfo;
-        vkUpdateDescriptorSets(g_device.device, 1, &writeDescriptorSet, 0, nullptr);
+        m_samplerBindlessPool.write(writeDescriptorSet);
     }
 
     void allocate_descriptor(AccelerationStructure* accelerationStructure)
@@ -1987,7 +1989,7 @@ public:
         writeDescriptorSet.dstArrayElement = accelerationStructure->descriptorIndex;
         writeDescriptorSet.descriptorCount = 1;
         writeDescriptorSet.pNext = &asInfo;
-        vkUpdateDescriptorSets(g_device.device, 1, &writeDescriptorSet, 0, nullptr);
+        m_accelerationStructureBindlessPool.write(writeDescriptorSet);
     }
 
     void free_descriptor(Buffer* buffer)
@@ -2255,6 +2257,13 @@ private:
             if (descriptorIndex != s_undefinedDescriptor)
                 freePlaces.push_back(descriptorIndex);
         }
+
+        // Vulkan requires external synchronization of the set, the mutex lets resources be created on any thread
+        void write(const VkWriteDescriptorSet& writeDescriptorSet)
+        {
+            std::scoped_lock<std::mutex> locker(mutex);
+            vkUpdateDescriptorSets(g_device.device, 1, &writeDescriptorSet, 0, nullptr);
+        }
     };
 
     struct ZeroDescriptorPool
@@ -3276,6 +3285,7 @@ void create_buffer(Buffer** buffer, const BufferInfo* info)
     bufferPtr->size = info->size;
     bufferPtr->format = info->format;
     bufferPtr->descriptorIndex = DescriptorHeap::s_undefinedDescriptor;
+    bufferPtr->memoryTag = info->memoryTag;
 
     VkBufferCreateInfo bufferCreateInfo{};
     VmaAllocationCreateInfo allocCreateInfo{};
@@ -3323,6 +3333,7 @@ void create_buffer(Buffer** buffer, const BufferInfo* info)
         bufferPtr->vk().address = get_device_address(bufferPtr->vk().buffer);
 
     bufferPtr->mappedData = bufferPtr->vk().allocation->GetMappedData();
+    MemoryTracker::on_allocate(bufferPtr->memoryTag, bufferPtr->size);
 
     switch (info->memoryUsage)
     {
@@ -3360,6 +3371,8 @@ void destroy_buffer(Buffer* buffer)
     if (buffer->vk().buffer != VK_NULL_HANDLE)
         vmaDestroyBuffer(g_allocator.gpuAllocator, buffer->vk().buffer, buffer->vk().allocation);
 
+    MemoryTracker::on_free(buffer->memoryTag, buffer->size);
+
     g_descriptorHeap.free_descriptor(buffer);
     g_allocator.bufferAllocator.free(buffer);
 }